@@ -0,0 +1,149 @@
+#ifndef CAROS_BENCH_HPP
+#define CAROS_BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Mikrobenchmark-Harness für die Kernmodule (bin/caros-bench, ohne GTK/GStreamer).
+//
+// Ein Benchmark besteht aus Vorbereitung und gemessener Operation:
+//
+//   CAROS_BENCH("catalog/parse_50k") {
+//       std::string json = make_catalog_json(50000);    // wird nicht gemessen
+//       return [json] { bench::keep(CatalogParser::parse(json)); };
+//   }
+//
+// Der Runner wärmt auf, wählt die Stapelgröße so, dass eine Probe mindestens min_sample_us
+// dauert, und sammelt Proben bis samples oder max_time_ms erreicht ist. Ausgewertet wird die
+// Zeit pro Operation über alle Proben (Perzentile, Mittel, Streuung).
+namespace bench {
+
+using Op = std::function<void()>;
+using Setup = std::function<Op()>;
+
+struct Options {
+    int warmup_ms = 200;
+    int min_sample_us = 2000;
+    int samples = 30;
+    int max_time_ms = 3000;
+};
+
+struct Stats {
+    size_t samples = 0;
+    uint64_t batch = 0;  // Operationen pro Probe
+    double min_ns = 0, p50_ns = 0, p90_ns = 0, p99_ns = 0, max_ns = 0;
+    double mean_ns = 0, stddev_ns = 0;
+};
+
+struct Result {
+    std::string name;
+    Stats stats;
+};
+
+// Perzentil mit linearer Interpolation (p in 0..100), values muss sortiert sein
+inline double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    double pos = (p / 100.0) * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(std::floor(pos));
+    size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+inline Stats summarize(std::vector<double> per_op_ns, uint64_t batch) {
+    Stats s;
+    s.samples = per_op_ns.size();
+    s.batch = batch;
+    if (per_op_ns.empty()) return s;
+    std::sort(per_op_ns.begin(), per_op_ns.end());
+    s.min_ns = per_op_ns.front();
+    s.max_ns = per_op_ns.back();
+    s.p50_ns = percentile(per_op_ns, 50);
+    s.p90_ns = percentile(per_op_ns, 90);
+    s.p99_ns = percentile(per_op_ns, 99);
+    double sum = 0;
+    for (double v : per_op_ns) sum += v;
+    s.mean_ns = sum / per_op_ns.size();
+    double var = 0;
+    for (double v : per_op_ns) var += (v - s.mean_ns) * (v - s.mean_ns);
+    s.stddev_ns = per_op_ns.size() > 1 ? std::sqrt(var / (per_op_ns.size() - 1)) : 0.0;
+    return s;
+}
+
+// Verhindert, dass der Compiler ein ungenutztes Ergebnis wegoptimiert
+template<typename T>
+inline void keep(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Von der Vorbereitung eines Benchmarks gesetzt, gilt nur für dessen Messung
+// (bench_main setzt sie vor jeder Vorbereitung zurück)
+struct Hooks {
+    uint64_t max_batch = 0; // Obergrenze der Stapelgröße, 0 = keine
+    Op between;             // nach jedem Stapel, außerhalb der gemessenen Zeit
+};
+
+inline Hooks& hooks() {
+    static Hooks h;
+    return h;
+}
+
+struct Entry {
+    std::string name;
+    Setup setup;
+};
+
+inline std::vector<Entry>& registry() {
+    static std::vector<Entry> entries;
+    return entries;
+}
+
+struct Registrar {
+    Registrar(const char *name, Setup setup) { registry().push_back({name, std::move(setup)}); }
+};
+
+inline Stats measure(const Op& op, const Options& opt) {
+    using clock = std::chrono::steady_clock;
+    auto elapsed_ns = [](clock::time_point since) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - since).count());
+    };
+
+    // Aufwärmen (Caches, Allokator, Branch-Prädiktor) und dabei die Stapelgröße bestimmen
+    uint64_t batch = 1;
+    auto warm_start = clock::now();
+    uint64_t max_batch = hooks().max_batch ? hooks().max_batch : (1ull << 30);
+    do {
+        auto t0 = clock::now();
+        for (uint64_t i = 0; i < batch; i++) op();
+        double ns = elapsed_ns(t0);
+        if (hooks().between) hooks().between();
+        if (ns < opt.min_sample_us * 1000.0 && batch < max_batch) batch = std::min(batch * 2, max_batch);
+    } while (elapsed_ns(warm_start) < opt.warmup_ms * 1e6);
+
+    std::vector<double> per_op;
+    auto run_start = clock::now();
+    while (static_cast<int>(per_op.size()) < opt.samples) {
+        auto t0 = clock::now();
+        for (uint64_t i = 0; i < batch; i++) op();
+        per_op.push_back(elapsed_ns(t0) / batch);
+        if (hooks().between) hooks().between();
+        // Mindestens 5 Proben, damit die Perzentile etwas aussagen
+        if (per_op.size() >= 5 && elapsed_ns(run_start) > opt.max_time_ms * 1e6) break;
+    }
+    return summarize(std::move(per_op), batch);
+}
+
+} // namespace bench
+
+#define CAROS_BENCH_CAT2(a, b) a##b
+#define CAROS_BENCH_CAT(a, b) CAROS_BENCH_CAT2(a, b)
+#define CAROS_BENCH(name)                                                                        \
+    static bench::Op CAROS_BENCH_CAT(caros_bench_setup_, __LINE__)();                            \
+    static bench::Registrar CAROS_BENCH_CAT(caros_bench_reg_, __LINE__)(name, &CAROS_BENCH_CAT(caros_bench_setup_, __LINE__)); \
+    static bench::Op CAROS_BENCH_CAT(caros_bench_setup_, __LINE__)()
+
+#endif
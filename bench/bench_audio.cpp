@@ -0,0 +1,63 @@
+// Audiopfad im Streaming-Thread: EQ (skalar und SIMD), Spektrum, Lautheitsmessung
+
+#include <memory>
+
+#include "audio_eq.hpp"
+#include "bench.hpp"
+#include "bench_data.hpp"
+#include "loudness.hpp"
+#include "spectrum.hpp"
+
+namespace {
+
+// Ein typischer GStreamer-Puffer: 1024 Stereo-Frames
+constexpr size_t FRAMES = 1024;
+
+std::shared_ptr<std::vector<float>> stereo_noise() {
+    auto data = std::make_shared<std::vector<float>>(FRAMES * 2);
+    bench_data::Rng rng(5);
+    for (auto& s : *data) s = static_cast<float>(rng.uniform(-0.5, 0.5));
+    return data;
+}
+
+bench::Op eq_bench(AudioEqualizer::Kernel kernel) {
+    auto eq = std::make_shared<AudioEqualizer>();
+    auto data = stereo_noise();
+    eq->set_kernel(kernel);
+    for (int b = 0; b < AudioEqualizer::BANDS; b++) eq->set_gain(b, b % 2 ? 4.0f : -3.0f);
+    return [eq, data] {
+        eq->process(data->data(), FRAMES);
+        bench::keep((*data)[0]);
+    };
+}
+
+} // namespace
+
+CAROS_BENCH("audio/eq_scalar_1024") {
+    return eq_bench(AudioEqualizer::Kernel::Scalar);
+}
+
+CAROS_BENCH("audio/eq_best_1024") {
+    // Schnellster Kern dieser CPU (AVX/SSE bzw. NEON)
+    return eq_bench(AudioEqualizer::best_kernel());
+}
+
+CAROS_BENCH("audio/spectrum_push_compute_1024") {
+    auto analyzer = std::make_shared<SpectrumAnalyzer>();
+    auto frames = std::make_shared<std::array<SpectrumFrame, 2>>();
+    auto data = stereo_noise();
+    return [analyzer, frames, data] {
+        analyzer->push(data->data(), FRAMES, 2);
+        analyzer->compute((*frames)[0], (*frames)[1], 0.9f);
+        std::swap((*frames)[0], (*frames)[1]);
+    };
+}
+
+CAROS_BENCH("audio/loudness_meter_1024") {
+    auto meter = std::make_shared<LoudnessMeter>();
+    auto data = stereo_noise();
+    return [meter, data] {
+        meter->process(data->data(), FRAMES);
+        bench::keep(meter->integrated_lufs());
+    };
+}
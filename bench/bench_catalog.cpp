@@ -0,0 +1,194 @@
+// Senderkatalog: Parsen der API-Antwort, Varianten-Gruppierung, Abgleich und stations.csv
+
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "bench.hpp"
+#include "bench_data.hpp"
+#include "station_catalog.hpp"
+#include "station_store.hpp"
+
+namespace {
+
+constexpr size_t CATALOG_SIZE = 50000;
+
+struct Catalog {
+    std::string json;
+    std::vector<CatalogEntry> entries;
+    std::vector<RadioStation> local; // Stand nach dem ersten Abgleich
+};
+
+// Einmal erzeugt und von allen Katalog-Benchmarks geteilt
+const Catalog& catalog() {
+    static Catalog c = [] {
+        Catalog out;
+        out.json = bench_data::catalog_json(CATALOG_SIZE);
+        out.entries = group_variants(CatalogParser::parse(out.json));
+        out.local = diff_catalog({}, out.entries).stations;
+        return out;
+    }();
+    return c;
+}
+
+bool logo_present(const std::string&) { return true; }
+
+// Stand-in für radio-browser auf 127.0.0.1: liefert feste Seiten pro Pfad (HTTP/1.1, Connection:
+// close), damit der Abgleich samt Übertragung gemessen werden kann, ohne Netz und reproduzierbar
+class LoopbackHttp {
+public:
+    explicit LoopbackHttp(std::map<std::string, std::string> pages) : pages(std::move(pages)) {
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 8) != 0 ||
+            getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            std::perror("LoopbackHttp");
+            std::exit(1);
+        }
+        port = ntohs(addr.sin_port);
+        server = std::thread([this] { serve(); });
+    }
+
+    ~LoopbackHttp() {
+        stopping = true;
+        shutdown(fd, SHUT_RDWR);
+        server.join();
+        close(fd);
+    }
+
+    LoopbackHttp(const LoopbackHttp&) = delete;
+    LoopbackHttp& operator=(const LoopbackHttp&) = delete;
+
+    // Einfacher GET wie curl ohne Kompression; leer bei Fehler oder Status != 200
+    std::string get(const std::string& path) const {
+        int c = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        std::string response;
+        if (connect(c, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\nUser-Agent: CarOS-RadioApp/1.0\r\n\r\n";
+            send_all(c, request);
+            char buf[65536];
+            ssize_t n;
+            while ((n = read(c, buf, sizeof(buf))) > 0) response.append(buf, static_cast<size_t>(n));
+        }
+        close(c);
+        size_t body = response.find("\r\n\r\n");
+        if (response.compare(0, 12, "HTTP/1.1 200") != 0 || body == std::string::npos) return "";
+        return response.substr(body + 4);
+    }
+
+private:
+    std::map<std::string, std::string> pages;
+    int fd = -1;
+    uint16_t port = 0;
+    std::atomic<bool> stopping{false};
+    std::thread server;
+
+    static void send_all(int c, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t w = send(c, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (w <= 0) return;
+            sent += static_cast<size_t>(w);
+        }
+    }
+
+    void serve() {
+        while (!stopping) {
+            int c = accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (c < 0) continue;
+            std::string request;
+            char buf[1024];
+            ssize_t n;
+            while (request.find("\r\n\r\n") == std::string::npos && (n = read(c, buf, sizeof(buf))) > 0) {
+                request.append(buf, static_cast<size_t>(n));
+            }
+            size_t start = request.find(' ') + 1;
+            std::string path = request.substr(start, request.find(' ', start) - start);
+            auto it = pages.find(path);
+            std::string head = it != pages.end()
+                ? "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(it->second.size())
+                : std::string("HTTP/1.1 404 Not Found\r\nContent-Length: 0");
+            send_all(c, head + "\r\nConnection: close\r\n\r\n");
+            if (it != pages.end()) send_all(c, it->second);
+            close(c);
+        }
+    }
+};
+
+constexpr const char *SEARCH_PATH = "/json/stations/search?countrycode=DE&order=clickcount&reverse=true&limit=50000";
+
+} // namespace
+
+CAROS_BENCH("catalog/parse_50k") {
+    const Catalog& c = catalog();
+    return [&c] { bench::keep(CatalogParser::parse(c.json)); };
+}
+
+CAROS_BENCH("catalog/group_variants_50k") {
+    auto raw = std::make_shared<std::vector<CatalogEntry>>(CatalogParser::parse(catalog().json));
+    return [raw] { bench::keep(group_variants(*raw)); };
+}
+
+CAROS_BENCH("catalog/diff_noop_50k") {
+    const Catalog& c = catalog();
+    return [&c] { bench::keep(diff_catalog(c.local, c.entries, {}, &logo_present)); };
+}
+
+CAROS_BENCH("catalog/diff_1pct_50k") {
+    const Catalog& c = catalog();
+    auto changed = std::make_shared<std::vector<CatalogEntry>>(
+        group_variants(CatalogParser::parse(bench_data::catalog_json(CATALOG_SIZE, 1, 100))));
+    return [&c, changed] { bench::keep(diff_catalog(c.local, *changed, {}, &logo_present)); };
+}
+
+CAROS_BENCH("catalog/sync_noop_50k") {
+    // Kompletter Abgleich wie in perform_seeding, ohne Netzwerk und Logos
+    const Catalog& c = catalog();
+    return [&c] { bench::keep(diff_catalog(c.local, group_variants(CatalogParser::parse(c.json)), {}, &logo_present)); };
+}
+
+CAROS_BENCH("catalog/sync_http_noop_50k") {
+    // Wie perform_seeding: Seite über HTTP holen, parsen, gruppieren, abgleichen (ohne Logos)
+    const Catalog& c = catalog();
+    auto http = std::make_shared<LoopbackHttp>(std::map<std::string, std::string>{{SEARCH_PATH, c.json}});
+    return [&c, http] {
+        std::string body = http->get(SEARCH_PATH);
+        bench::keep(diff_catalog(c.local, group_variants(CatalogParser::parse(body)), {}, &logo_present));
+    };
+}
+
+CAROS_BENCH("catalog/sync_http_1pct_50k") {
+    const Catalog& c = catalog();
+    auto http = std::make_shared<LoopbackHttp>(
+        std::map<std::string, std::string>{{SEARCH_PATH, bench_data::catalog_json(CATALOG_SIZE, 1, 100)}});
+    return [&c, http] {
+        CatalogDiff diff = diff_catalog(c.local, group_variants(CatalogParser::parse(http->get(SEARCH_PATH))), {}, &logo_present);
+        bench::keep(diff);
+    };
+}
+
+CAROS_BENCH("store/store_50k") {
+    auto dir = std::make_shared<bench_data::TempDir>();
+    const Catalog& c = catalog();
+    return [&c, dir] { bench::keep(store_stations(c.local, dir->path + "/stations.csv")); };
+}
+
+CAROS_BENCH("store/load_50k") {
+    auto dir = std::make_shared<bench_data::TempDir>();
+    std::string path = dir->path + "/stations.csv";
+    store_stations(catalog().local, path);
+    return [dir, path] { bench::keep(load_stations(path)); };
+}
@@ -0,0 +1,112 @@
+#ifndef CAROS_BENCH_DATA_HPP
+#define CAROS_BENCH_DATA_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// Reproduzierbare Testdaten für Benchmarks und Tests (fester Seed, keine Netzwerkzugriffe).
+// make_catalog_json ersetzt die radio-browser-API: gleiche Felder, gleiche Struktur.
+namespace bench_data {
+
+// xorshift64*, damit alle Läufe auf allen Rechnern dieselben Daten sehen
+struct Rng {
+    uint64_t state;
+    explicit Rng(uint64_t seed = 0x9e3779b97f4a7c15ull) : state(seed) {}
+    uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ull;
+    }
+    double uniform(double lo, double hi) { return lo + (hi - lo) * (next() >> 11) * (1.0 / 9007199254740992.0); }
+    size_t below(size_t n) { return static_cast<size_t>(next() % n); }
+};
+
+inline const std::vector<std::string>& words() {
+    static const std::vector<std::string> list = {
+        "Radio", "Bayern", "Deutschlandfunk", "Antenne", "Klassik", "Jazz", "Rock", "Hits", "Welle", "Kultur",
+        "Nord", "Süd", "Berlin", "München", "Köln", "Hamburg", "Schlager", "Lounge", "News", "Info",
+        "Energy", "Sport", "Oldies", "Chillout", "Dance", "Metal", "Country", "Gospel", "Pop", "Blues"};
+    return list;
+}
+
+inline std::string station_name(Rng& rng) {
+    std::string name = words()[rng.below(words().size())];
+    int extra = 1 + static_cast<int>(rng.below(3));
+    for (int i = 0; i < extra; i++) name += " " + words()[rng.below(words().size())];
+    if (rng.below(4) == 0) name += " " + std::to_string(1 + rng.below(5));
+    return name;
+}
+
+inline std::vector<std::string> station_names(size_t n, uint64_t seed = 7) {
+    Rng rng(seed);
+    std::vector<std::string> out;
+    out.reserve(n);
+    for (size_t i = 0; i < n; i++) out.push_back(station_name(rng));
+    return out;
+}
+
+inline std::string uuid(uint64_t a, uint64_t b) {
+    char buf[40];
+    std::snprintf(buf, sizeof(buf), "%08llx-%04llx-%04llx-%04llx-%012llx", static_cast<unsigned long long>(a >> 32),
+                  static_cast<unsigned long long>((a >> 16) & 0xffff), static_cast<unsigned long long>(a & 0xffff),
+                  static_cast<unsigned long long>(b >> 48), static_cast<unsigned long long>(b & 0xffffffffffffull));
+    return buf;
+}
+
+// Katalog wie /json/stations/search. revision ändert die changeuuid jedes changed_every-ten
+// Eintrags (0 = keiner), so lassen sich "nichts geändert" und "1 % geändert" nachstellen.
+inline std::string catalog_json(size_t n, unsigned revision = 0, size_t changed_every = 0) {
+    Rng rng(42);
+    static const char *codecs[] = {"MP3", "AAC", "AAC+", "OGG"};
+    static const int bitrates[] = {64, 96, 128, 192, 320};
+    std::string out = "[";
+    out.reserve(n * 520);
+    for (size_t i = 0; i < n; i++) {
+        uint64_t id = rng.next();
+        std::string name = station_name(rng);
+        unsigned rev = (changed_every && i % changed_every == 0) ? revision : 0;
+        double lat = rng.uniform(-60, 70), lon = rng.uniform(-180, 180);
+        char geo[96];
+        std::snprintf(geo, sizeof(geo), "\"geo_lat\":%.6f,\"geo_long\":%.6f", lat, lon);
+        if (i) out += ",";
+        out += "{\"changeuuid\":\"" + uuid(id ^ rev, i) + "\",\"stationuuid\":\"" + uuid(id, i) + "\",";
+        out += "\"serveruuid\":null,\"name\":\"" + name + "\",";
+        out += "\"url\":\"http://stream" + std::to_string(i) + ".example.net/live\",";
+        out += "\"url_resolved\":\"https://stream" + std::to_string(i) + ".example.net/live.mp3\",";
+        out += "\"homepage\":\"https://www.sender" + std::to_string(i % (n / 2 + 1)) + ".example/\",";
+        out += "\"favicon\":\"https://www.sender" + std::to_string(i) + ".example/favicon.png\",";
+        out += "\"tags\":\"pop,rock,news\",\"country\":\"Germany\",\"countrycode\":\"DE\",\"state\":\"\",";
+        out += "\"language\":\"german\",\"languagecodes\":\"de\",\"votes\":" + std::to_string(rng.below(5000)) + ",";
+        out += "\"lastchangetime_iso8601\":\"2026-0" + std::to_string(1 + rng.below(9)) + "-1" +
+               std::to_string(rng.below(10)) + "T12:00:00Z\",";
+        out += "\"codec\":\"" + std::string(codecs[rng.below(4)]) + "\",\"bitrate\":" + std::to_string(bitrates[rng.below(5)]) + ",";
+        out += "\"hls\":0,\"lastcheckok\":1,\"clickcount\":" + std::to_string(rng.below(1000)) + ",";
+        out += geo;
+        out += ",\"has_extended_info\":false}";
+    }
+    out += "]";
+    return out;
+}
+
+// Temporäres Verzeichnis, das mit dem Objekt wieder verschwindet
+struct TempDir {
+    std::string path;
+    TempDir() {
+        char tmpl[] = "/tmp/caros-bench-XXXXXX";
+        if (mkdtemp(tmpl)) path = tmpl;
+    }
+    ~TempDir() {
+        if (!path.empty()) std::system(("rm -rf '" + path + "'").c_str());
+    }
+    TempDir(const TempDir&) = delete;
+    TempDir& operator=(const TempDir&) = delete;
+};
+
+} // namespace bench_data
+
+#endif
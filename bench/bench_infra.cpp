@@ -0,0 +1,219 @@
+// Infrastruktur: Metriken, Logging, Bluetooth-Geräteliste, Medienscan, IPC zum Audio-Daemon
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#include "audio_ipc.hpp"
+#include "bench.hpp"
+#include "bench_data.hpp"
+#include "bluetooth_device_model.hpp"
+#include "logger.hpp"
+#include "media_index.hpp"
+#include "metrics.hpp"
+
+namespace {
+
+// Gegenstelle für den IPC-Rundlauf: antwortet auf jeden Befehl sofort mit einem Ereignis,
+// wie der Daemon auf Play mit dem Status
+struct IpcEcho {
+    audio_ipc::Ring<64> commands;
+    audio_ipc::Ring<256> events;
+    int command_fd = eventfd(0, 0);
+    int event_fd = eventfd(0, 0);
+    std::atomic<bool> running{true};
+    std::thread peer;
+
+    IpcEcho() {
+        peer = std::thread([this] {
+            audio_ipc::Message m;
+            while (running.load(std::memory_order_relaxed)) {
+                audio_ipc::clear_wakeups(command_fd);
+                while (commands.pop(m)) {
+                    events.push(m);
+                    audio_ipc::wake(event_fd);
+                }
+            }
+        });
+    }
+
+    ~IpcEcho() {
+        running = false;
+        audio_ipc::wake(command_fd);
+        peer.join();
+        close(command_fd);
+        close(event_fd);
+    }
+
+    void round_trip(const audio_ipc::Message& m) {
+        audio_ipc::Message reply;
+        commands.push(m);
+        audio_ipc::wake(command_fd);
+        while (!events.pop(reply)) audio_ipc::clear_wakeups(event_fd);
+    }
+};
+
+// Musikordner mit MP3-Dateien (nur ID3v2-Kopf, Inhalt egal), 50 Dateien pro Album
+void make_media_tree(const std::string& root, size_t files) {
+    for (size_t i = 0; i < files; i++) {
+        std::string dir = root + "/Interpret " + std::to_string(i / 500) + "/Album " + std::to_string(i / 50);
+        if (i % 50 == 0) std::system(("mkdir -p '" + dir + "'").c_str());
+        std::ofstream out(dir + "/Titel " + std::to_string(i) + ".mp3", std::ios::binary);
+        std::string title = "Titel " + std::to_string(i);
+        std::string frame = "TIT2" + std::string("\0\0\0", 3) + char(title.size() + 1) + std::string("\0\0\0", 3) + title;
+        out << "ID3" << char(3) << char(0) << char(0) << std::string("\0\0\0", 3) << char(frame.size()) << frame;
+        out << std::string(2048, '\0');
+    }
+}
+
+// Logger einmalig auf eine Datei im Temp-Verzeichnis starten, ohne Kopie auf stderr und ohne
+// Drosselung: gemessen wird jede Zeile bis in die Datei, nicht der Verwerfen-Pfad
+const std::string& bench_log_dir() {
+    static bench_data::TempDir dir;
+    static bool started = [] {
+        setenv("CAROS_LOG_FILE", (dir.path + "/caros.log").c_str(), 1);
+        setenv("CAROS_LOG_ECHO", "0", 1);
+        Logger::instance().set_rate_limit(0);
+        Logger::instance().start();
+        return true;
+    }();
+    (void) started;
+    return dir.path;
+}
+
+off_t file_size(const std::string& path) {
+    struct stat st{};
+    return stat(path.c_str(), &st) == 0 ? st.st_size : 0;
+}
+
+constexpr int LOG_LINES = 256;
+
+size_t media_files() {
+    const char *env = getenv("CAROS_BENCH_MEDIA_FILES");
+    return env ? std::strtoul(env, nullptr, 10) : 50000;
+}
+
+} // namespace
+
+CAROS_BENCH("infra/metrics_counter_inc") {
+    Counter& c = MetricsRegistry::instance().counter("caros_bench_counter_total", "Benchmark");
+    return [&c] { c.inc(); };
+}
+
+CAROS_BENCH("infra/metrics_histogram_record") {
+    Histogram& h = MetricsRegistry::instance().histogram("caros_bench_histogram", "Benchmark");
+    auto v = std::make_shared<uint64_t>(1);
+    return [&h, v] { h.record(*v = *v * 33 % 100003); };
+}
+
+// Aufrufer-Seite von LOG_INFO: ein Datensatz in den Ring des Threads. Ein Stapel passt in den
+// Ring, danach leert flush() ihn außerhalb der Messung, damit nie der Verwerfen-Pfad läuft.
+CAROS_BENCH("infra/log_info_caller") {
+    bench_log_dir();
+    bench::hooks().max_batch = LogRing::CAPACITY;
+    bench::hooks().between = [] { Logger::instance().flush(); };
+    auto n = std::make_shared<int>(0);
+    return [n] { LOG_INFO("Bench", "Puffer {}% für {}", ++*n % 100, "http://stream.example.net/live.mp3"); };
+}
+
+// Gesamtkosten für 256 Zeilen einschließlich Formatieren und Schreiben im selben Thread
+// (flush() statt Formatter-Thread), jede Zeile landet in der Datei
+CAROS_BENCH("infra/log_async_256_lines") {
+    bench_log_dir();
+    return [] {
+        for (int i = 0; i < LOG_LINES; i++) LOG_INFO("Bench", "Puffer {}% für {}", i % 100, "http://stream.example.net/live.mp3");
+        Logger::instance().flush();
+    };
+}
+
+// Zum Vergleich der frühere Stil: iostream mit std::endl, also ein flush pro Zeile. Dieselbe
+// Zeile wie der Logger (Zeitstempel, Level, Tag), damit beide gleich viele Bytes schreiben.
+CAROS_BENCH("infra/iostream_endl_256_lines") {
+    std::string path = bench_log_dir() + "/iostream.log";
+    auto out = std::make_shared<std::ofstream>(path);
+    auto lines = [out] {
+        for (int i = 0; i < LOG_LINES; i++) {
+            timeval tv;
+            gettimeofday(&tv, nullptr);
+            tm local{};
+            localtime_r(&tv.tv_sec, &local);
+            char when[32];
+            strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &local);
+            char millis[8];
+            snprintf(millis, sizeof(millis), ".%03d", static_cast<int>(tv.tv_usec / 1000));
+            *out << when << millis << " I [Bench] Puffer " << i % 100 << "% für " << "http://stream.example.net/live.mp3" << std::endl;
+        }
+    };
+
+    // Gleiche Arbeit prüfen: ein Durchgang beider Varianten, Zuwachs der Dateien vergleichen
+    std::string log = bench_log_dir() + "/caros.log";
+    Logger::instance().flush();
+    off_t before = file_size(log);
+    for (int i = 0; i < LOG_LINES; i++) LOG_INFO("Bench", "Puffer {}% für {}", i % 100, "http://stream.example.net/live.mp3");
+    Logger::instance().flush();
+    off_t logger_bytes = file_size(log) - before;
+    lines();
+    off_t iostream_bytes = file_size(path);
+    if (logger_bytes != iostream_bytes) {
+        std::fprintf(stderr, "infra/iostream_endl_256_lines: %lld Bytes gegenüber %lld beim Logger\n",
+                     static_cast<long long>(iostream_bytes), static_cast<long long>(logger_bytes));
+    }
+
+    return [out, lines] {
+        lines();
+        out->seekp(0); // Datei nicht über den ganzen Lauf wachsen lassen
+    };
+}
+
+CAROS_BENCH("infra/bluetooth_discovery_storm") {
+    // 200 Geräte, je 20 RSSI-Updates, einmal pro Frame abgeholt
+    return [] {
+        BluetoothDeviceModel model;
+        for (int round = 0; round < 20; round++) {
+            for (int d = 0; d < 200; d++) {
+                BluetoothDeviceDelta delta;
+                char addr[18];
+                std::snprintf(addr, sizeof(addr), "00:11:22:33:%02X:%02X", d >> 8, d & 0xff);
+                if (round == 0) {
+                    delta.address = std::string(addr);
+                    delta.name = std::string("Gerät ") + std::to_string(d);
+                }
+                delta.rssi = static_cast<int16_t>(-40 - (round + d) % 50);
+                model.apply("/org/bluez/hci0/dev_" + std::to_string(d), delta, round * 100000);
+            }
+            bench::keep(model.take_changes());
+        }
+    };
+}
+
+CAROS_BENCH("infra/ipc_round_trip") {
+    auto echo = std::make_shared<IpcEcho>();
+    audio_ipc::Message m = audio_ipc::make_message(1, 0, 0.5, "http://stream.example.net/live.mp3");
+    return [echo, m] { echo->round_trip(m); };
+}
+
+// Erster Scan ohne Index: alle Tags werden gelesen. Der Seitencache ist dabei warm (der Baum
+// wurde eben erzeugt), gemessen wird also Verzeichnislauf und Tag-Parsing, nicht USB-Lesen.
+CAROS_BENCH("media/scan_no_index") {
+    auto dir = std::make_shared<bench_data::TempDir>();
+    make_media_tree(dir->path, media_files());
+    return [dir] {
+        MediaIndex empty;
+        bench::keep(MediaScanner::scan(dir->path, empty).stats.files);
+    };
+}
+
+CAROS_BENCH("media/scan_warm") {
+    // Zweiter Scan mit dem Index des ersten: nur stat, keine Tags
+    auto dir = std::make_shared<bench_data::TempDir>();
+    make_media_tree(dir->path, media_files());
+    auto index = std::make_shared<MediaIndex>();
+    index->assign(MediaScanner::scan(dir->path, MediaIndex()).tracks);
+    return [dir, index] { bench::keep(MediaScanner::scan(dir->path, *index).stats.reused); };
+}
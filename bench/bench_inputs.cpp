@@ -0,0 +1,88 @@
+// Eingabepfade: Drehgeber, GPS-Meldungen, Stream-Titel, Variantenwahl, Trace-Zeilen
+
+#include <memory>
+
+#include "bench.hpp"
+#include "bench_data.hpp"
+#include "encoder_decoder.hpp"
+#include "gps_fix.hpp"
+#include "input_trace.hpp"
+#include "stream_metadata.hpp"
+#include "stream_variants.hpp"
+
+namespace {
+
+constexpr size_t EDGES = 4096;
+
+// Flanken eines schnell gedrehten Gebers mit gelegentlichem Prellen
+std::vector<EncoderEdge> encoder_edges() {
+    bench_data::Rng rng(3);
+    std::vector<EncoderEdge> edges;
+    uint64_t t = 0;
+    for (size_t i = 0; i < EDGES; i++) {
+        t += rng.below(8) == 0 ? 300000 : 6000000 + rng.below(4000000);
+        edges.push_back({static_cast<unsigned>(rng.below(3) == 0 ? 17 : 27), t, rng.below(2) == 0});
+    }
+    return edges;
+}
+
+} // namespace
+
+CAROS_BENCH("inputs/encoder_4096_edges") {
+    auto edges = std::make_shared<std::vector<EncoderEdge>>(encoder_edges());
+    return [edges] {
+        EncoderDecoder decoder(27, 1000000);
+        int position = 0;
+        bool clockwise = false;
+        for (const auto& e : *edges) {
+            if (decoder.feed(e, clockwise)) position += clockwise ? 1 : -1;
+        }
+        bench::keep(position);
+    };
+}
+
+CAROS_BENCH("inputs/gps_report") {
+    auto i = std::make_shared<int>(0);
+    return [i] {
+        GpsReport r;
+        r.mode = 3;
+        r.latitude = 48.137 + (*i & 255) * 1e-5;
+        r.longitude = 11.575;
+        r.speed_ms = 13.9;
+        r.satellites_used = 9;
+        ++*i;
+        bench::keep(gps_data_from_report(r));
+    };
+}
+
+CAROS_BENCH("inputs/stream_title") {
+    return [] { bench::keep(format_stream_title("  Die Ärzte ", "Westerland\n")); };
+}
+
+CAROS_BENCH("inputs/variant_buffering_poll") {
+    auto selector = std::make_shared<VariantSelector>();
+    auto now = std::make_shared<int64_t>(0);
+    selector->start({{"MP3", 64, "http://a/64"}, {"MP3", 128, "http://a/128"}, {"AAC", 256, "http://a/256"}}, 0);
+    return [selector, now] {
+        *now += 100000;
+        selector->on_buffering(100, 180.0 + (*now / 100000 % 50), *now);
+        bench::keep(selector->poll(false, *now));
+    };
+}
+
+CAROS_BENCH("inputs/trace_format_parse") {
+    // Eine Zeile pro Quelle, wie sie beim Aufnehmen bzw. Laden einer Trace-Datei anfällt
+    auto lines = std::make_shared<std::vector<InputEvent>>(4);
+    (*lines)[0].encoder = {27, 123456789, true};
+    (*lines)[1].source = InputSource::Gps;
+    (*lines)[1].gps = GpsReport{3, 48.137154, 11.575382, 13.9, 9};
+    (*lines)[2].source = InputSource::Bluetooth;
+    (*lines)[2].bt_path = "/org/bluez/hci0/dev_00_11_22_33_44_55";
+    (*lines)[2].bt.rssi = static_cast<int16_t>(-60);
+    (*lines)[3].source = InputSource::Stream;
+    (*lines)[3].stream.text = "Interpret - Titel";
+    return [lines] {
+        InputEvent back;
+        for (const auto& e : *lines) bench::keep(parse_input_event(format_input_event(e), back));
+    };
+}
@@ -0,0 +1,158 @@
+// Runner für bin/caros-bench
+//
+//   caros-bench [--filter TEXT] [--list] [--json DATEI] [--compare DATEI] [--threshold PROZENT]
+//               [--samples N] [--warmup-ms N] [--min-sample-us N] [--max-time-ms N]
+//
+// --json schreibt die Ergebnisse für die Regressionsverfolgung, --compare vergleicht den
+// Median mit einer früheren JSON-Datei und endet mit Code 2, wenn ein Benchmark um mehr als
+// --threshold Prozent (Default 10) langsamer geworden ist.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "bench.hpp"
+
+namespace {
+
+std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+bool write_json(const std::string& path, const std::vector<bench::Result>& results) {
+    FILE *f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    char host[128] = "?";
+    gethostname(host, sizeof(host) - 1);
+    std::fprintf(f, "{\n  \"timestamp\": %lld,\n  \"host\": \"%s\",\n  \"compiler\": \"%s\",\n  \"unit\": \"ns\",\n  \"benchmarks\": [\n",
+                 static_cast<long long>(std::time(nullptr)), json_escape(host).c_str(), json_escape(__VERSION__).c_str());
+    for (size_t i = 0; i < results.size(); i++) {
+        const bench::Stats& s = results[i].stats;
+        std::fprintf(f,
+                     "    {\"name\": \"%s\", \"samples\": %zu, \"batch\": %llu, \"min\": %.1f, \"p50\": %.1f, "
+                     "\"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f, \"mean\": %.1f, \"stddev\": %.1f}%s\n",
+                     json_escape(results[i].name).c_str(), s.samples, static_cast<unsigned long long>(s.batch), s.min_ns,
+                     s.p50_ns, s.p90_ns, s.p99_ns, s.max_ns, s.mean_ns, s.stddev_ns, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    return std::fclose(f) == 0;
+}
+
+// Liest name -> p50 aus einer von write_json erzeugten Datei (eine Zeile pro Benchmark)
+std::map<std::string, double> read_baseline(const std::string& path) {
+    std::map<std::string, double> out;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t n = line.find("\"name\": \"");
+        size_t p = line.find("\"p50\": ");
+        if (n == std::string::npos || p == std::string::npos) continue;
+        n += 9;
+        size_t end = line.find('"', n);
+        out[line.substr(n, end - n)] = std::atof(line.c_str() + p + 7);
+    }
+    return out;
+}
+
+std::string human(double ns) {
+    char buf[32];
+    if (ns < 1e3) std::snprintf(buf, sizeof(buf), "%.1f ns", ns);
+    else if (ns < 1e6) std::snprintf(buf, sizeof(buf), "%.2f us", ns / 1e3);
+    else if (ns < 1e9) std::snprintf(buf, sizeof(buf), "%.2f ms", ns / 1e6);
+    else std::snprintf(buf, sizeof(buf), "%.2f s", ns / 1e9);
+    return buf;
+}
+
+void usage() {
+    std::fprintf(stderr, "Aufruf: caros-bench [--filter TEXT] [--list] [--json DATEI] [--compare DATEI] [--threshold PROZENT]\n"
+                         "                    [--samples N] [--warmup-ms N] [--min-sample-us N] [--max-time-ms N]\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    bench::Options opt;
+    std::string filter, json_path, compare_path;
+    double threshold = 10.0;
+    bool list = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                usage();
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--filter") filter = value();
+        else if (arg == "--list") list = true;
+        else if (arg == "--json") json_path = value();
+        else if (arg == "--compare") compare_path = value();
+        else if (arg == "--threshold") threshold = std::atof(value());
+        else if (arg == "--samples") opt.samples = std::atoi(value());
+        else if (arg == "--warmup-ms") opt.warmup_ms = std::atoi(value());
+        else if (arg == "--min-sample-us") opt.min_sample_us = std::atoi(value());
+        else if (arg == "--max-time-ms") opt.max_time_ms = std::atoi(value());
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    std::vector<bench::Entry> entries = bench::registry();
+    std::sort(entries.begin(), entries.end(), [](const bench::Entry& a, const bench::Entry& b) { return a.name < b.name; });
+
+    std::vector<bench::Result> results;
+    std::printf("%-36s %12s %12s %12s %12s %8s\n", "Benchmark", "p50", "p90", "p99", "stddev", "Proben");
+    for (const auto& e : entries) {
+        if (!filter.empty() && e.name.find(filter) == std::string::npos) continue;
+        if (list) {
+            std::printf("%s\n", e.name.c_str());
+            continue;
+        }
+        bench::hooks() = {};
+        bench::Op op = e.setup();
+        bench::Stats s = bench::measure(op, opt);
+        results.push_back({e.name, s});
+        std::printf("%-36s %12s %12s %12s %12s %8zu\n", e.name.c_str(), human(s.p50_ns).c_str(), human(s.p90_ns).c_str(),
+                    human(s.p99_ns).c_str(), human(s.stddev_ns).c_str(), s.samples);
+        std::fflush(stdout);
+    }
+
+    if (!json_path.empty() && !write_json(json_path, results)) {
+        std::fprintf(stderr, "%s konnte nicht geschrieben werden\n", json_path.c_str());
+        return 1;
+    }
+
+    int status = 0;
+    if (!compare_path.empty()) {
+        std::map<std::string, double> baseline = read_baseline(compare_path);
+        if (baseline.empty()) {
+            std::fprintf(stderr, "Keine Vergleichswerte in %s\n", compare_path.c_str());
+            return 1;
+        }
+        std::printf("\nVergleich mit %s (Median, Schwelle %.0f%%):\n", compare_path.c_str(), threshold);
+        for (const auto& r : results) {
+            auto it = baseline.find(r.name);
+            if (it == baseline.end() || it->second <= 0) continue;
+            double change = (r.stats.p50_ns / it->second - 1.0) * 100.0;
+            bool regressed = change > threshold;
+            if (regressed) status = 2;
+            std::printf("  %-36s %+7.1f%%%s\n", r.name.c_str(), change, regressed ? "  LANGSAMER" : "");
+        }
+    }
+    return status;
+}
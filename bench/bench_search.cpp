@@ -0,0 +1,87 @@
+// Sendersuche: Umkreis (Geo-Gitter), Volltext mit Tippfehlern, Vervollständigung
+
+#include <memory>
+
+#include "bench.hpp"
+#include "bench_data.hpp"
+#include "station_completion.hpp"
+#include "station_geo_index.hpp"
+#include "station_search.hpp"
+
+namespace {
+
+constexpr size_t STATIONS = 50000;
+
+const std::vector<std::string>& names() {
+    static const std::vector<std::string> list = bench_data::station_names(STATIONS);
+    return list;
+}
+
+} // namespace
+
+CAROS_BENCH("search/geo_build_50k") {
+    auto entries = std::make_shared<std::vector<GeoEntry>>();
+    bench_data::Rng rng(11);
+    for (size_t i = 0; i < STATIONS; i++) entries->push_back({i, rng.uniform(-60, 70), rng.uniform(-180, 180)});
+    return [entries] {
+        StationGeoIndex index;
+        index.build(*entries);
+        bench::keep(index.size());
+    };
+}
+
+CAROS_BENCH("search/geo_query_50k") {
+    // Dicht wie in Mitteleuropa: die Hälfte der Sender in einem 10x15-Grad-Fenster
+    auto index = std::make_shared<StationGeoIndex>();
+    std::vector<GeoEntry> entries;
+    bench_data::Rng rng(11);
+    for (size_t i = 0; i < STATIONS; i++) {
+        bool europe = i % 2 == 0;
+        entries.push_back({i, europe ? rng.uniform(45, 55) : rng.uniform(-60, 70),
+                           europe ? rng.uniform(0, 15) : rng.uniform(-180, 180)});
+    }
+    index->build(std::move(entries));
+    auto i = std::make_shared<int>(0);
+    return [index, i] {
+        double step = (++*i & 1023) * 0.005;
+        bench::keep(index->query(48.1 + step, 11.5 + step, 20, 150.0));
+    };
+}
+
+CAROS_BENCH("search/fulltext_build_50k") {
+    return [] {
+        StationSearchIndex index;
+        index.build(names());
+        bench::keep(index.size());
+    };
+}
+
+CAROS_BENCH("search/fulltext_typing_50k") {
+    // Ein Suchbegriff Taste für Taste eingetippt, inkl. Tippfehler ("Deutschlanfunk")
+    auto index = std::make_shared<StationSearchIndex>();
+    index->build(names());
+    return [index] {
+        static const char *word = "deutschlanfunk kultur";
+        SearchSession session;
+        std::string query;
+        for (const char *p = word; *p; p++) {
+            query += *p;
+            bench::keep(index->search(query, session, 50));
+        }
+    };
+}
+
+CAROS_BENCH("search/fulltext_fresh_query_50k") {
+    auto index = std::make_shared<StationSearchIndex>();
+    index->build(names());
+    return [index] {
+        SearchSession session;
+        bench::keep(index->search("bayren klasik", session, 50));
+    };
+}
+
+CAROS_BENCH("search/completion_50k") {
+    auto index = std::make_shared<StationCompletionIndex>();
+    index->build(names());
+    return [index] { bench::keep(index->complete("bay", 8)); };
+}
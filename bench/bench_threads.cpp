@@ -0,0 +1,165 @@
+// Thread-Policy unter Last: gleiche Last einmal ohne und einmal mit assets/thread_policy.csv.
+// Eine simulierte Audio-Ausgabe (5-ms-Periode, 10 ms Puffer) zählt Unterläufe, der Drehgeber-
+// Thread misst seine Aufweck-Latenz. Dazu so viele rechnende "ui"-Threads wie CPUs plus zwei.
+// Die Vorbereitung fährt CAROS_BENCH_STRESS_MS lang (Default 3000) alle 10 ms ein Drehgeber-
+// Ereignis; daraus stammt die Zeile unter dem Ergebnis (Unterläufe, Latenz pro Ereignis).
+// Gemessen wird danach der Rundlauf eines Ereignisses unter derselben Last.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "bench.hpp"
+#include "thread_registry.hpp"
+
+namespace {
+
+constexpr int64_t PERIOD_NS = 5000000;
+constexpr int64_t SLACK_NS = 10000000;
+constexpr int64_t WORK_NS = 500000;     // Mischen/Filtern pro Periode
+constexpr int64_t EDGE_INTERVAL_NS = 10000000;
+constexpr size_t MAX_EDGES = 1 << 20;
+
+int64_t now_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void spin_for(int64_t ns) {
+    int64_t end = now_ns() + ns;
+    while (now_ns() < end) {}
+}
+
+class StressLoad {
+public:
+    StressLoad(const char *label, const std::string& policy) : label(label) {
+        policy_loaded = ThreadRegistry::instance().load_policy(policy);
+        latencies_us.reserve(MAX_EDGES);
+
+        unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < cpus + 2; i++) {
+            threads.push_back(ThreadRegistry::spawn("bench-ui-" + std::to_string(i), "ui", [this] {
+                while (running.load(std::memory_order_relaxed)) spin_for(100000);
+            }));
+        }
+        threads.push_back(ThreadRegistry::spawn("bench-audio", "audio", [this] { audio_loop(); }));
+        threads.push_back(ThreadRegistry::spawn("bench-encoder", "encoder", [this] { encoder_loop(); }));
+    }
+
+    // Last für duration_ms halten, alle 10 ms ein Ereignis; nur dieser Abschnitt wird ausgewertet
+    void run_window(int64_t duration_ms) {
+        recording = true;
+        int64_t end = now_ns() + duration_ms * 1000000;
+        for (int64_t next = now_ns(); next < end; next += EDGE_INTERVAL_NS) {
+            timespec ts{static_cast<time_t>(next / 1000000000LL), static_cast<long>(next % 1000000000LL)};
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+            edge();
+        }
+        recording = false;
+    }
+
+    ~StressLoad() {
+        running = false;
+        uint64_t one = 1;
+        (void) !write(edge_fd, &one, sizeof(one));
+        for (auto& t : threads) t.join();
+
+        bool applied = policy_loaded;
+        for (const ThreadInfo& t : ThreadRegistry::instance().threads()) applied = applied && t.applied;
+        std::sort(latencies_us.begin(), latencies_us.end());
+        std::printf("    %s: %llu/%llu Perioden unterlaufen, Drehgeber p50 %.0f us, p99 %.0f us, max %.0f us%s\n",
+                    label, (unsigned long long)underruns.load(), (unsigned long long)periods.load(),
+                    bench::percentile(latencies_us, 50), bench::percentile(latencies_us, 99),
+                    latencies_us.empty() ? 0.0 : latencies_us.back(),
+                    applied ? "" : " (Policy nicht vollständig übernommen, siehe stderr)");
+        ThreadRegistry::instance().load_policy("");
+        close(edge_fd);
+        close(ack_fd);
+    }
+
+    StressLoad(const StressLoad&) = delete;
+    StressLoad& operator=(const StressLoad&) = delete;
+
+    // Ein Drehgeber-Ereignis auslösen und auf die Bestätigung warten
+    void edge() {
+        sent_ns.store(now_ns(), std::memory_order_release);
+        uint64_t one = 1;
+        (void) !write(edge_fd, &one, sizeof(one));
+        uint64_t value;
+        (void) !read(ack_fd, &value, sizeof(value));
+    }
+
+private:
+    const char *label;
+    bool policy_loaded = false;
+    std::atomic<bool> running{true};
+    std::atomic<bool> recording{false};
+    std::vector<std::thread> threads;
+    int edge_fd = eventfd(0, 0);
+    int ack_fd = eventfd(0, 0);
+    std::atomic<int64_t> sent_ns{0};
+    std::vector<double> latencies_us;   // nur der Drehgeber-Thread schreibt bis zum join
+    std::atomic<uint64_t> periods{0};
+    std::atomic<uint64_t> underruns{0};
+
+    void audio_loop() {
+        int64_t deadline = now_ns() + PERIOD_NS;
+        while (running.load(std::memory_order_relaxed)) {
+            timespec ts{static_cast<time_t>(deadline / 1000000000LL), static_cast<long>(deadline % 1000000000LL)};
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+            spin_for(WORK_NS);
+            // Fertig erst nach Ablauf des Puffers: die Soundkarte hätte Stille gespielt
+            bool underrun = now_ns() - deadline > SLACK_NS;
+            if (recording.load(std::memory_order_relaxed)) {
+                periods.fetch_add(1, std::memory_order_relaxed);
+                if (underrun) underruns.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (underrun) deadline = now_ns(); // wie ein ALSA-Restart: Takt neu aufsetzen
+            deadline += PERIOD_NS;
+        }
+    }
+
+    void encoder_loop() {
+        uint64_t value;
+        while (read(edge_fd, &value, sizeof(value)) == sizeof(value) && running.load(std::memory_order_relaxed)) {
+            int64_t latency = now_ns() - sent_ns.load(std::memory_order_acquire);
+            if (recording.load(std::memory_order_relaxed) && latencies_us.size() < MAX_EDGES) {
+                latencies_us.push_back(latency / 1000.0);
+            }
+            uint64_t one = 1;
+            (void) !write(ack_fd, &one, sizeof(one));
+        }
+    }
+};
+
+int64_t stress_ms() {
+    const char *env = getenv("CAROS_BENCH_STRESS_MS");
+    return env ? std::strtoll(env, nullptr, 10) : 3000;
+}
+
+std::string policy_path() {
+    const char *env = getenv("CAROS_THREAD_POLICY");
+    return env && std::string(env) != "0" ? env : "assets/thread_policy.csv";
+}
+
+} // namespace
+
+CAROS_BENCH("threads/stress_policy_off") {
+    auto load = std::make_shared<StressLoad>("ohne Policy", "");
+    load->run_window(stress_ms());
+    return [load] { load->edge(); };
+}
+
+CAROS_BENCH("threads/stress_policy_on") {
+    auto load = std::make_shared<StressLoad>("mit Policy", policy_path());
+    load->run_window(stress_ms());
+    return [load] { load->edge(); };
+}
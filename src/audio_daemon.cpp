@@ -0,0 +1,215 @@
+// caros-audiod: Wiedergabe in einem eigenen Prozess.
+// Hängt oder stürzt die Oberfläche ab, läuft das Radio weiter; eine neu gestartete
+// Oberfläche verbindet sich wieder und bekommt den aktuellen Stand.
+#include <gst/gst.h>
+#include <glib-unix.h>
+#include <csignal>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "audio_engine.hpp"
+#include "audio_ipc.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+#include "metrics_server.hpp"
+#include "thread_registry.hpp"
+
+using audio_ipc::Command;
+using audio_ipc::Event;
+
+class AudioDaemon {
+public:
+    static constexpr guint LEVELS_INTERVAL_MS = 16;
+    static constexpr int LOCK_WAIT_MS = 1000; // Vorgänger, den die Oberfläche gerade beendet
+
+    bool start(const std::string& socket_path) {
+        // Ein zweiter Daemon darf einem laufenden den Socket nicht wegnehmen
+        lock_fd = audio_ipc::lock_socket(socket_path, LOCK_WAIT_MS);
+        if (lock_fd < 0) {
+            LOG_ERROR("AudioDaemon", "Auf {} läuft bereits ein Audio-Daemon, beende", socket_path);
+            return false;
+        }
+        if (!endpoint.create()) {
+            LOG_ERROR("AudioDaemon", "Gemeinsamer Speicher/eventfd fehlgeschlagen: {}", strerror(errno));
+            return false;
+        }
+        endpoint.shared->status.daemon_pid.store(getpid(), std::memory_order_relaxed);
+        publish_status();
+
+        listen_fd = audio_ipc::listen_socket(socket_path);
+        if (listen_fd < 0) {
+            LOG_ERROR("AudioDaemon", "Socket {} nicht verfügbar: {}", socket_path, strerror(errno));
+            return false;
+        }
+
+        g_unix_fd_add(listen_fd, G_IO_IN, [](gint, GIOCondition, gpointer data) -> gboolean {
+            static_cast<AudioDaemon*>(data)->accept_client();
+            return G_SOURCE_CONTINUE;
+        }, this);
+        g_unix_fd_add(endpoint.command_fd, G_IO_IN, [](gint, GIOCondition, gpointer data) -> gboolean {
+            static_cast<AudioDaemon*>(data)->drain_commands();
+            return G_SOURCE_CONTINUE;
+        }, this);
+
+        engine.on_title = [this](const std::string& text) {
+            last_title = text;
+            post(Event::Title, 0, 0.0, text);
+        };
+        engine.on_buffering = [this](int percent, double kbps) { post(Event::Buffering, percent, kbps); };
+        engine.on_error = [this](const std::string& text) { post(Event::Error, 0, 0.0, text); };
+
+        LOG_INFO("AudioDaemon", "Bereit auf {}", socket_path);
+        return true;
+    }
+
+private:
+    AudioEngine engine;
+    audio_ipc::Endpoint endpoint;
+    int listen_fd = -1;
+    int lock_fd = -1;
+    guint levels_id = 0;
+    std::string last_title;
+    std::vector<std::string> queue;
+
+    // Neue Oberfläche: neue Sitzung, Kanal übergeben und den aktuellen Stand nachschicken.
+    // Meldungen und Befehle der vorigen Sitzung, die noch in den Ringen liegen, verfallen.
+    void accept_client() {
+        int client = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) return;
+        endpoint.shared->status.session.fetch_add(1, std::memory_order_release);
+        bool ok = audio_ipc::send_fds(client, endpoint);
+        close(client);
+        LOG_INFO("AudioDaemon", "Oberfläche verbunden{}", ok ? "" : " (Übergabe fehlgeschlagen)");
+        set_spectrum(false); // die neue Oberfläche meldet sich, sobald der Visualizer sichtbar ist
+        publish_status();
+        if (!last_title.empty()) post(Event::Title, 0, 0.0, last_title);
+    }
+
+    void post(Event type, int32_t arg = 0, double value = 0.0, const std::string& text = "") {
+        static Counter& dropped = MetricsRegistry::instance().counter("caros_audio_ipc_events_dropped_total", "Verworfene Meldungen an die Oberfläche (Ring voll)");
+        uint32_t session = endpoint.shared->status.session.load(std::memory_order_relaxed);
+        if (!endpoint.shared->events.push(audio_ipc::make_message(static_cast<uint32_t>(type), arg, value, text, session))) {
+            dropped.inc(); // keine Oberfläche verbunden oder sie hängt
+            return;
+        }
+        audio_ipc::wake(endpoint.event_fd);
+    }
+
+    void publish_status() {
+        audio_ipc::Status& st = endpoint.shared->status;
+        for (int b = 0; b < audio_ipc::EQ_BANDS && b < AudioEqualizer::BANDS; b++) {
+            st.eq_gain[b].store(engine.filter().equalizer().gain(b), std::memory_order_relaxed);
+        }
+        st.buffer_bytes.store(static_cast<uint32_t>(engine.buffer_bytes()), std::memory_order_relaxed);
+    }
+
+    void drain_commands() {
+        static Counter& commands = MetricsRegistry::instance().counter("caros_audio_ipc_commands_total", "Befehle von der Oberfläche");
+        static Counter& stale = MetricsRegistry::instance().counter("caros_audio_ipc_stale_commands_total", "Verworfene Befehle aus einer früheren Sitzung");
+        audio_ipc::clear_wakeups(endpoint.command_fd);
+        audio_ipc::Message m;
+        while (endpoint.shared->commands.pop(m)) {
+            if (m.session != endpoint.shared->status.session.load(std::memory_order_relaxed)) {
+                stale.inc();
+                continue;
+            }
+            commands.inc();
+            std::string text(m.text, m.text_len);
+            switch (static_cast<Command>(m.type)) {
+                case Command::Ping:
+                    post(Event::Pong, m.arg, m.value);
+                    break;
+                case Command::PlayUri: {
+                    std::string uri, station;
+                    audio_ipc::split_play_text(text, uri, station);
+                    last_title.clear();
+                    engine.set_source(uri, station);
+                    break;
+                }
+                case Command::SetVolume:
+                    engine.set_volume(m.value);
+                    break;
+                case Command::SetLowMemory:
+                    engine.set_low_memory(m.arg != 0);
+                    publish_status();
+                    break;
+                case Command::SetEqGain:
+                    engine.filter().equalizer().set_gain(m.arg, static_cast<float>(m.value));
+                    publish_status();
+                    break;
+                case Command::SaveEq:
+                    engine.filter().save_settings();
+                    break;
+                case Command::SetSpectrum:
+                    set_spectrum(m.arg != 0);
+                    break;
+                case Command::SetSpectrumRate:
+                    engine.spectrum().set_rate_hz(m.arg);
+                    break;
+                case Command::QueueClear:
+                    queue.clear();
+                    break;
+                case Command::QueueAdd:
+                    queue.push_back(text);
+                    break;
+                case Command::QueuePlay:
+                    last_title.clear();
+                    engine.play_queue(std::move(queue));
+                    queue.clear();
+                    break;
+            }
+        }
+    }
+
+    // Pegel nur rechnen und veröffentlichen, solange die Oberfläche den Visualizer zeigt
+    void set_spectrum(bool active) {
+        engine.spectrum().set_active(active);
+        if (active && !levels_id) {
+            levels_id = g_timeout_add(LEVELS_INTERVAL_MS, [](gpointer data) -> gboolean {
+                auto *self = static_cast<AudioDaemon*>(data);
+                SpectrumFrame frame;
+                if (self->engine.spectrum().poll(frame)) audio_ipc::write_levels(self->endpoint.shared->levels, frame.level.data());
+                return G_SOURCE_CONTINUE;
+            }, this);
+        } else if (!active && levels_id) {
+            g_source_remove(levels_id);
+            levels_id = 0;
+        }
+    }
+};
+
+int main(int argc, char **argv) {
+    // Eigene Log-Datei, auch wenn die Oberfläche beim Starten CAROS_LOG_FILE vererbt
+    const char *log_file = g_getenv("CAROS_AUDIO_LOG_FILE");
+    setenv("CAROS_LOG_FILE", log_file ? log_file : "caros-audiod.log", 1);
+    ThreadRegistry::instance().register_current("", "control");
+    Logger::instance().start();
+    gst_init(&argc, &argv);
+    signal(SIGPIPE, SIG_IGN);
+
+    const char *metrics_socket = g_getenv("CAROS_AUDIO_METRICS_SOCKET");
+    MetricsServer::serve(metrics_socket ? metrics_socket : "/tmp/caros-audiod-metrics.sock");
+
+    const char *socket_path = g_getenv("CAROS_AUDIO_SOCKET");
+    AudioDaemon *audiod = new AudioDaemon();
+    if (!audiod->start(socket_path ? socket_path : audio_ipc::default_socket_path())) {
+        Logger::instance().flush();
+        return 1;
+    }
+
+    GMainLoop *loop = g_main_loop_new(nullptr, FALSE);
+    auto quit = [](gpointer data) -> gboolean {
+        g_main_loop_quit(static_cast<GMainLoop*>(data));
+        return G_SOURCE_REMOVE;
+    };
+    g_unix_signal_add(SIGTERM, quit, loop);
+    g_unix_signal_add(SIGINT, quit, loop);
+    g_main_loop_run(loop);
+
+    LOG_INFO("AudioDaemon", "Beendet");
+    Logger::instance().flush();
+    return 0;
+}
@@ -0,0 +1,251 @@
+#ifndef AUDIO_ENGINE_HPP
+#define AUDIO_ENGINE_HPP
+
+#include <gst/gst.h>
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdio>
+
+#include "audio_filter_stage.hpp"
+#include "spectrum_tap.hpp"
+#include "media_player.hpp"
+#include "station_gain_store.hpp"
+#include "gst_threads.hpp"
+#include "stream_metadata.hpp"
+#include "named_source.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+
+// Wiedergabe ohne Oberfläche: playbin mit Audio-Filter (Lautheit, EQ, Limiter), Spektrum-Abgriff,
+// lokale Warteschlange und Lautheitsspeicher pro Sender. Läuft entweder im Audio-Daemon
+// (audio_daemon.cpp) oder als Rückfallebene direkt in der Oberfläche (RadioManager).
+// Alle Methoden erwarten die GLib-Main-Loop des jeweiligen Prozesses.
+class AudioEngine {
+public:
+    // Rückmeldungen aus dem Bus, im Main-Thread
+    std::function<void(const std::string&)> on_title;
+    std::function<void(int, double)> on_buffering; // Prozent, Eingangsrate in kbit/s (-1 = unbekannt)
+    std::function<void(const std::string&)> on_error;
+
+    AudioEngine() {
+        pipeline = gst_element_factory_make("playbin", "radio-player");
+        if (!pipeline) {
+            LOG_ERROR("AudioEngine", "playbin konnte nicht erstellt werden!");
+            return;
+        }
+
+        // Lautheit + EQ + Limiter zwischen Decoder und Audio-Sink, dahinter der Visualizer-Abgriff
+        audio_filter = new AudioFilterStage();
+        if (audio_filter->element()) g_object_set(pipeline, "audio-filter", audio_filter->element(), NULL);
+        audio_filter->set_tap(&tap);
+        media = new MediaPlayer(pipeline);
+
+        // Streaming- und Audio-Sink-Threads bekommen die Rolle "audio" (Kern + SCHED_FIFO)
+        register_streaming_threads(pipeline, "audio");
+        GstBus *bus = gst_element_get_bus(pipeline);
+        gst_bus_add_watch(bus, (GstBusFunc)on_bus_message, this);
+        gst_object_unref(bus);
+
+        // Gelernte Lautheit regelmäßig sichern, nicht nur beim Senderwechsel
+        NamedSource::timeout_seconds("loudness-save", LOUDNESS_SAVE_INTERVAL_S, +[](gpointer d) -> gboolean {
+            static_cast<AudioEngine*>(d)->remember_loudness();
+            return G_SOURCE_CONTINUE;
+        }, this);
+    }
+
+    std::string resolve_m3u(const std::string& url) {
+        if (url.find(".m3u") == std::string::npos && url.find(".pls") == std::string::npos) {
+            return url; // Keine Playlist, URL direkt zurückgeben
+        }
+
+        LOG_INFO("AudioEngine", "Playlist erkannt, extrahiere Stream-URL...");
+
+        // Einfacher Weg ohne libcurl (via Shell für schnellen Test):
+        // In einer produktiven App solltest du eine HTTP-Library nutzen.
+        std::string cmd = "curl -L -s " + url + " | grep -v '^#' | head -n 1";
+        char buffer[128];
+        std::string result = "";
+        FILE* pipe = popen(cmd.c_str(), "r");
+        if (pipe) {
+            if (fgets(buffer, sizeof(buffer), pipe) != NULL) {
+                result = buffer;
+                result.erase(result.find_last_not_of(" \n\r\t") + 1); // Trim
+            }
+            pclose(pipe);
+        }
+
+        if (!result.empty()) {
+            LOG_INFO("AudioEngine", "Echte URL gefunden: {}", result);
+            return result;
+        }
+        return url;
+    }
+
+    void set_volume(double volume) {
+        // volume sollte zwischen 0.0 und 1.0 (oder bis 10.0 für Boost) liegen
+        if (pipeline) g_object_set(pipeline, "volume", volume, NULL);
+    }
+
+    // Speicherdruck: kleinere Stream-Puffer (greift spätestens beim nächsten Senderwechsel)
+    void set_low_memory(bool enabled) {
+        low_memory = enabled;
+        apply_buffer_limits();
+    }
+
+    size_t buffer_bytes() const { return low_memory ? LOW_BUFFER_SIZE : BUFFER_SIZE; }
+
+    // station: Sender, unter dem die Lautheit gelernt wird (leer = die URL selbst). Wechselt nur
+    // die Variante desselben Senders, läuft die aktuelle Verstärkung ohne Sprung weiter.
+    void set_source(const std::string& uri, const std::string& station = "") {
+        if (!pipeline) return;
+        std::string key = station.empty() ? uri : station;
+        bool same_station = !current_station.empty() && key == current_station;
+        media->stop();
+        if (!same_station) remember_loudness();
+        current_station = key;
+        std::string final_uri = resolve_m3u(uri); // URL auflösen
+        LOG_INFO("AudioEngine", "Lade URI: {}", final_uri);
+
+        gst_element_set_state(pipeline, GST_STATE_NULL); // Reset auf NULL für sauberen Wechsel
+        g_object_set(pipeline, "uri", final_uri.c_str(), NULL);
+
+        // Puffer-Einstellungen
+        apply_buffer_limits();
+
+        // Bekannte Lautheitskorrektur sofort anwenden, sonst bei 0 dB anfangen und lernen
+        if (same_station) {
+            LOG_DEBUG("AudioEngine", "Variante gewechselt, Lautheitskorrektur bleibt");
+        } else {
+            double gain_db = 0.0;
+            bool known = loudness_gains.lookup(key, gain_db);
+            audio_filter->normalizer().start_stream(gain_db);
+            LOG_DEBUG("AudioEngine", "Lautheitskorrektur {} dB ({})", gain_db, known ? "gespeichert" : "neu");
+        }
+
+        static Counter& starts = MetricsRegistry::instance().counter("caros_radio_stream_starts_total", "Gestartete Streams");
+        starts.inc();
+
+        GstStateChangeReturn ret = gst_element_set_state(pipeline, GST_STATE_PLAYING);
+        if (ret == GST_STATE_CHANGE_FAILURE) {
+            LOG_ERROR("AudioEngine", "Pipeline konnte nicht in PLAYING-Zustand versetzt werden!");
+        }
+    }
+
+    // Lokale Titel lückenlos abspielen; gelernte Lautheit des Senders vorher sichern
+    void play_queue(std::vector<std::string> queue) {
+        if (!pipeline || queue.empty()) return;
+        remember_loudness();
+        current_station.clear();
+        audio_filter->normalizer().start_stream(0.0);
+        media->play(std::move(queue));
+    }
+
+    // Ohne Audiogerät (test/gst): eigenes Sink statt autoaudiosink, vor set_source setzen
+    void set_audio_sink(GstElement *sink) {
+        if (pipeline) g_object_set(pipeline, "audio-sink", sink, NULL);
+    }
+
+    void stop() {
+        if (!pipeline) return;
+        media->stop();
+        gst_element_set_state(pipeline, GST_STATE_NULL);
+    }
+
+    AudioFilterStage& filter() { return *audio_filter; }
+    SpectrumTap& spectrum() { return tap; }
+
+private:
+    static constexpr int BUFFER_SIZE = 1024 * 1024;
+    static constexpr int LOW_BUFFER_SIZE = 256 * 1024;
+    static constexpr guint LOUDNESS_SAVE_INTERVAL_S = 30;
+
+    GstElement *pipeline = nullptr;
+    AudioFilterStage *audio_filter = nullptr;
+    MediaPlayer *media = nullptr;
+    SpectrumTap tap;
+    bool low_memory = false;
+    StationGainStore loudness_gains;
+    std::string current_station; // Original-URL aus der Senderliste (Schlüssel für loudness_gains)
+
+    void remember_loudness() {
+        LoudnessNormalizer& norm = audio_filter->normalizer();
+        if (current_station.empty() || !norm.has_estimate()) return;
+        static Gauge& lufs = MetricsRegistry::instance().gauge("caros_audio_loudness_lufs", "Integrierte Lautheit des laufenden Senders");
+        static Gauge& gain = MetricsRegistry::instance().gauge("caros_audio_loudness_gain_db", "Lautheitskorrektur des laufenden Senders");
+        lufs.set(norm.integrated_lufs());
+        gain.set(norm.learned_gain_db());
+        loudness_gains.record(current_station, norm.learned_gain_db());
+    }
+
+    void apply_buffer_limits() {
+        if (!pipeline) return;
+        gint64 duration = (low_memory ? 2000 : 5000) * GST_MSECOND;
+        g_object_set(pipeline, "buffer-duration", duration, NULL);
+        g_object_set(pipeline, "buffer-size", low_memory ? LOW_BUFFER_SIZE : BUFFER_SIZE, NULL);
+    }
+
+    static gboolean on_bus_message(GstBus *bus, GstMessage *msg, gpointer data) {
+        (void) bus; // ignore the bus paramter
+        AudioEngine *self = static_cast<AudioEngine*>(data);
+
+        switch (GST_MESSAGE_TYPE(msg)) {
+            case GST_MESSAGE_ERROR: {
+                GError *err;
+                gchar *debug_info;
+                gst_message_parse_error(msg, &err, &debug_info);
+                static Counter& errors = MetricsRegistry::instance().counter("caros_radio_errors_total", "GStreamer-Fehler der Wiedergabe");
+                errors.inc();
+                LOG_ERROR("AudioEngine", "GST-FEHLER: {}", err->message);
+                LOG_ERROR("AudioEngine", "Debug Info: {}", debug_info ? debug_info : "keine");
+                if (self->on_error) self->on_error(err->message);
+                g_clear_error(&err);
+                g_free(debug_info);
+                break;
+            }
+            case GST_MESSAGE_STATE_CHANGED: {
+                GstState old_state, new_state, pending_state;
+                gst_message_parse_state_changed(msg, &old_state, &new_state, &pending_state);
+                if (GST_MESSAGE_SRC(msg) == GST_OBJECT(self->pipeline)) {
+                    LOG_INFO("AudioEngine", "Status: {} -> {}", gst_element_state_get_name(old_state), gst_element_state_get_name(new_state));
+                }
+                break;
+            }
+            case GST_MESSAGE_BUFFERING: {
+                gint percent = 0;
+                gint avg_in = -1; // Bytes/s, von queue2 gemessen
+                gst_message_parse_buffering(msg, &percent);
+                gst_message_parse_buffering_stats(msg, nullptr, &avg_in, nullptr, nullptr);
+                static Counter& buffering = MetricsRegistry::instance().counter("caros_radio_buffering_events_total", "Buffering-Meldungen unter 100%");
+                static Gauge& level = MetricsRegistry::instance().gauge("caros_radio_buffer_percent", "Aktueller Füllstand des Stream-Puffers");
+                if (percent < 100) buffering.inc();
+                level.set(percent);
+                LOG_DEBUG("AudioEngine", "Buffering: {}%", percent);
+                if (self->on_buffering) self->on_buffering(percent, avg_in > 0 ? avg_in * 8.0 / 1000.0 : -1.0);
+                break;
+            }
+            case GST_MESSAGE_TAG: {
+                GstTagList *tags = NULL;
+                gst_message_parse_tag(msg, &tags);
+                gchar *title = NULL;
+                gchar *artist = NULL;
+
+                if (gst_tag_list_get_string(tags, GST_TAG_TITLE, &title) ||
+                    gst_tag_list_get_string(tags, GST_TAG_ARTIST, &artist)) {
+
+                    if (self->on_title) self->on_title(format_stream_title(artist, title));
+
+                    g_free(title);
+                    g_free(artist);
+                }
+                if (tags) gst_tag_list_free(tags);
+                break;
+            }
+            default:
+                break;
+        }
+        return TRUE;
+    }
+};
+
+#endif
@@ -0,0 +1,415 @@
+#ifndef AUDIO_EQ_HPP
+#define AUDIO_EQ_HPP
+
+#include <atomic>
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CAROS_EQ_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CAROS_EQ_NEON 1
+#endif
+
+// Parametrischer 8-Band-EQ (Biquads, Transposed Direct Form II) plus Limiter
+// für interleaved float32 (Mono oder Stereo).
+//
+// SIMD-Ansatz: Je vier Bänder eines Kanals laufen als Pipeline in den vier Lanes eines
+// Vektors. Lane k rechnet Band k für das Sample n-k, nach jedem Schritt wandert das
+// Ergebnis eine Lane weiter. So ist der Vektor in jedem Schritt voll ausgelastet, die
+// Ausgabe ist dafür um 3 Samples pro Vierergruppe verzögert (latency_frames()).
+// Der skalare Pfad ist die unverzögerte Referenz.
+
+enum class EqBandType { LowShelf, Peaking, HighShelf };
+
+struct EqBand {
+    EqBandType type;
+    float freq;
+    float q;
+};
+
+struct BiquadCoeffs {
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+};
+
+// Von der Verstärkung unabhängiger Teil eines Bands (hängt nur an Frequenz, Güte und Rate)
+struct BiquadShape {
+    double cw = 1.0, alpha = 0.0;
+};
+
+inline BiquadShape biquad_shape(double freq, double q, double rate) {
+    double w0 = 2.0 * M_PI * std::min(freq, rate * 0.45) / rate;
+    return {std::cos(w0), std::sin(w0) / (2.0 * q)};
+}
+
+// Formeln aus dem "Audio EQ Cookbook" (R. Bristow-Johnson)
+inline BiquadCoeffs design_biquad(EqBandType type, const BiquadShape& shape, double gain_db) {
+    double A = std::pow(10.0, gain_db / 40.0);
+    double cw = shape.cw;
+    double alpha = shape.alpha;
+    double b0, b1, b2, a0, a1, a2;
+
+    switch (type) {
+        case EqBandType::LowShelf: {
+            double k = 2.0 * std::sqrt(A) * alpha;
+            b0 = A * ((A + 1) - (A - 1) * cw + k);
+            b1 = 2 * A * ((A - 1) - (A + 1) * cw);
+            b2 = A * ((A + 1) - (A - 1) * cw - k);
+            a0 = (A + 1) + (A - 1) * cw + k;
+            a1 = -2 * ((A - 1) + (A + 1) * cw);
+            a2 = (A + 1) + (A - 1) * cw - k;
+            break;
+        }
+        case EqBandType::HighShelf: {
+            double k = 2.0 * std::sqrt(A) * alpha;
+            b0 = A * ((A + 1) + (A - 1) * cw + k);
+            b1 = -2 * A * ((A - 1) + (A + 1) * cw);
+            b2 = A * ((A + 1) + (A - 1) * cw - k);
+            a0 = (A + 1) - (A - 1) * cw + k;
+            a1 = 2 * ((A - 1) - (A + 1) * cw);
+            a2 = (A + 1) - (A - 1) * cw - k;
+            break;
+        }
+        default:
+            b0 = 1 + alpha * A;
+            b1 = -2 * cw;
+            b2 = 1 - alpha * A;
+            a0 = 1 + alpha / A;
+            a1 = -2 * cw;
+            a2 = 1 - alpha / A;
+            break;
+    }
+    return {float(b0 / a0), float(b1 / a0), float(b2 / a0), float(a1 / a0), float(a2 / a0)};
+}
+
+inline BiquadCoeffs design_biquad(EqBandType type, double freq, double q, double gain_db, double rate) {
+    return design_biquad(type, biquad_shape(freq, q, rate), gain_db);
+}
+
+class AudioEqualizer {
+public:
+    static constexpr int BANDS = 8;
+    static constexpr int GROUPS = BANDS / 4;
+    static constexpr int MAX_CHANNELS = 2;
+    static constexpr size_t RAMP_FRAMES = 32;  // Koeffizienten-Update höchstens alle 32 Frames
+    static constexpr float RAMP_DB = 0.25f;     // max. Änderung pro Update -> ~345 dB/s bei 44,1 kHz
+                                                // (12 dB in 35 ms), in 0,25-dB-Stufen klickfrei
+    static constexpr float MAX_GAIN_DB = 12.0f;
+    static constexpr float LIMIT = 0.891f;      // -1 dBFS
+
+    enum class Kernel { Scalar, Sse, Avx, Neon };
+
+    static const std::array<EqBand, BANDS>& bands() {
+        static const std::array<EqBand, BANDS> table = {{
+            {EqBandType::LowShelf, 60.0f, 0.707f},
+            {EqBandType::Peaking, 150.0f, 1.0f},
+            {EqBandType::Peaking, 400.0f, 1.0f},
+            {EqBandType::Peaking, 1000.0f, 1.0f},
+            {EqBandType::Peaking, 2400.0f, 1.0f},
+            {EqBandType::Peaking, 6000.0f, 1.0f},
+            {EqBandType::Peaking, 10000.0f, 1.0f},
+            {EqBandType::HighShelf, 14000.0f, 0.707f},
+        }};
+        return table;
+    }
+
+    AudioEqualizer() : kernel(best_kernel()) {
+        for (auto& t : target_db) t.store(0.0f, std::memory_order_relaxed);
+        configure(44100, 2);
+    }
+
+    // Aus dem Streaming-Thread, wenn sich das Format ändert (setzt die Filterzustände zurück)
+    void configure(int sample_rate, int channel_count) {
+        rate = sample_rate > 0 ? sample_rate : 44100;
+        channels = channel_count;
+        release = std::exp(-1.0f / (0.15f * rate)); // Limiter-Release 150 ms
+        envelope = 0.0f;
+        for (int b = 0; b < BANDS; b++) {
+            shapes[b] = biquad_shape(bands()[b].freq, bands()[b].q, rate);
+            current_db[b] = target_db[b].load(std::memory_order_relaxed);
+            update_band(b);
+        }
+        reset_state();
+    }
+
+    // Threadsicher, wird im Streaming-Thread in kleinen Schritten angefahren
+    void set_gain(int band, float db) {
+        if (band < 0 || band >= BANDS) return;
+        target_db[band].store(std::clamp(db, -MAX_GAIN_DB, MAX_GAIN_DB), std::memory_order_relaxed);
+    }
+
+    float gain(int band) const { return target_db[band].load(std::memory_order_relaxed); }
+
+    // Für Tests und Benchmarks: im Streaming-Thread gerade angefahrene Verstärkung und
+    // Anzahl der Koeffizienten-Berechnungen seit dem Start
+    float ramped_gain(int band) const { return current_db[band]; }
+    uint64_t coefficient_updates() const { return updates; }
+
+    void set_limiter_enabled(bool enabled) { limiter_enabled.store(enabled, std::memory_order_relaxed); }
+
+    void process(float *data, size_t frames) {
+        if (channels < 1 || channels > MAX_CHANNELS) return; // Mehrkanal: unverändert durchreichen
+
+#if CAROS_EQ_X86
+        // Denormals im IIR-Ausklang vermeiden (ARM-NEON arbeitet ohnehin mit flush-to-zero)
+        unsigned int csr = _mm_getcsr();
+        _mm_setcsr(csr | 0x8040);
+#endif
+        for (size_t done = 0; done < frames; done += RAMP_FRAMES) {
+            size_t n = std::min(RAMP_FRAMES, frames - done);
+            float *chunk = data + done * channels;
+            ramp_gains();
+            run_kernel(chunk, n);
+            if (limiter_enabled.load(std::memory_order_relaxed)) limit(chunk, n);
+        }
+#if CAROS_EQ_X86
+        _mm_setcsr(csr);
+#endif
+    }
+
+    int latency_frames() const { return kernel == Kernel::Scalar ? 0 : 3 * GROUPS; }
+
+    Kernel get_kernel() const { return kernel; }
+
+    // Für Tests und Benchmarks; setzt den Zustand zurück
+    void set_kernel(Kernel k) {
+        kernel = k;
+        reset_state();
+    }
+
+    static Kernel best_kernel() {
+#if CAROS_EQ_X86
+        if (__builtin_cpu_supports("avx")) return Kernel::Avx;
+        return Kernel::Sse;
+#elif CAROS_EQ_NEON
+        return Kernel::Neon;
+#else
+        return Kernel::Scalar;
+#endif
+    }
+
+    static const char* kernel_name(Kernel k) {
+        switch (k) {
+            case Kernel::Sse: return "sse";
+            case Kernel::Avx: return "avx";
+            case Kernel::Neon: return "neon";
+            default: return "scalar";
+        }
+    }
+
+private:
+    // Koeffizienten einer Vierergruppe, Lane = Band
+    struct alignas(16) Group {
+        float b0[4], b1[4], b2[4], a1[4], a2[4];
+    };
+    // Pipeline-Zustand einer Gruppe und eines Kanals (o = letzte Ausgabe aller Lanes)
+    struct alignas(16) PipeState {
+        float s1[4], s2[4], o[4];
+    };
+    struct ScalarState {
+        float s1, s2;
+    };
+
+    Kernel kernel;
+    int rate = 44100;
+    int channels = 2;
+    std::array<std::atomic<float>, BANDS> target_db;
+    std::array<float, BANDS> current_db{};
+    std::array<BiquadShape, BANDS> shapes{};   // je Band bei configure() berechnet
+    uint64_t updates = 0;
+    std::atomic<bool> limiter_enabled{true};
+    float release = 0.0f;
+    float envelope = 0.0f;
+
+    std::array<Group, GROUPS> groups{};
+    PipeState pipe[MAX_CHANNELS][GROUPS]{};
+    ScalarState scalar[MAX_CHANNELS][BANDS]{};
+
+    void reset_state() {
+        for (auto& ch : pipe) for (auto& g : ch) g = PipeState{};
+        for (auto& ch : scalar) for (auto& s : ch) s = ScalarState{};
+    }
+
+    // Nur die von der Verstärkung abhängigen Terme; cos/sin der Mittenfrequenz liegen in shapes
+    void update_band(int b) {
+        BiquadCoeffs c = design_biquad(bands()[b].type, shapes[b], current_db[b]);
+        updates++;
+        Group& g = groups[b / 4];
+        int lane = b % 4;
+        g.b0[lane] = c.b0;
+        g.b1[lane] = c.b1;
+        g.b2[lane] = c.b2;
+        g.a1[lane] = c.a1;
+        g.a2[lane] = c.a2;
+    }
+
+    // Verstärkung in kleinen Schritten nachführen, Koeffizienten aus der Zwischen-Verstärkung
+    // neu berechnen (stabil, im Gegensatz zur Interpolation der Koeffizienten selbst).
+    // Bänder am Ziel behalten ihre Koeffizienten, gerechnet wird nur während einer Rampe.
+    void ramp_gains() {
+        for (int b = 0; b < BANDS; b++) {
+            float target = target_db[b].load(std::memory_order_relaxed);
+            if (current_db[b] == target) continue;
+            float delta = std::clamp(target - current_db[b], -RAMP_DB, RAMP_DB);
+            current_db[b] += delta;
+            update_band(b);
+        }
+    }
+
+    void run_kernel(float *data, size_t frames) {
+        switch (kernel) {
+#if CAROS_EQ_X86
+            case Kernel::Avx:
+                if (channels == 2) {
+                    run_avx_stereo(data, frames);
+                    return;
+                }
+                run_sse(data, frames);
+                return;
+            case Kernel::Sse:
+                run_sse(data, frames);
+                return;
+#endif
+#if CAROS_EQ_NEON
+            case Kernel::Neon:
+                run_neon(data, frames);
+                return;
+#endif
+            default:
+                run_scalar(data, frames);
+                return;
+        }
+    }
+
+    void run_scalar(float *data, size_t frames) {
+        for (size_t n = 0; n < frames; n++) {
+            for (int c = 0; c < channels; c++) {
+                float x = data[n * channels + c];
+                for (int b = 0; b < BANDS; b++) {
+                    const Group& g = groups[b / 4];
+                    int l = b % 4;
+                    ScalarState& s = scalar[c][b];
+                    float y = g.b0[l] * x + s.s1;
+                    s.s1 = g.b1[l] * x - g.a1[l] * y + s.s2;
+                    s.s2 = g.b2[l] * x - g.a2[l] * y;
+                    x = y;
+                }
+                data[n * channels + c] = x;
+            }
+        }
+    }
+
+#if CAROS_EQ_X86
+    void run_sse(float *data, size_t frames) {
+        for (int c = 0; c < channels; c++) {
+            for (int gi = 0; gi < GROUPS; gi++) {
+                const Group& g = groups[gi];
+                PipeState& st = pipe[c][gi];
+                __m128 b0 = _mm_load_ps(g.b0), b1 = _mm_load_ps(g.b1), b2 = _mm_load_ps(g.b2);
+                __m128 a1 = _mm_load_ps(g.a1), a2 = _mm_load_ps(g.a2);
+                __m128 s1 = _mm_load_ps(st.s1), s2 = _mm_load_ps(st.s2), o = _mm_load_ps(st.o);
+
+                float *p = data + c;
+                for (size_t n = 0; n < frames; n++, p += channels) {
+                    // [x, o0, o1, o2]: neues Sample in Lane 0, Zwischenergebnisse rücken weiter
+                    __m128 in = _mm_move_ss(_mm_shuffle_ps(o, o, _MM_SHUFFLE(2, 1, 0, 0)), _mm_set_ss(*p));
+                    __m128 y = _mm_add_ps(_mm_mul_ps(b0, in), s1);
+                    s1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, in), _mm_mul_ps(a1, y)), s2);
+                    s2 = _mm_sub_ps(_mm_mul_ps(b2, in), _mm_mul_ps(a2, y));
+                    o = y;
+                    *p = _mm_cvtss_f32(_mm_shuffle_ps(y, y, _MM_SHUFFLE(3, 3, 3, 3)));
+                }
+                _mm_store_ps(st.s1, s1);
+                _mm_store_ps(st.s2, s2);
+                _mm_store_ps(st.o, o);
+            }
+        }
+    }
+
+    // Stereo in einem 256-Bit-Register: Lanes 0-3 links, 4-7 rechts
+    __attribute__((target("avx")))
+    void run_avx_stereo(float *data, size_t frames) {
+        for (int gi = 0; gi < GROUPS; gi++) {
+            const Group& g = groups[gi];
+            __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(g.b0));
+            __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(g.b1));
+            __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(g.b2));
+            __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(g.a1));
+            __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(g.a2));
+            PipeState& l = pipe[0][gi];
+            PipeState& r = pipe[1][gi];
+            __m256 s1 = _mm256_setr_m128(_mm_load_ps(l.s1), _mm_load_ps(r.s1));
+            __m256 s2 = _mm256_setr_m128(_mm_load_ps(l.s2), _mm_load_ps(r.s2));
+            __m256 o = _mm256_setr_m128(_mm_load_ps(l.o), _mm_load_ps(r.o));
+
+            float *p = data;
+            for (size_t n = 0; n < frames; n++, p += 2) {
+                __m256 x = _mm256_setr_ps(p[0], 0, 0, 0, p[1], 0, 0, 0);
+                __m256 in = _mm256_blend_ps(_mm256_permute_ps(o, _MM_SHUFFLE(2, 1, 0, 0)), x, 0x11);
+                __m256 y = _mm256_add_ps(_mm256_mul_ps(b0, in), s1);
+                s1 = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(b1, in), _mm256_mul_ps(a1, y)), s2);
+                s2 = _mm256_sub_ps(_mm256_mul_ps(b2, in), _mm256_mul_ps(a2, y));
+                o = y;
+                __m256 last = _mm256_permute_ps(y, _MM_SHUFFLE(3, 3, 3, 3));
+                p[0] = _mm256_cvtss_f32(last);
+                p[1] = _mm_cvtss_f32(_mm256_extractf128_ps(last, 1));
+            }
+            _mm_store_ps(l.s1, _mm256_castps256_ps128(s1));
+            _mm_store_ps(r.s1, _mm256_extractf128_ps(s1, 1));
+            _mm_store_ps(l.s2, _mm256_castps256_ps128(s2));
+            _mm_store_ps(r.s2, _mm256_extractf128_ps(s2, 1));
+            _mm_store_ps(l.o, _mm256_castps256_ps128(o));
+            _mm_store_ps(r.o, _mm256_extractf128_ps(o, 1));
+        }
+    }
+#endif
+
+#if CAROS_EQ_NEON
+    void run_neon(float *data, size_t frames) {
+        for (int c = 0; c < channels; c++) {
+            for (int gi = 0; gi < GROUPS; gi++) {
+                const Group& g = groups[gi];
+                PipeState& st = pipe[c][gi];
+                float32x4_t b0 = vld1q_f32(g.b0), b1 = vld1q_f32(g.b1), b2 = vld1q_f32(g.b2);
+                float32x4_t a1 = vld1q_f32(g.a1), a2 = vld1q_f32(g.a2);
+                float32x4_t s1 = vld1q_f32(st.s1), s2 = vld1q_f32(st.s2), o = vld1q_f32(st.o);
+
+                float *p = data + c;
+                for (size_t n = 0; n < frames; n++, p += channels) {
+                    // vext(a, b, 3) = [a3, b0, b1, b2] -> [x, o0, o1, o2]
+                    float32x4_t in = vextq_f32(vdupq_n_f32(*p), o, 3);
+                    float32x4_t y = vaddq_f32(vmulq_f32(b0, in), s1);
+                    s1 = vaddq_f32(vsubq_f32(vmulq_f32(b1, in), vmulq_f32(a1, y)), s2);
+                    s2 = vsubq_f32(vmulq_f32(b2, in), vmulq_f32(a2, y));
+                    o = y;
+                    *p = vgetq_lane_f32(y, 3);
+                }
+                vst1q_f32(st.s1, s1);
+                vst1q_f32(st.s2, s2);
+                vst1q_f32(st.o, o);
+            }
+        }
+    }
+#endif
+
+    // Limiter mit sofortigem Attack und weichem Release, Kanäle gekoppelt
+    void limit(float *data, size_t frames) {
+        for (size_t n = 0; n < frames; n++) {
+            float *frame = data + n * channels;
+            float peak = std::fabs(frame[0]);
+            if (channels == 2) peak = std::max(peak, std::fabs(frame[1]));
+            envelope = std::max(peak, envelope * release);
+            if (envelope > LIMIT) {
+                float g = LIMIT / envelope;
+                for (int c = 0; c < channels; c++) frame[c] *= g;
+            }
+        }
+    }
+};
+
+#endif
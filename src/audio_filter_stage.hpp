@@ -0,0 +1,138 @@
+#ifndef AUDIO_FILTER_STAGE_HPP
+#define AUDIO_FILTER_STAGE_HPP
+
+#include <gst/gst.h>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+
+#include "audio_eq.hpp"
+#include "loudness.hpp"
+#include "spectrum_tap.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+
+// Audio-Filter für playbin ("audio-filter"):
+//   audioconvert ! audio/x-raw,format=F32LE,layout=interleaved ! audioconvert
+// Reihenfolge: Lautheitsmessung + Angleich auf dem Decoder-Signal, dann EQ und Limiter.
+// Die eigentliche Bearbeitung läuft in-place in einer Pad-Probe hinter dem Capsfilter,
+// im Streaming-Thread von GStreamer und ohne zusätzliches Element oder Kopie.
+class AudioFilterStage {
+public:
+    explicit AudioFilterStage(const std::string& settings = "assets/eq_settings.csv") : settings_path(settings) {
+        GstElement *convert_in = gst_element_factory_make("audioconvert", nullptr);
+        GstElement *capsfilter = gst_element_factory_make("capsfilter", nullptr);
+        GstElement *convert_out = gst_element_factory_make("audioconvert", nullptr);
+        if (!convert_in || !capsfilter || !convert_out) {
+            LOG_ERROR("AudioFilter", "audioconvert/capsfilter fehlen, Wiedergabe ohne EQ");
+            return;
+        }
+
+        GstCaps *caps = gst_caps_from_string("audio/x-raw,format=F32LE,layout=interleaved");
+        g_object_set(capsfilter, "caps", caps, NULL);
+        gst_caps_unref(caps);
+
+        bin = gst_bin_new("caros-audio-filter");
+        gst_bin_add_many(GST_BIN(bin), convert_in, capsfilter, convert_out, NULL);
+        gst_element_link_many(convert_in, capsfilter, convert_out, NULL);
+
+        GstPad *sink = gst_element_get_static_pad(convert_in, "sink");
+        GstPad *src = gst_element_get_static_pad(convert_out, "src");
+        gst_element_add_pad(bin, gst_ghost_pad_new("sink", sink));
+        gst_element_add_pad(bin, gst_ghost_pad_new("src", src));
+        gst_object_unref(sink);
+        gst_object_unref(src);
+
+        GstPad *probe_pad = gst_element_get_static_pad(capsfilter, "src");
+        gst_pad_add_probe(probe_pad, static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM),
+                          on_probe, this, nullptr);
+        gst_object_unref(probe_pad);
+
+        load_settings();
+        const char *loudness_env = std::getenv("CAROS_LOUDNESS");
+        if (loudness_env && std::string(loudness_env) == "0") loudness.set_enabled(false);
+        LOG_INFO("AudioFilter", "EQ aktiv, Kernel {}", AudioEqualizer::kernel_name(eq.get_kernel()));
+    }
+
+    // Für g_object_set(playbin, "audio-filter", ...), nullptr wenn nicht verfügbar
+    GstElement* element() { return bin; }
+
+    AudioEqualizer& equalizer() { return eq; }
+
+    LoudnessNormalizer& normalizer() { return loudness; }
+
+    // Visualizer-Abgriff hinter dem EQ (nullptr = aus)
+    void set_tap(SpectrumTap *spectrum) { tap.store(spectrum, std::memory_order_release); }
+
+    // Eine Zeile "g1;g2;...;g8" in dB
+    void save_settings() const {
+        std::ofstream file(settings_path, std::ios::trunc);
+        for (int b = 0; b < AudioEqualizer::BANDS; b++) file << (b ? ";" : "") << eq.gain(b);
+        file << "\n";
+    }
+
+private:
+    GstElement *bin = nullptr;
+    AudioEqualizer eq;
+    LoudnessNormalizer loudness;
+    std::string settings_path;
+    std::atomic<SpectrumTap*> tap{nullptr};
+    int channels = 2;
+    int rate = 44100;
+
+    void load_settings() {
+        std::ifstream file(settings_path);
+        std::string line, value;
+        if (!std::getline(file, line)) return;
+        std::stringstream ss(line);
+        for (int b = 0; b < AudioEqualizer::BANDS && std::getline(ss, value, ';'); b++) {
+            eq.set_gain(b, std::strtof(value.c_str(), nullptr));
+        }
+    }
+
+    static GstPadProbeReturn on_probe(GstPad*, GstPadProbeInfo *info, gpointer data) {
+        auto *self = static_cast<AudioFilterStage*>(data);
+
+        if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM) {
+            GstEvent *event = GST_PAD_PROBE_INFO_EVENT(info);
+            if (GST_EVENT_TYPE(event) == GST_EVENT_CAPS) {
+                GstCaps *caps = nullptr;
+                gst_event_parse_caps(event, &caps);
+                GstStructure *s = gst_caps_get_structure(caps, 0);
+                int rate = 0, ch = 0;
+                if (gst_structure_get_int(s, "rate", &rate) && gst_structure_get_int(s, "channels", &ch)) {
+                    self->channels = ch;
+                    self->rate = rate;
+                    self->eq.configure(rate, ch);
+                    self->loudness.configure(rate, ch);
+                    LOG_INFO("AudioFilter", "Format {} Hz, {} Kanäle", rate, ch);
+                }
+            }
+            return GST_PAD_PROBE_OK;
+        }
+
+        static Histogram& cost = MetricsRegistry::instance().histogram("caros_audio_filter_ns", "Rechenzeit des Audio-Filters pro Buffer (ns)");
+        GstBuffer *buffer = gst_buffer_make_writable(GST_PAD_PROBE_INFO_BUFFER(info));
+        GST_PAD_PROBE_INFO_DATA(info) = buffer;
+
+        GstMapInfo map;
+        if (gst_buffer_map(buffer, &map, GST_MAP_READWRITE)) {
+            auto start = std::chrono::steady_clock::now();
+            size_t frames = map.size / (sizeof(float) * self->channels);
+            float *samples = reinterpret_cast<float*>(map.data);
+            self->loudness.process(samples, frames);
+            self->eq.process(samples, frames);
+            cost.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+            gst_buffer_unmap(buffer, &map);
+        }
+
+        SpectrumTap *spectrum = self->tap.load(std::memory_order_acquire);
+        if (spectrum) spectrum->push(buffer, self->channels, self->rate);
+        return GST_PAD_PROBE_OK;
+    }
+};
+
+#endif
@@ -0,0 +1,346 @@
+#ifndef AUDIO_IPC_HPP
+#define AUDIO_IPC_HPP
+
+#include <atomic>
+#include <array>
+#include <algorithm>
+#include <new>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Kanal zwischen Oberfläche und Audio-Daemon (caros-audiod).
+// Befehle, Statusmeldungen und Pegel laufen über gemeinsamen Speicher (memfd) mit zwei
+// lock-freien SPSC-Ringen; je ein eventfd weckt die Gegenseite. Der Unix-Socket dient nur
+// dazu, beim Verbinden die drei Dateideskriptoren per SCM_RIGHTS zu übergeben.
+// Jede Übergabe beginnt eine neue Sitzung; Nachrichten tragen ihre Sitzungsnummer, damit
+// Reste aus einer früheren Verbindung in den Ringen keine Wirkung mehr haben.
+// Reine POSIX-Schicht ohne GLib, damit Daemon, Oberfläche und Benchmarks sie teilen.
+namespace audio_ipc {
+
+constexpr uint32_t MAGIC = 0x31414143; // "CAA1"
+constexpr size_t TEXT_SIZE = 488;
+constexpr int LEVEL_BANDS = 32;
+constexpr int EQ_BANDS = 8;
+constexpr int CONNECT_TIMEOUT_MS = 250; // Daemon nimmt an, übergibt aber nicht: gilt als hängend
+
+enum class Command : uint32_t {
+    Ping,            // value = Zeitstempel, kommt als Pong zurück
+    PlayUri,         // text = Stream-URL '\n' Sender (Schlüssel der Lautheit, siehe play_text)
+    SetVolume,       // value = 0..1
+    SetLowMemory,    // arg = 0/1
+    SetEqGain,       // arg = Band, value = dB
+    SaveEq,
+    SetSpectrum,     // arg = 0/1
+    SetSpectrumRate, // arg = Analysen pro Sekunde
+    QueueClear,      // lokale Warteschlange leeren
+    QueueAdd,        // text = absoluter Pfad
+    QueuePlay,
+};
+
+enum class Event : uint32_t {
+    Pong,      // value = Zeitstempel aus dem Ping
+    Title,     // text = Metadaten
+    Buffering, // arg = Prozent, value = Eingangsrate in kbit/s (-1 = unbekannt)
+    Error,     // text = Fehlermeldung
+};
+
+// Eine Nachricht in beide Richtungen, 512 Bytes
+struct Message {
+    uint32_t type;
+    int32_t arg;
+    double value;
+    char text[TEXT_SIZE];
+    uint32_t text_len;
+    uint32_t session;
+};
+static_assert(sizeof(Message) == 512, "Message soll genau 512 Bytes haben");
+
+// SPSC-Ring im gemeinsamen Speicher; die Indizes laufen frei, N muss Zweierpotenz sein
+template<size_t N>
+struct Ring {
+    static_assert((N & (N - 1)) == 0, "N muss eine Zweierpotenz sein");
+    alignas(64) std::atomic<uint64_t> head{0}; // nur Produzent
+    alignas(64) std::atomic<uint64_t> tail{0}; // nur Konsument
+    alignas(64) std::array<Message, N> slots;
+
+    bool push(const Message& m) {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= N) return false;
+        slots[h & (N - 1)] = m;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(Message& m) {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        m = slots[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// Zuletzt berechnete Pegel (nur der neueste Stand zählt), per Seqlock geschützt
+struct Levels {
+    std::atomic<uint32_t> seq{0};
+    std::array<std::atomic<float>, LEVEL_BANDS> band{};
+};
+
+// Zustand, den die Oberfläche beim (Wieder-)Verbinden braucht
+struct Status {
+    std::array<std::atomic<float>, EQ_BANDS> eq_gain{};
+    std::atomic<uint32_t> buffer_bytes{0};
+    std::atomic<int32_t> daemon_pid{0};
+    std::atomic<uint32_t> session{0}; // zählt bei jeder Übergabe an eine Oberfläche hoch
+};
+
+struct Shared {
+    uint32_t magic = MAGIC;
+    uint32_t size = sizeof(Shared);
+    Ring<64> commands;  // Oberfläche -> Daemon
+    Ring<256> events;   // Daemon -> Oberfläche
+    Levels levels;
+    Status status;
+};
+
+inline uint64_t now_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+inline Message make_message(uint32_t type, int32_t arg = 0, double value = 0.0, const std::string& text = "",
+                            uint32_t session = 0) {
+    Message m{};
+    m.session = session;
+    m.type = type;
+    m.arg = arg;
+    m.value = value;
+    m.text_len = static_cast<uint32_t>(std::min(text.size(), TEXT_SIZE - 1));
+    std::memcpy(m.text, text.data(), m.text_len);
+    m.text[m.text_len] = '\0';
+    return m;
+}
+
+// PlayUri trägt neben der Stream-URL (ggf. eine Variante) den Sender, unter dem die Lautheit
+// gespeichert ist. Passt beides nicht in eine Nachricht, gilt die URL selbst als Sender.
+inline std::string play_text(const std::string& uri, const std::string& station) {
+    if (station.empty() || uri.size() + 1 + station.size() >= TEXT_SIZE) return uri;
+    return uri + "\n" + station;
+}
+
+inline void split_play_text(const std::string& text, std::string& uri, std::string& station) {
+    size_t sep = text.find('\n');
+    uri = text.substr(0, sep);
+    station = sep == std::string::npos ? uri : text.substr(sep + 1);
+}
+
+inline void wake(int efd) {
+    uint64_t one = 1;
+    ssize_t r = write(efd, &one, sizeof(one));
+    (void) r; // EAGAIN bei übervollem Zähler: die Gegenseite ist ohnehin wach
+}
+
+inline void clear_wakeups(int efd) {
+    uint64_t count;
+    ssize_t r = read(efd, &count, sizeof(count));
+    (void) r;
+}
+
+// Seqlock-Schreiber (nur der Daemon)
+inline void write_levels(Levels& l, const float *bands) {
+    uint32_t s = l.seq.load(std::memory_order_relaxed);
+    l.seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int b = 0; b < LEVEL_BANDS; b++) l.band[b].store(bands[b], std::memory_order_relaxed);
+    l.seq.store(s + 2, std::memory_order_release);
+}
+
+// Seqlock-Leser: false, wenn sich seit last_seq nichts geändert hat oder gerade geschrieben wird
+inline bool read_levels(const Levels& l, float *bands, uint32_t& last_seq) {
+    uint32_t s1 = l.seq.load(std::memory_order_acquire);
+    if (s1 == last_seq || (s1 & 1)) return false;
+    for (int b = 0; b < LEVEL_BANDS; b++) bands[b] = l.band[b].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (l.seq.load(std::memory_order_relaxed) != s1) return false;
+    last_seq = s1;
+    return true;
+}
+
+// Gemeinsamer Speicher + eventfds, Seite des Daemons
+struct Endpoint {
+    int shm_fd = -1;
+    int command_fd = -1; // weckt den Daemon
+    int event_fd = -1;   // weckt die Oberfläche
+    Shared *shared = nullptr;
+
+    bool create() {
+        shm_fd = memfd_create("caros-audio", MFD_CLOEXEC);
+        if (shm_fd < 0 || ftruncate(shm_fd, sizeof(Shared)) != 0) return false;
+        void *mem = mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+        if (mem == MAP_FAILED) return false;
+        shared = new (mem) Shared();
+        command_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        return command_fd >= 0 && event_fd >= 0;
+    }
+
+    // Seite der Oberfläche: übergebene Deskriptoren einblenden
+    bool attach(int shm, int command, int event) {
+        shm_fd = shm;
+        command_fd = command;
+        event_fd = event;
+        void *mem = mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+        if (mem == MAP_FAILED) return false;
+        shared = static_cast<Shared*>(mem);
+        return shared->magic == MAGIC && shared->size == sizeof(Shared);
+    }
+
+    void close_all() {
+        if (shared) munmap(shared, sizeof(Shared));
+        for (int fd : {shm_fd, command_fd, event_fd}) if (fd >= 0) close(fd);
+        shared = nullptr;
+        shm_fd = command_fd = event_fd = -1;
+    }
+};
+
+// $XDG_RUNTIME_DIR gehört nur dem Benutzer; ohne ihn /tmp mit der UID im Namen
+inline std::string default_socket_path() {
+    const char *runtime = std::getenv("XDG_RUNTIME_DIR");
+    if (runtime && *runtime) return std::string(runtime) + "/caros-audio.sock";
+    return "/tmp/caros-audio-" + std::to_string(getuid()) + ".sock";
+}
+
+inline sockaddr_un socket_address(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    return addr;
+}
+
+// Daemon: Sperrdatei neben dem Socket, gehalten bis zum Prozessende. Solange ein anderer
+// Daemon lebt, bleibt sie belegt; wait_ms deckt einen gerade beendeten Vorgänger ab.
+// Liefert den Deskriptor der Sperre oder -1.
+inline int lock_socket(const std::string& socket_path, int wait_ms) {
+    int fd = open((socket_path + ".lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) return -1;
+    for (int waited = 0; flock(fd, LOCK_EX | LOCK_NB) != 0; waited += 50) {
+        if (errno != EWOULDBLOCK || waited >= wait_ms) {
+            close(fd);
+            return -1;
+        }
+        usleep(50 * 1000);
+    }
+    return fd;
+}
+
+// Daemon: Socket nur für den Benutzer anlegen (umask vor bind, kein chmod-Fenster).
+// Nur mit gehaltener Sperre aufrufen, ein übrig gebliebener Socket wird ersetzt.
+inline int listen_socket(const std::string& socket_path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) return -1;
+    sockaddr_un addr = socket_address(socket_path);
+    unlink(socket_path.c_str());
+    mode_t old_mask = umask(0077);
+    bool ok = bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+    umask(old_mask);
+    if (!ok || listen(fd, 4) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+    return fd;
+}
+
+// Daemon: die drei Deskriptoren an einen frisch verbundenen Client schicken
+inline bool send_fds(int sock, const Endpoint& ep) {
+    int fds[3] = {ep.shm_fd, ep.command_fd, ep.event_fd};
+    char payload = 'C';
+    iovec iov{&payload, 1};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    std::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+    return sendmsg(sock, &msg, MSG_NOSIGNAL) == 1;
+}
+
+// Oberfläche, Schritt 1: nicht blockierend verbinden. Liefert den Socket oder -1, errno
+// ENOENT/ECONNREFUSED = kein Daemon, EAGAIN = Daemon nimmt keine Verbindungen mehr an.
+inline int dial(const std::string& socket_path) {
+    int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (sock < 0) return -1;
+    sockaddr_un addr = socket_address(socket_path);
+    if (::connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        int saved = errno;
+        close(sock);
+        errno = saved;
+        return -1;
+    }
+    return sock;
+}
+
+// Schritt 2, sobald der Socket lesbar ist: Kanal übernehmen. Blockiert nicht.
+inline bool receive(int sock, Endpoint& ep) {
+    char payload;
+    iovec iov{&payload, 1};
+    alignas(cmsghdr) char control[CMSG_SPACE(3 * sizeof(int))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    ssize_t n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC | MSG_DONTWAIT);
+
+    cmsghdr *cmsg = n == 1 ? CMSG_FIRSTHDR(&msg) : nullptr;
+    if (!cmsg || cmsg->cmsg_type != SCM_RIGHTS || cmsg->cmsg_len != CMSG_LEN(3 * sizeof(int))) return false;
+    int fds[3];
+    std::memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+    if (!ep.attach(fds[0], fds[1], fds[2])) {
+        ep.close_all();
+        return false;
+    }
+    return true;
+}
+
+// PID des Daemons am anderen Ende des Sockets, 0 wenn unbekannt
+inline pid_t peer_pid(int sock) {
+    ucred cred{};
+    socklen_t len = sizeof(cred);
+    if (getsockopt(sock, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0) return 0;
+    return cred.pid;
+}
+
+// Blockierend mit Zeitlimit (Tests, Werkzeuge); die Oberfläche nutzt dial/receive mit fd-Watch
+inline bool connect(const std::string& socket_path, Endpoint& ep, int timeout_ms = CONNECT_TIMEOUT_MS) {
+    int sock = dial(socket_path);
+    if (sock < 0) return false;
+    pollfd p{sock, POLLIN, 0};
+    bool ok = poll(&p, 1, timeout_ms) == 1 && receive(sock, ep);
+    close(sock);
+    return ok;
+}
+
+} // namespace audio_ipc
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef BLUETOOTH_DEVICE_MODEL_HPP
+#define BLUETOOTH_DEVICE_MODEL_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <optional>
+#include <cstdint>
+
+// Struktur für ein gefundenes Gerät
+struct BluetoothDevice {
+    std::string object_path;
+    std::string address;
+    std::string name;
+    bool paired = false;
+    bool connected = false;
+    bool has_rssi = false;
+    int16_t rssi = 0;
+    int64_t last_seen_us = 0; // monotone Zeit der letzten Eigenschaftsänderung
+};
+
+// Teil-Update aus InterfacesAdded / GetManagedObjects / PropertiesChanged.
+// Nicht gesetzte Felder bleiben am Gerät unverändert.
+struct BluetoothDeviceDelta {
+    std::optional<std::string> address;
+    std::optional<std::string> name;
+    std::optional<std::string> alias;
+    std::optional<bool> paired;
+    std::optional<bool> connected;
+    std::optional<int16_t> rssi;
+    bool rssi_invalidated = false;
+};
+
+enum class BluetoothChange { Added, Updated, Removed };
+
+// Geräteliste nach MAC-Adresse. Änderungen werden pro Adresse zusammengefasst
+// und mit take_changes() gesammelt abgeholt (einmal pro Frame im UI).
+class BluetoothDeviceModel {
+public:
+    // Gerät anlegen oder aktualisieren; liefert false, wenn keine Adresse bekannt ist
+    bool apply(const std::string& object_path, const BluetoothDeviceDelta& delta, int64_t now_us) {
+        std::string address;
+        auto p = path_to_address.find(object_path);
+        if (p != path_to_address.end()) {
+            address = p->second;
+        } else if (delta.address) {
+            address = *delta.address;
+        } else {
+            return false;
+        }
+
+        auto it = devices.find(address);
+        bool is_new = (it == devices.end());
+        if (is_new) {
+            it = devices.emplace(address, BluetoothDevice{}).first;
+            it->second.object_path = object_path;
+            it->second.address = address;
+            it->second.name = "Unbekanntes Gerät";
+            path_to_address[object_path] = address;
+        }
+
+        BluetoothDevice& d = it->second;
+        // Alias hat Vorrang vor Name (BlueZ setzt Alias = Name, solange der Nutzer nichts ändert)
+        if (delta.alias) {
+            d.name = *delta.alias;
+            aliased.insert(address);
+        } else if (delta.name && !aliased.count(address)) {
+            d.name = *delta.name;
+        }
+        if (delta.paired) d.paired = *delta.paired;
+        if (delta.connected) d.connected = *delta.connected;
+        if (delta.rssi) { d.rssi = *delta.rssi; d.has_rssi = true; }
+        if (delta.rssi_invalidated) d.has_rssi = false;
+        d.last_seen_us = now_us;
+
+        mark(address, is_new ? BluetoothChange::Added : BluetoothChange::Updated);
+        return true;
+    }
+
+    void remove_path(const std::string& object_path) {
+        auto p = path_to_address.find(object_path);
+        if (p == path_to_address.end()) return;
+        remove_address(p->second);
+    }
+
+    // Entfernt Geräte, die länger als max_age_us nichts mehr gemeldet haben.
+    // Gekoppelte oder verbundene Geräte bleiben immer in der Liste.
+    size_t prune_stale(int64_t now_us, int64_t max_age_us) {
+        std::vector<std::string> stale;
+        for (const auto& [addr, d] : devices) {
+            if (!d.paired && !d.connected && now_us - d.last_seen_us > max_age_us) {
+                stale.push_back(addr);
+            }
+        }
+        for (const auto& addr : stale) remove_address(addr);
+        return stale.size();
+    }
+
+    const BluetoothDevice* find(const std::string& address) const {
+        auto it = devices.find(address);
+        return it != devices.end() ? &it->second : nullptr;
+    }
+
+    const BluetoothDevice* find_by_path(const std::string& object_path) const {
+        auto p = path_to_address.find(object_path);
+        return p != path_to_address.end() ? find(p->second) : nullptr;
+    }
+
+    size_t size() const { return devices.size(); }
+    bool has_changes() const { return !pending.empty(); }
+
+    // Liefert die gesammelten Änderungen in Eintrittsreihenfolge und leert die Liste
+    std::vector<std::pair<std::string, BluetoothChange>> take_changes() {
+        std::vector<std::pair<std::string, BluetoothChange>> out;
+        out.reserve(pending_order.size());
+        for (const auto& addr : pending_order) {
+            auto it = pending.find(addr);
+            if (it == pending.end()) continue;
+            out.emplace_back(addr, it->second);
+            pending.erase(it);
+        }
+        pending.clear();
+        pending_order.clear();
+        return out;
+    }
+
+private:
+    std::unordered_map<std::string, BluetoothDevice> devices;
+    std::unordered_map<std::string, std::string> path_to_address;
+    std::unordered_set<std::string> aliased;
+    std::unordered_map<std::string, BluetoothChange> pending;
+    std::vector<std::string> pending_order;
+
+    void remove_address(const std::string& address) {
+        auto it = devices.find(address);
+        if (it == devices.end()) return;
+        path_to_address.erase(it->second.object_path);
+        aliased.erase(address);
+        devices.erase(it);
+        mark(address, BluetoothChange::Removed);
+    }
+
+    // Fasst mehrere Änderungen eines Frames zusammen:
+    // Added+Updated = Added, Added+Removed = nichts, Removed+Added = Updated
+    void mark(const std::string& address, BluetoothChange change) {
+        auto it = pending.find(address);
+        if (it == pending.end()) {
+            pending.emplace(address, change);
+            pending_order.push_back(address);
+            return;
+        }
+
+        BluetoothChange prev = it->second;
+        if (prev == BluetoothChange::Added && change == BluetoothChange::Removed) {
+            pending.erase(it); // Eintrag in pending_order wird beim Abholen übersprungen
+        } else if (prev == BluetoothChange::Removed && change == BluetoothChange::Added) {
+            it->second = BluetoothChange::Updated;
+        } else if (prev != BluetoothChange::Added) {
+            it->second = change;
+        }
+    }
+};
+
+#endif
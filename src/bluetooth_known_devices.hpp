@@ -0,0 +1,82 @@
+#ifndef BLUETOOTH_KNOWN_DEVICES_HPP
+#define BLUETOOTH_KNOWN_DEVICES_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdint>
+
+// Ein früher schon einmal verbundenes Gerät
+struct KnownDevice {
+    std::string address;
+    std::string name;
+    int connect_count = 0;
+    int64_t last_connected = 0; // Unix-Zeit in Sekunden
+};
+
+// Liste der bekannten Geräte für den Auto-Reconnect (CSV: Adresse;Name;Anzahl;Zeitpunkt)
+class KnownDeviceStore {
+public:
+    explicit KnownDeviceStore(std::string path = "assets/bt_known_devices.csv") : path(std::move(path)) {
+        load();
+    }
+
+    void load() {
+        devices.clear();
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            std::stringstream ss(line);
+            std::string addr, name, count, last;
+            if (std::getline(ss, addr, ';') && std::getline(ss, name, ';') &&
+                std::getline(ss, count, ';') && std::getline(ss, last, ';')) {
+                devices.push_back({addr, name, std::atoi(count.c_str()), std::atoll(last.c_str())});
+            }
+        }
+    }
+
+    void save() const {
+        std::ofstream file(path, std::ios::trunc);
+        for (const auto& d : devices) {
+            file << d.address << ";" << d.name << ";" << d.connect_count << ";" << d.last_connected << "\n";
+        }
+    }
+
+    void record_connected(const std::string& address, const std::string& name, int64_t now) {
+        auto it = std::find_if(devices.begin(), devices.end(), [&](const KnownDevice& d) { return d.address == address; });
+        if (it == devices.end()) {
+            devices.push_back({address, name, 0, 0});
+            it = devices.end() - 1;
+        }
+        it->connect_count++;
+        it->last_connected = now;
+        if (!name.empty()) {
+            it->name = name;
+            std::replace(it->name.begin(), it->name.end(), ';', ' ');
+        }
+        save();
+    }
+
+    // Reihenfolge für den Reconnect: zuletzt verbundene zuerst, bei Gleichstand die häufigeren
+    std::vector<KnownDevice> ranked(size_t max_count) const {
+        std::vector<KnownDevice> list = devices;
+        std::sort(list.begin(), list.end(), [](const KnownDevice& a, const KnownDevice& b) {
+            if (a.last_connected != b.last_connected) return a.last_connected > b.last_connected;
+            return a.connect_count > b.connect_count;
+        });
+        if (list.size() > max_count) list.resize(max_count);
+        return list;
+    }
+
+    bool contains(const std::string& address) const {
+        return std::any_of(devices.begin(), devices.end(), [&](const KnownDevice& d) { return d.address == address; });
+    }
+
+private:
+    std::string path;
+    std::vector<KnownDevice> devices;
+};
+
+#endif
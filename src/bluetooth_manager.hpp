@@ -1,184 +1,143 @@
 #ifndef BLUETOOTH_MANAGER_HPP
 #define BLUETOOTH_MANAGER_HPP
 
-#include <gio/gio.h>
 #include <gtk/gtk.h>
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
 
-// Struktur für ein gefundenes Gerät
-struct BluetoothDevice {
-    std::string address;
-    std::string name;
-    bool paired;
-    bool connected;
-};
+#include "bluetooth_tracker.hpp"
+#include "metrics.hpp"
 
+// Geräteliste im UI. Die BlueZ-Seite (Signale, Modell, Reconnect) liegt im BluetoothTracker.
 class BluetoothManager {
 private:
-    GDBusConnection *connection;
-    GtkListBox *ui_list; // Referenz auf die Liste im UI
+    GtkListView *ui_list;        // Referenz auf die Liste im UI
+    GtkStringList *ui_model;     // Adressen in Anzeigereihenfolge, Details kommen aus dem Modell
+    std::vector<std::string> ui_order; // Spiegel von ui_model (Position -> Adresse)
+    std::unordered_map<std::string, guint> ui_position; // Adresse -> Position in ui_order
+    bool flush_scheduled = false;
+    BluetoothTracker tracker;
 
 public:
-    BluetoothManager(GtkListBox *listbox) : ui_list(listbox) {
-        GError *error = nullptr;
-        connection = g_bus_get_sync(G_BUS_TYPE_SYSTEM, nullptr, &error);
-        
-        if (error) {
-            g_printerr("Fehler beim Verbinden mit D-Bus: %s\n", error->message);
-            g_error_free(error);
-        } else {
-            setup_signals();
-        }
+    // start_us: Startzeitpunkt der App (g_get_monotonic_time) für die Reconnect-Metrik,
+    // live = false beim Replay (nur replay(), kein D-Bus)
+    BluetoothManager(GtkListView *listview, int64_t start_us, bool live = true)
+        : ui_list(listview),
+          tracker(start_us, [this]() { schedule_flush(); }, "assets/bt_known_devices.csv", live) {
+        ui_model = gtk_string_list_new(nullptr);
+        setup_view();
     }
 
-    void start_discovery() {
-        if (!connection) return;
-
-        g_print("Bluetooth: Sende StartDiscovery Signal...\n");
-
-        g_dbus_connection_call(
-            connection,
-            "org.bluez",
-            "/org/bluez/hci0",
-            "org.bluez.Adapter1",
-            "StartDiscovery",
-            nullptr, // Hier war der Absturzgrund: nullptr ist oft okay, aber GVariant ist strikt
-            nullptr, // Erwarteter Rückgabetyp (GVariantType*)
-            G_DBUS_CALL_FLAGS_NONE,
-            -1,
-            nullptr,
-            [](GObject* source, GAsyncResult* res, gpointer) {
-                GError *local_error = nullptr;
-                // WICHTIG: Ergebnis abholen, sonst bleibt der Call im Speicher hängen
-                GVariant *result = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, &local_error);
-                
-                if (local_error) {
-                    g_printerr("Discovery Fehler: %s\n", local_error->message);
-                    g_error_free(local_error);
-                } else {
-                    g_print("Bluetooth: Scan läuft.\n");
-                    g_variant_unref(result);
-                }
-            },
-            nullptr
-        );
-    }
+    void start_discovery() { tracker.start_discovery(); }
 
-    // Meldet sich für Signale an, wenn neue Geräte auftauchen
-    void setup_signals() {
-        g_dbus_connection_signal_subscribe(
-            connection,
-            "org.bluez",
-            "org.freedesktop.DBus.ObjectManager",
-            "InterfacesAdded",
-            nullptr, // Objekt-Pfad egal
-            nullptr,
-            G_DBUS_SIGNAL_FLAGS_NONE,
-            on_interface_added,
-            this, // Wir übergeben die Instanz
-            nullptr
-        );
-    }
-
-    void pair_device(const std::string& address) {
-        if (!connection) return;
-
-        // MAC-Adresse für D-Bus Pfad formatieren (Doppelpunkte zu Unterstrichen)
-        std::string path_addr = address;
-        for (auto &c : path_addr) if (c == ':') c = '_';
-        std::string device_path = "/org/bluez/hci0/dev_" + path_addr;
-
-        g_print("D-Bus Call: Pair @ %s\n", device_path.c_str());
-
-        g_dbus_connection_call(
-            connection, "org.bluez", device_path.c_str(), "org.bluez.Device1",
-            "Pair", nullptr, nullptr, G_DBUS_CALL_FLAGS_NONE, -1, nullptr,
-            [](GObject* source, GAsyncResult* res, gpointer) {
-                GError *err = nullptr;
-                g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, &err);
-                if (err) {
-                    g_printerr("Pairing fehlgeschlagen: %s\n", err->message);
-                    g_error_free(err);
-                } else {
-                    g_print("Pairing erfolgreich! Verbinde...\n");
-                    // Nach dem Pairing folgt meist automatisch 'Connect'
-                }
-            }, nullptr);
+    // Abgespielte BlueZ-Ereignisse (input_replay.hpp): dieselben Pfade wie die D-Bus-Signale
+    void replay(const std::string& object_path, const BluetoothDeviceDelta& delta, bool removed) {
+        tracker.replay(object_path, delta, removed);
     }
 
 private:
-    void add_device_to_ui(const std::string& name, const std::string& address) {
-        GtkWidget *row = gtk_list_box_row_new();
-        
-        // Wir speichern die MAC-Adresse als String am Row-Objekt
-        g_object_set_data_full(G_OBJECT(row), "dev_addr", g_strdup(address.c_str()), g_free);
-
-        GtkWidget *box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 15);
-        GtkWidget *label_name = gtk_label_new(name.c_str());
-        GtkWidget *label_addr = gtk_label_new(address.c_str());
-
-        gtk_widget_set_hexpand(label_name, TRUE);
-        gtk_widget_set_halign(label_name, GTK_ALIGN_START);
-        gtk_widget_add_css_class(label_addr, "bt-address-dimmed");
-
-        gtk_box_append(GTK_BOX(box), label_name);
-        gtk_box_append(GTK_BOX(box), label_addr);
-        gtk_list_box_row_set_child(GTK_LIST_BOX_ROW(row), box);
+    // --- UI ---
+
+    void setup_view() {
+        GtkListItemFactory *factory = gtk_signal_list_item_factory_new();
+
+        g_signal_connect(factory, "setup", G_CALLBACK(+[](GtkSignalListItemFactory*, GtkListItem *item, gpointer) {
+            GtkWidget *box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 15);
+            GtkWidget *label_name = gtk_label_new(nullptr);
+            GtkWidget *label_state = gtk_label_new(nullptr);
+            GtkWidget *label_addr = gtk_label_new(nullptr);
+
+            gtk_widget_set_hexpand(label_name, TRUE);
+            gtk_widget_set_halign(label_name, GTK_ALIGN_START);
+            gtk_widget_add_css_class(label_state, "bt-address-dimmed");
+            gtk_widget_add_css_class(label_addr, "bt-address-dimmed");
+
+            gtk_box_append(GTK_BOX(box), label_name);
+            gtk_box_append(GTK_BOX(box), label_state);
+            gtk_box_append(GTK_BOX(box), label_addr);
+            gtk_list_item_set_child(item, box);
+        }), nullptr);
+
+        g_signal_connect(factory, "bind", G_CALLBACK(+[](GtkSignalListItemFactory*, GtkListItem *item, gpointer data) {
+            BluetoothManager *self = static_cast<BluetoothManager*>(data);
+            const char *address = gtk_string_object_get_string(GTK_STRING_OBJECT(gtk_list_item_get_item(item)));
+            const BluetoothDevice *d = self->tracker.devices().find(address);
+            if (!d) return;
+
+            GtkWidget *label_name = gtk_widget_get_first_child(gtk_list_item_get_child(item));
+            GtkWidget *label_state = gtk_widget_get_next_sibling(label_name);
+            GtkWidget *label_addr = gtk_widget_get_next_sibling(label_state);
+
+            char state[64];
+            if (d->connected) snprintf(state, sizeof(state), "verbunden");
+            else if (d->has_rssi) snprintf(state, sizeof(state), "%d dBm", d->rssi);
+            else snprintf(state, sizeof(state), "%s", d->paired ? "gekoppelt" : "");
+
+            gtk_label_set_text(GTK_LABEL(label_name), d->name.c_str());
+            gtk_label_set_text(GTK_LABEL(label_state), state);
+            gtk_label_set_text(GTK_LABEL(label_addr), d->address.c_str());
+        }), this);
+
+        GtkNoSelection *selection = gtk_no_selection_new(G_LIST_MODEL(ui_model));
+        gtk_list_view_set_model(ui_list, GTK_SELECTION_MODEL(selection));
+        gtk_list_view_set_factory(ui_list, factory);
+        g_object_unref(selection);
+        g_object_unref(factory);
+
+        gtk_list_view_set_single_click_activate(ui_list, TRUE);
+        g_signal_connect(ui_list, "activate", G_CALLBACK(+[](GtkListView*, guint position, gpointer data) {
+            BluetoothManager *self = static_cast<BluetoothManager*>(data);
+            if (position < self->ui_order.size()) {
+                self->tracker.pair_device(self->ui_order[position]);
+            }
+        }), this);
+    }
 
-        gtk_list_box_append(ui_list, row);
+    // Maximal ein UI-Update pro Frame, egal wie viele Signale eintreffen
+    void schedule_flush() {
+        if (flush_scheduled || !tracker.devices().has_changes()) return;
+        flush_scheduled = true;
+        gtk_widget_add_tick_callback(GTK_WIDGET(ui_list), [](GtkWidget*, GdkFrameClock*, gpointer data) -> gboolean {
+            static_cast<BluetoothManager*>(data)->flush_changes();
+            return G_SOURCE_REMOVE;
+        }, this, nullptr);
     }
 
-    static void on_interface_added(GDBusConnection*, const gchar*, const gchar*, 
-                               const gchar*, const gchar*, GVariant *parameters, 
-                               gpointer user_data) {
-        BluetoothManager *self = static_cast<BluetoothManager*>(user_data);
-        
-        const gchar *object_path;
-        GVariantIter *interfaces;
-
-        // Entpacken des Tupels: (ObjectPath, Dict von Interfaces)
-        g_variant_get(parameters, "(&oa{sa{sv}})", &object_path, &interfaces);
-
-        const gchar *interface_name;
-        GVariantIter *properties_iter;
-
-        // Wir suchen in den Interfaces nach "org.bluez.Device1"
-        while (g_variant_iter_next(interfaces, "{&sa{sv}}", &interface_name, &properties_iter)) {
-            if (g_strcmp0(interface_name, "org.bluez.Device1") == 0) {
-                const gchar *name = "Unbekanntes Gerät";
-                const gchar *address = "??:??:??:??:??:??";
-                
-                const gchar *key;
-                GVariant *value;
-
-                // Wir iterieren durch die Eigenschaften des Geräts
-                while (g_variant_iter_next(properties_iter, "{&sv}", &key, &value)) {
-                    if (g_strcmp0(key, "Alias") == 0 || (g_strcmp0(key, "Name") == 0 && g_strcmp0(name, "Unbekanntes Gerät") == 0)) {
-                        name = g_variant_get_string(value, nullptr);
-                    } else if (g_strcmp0(key, "Address") == 0) {
-                        address = g_variant_get_string(value, nullptr);
-                    }
-                    g_variant_unref(value);
-                }
-
-                g_print("Bluetooth: Gerät erkannt -> %s [%s]\n", name, address);
-
-                // UI-Update sicher im Main-Thread ausführen
-                struct DevData { BluetoothManager* mgr; std::string n; std::string a; };
-                DevData* d = new DevData{self, name, address};
-
-                g_idle_add((GSourceFunc)+[](gpointer data) -> gboolean {
-                    DevData* d = static_cast<DevData*>(data);
-                    d->mgr->add_device_to_ui(d->n, d->a);
-                    delete d;
-                    return FALSE;
-                }, d);
+    void flush_changes() {
+        static Gauge& devices = MetricsRegistry::instance().gauge("caros_bt_devices", "Geräte im Bluetooth-Modell");
+        flush_scheduled = false;
+        std::vector<guint> removed;
+        for (const auto& [address, change] : tracker.devices().take_changes()) {
+            auto it = ui_position.find(address);
+            if (change == BluetoothChange::Added && it == ui_position.end()) {
+                ui_position.emplace(address, static_cast<guint>(ui_order.size()));
+                ui_order.push_back(address);
+                gtk_string_list_append(ui_model, address.c_str());
+            } else if (change == BluetoothChange::Removed && it != ui_position.end()) {
+                removed.push_back(it->second);
+                ui_position.erase(it);
+            } else if (it != ui_position.end()) {
+                // Gleiches Element ersetzen -> items-changed -> Zeile wird neu gebunden
+                const char *items[] = {address.c_str(), nullptr};
+                gtk_string_list_splice(ui_model, it->second, 1, items);
             }
-            g_variant_iter_free(properties_iter); // Wichtig: Den inneren Iterator freigeben
         }
-        g_variant_iter_free(interfaces);
+        if (!removed.empty()) remove_rows(removed);
+        devices.set(static_cast<double>(tracker.devices().size()));
+    }
+
+    // Entfernt die Zeilen von hinten nach vorn und nummeriert danach einmal ab der ersten neu
+    void remove_rows(std::vector<guint>& positions) {
+        std::sort(positions.begin(), positions.end(), std::greater<guint>());
+        for (guint pos : positions) {
+            ui_order.erase(ui_order.begin() + pos);
+            gtk_string_list_remove(ui_model, pos);
+        }
+        for (guint pos = positions.back(); pos < ui_order.size(); pos++) ui_position[ui_order[pos]] = pos;
     }
 };
 
-#endif
\ No newline at end of file
+#endif
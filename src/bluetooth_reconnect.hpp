@@ -0,0 +1,257 @@
+#ifndef BLUETOOTH_RECONNECT_HPP
+#define BLUETOOTH_RECONNECT_HPP
+
+#include <gio/gio.h>
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+#include "bluetooth_known_devices.hpp"
+#include "metrics.hpp"
+#include "logger.hpp"
+
+// Verbindet nach dem Start automatisch das zuletzt genutzte Telefon.
+// Die bekannten Geräte werden parallel per Device1.Connect angefragt (ohne Scan).
+// Erst wenn alle fehlschlagen, läuft eine kurze, gefilterte Suche nach genau diesen Geräten.
+class BluetoothReconnector {
+public:
+    using PathLookup = std::function<std::string(const std::string&)>;
+    using ConnectedLookup = std::function<bool(const std::string&)>;
+
+    static constexpr size_t MAX_PARALLEL = 3;
+    static constexpr int CONNECT_TIMEOUT_MS = 8000;
+    static constexpr guint SEARCH_TIMEOUT_S = 10;
+
+    BluetoothReconnector(KnownDeviceStore& store, int64_t start_us) : store(store), start_us(start_us) {}
+
+    ~BluetoothReconnector() {
+        if (search_timeout_id) g_source_remove(search_timeout_id);
+        if (cancellable) {
+            g_cancellable_cancel(cancellable);
+            g_object_unref(cancellable);
+        }
+    }
+
+    BluetoothReconnector(const BluetoothReconnector&) = delete;
+    BluetoothReconnector& operator=(const BluetoothReconnector&) = delete;
+
+    // is_connected: Stand des Gerätemodells (Connected=true aus GetManagedObjects)
+    void start(GDBusConnection *conn, const std::string& adapter, PathLookup lookup, ConnectedLookup is_connected) {
+        connection = conn;
+        adapter_path = adapter;
+        path_lookup = std::move(lookup);
+        connected_lookup = std::move(is_connected);
+
+        candidates = store.ranked(MAX_PARALLEL);
+        if (candidates.empty()) {
+            state = State::Done;
+            return;
+        }
+
+        // Telefon hat sich schon selbst verbunden (vor dem Start der App oder schneller als wir)
+        for (const auto& d : candidates) {
+            if (!already_connected(d.address)) continue;
+            state = State::Connecting;
+            finish(d.address);
+            return;
+        }
+
+        state = State::Connecting;
+        cancellable = g_cancellable_new();
+        for (const auto& d : candidates) {
+            connect(d.address);
+        }
+    }
+
+    // Während der Suche: ein bekanntes Gerät ist in Reichweite aufgetaucht
+    void on_device_seen(const std::string& address) {
+        if (state != State::Searching) return;
+        if (std::find(attempted_in_search.begin(), attempted_in_search.end(), address) != attempted_in_search.end()) return;
+        if (!is_candidate(address)) return;
+
+        attempted_in_search.push_back(address);
+        connect(address);
+    }
+
+    // Ein Gerät meldet Connected=true (auch wenn das Telefon selbst verbunden hat)
+    void on_connected(const std::string& address) {
+        if (state == State::Connecting || state == State::Searching) {
+            finish(address);
+        }
+    }
+
+    // Zeit vom Programmstart bis zur Verbindung, -1 solange nichts verbunden ist
+    int64_t time_to_connect_ms() const { return connected_after_ms; }
+
+private:
+    enum class State { Idle, Connecting, Searching, Done };
+
+    struct Attempt {
+        BluetoothReconnector *self;
+        std::string address;
+    };
+
+    KnownDeviceStore& store;
+    int64_t start_us;
+    GDBusConnection *connection = nullptr;
+    GCancellable *cancellable = nullptr;
+    std::string adapter_path;
+    PathLookup path_lookup;
+    ConnectedLookup connected_lookup;
+    State state = State::Idle;
+    std::vector<KnownDevice> candidates;
+    std::vector<std::string> attempted_in_search;
+    int pending = 0;
+    guint search_timeout_id = 0;
+    int64_t connected_after_ms = -1;
+
+    bool is_candidate(const std::string& address) const {
+        return std::any_of(candidates.begin(), candidates.end(), [&](const KnownDevice& d) { return d.address == address; });
+    }
+
+    std::string device_path(const std::string& address) const {
+        std::string path = path_lookup ? path_lookup(address) : "";
+        if (!path.empty()) return path;
+
+        // Noch nicht im Modell: Pfad nach BlueZ-Schema aus der Adresse bilden
+        std::string path_addr = address;
+        for (auto &c : path_addr) if (c == ':') c = '_';
+        return adapter_path + "/dev_" + path_addr;
+    }
+
+    bool already_connected(const std::string& address) const {
+        return connected_lookup && connected_lookup(address);
+    }
+
+    // BlueZ antwortet so, wenn das Gerät zwischen Anfrage und Connect selbst verbunden hat
+    static bool is_already_connected(const GError *err) {
+        if (!g_dbus_error_is_remote_error(err)) return false;
+        gchar *name = g_dbus_error_get_remote_error(err);
+        bool already = g_strcmp0(name, "org.bluez.Error.AlreadyConnected") == 0;
+        g_free(name);
+        return already;
+    }
+
+    void connect(const std::string& address) {
+        if (already_connected(address)) {
+            on_connected(address);
+            return;
+        }
+        std::string path = device_path(address);
+        LOG_INFO("Bluetooth", "Reconnect-Versuch -> {}", address);
+        pending++;
+
+        g_dbus_connection_call(
+            connection, "org.bluez", path.c_str(), "org.bluez.Device1",
+            "Connect", nullptr, nullptr, G_DBUS_CALL_FLAGS_NONE,
+            CONNECT_TIMEOUT_MS, cancellable,
+            [](GObject* source, GAsyncResult* res, gpointer data) {
+                Attempt *a = static_cast<Attempt*>(data);
+                GError *err = nullptr;
+                GVariant *result = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, &err);
+                // Abgebrochen: entweder verbunden (finish) oder der Reconnector ist schon zerstört
+                if (err && g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+                    g_error_free(err);
+                    delete a;
+                    return;
+                }
+                a->self->pending--;
+
+                if (err && is_already_connected(err)) {
+                    g_error_free(err);
+                    a->self->on_connected(a->address);
+                } else if (err) {
+                    LOG_WARN("Bluetooth", "Reconnect zu {} fehlgeschlagen: {}", a->address, err->message);
+                    a->self->on_attempt_failed();
+                    g_error_free(err);
+                } else {
+                    g_variant_unref(result);
+                    a->self->on_connected(a->address);
+                }
+                delete a;
+            }, new Attempt{this, address});
+    }
+
+    void on_attempt_failed() {
+        if (pending > 0) return;
+        if (state == State::Connecting) {
+            start_filtered_search();
+        }
+    }
+
+    // Sucht nur BR/EDR-Geräte mit Audio-Profil (A2DP Source, HFP AG) statt eines vollen Scans
+    void start_filtered_search() {
+        state = State::Searching;
+
+        GVariantBuilder filter;
+        g_variant_builder_init(&filter, G_VARIANT_TYPE("a{sv}"));
+        g_variant_builder_add(&filter, "{sv}", "Transport", g_variant_new_string("bredr"));
+        const gchar *uuids[] = {
+            "0000110a-0000-1000-8000-00805f9b34fb", // A2DP Source
+            "0000111f-0000-1000-8000-00805f9b34fb", // Handsfree Audio Gateway
+            nullptr
+        };
+        g_variant_builder_add(&filter, "{sv}", "UUIDs", g_variant_new_strv(uuids, -1));
+
+        call_adapter("SetDiscoveryFilter", g_variant_new("(a{sv})", &filter));
+        call_adapter("StartDiscovery", nullptr);
+
+        search_timeout_id = g_timeout_add_seconds(SEARCH_TIMEOUT_S, [](gpointer data) -> gboolean {
+            BluetoothReconnector *self = static_cast<BluetoothReconnector*>(data);
+            self->search_timeout_id = 0;
+            if (self->state == State::Searching) {
+                LOG_INFO("Bluetooth", "Kein bekanntes Gerät in Reichweite.");
+                self->stop_search();
+                self->state = State::Done;
+            }
+            return G_SOURCE_REMOVE;
+        }, this);
+    }
+
+    void stop_search() {
+        if (search_timeout_id) {
+            g_source_remove(search_timeout_id);
+            search_timeout_id = 0;
+        }
+        call_adapter("StopDiscovery", nullptr);
+        // Filter zurücksetzen, damit die manuelle Suche wieder alles findet
+        GVariantBuilder empty;
+        g_variant_builder_init(&empty, G_VARIANT_TYPE("a{sv}"));
+        call_adapter("SetDiscoveryFilter", g_variant_new("(a{sv})", &empty));
+    }
+
+    void call_adapter(const char *method, GVariant *params) {
+        g_dbus_connection_call(
+            connection, "org.bluez", adapter_path.c_str(), "org.bluez.Adapter1",
+            method, params, nullptr, G_DBUS_CALL_FLAGS_NONE, -1, nullptr,
+            [](GObject* source, GAsyncResult* res, gpointer) {
+                GError *err = nullptr;
+                GVariant *result = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, &err);
+                if (err) {
+                    LOG_ERROR("Bluetooth", "Adapter-Aufruf fehlgeschlagen: {}", err->message);
+                    g_error_free(err);
+                } else {
+                    g_variant_unref(result);
+                }
+            }, nullptr);
+    }
+
+    void finish(const std::string& address) {
+        bool was_searching = (state == State::Searching);
+        state = State::Done;
+        connected_after_ms = (g_get_monotonic_time() - start_us) / 1000;
+        LOG_INFO("Bluetooth", "Auto-Reconnect zu {} nach {} ms", address, connected_after_ms);
+        MetricsRegistry::instance().gauge("caros_bt_reconnect_ms", "Zeit vom Start bis zum Auto-Reconnect (ms)")
+            .set(static_cast<double>(connected_after_ms));
+
+        // Restliche Versuche abbrechen, ein Telefon reicht
+        if (cancellable) {
+            g_cancellable_cancel(cancellable);
+            g_clear_object(&cancellable);
+        }
+        if (was_searching) stop_search();
+    }
+};
+
+#endif
@@ -0,0 +1,409 @@
+#ifndef BLUETOOTH_TRACKER_HPP
+#define BLUETOOTH_TRACKER_HPP
+
+#include <gio/gio.h>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+#include "bluetooth_device_model.hpp"
+#include "bluetooth_known_devices.hpp"
+#include "bluetooth_reconnect.hpp"
+#include "input_trace.hpp"
+#include "metrics.hpp"
+#include "logger.hpp"
+
+// BlueZ-Seite der Geräteliste (ohne GTK): folgt GetManagedObjects, InterfacesAdded/-Removed und
+// Device1-PropertiesChanged, hält das BluetoothDeviceModel aktuell und startet den Auto-Reconnect.
+// on_change läuft im Main-Thread nach jeder Änderung am Modell; das UI holt die Änderungen
+// dort gesammelt ab. Ohne GTK auch gegen ein gemocktes BlueZ testbar (test/dbus/).
+class BluetoothTracker {
+public:
+    using ChangeCallback = std::function<void()>;
+
+    // Geräte ohne Lebenszeichen verschwinden nach einer Minute aus der Liste
+    static constexpr int64_t STALE_AFTER_US = 60 * G_USEC_PER_SEC;
+
+    // start_us: Startzeitpunkt der App (g_get_monotonic_time) für die Reconnect-Metrik.
+    // live = false (CAROS_INPUT_REPLAY): kein Bus, keine Signale; Geräte kommen nur über replay()
+    BluetoothTracker(int64_t start_us, ChangeCallback on_change,
+                     std::string known_devices_path = "assets/bt_known_devices.csv", bool live = true)
+        : on_change(std::move(on_change)), known_devices(std::move(known_devices_path)),
+          reconnector(known_devices, start_us) {
+        cancellable = g_cancellable_new();
+        prune_source = g_timeout_add_seconds(10, [](gpointer data) -> gboolean {
+            static_cast<BluetoothTracker*>(data)->prune_stale(g_get_monotonic_time());
+            return G_SOURCE_CONTINUE;
+        }, this);
+        if (!live) {
+            LOG_INFO("Bluetooth", "Replay: BlueZ wird nicht angesprochen");
+            return;
+        }
+
+        // Asynchron verbinden, damit der Aufbau der UI nicht auf D-Bus wartet.
+        // CAROS_BT_BUS=session erlaubt Tests gegen ein gemocktes BlueZ auf dem Session-Bus.
+        GBusType bus_type = g_strcmp0(g_getenv("CAROS_BT_BUS"), "session") == 0
+                            ? G_BUS_TYPE_SESSION : G_BUS_TYPE_SYSTEM;
+        g_bus_get(bus_type, cancellable, [](GObject*, GAsyncResult* res, gpointer data) {
+            GError *error = nullptr;
+            GDBusConnection *conn = g_bus_get_finish(res, &error);
+            if (error) {
+                if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+                    LOG_ERROR("Bluetooth", "Fehler beim Verbinden mit D-Bus: {}", error->message);
+                }
+                g_error_free(error);
+                return;
+            }
+            BluetoothTracker *self = static_cast<BluetoothTracker*>(data);
+            self->connection = conn;
+            self->setup_signals();
+            self->load_managed_objects();
+        }, this);
+    }
+
+    ~BluetoothTracker() {
+        g_source_remove(prune_source);
+        g_cancellable_cancel(cancellable);
+        g_object_unref(cancellable);
+        if (connection) {
+            for (guint id : subscriptions) g_dbus_connection_signal_unsubscribe(connection, id);
+            g_object_unref(connection);
+        }
+    }
+
+    BluetoothTracker(const BluetoothTracker&) = delete;
+    BluetoothTracker& operator=(const BluetoothTracker&) = delete;
+
+    BluetoothDeviceModel& devices() { return model; }
+
+    // true, sobald GetManagedObjects ausgewertet und ein Adapter gefunden ist
+    bool ready() const { return !adapter_path.empty(); }
+
+    int64_t reconnect_ms() const { return reconnector.time_to_connect_ms(); }
+
+    void start_discovery() {
+        if (!connection || adapter_path.empty()) return;
+
+        LOG_INFO("Bluetooth", "Sende StartDiscovery Signal...");
+
+        g_dbus_connection_call(
+            connection,
+            "org.bluez",
+            adapter_path.c_str(),
+            "org.bluez.Adapter1",
+            "StartDiscovery",
+            nullptr, // Hier war der Absturzgrund: nullptr ist oft okay, aber GVariant ist strikt
+            nullptr, // Erwarteter Rückgabetyp (GVariantType*)
+            G_DBUS_CALL_FLAGS_NONE,
+            -1,
+            nullptr,
+            [](GObject* source, GAsyncResult* res, gpointer) {
+                GError *local_error = nullptr;
+                // WICHTIG: Ergebnis abholen, sonst bleibt der Call im Speicher hängen
+                GVariant *result = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, &local_error);
+
+                if (local_error) {
+                    LOG_ERROR("Bluetooth", "Discovery Fehler: {}", local_error->message);
+                    g_error_free(local_error);
+                } else {
+                    LOG_INFO("Bluetooth", "Scan läuft.");
+                    g_variant_unref(result);
+                }
+            },
+            nullptr
+        );
+    }
+
+    void pair_device(const std::string& address) {
+        const BluetoothDevice *d = model.find(address);
+        if (!connection || !d) return;
+        std::string device_path = d->object_path;
+
+        LOG_INFO("Bluetooth", "D-Bus Call: Pair @ {}", device_path);
+
+        g_dbus_connection_call(
+            connection, "org.bluez", device_path.c_str(), "org.bluez.Device1",
+            "Pair", nullptr, nullptr, G_DBUS_CALL_FLAGS_NONE, -1, nullptr,
+            [](GObject* source, GAsyncResult* res, gpointer) {
+                GError *err = nullptr;
+                g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, &err);
+                if (err) {
+                    LOG_ERROR("Bluetooth", "Pairing fehlgeschlagen: {}", err->message);
+                    g_error_free(err);
+                } else {
+                    LOG_INFO("Bluetooth", "Pairing erfolgreich! Verbinde...");
+                    // Nach dem Pairing folgt meist automatisch 'Connect'
+                }
+            }, nullptr);
+    }
+
+    // Abgespielte BlueZ-Ereignisse (input_replay.hpp): dieselben Pfade wie die D-Bus-Signale
+    void replay(const std::string& object_path, const BluetoothDeviceDelta& delta, bool removed) {
+        if (removed) remove_device(object_path.c_str());
+        else apply_delta(object_path.c_str(), delta);
+        changed();
+    }
+
+    // Entfernt Geräte, die seit STALE_AFTER_US nichts gemeldet haben (alle 10 s aus dem Timer)
+    size_t prune_stale(int64_t now_us) {
+        size_t removed = model.prune_stale(now_us, STALE_AFTER_US);
+        if (removed > 0) changed();
+        return removed;
+    }
+
+private:
+    ChangeCallback on_change;
+    GDBusConnection *connection = nullptr;
+    GCancellable *cancellable = nullptr; // bricht beim Zerstören alle eigenen Aufrufe ab
+    std::string adapter_path;    // erster Adapter aus GetManagedObjects (meist /org/bluez/hci0)
+    std::vector<guint> subscriptions;
+    guint prune_source = 0;
+    BluetoothDeviceModel model;
+    KnownDeviceStore known_devices;
+    BluetoothReconnector reconnector;
+    std::unordered_set<std::string> fetching; // Pfade mit laufendem Properties.GetAll
+
+    struct Fetch {
+        BluetoothTracker *self;
+        std::string path;
+    };
+
+    void changed() {
+        if (on_change) on_change();
+    }
+
+    static void count_signal() {
+        static Counter& signals = MetricsRegistry::instance().counter("caros_bt_dbus_signals_total", "Empfangene BlueZ-Signale");
+        signals.inc();
+    }
+
+    // Meldet sich für Signale an: neue Geräte, entfernte Geräte und Eigenschaftsänderungen
+    void setup_signals() {
+        subscriptions.push_back(g_dbus_connection_signal_subscribe(
+            connection,
+            "org.bluez",
+            "org.freedesktop.DBus.ObjectManager",
+            "InterfacesAdded",
+            nullptr, // Objekt-Pfad egal
+            nullptr,
+            G_DBUS_SIGNAL_FLAGS_NONE,
+            on_interface_added,
+            this, // Wir übergeben die Instanz
+            nullptr
+        ));
+
+        subscriptions.push_back(g_dbus_connection_signal_subscribe(
+            connection, "org.bluez", "org.freedesktop.DBus.ObjectManager", "InterfacesRemoved",
+            nullptr, nullptr, G_DBUS_SIGNAL_FLAGS_NONE, on_interface_removed, this, nullptr));
+
+        // arg0 filtert direkt im Bus auf Device1 (RSSI, Connected, Paired, Alias ...)
+        subscriptions.push_back(g_dbus_connection_signal_subscribe(
+            connection, "org.bluez", "org.freedesktop.DBus.Properties", "PropertiesChanged",
+            nullptr, "org.bluez.Device1", G_DBUS_SIGNAL_FLAGS_NONE, on_properties_changed, this, nullptr));
+    }
+
+    // Übernimmt die bereits bekannten Geräte (gekoppelt oder noch im BlueZ-Cache),
+    // sucht den Adapter und startet danach den Auto-Reconnect
+    void load_managed_objects() {
+        g_dbus_connection_call(
+            connection, "org.bluez", "/", "org.freedesktop.DBus.ObjectManager",
+            "GetManagedObjects", nullptr, G_VARIANT_TYPE("(a{oa{sa{sv}}})"),
+            G_DBUS_CALL_FLAGS_NONE, -1, cancellable,
+            [](GObject* source, GAsyncResult* res, gpointer data) {
+                GError *err = nullptr;
+                GVariant *result = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, &err);
+                if (err) {
+                    if (!g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+                        LOG_ERROR("Bluetooth", "GetManagedObjects fehlgeschlagen: {}", err->message);
+                    }
+                    g_error_free(err);
+                    return;
+                }
+                BluetoothTracker *self = static_cast<BluetoothTracker*>(data);
+
+                GVariantIter *objects;
+                const gchar *object_path;
+                GVariant *interfaces;
+                g_variant_get(result, "(a{oa{sa{sv}}})", &objects);
+                while (g_variant_iter_next(objects, "{&o@a{sa{sv}}}", &object_path, &interfaces)) {
+                    GVariant *adapter = g_variant_lookup_value(interfaces, "org.bluez.Adapter1", nullptr);
+                    if (adapter) {
+                        if (self->adapter_path.empty()) self->adapter_path = object_path;
+                        g_variant_unref(adapter);
+                    }
+                    self->apply_interfaces(object_path, interfaces);
+                    g_variant_unref(interfaces);
+                }
+                g_variant_iter_free(objects);
+                g_variant_unref(result);
+                self->changed();
+
+                if (self->adapter_path.empty()) {
+                    LOG_ERROR("Bluetooth", "Kein Adapter gefunden.");
+                    return;
+                }
+                self->reconnector.start(self->connection, self->adapter_path, [self](const std::string& addr) {
+                    const BluetoothDevice *d = self->model.find(addr);
+                    return d ? d->object_path : std::string();
+                }, [self](const std::string& addr) {
+                    const BluetoothDevice *d = self->model.find(addr);
+                    return d && d->connected;
+                });
+            }, this);
+    }
+
+    // PropertiesChanged für einen Pfad, den das Modell nicht (mehr) kennt, z.B. nach
+    // prune_stale: Das Delta hat keine Adresse, also den vollen Stand bei BlueZ nachfragen
+    void fetch_device(const gchar *object_path) {
+        if (!fetching.insert(object_path).second) return; // Abfrage läuft schon
+        LOG_DEBUG("Bluetooth", "Unbekanntes Gerät {}, lese Eigenschaften nach", object_path);
+
+        g_dbus_connection_call(
+            connection, "org.bluez", object_path, "org.freedesktop.DBus.Properties",
+            "GetAll", g_variant_new("(s)", "org.bluez.Device1"), G_VARIANT_TYPE("(a{sv})"),
+            G_DBUS_CALL_FLAGS_NONE, -1, cancellable,
+            [](GObject* source, GAsyncResult* res, gpointer data) {
+                Fetch *f = static_cast<Fetch*>(data);
+                GError *err = nullptr;
+                GVariant *result = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, &err);
+                if (err) {
+                    if (!g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+                        // Objekt inzwischen verschwunden: InterfacesRemoved folgt bzw. ist schon da
+                        LOG_DEBUG("Bluetooth", "GetAll für {} fehlgeschlagen: {}", f->path, err->message);
+                        f->self->fetching.erase(f->path);
+                    }
+                    g_error_free(err);
+                    delete f;
+                    return;
+                }
+
+                BluetoothTracker *self = f->self;
+                self->fetching.erase(f->path);
+                GVariant *props;
+                g_variant_get(result, "(@a{sv})", &props);
+                self->apply_delta(f->path.c_str(), parse_device_properties(props, nullptr));
+                self->changed();
+                g_variant_unref(props);
+                g_variant_unref(result);
+                delete f;
+            }, new Fetch{this, object_path});
+    }
+
+    // Wertet ein a{sa{sv}} aus und übernimmt ein enthaltenes Device1 ins Modell
+    void apply_interfaces(const gchar *object_path, GVariant *interfaces) {
+        GVariant *props = g_variant_lookup_value(interfaces, "org.bluez.Device1", G_VARIANT_TYPE("a{sv}"));
+        if (!props) return;
+        apply_delta(object_path, parse_device_properties(props, nullptr));
+        g_variant_unref(props);
+    }
+
+    // Übernimmt ein Delta ins Modell und informiert den Reconnect über relevante Änderungen
+    void apply_delta(const gchar *object_path, const BluetoothDeviceDelta& delta) {
+        InputRecorder::instance().record_bluetooth(object_path, delta);
+        if (!model.apply(object_path, delta, g_get_monotonic_time())) return;
+        const BluetoothDevice *d = model.find_by_path(object_path);
+        if (!d) return;
+
+        if (delta.connected && *delta.connected) {
+            known_devices.record_connected(d->address, d->name, g_get_real_time() / G_USEC_PER_SEC);
+            reconnector.on_connected(d->address);
+        } else if (delta.rssi) {
+            reconnector.on_device_seen(d->address);
+        }
+    }
+
+    void remove_device(const gchar *object_path) {
+        InputRecorder::instance().record_bluetooth(object_path, {}, true);
+        model.remove_path(object_path);
+        fetching.erase(object_path);
+    }
+
+    static BluetoothDeviceDelta parse_device_properties(GVariant *props, const gchar **invalidated) {
+        BluetoothDeviceDelta delta;
+        GVariantIter iter;
+        const gchar *key;
+        GVariant *value;
+
+        g_variant_iter_init(&iter, props);
+        while (g_variant_iter_next(&iter, "{&sv}", &key, &value)) {
+            if (g_strcmp0(key, "Address") == 0) {
+                delta.address = g_variant_get_string(value, nullptr);
+            } else if (g_strcmp0(key, "Alias") == 0) {
+                delta.alias = g_variant_get_string(value, nullptr);
+            } else if (g_strcmp0(key, "Name") == 0) {
+                delta.name = g_variant_get_string(value, nullptr);
+            } else if (g_strcmp0(key, "Paired") == 0) {
+                delta.paired = g_variant_get_boolean(value);
+            } else if (g_strcmp0(key, "Connected") == 0) {
+                delta.connected = g_variant_get_boolean(value);
+            } else if (g_strcmp0(key, "RSSI") == 0) {
+                delta.rssi = g_variant_get_int16(value);
+            }
+            g_variant_unref(value);
+        }
+
+        // RSSI wird von BlueZ invalidiert, sobald das Gerät nicht mehr sendet
+        for (; invalidated && *invalidated; invalidated++) {
+            if (g_strcmp0(*invalidated, "RSSI") == 0) delta.rssi_invalidated = true;
+        }
+        return delta;
+    }
+
+    static void on_interface_added(GDBusConnection*, const gchar*, const gchar*,
+                               const gchar*, const gchar*, GVariant *parameters,
+                               gpointer user_data) {
+        BluetoothTracker *self = static_cast<BluetoothTracker*>(user_data);
+        count_signal();
+
+        const gchar *object_path;
+        GVariant *interfaces;
+
+        // Entpacken des Tupels: (ObjectPath, Dict von Interfaces)
+        g_variant_get(parameters, "(&o@a{sa{sv}})", &object_path, &interfaces);
+        self->apply_interfaces(object_path, interfaces);
+        g_variant_unref(interfaces);
+        self->changed();
+    }
+
+    static void on_interface_removed(GDBusConnection*, const gchar*, const gchar*,
+                                     const gchar*, const gchar*, GVariant *parameters,
+                                     gpointer user_data) {
+        BluetoothTracker *self = static_cast<BluetoothTracker*>(user_data);
+        count_signal();
+
+        const gchar *object_path;
+        const gchar **interfaces;
+        g_variant_get(parameters, "(&o^a&s)", &object_path, &interfaces);
+        if (g_strv_contains(interfaces, "org.bluez.Device1")) {
+            self->remove_device(object_path);
+            self->changed();
+        }
+        g_free(interfaces);
+    }
+
+    static void on_properties_changed(GDBusConnection*, const gchar*, const gchar *object_path,
+                                      const gchar*, const gchar*, GVariant *parameters,
+                                      gpointer user_data) {
+        BluetoothTracker *self = static_cast<BluetoothTracker*>(user_data);
+        count_signal();
+
+        const gchar *interface_name;
+        GVariant *changed;
+        const gchar **invalidated;
+        g_variant_get(parameters, "(&s@a{sv}^a&s)", &interface_name, &changed, &invalidated);
+
+        BluetoothDeviceDelta delta = parse_device_properties(changed, invalidated);
+        if (!delta.address && !self->model.find_by_path(object_path)) {
+            self->fetch_device(object_path);
+        } else {
+            self->apply_delta(object_path, delta);
+            self->changed();
+        }
+
+        g_variant_unref(changed);
+        g_free(invalidated);
+    }
+};
+
+#endif
@@ -0,0 +1,17 @@
+#include "encoder_decoder.hpp"
+
+EncoderDecoder::EncoderDecoder(unsigned pin_a, uint64_t min_interval_ns)
+    : pin_a(pin_a), min_interval_ns(min_interval_ns) {}
+
+bool EncoderDecoder::feed(const EncoderEdge& edge, bool& clockwise) {
+    if (edge.line != pin_a) return false;
+    if (seen && min_interval_ns > 0 && edge.timestamp_ns - last_ns < min_interval_ns) {
+        bounce_count++;
+        return false;
+    }
+    seen = true;
+    last_ns = edge.timestamp_ns;
+    clockwise = edge.b_active;
+    step_count++;
+    return true;
+}
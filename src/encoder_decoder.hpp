@@ -0,0 +1,35 @@
+#ifndef ENCODER_DECODER_HPP
+#define ENCODER_DECODER_HPP
+
+#include <cstdint>
+
+// Eine Flanke des Drehgebers, wie monitor_encoder() sie von libgpiod liest
+struct EncoderEdge {
+    unsigned line;         // GPIO-Offset der Flanke
+    uint64_t timestamp_ns; // Zeitstempel des Kernels
+    bool b_active;         // Pegel von Pin B beim Auslesen
+};
+
+// Wertet die steigenden Flanken von Pin A aus: ist Pin B dabei aktiv, dreht der Geber im
+// Uhrzeigersinn. Flanken, die näher als min_interval_ns an der letzten liegen, gelten als
+// Prellen (Rückfallebene für Kernel ohne Debounce; 0 = aus, der Kernel entprellt mit 5 ms).
+class EncoderDecoder {
+public:
+    explicit EncoderDecoder(unsigned pin_a, uint64_t min_interval_ns = 0);
+
+    // true = gültiger Schritt, Richtung in clockwise
+    bool feed(const EncoderEdge& edge, bool& clockwise);
+
+    uint64_t steps() const { return step_count; }
+    uint64_t bounces() const { return bounce_count; }
+
+private:
+    unsigned pin_a;
+    uint64_t min_interval_ns;
+    uint64_t last_ns = 0;
+    bool seen = false;
+    uint64_t step_count = 0;
+    uint64_t bounce_count = 0;
+};
+
+#endif
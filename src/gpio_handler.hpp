@@ -4,11 +4,43 @@
 #include <gpiod.hpp>
 #include <gtk/gtk.h>
 #include <chrono>
-#include <iostream>
 #include <functional>
 
+#include "encoder_decoder.hpp"
+#include "input_trace.hpp"
+#include "metrics.hpp"
+#include "logger.hpp"
+
 using EncoderCallback = std::function<void(bool, gpointer)>;
 
+// Gemeinsamer Eingang für Live- und abgespielte Flanken (input_replay.hpp): aufzeichnen,
+// auswerten und einen Schritt per Callback in den GTK Main-Loop schieben (Thread-Safety!)
+inline void handle_encoder_edge(EncoderDecoder& decoder, const EncoderEdge& edge, const EncoderCallback& callback, gpointer user_data) {
+    static Counter& events = MetricsRegistry::instance().counter("caros_encoder_events_total", "Drehgeber-Schritte");
+    static Histogram& dispatch = MetricsRegistry::instance().histogram("caros_encoder_dispatch_us", "Zeit vom Lesen des Events bis zum Callback im Main-Thread (us)");
+    InputRecorder::instance().record_encoder(edge);
+
+    bool clockwise = false;
+    if (!decoder.feed(edge, clockwise)) return;
+    events.inc();
+
+    struct CallbackWrapper {
+        EncoderCallback cb;
+        bool cw;
+        gpointer data;
+        int64_t read_us;
+    };
+    auto* wrapper = new CallbackWrapper{callback, clockwise, user_data, g_get_monotonic_time()};
+
+    g_idle_add([](gpointer d) -> gboolean {
+        auto* w = static_cast<CallbackWrapper*>(d);
+        dispatch.record(static_cast<uint64_t>(g_get_monotonic_time() - w->read_us));
+        w->cb(w->cw, w->data);
+        delete w;
+        return FALSE;
+    }, wrapper);
+}
+
 inline void monitor_encoder(int pinA, int pinB, EncoderCallback callback, gpointer user_data) {
     try {
         // 1. Einstellungen für die Leitungen festlegen
@@ -40,6 +72,8 @@ inline void monitor_encoder(int pinA, int pinB, EncoderCallback callback, gpoint
         // Buffer für Events vorab allozieren (Performance)
         gpiod::edge_event_buffer buffer(16);
 
+        EncoderDecoder decoder(static_cast<unsigned int>(pinA));
+
         while (true) {
             // Warten auf Events
             if (request.wait_edge_events(std::chrono::milliseconds(100))) {
@@ -50,29 +84,14 @@ inline void monitor_encoder(int pinA, int pinB, EncoderCallback callback, gpoint
                     if (event.line_offset() == static_cast<unsigned int>(pinA)) {
                         // Richtung prüfen über Pin B
                         auto val_b = request.get_value(static_cast<unsigned int>(pinB));
-                        
-                        bool clockwise = (val_b == gpiod::line::value::ACTIVE);
-                        
-                        // Callback in den GTK Main-Loop schieben (Thread-Safety!)
-                        struct CallbackWrapper {
-                            EncoderCallback cb;
-                            bool cw;
-                            gpointer data;
-                        };
-                        auto* wrapper = new CallbackWrapper{callback, clockwise, user_data};
-                        
-                        g_idle_add([](gpointer d) -> gboolean {
-                            auto* w = static_cast<CallbackWrapper*>(d);
-                            w->cb(w->cw, w->data);
-                            delete w;
-                            return FALSE;
-                        }, wrapper);
+                        EncoderEdge edge{event.line_offset(), event.timestamp_ns().ns(), val_b == gpiod::line::value::ACTIVE};
+                        handle_encoder_edge(decoder, edge, callback, user_data);
                     }
                 }
             }
         }
     } catch (const std::exception& e) {
-        std::cerr << "GPIO Fehler: " << e.what() << std::endl;
+        LOG_ERROR("GPIO", "Fehler: {}", e.what());
     }
 }
 
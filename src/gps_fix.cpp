@@ -0,0 +1,14 @@
+#include "gps_fix.hpp"
+
+#include <cmath>
+
+GPSData gps_data_from_report(const GpsReport& report) {
+    GPSData data;
+    data.fix = report.mode >= 2 && std::isfinite(report.latitude) && std::isfinite(report.longitude);
+    if (!data.fix) return data;
+    data.latitude = report.latitude;
+    data.longitude = report.longitude;
+    data.speed = std::isfinite(report.speed_ms) ? report.speed_ms * 3.6 : 0.0; // m/s in km/h
+    data.satellites = report.satellites_used;
+    return data;
+}
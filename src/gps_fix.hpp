@@ -0,0 +1,26 @@
+#ifndef GPS_FIX_HPP
+#define GPS_FIX_HPP
+
+#include <cstdint>
+
+struct GPSData {
+    double latitude = 0.0;
+    double longitude = 0.0;
+    double speed = 0.0; // km/h
+    int satellites = 0;
+    bool fix = false;
+};
+
+// Die Felder einer gpsd-Meldung, die CarOS auswertet (ohne Abhängigkeit von libgps)
+struct GpsReport {
+    int mode = 0;           // MODE_NOT_SEEN/NO_FIX = 0/1, MODE_2D = 2, MODE_3D = 3
+    double latitude = 0.0;
+    double longitude = 0.0;
+    double speed_ms = 0.0;  // m/s, wie von gpsd geliefert
+    int satellites_used = 0;
+};
+
+// Übersetzt eine Meldung in den Stand für die Oberfläche; ohne 2D-Fix bleibt nur fix = false
+GPSData gps_data_from_report(const GpsReport& report);
+
+#endif
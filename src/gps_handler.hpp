@@ -3,17 +3,14 @@
 
 #include <gps.h>
 #include <gtk/gtk.h>
-#include <iostream>
 #include <thread>
 #include <atomic>
 
-struct GPSData {
-    double latitude;
-    double longitude;
-    double speed;
-    int satellites;
-    bool fix;
-};
+#include "gps_fix.hpp"
+#include "input_trace.hpp"
+#include "metrics.hpp"
+#include "logger.hpp"
+#include "thread_registry.hpp"
 
 class GPSManager {
 public:
@@ -21,13 +18,28 @@ public:
     
     void start() {
         running = true;
-        worker_thread = std::thread(&GPSManager::update_loop, this);
+        worker_thread = ThreadRegistry::spawn("caros-gps", "gps", [this]() { update_loop(); });
     }
 
     GPSData get_latest_data() {
         return last_data.load();
     }
 
+    // Gemeinsamer Eingang für gpsd und abgespielte Meldungen (input_replay.hpp)
+    void apply_report(const GpsReport& report) {
+        static Counter& reports = MetricsRegistry::instance().counter("caros_gps_reports_total", "Von gpsd gelesene Meldungen");
+        static Counter& fixes = MetricsRegistry::instance().counter("caros_gps_fixes_total", "Meldungen mit 2D/3D-Fix");
+        static Gauge& satellites = MetricsRegistry::instance().gauge("caros_gps_satellites", "Für den Fix genutzte Satelliten");
+        InputRecorder::instance().record_gps(report);
+        GPSData current = gps_data_from_report(report);
+        reports.inc();
+        if (current.fix) {
+            fixes.inc();
+            satellites.set(current.satellites);
+        }
+        last_data.store(current);
+    }
+
 private:
     std::atomic<bool> running;
     std::thread worker_thread;
@@ -38,7 +50,7 @@ private:
         
         // Verbindung zum lokalen gpsd-Daemon
         if (gps_open("localhost", DEFAULT_GPSD_PORT, &gps_data) != 0) {
-            std::cerr << "GPS Fehler: gpsd nicht erreichbar." << std::endl;
+            LOG_ERROR("GPS", "gpsd nicht erreichbar.");
             return;
         }
 
@@ -47,15 +59,13 @@ private:
         while (running) {
             if (gps_waiting(&gps_data, 1000000)) { // 1 Sekunde Timeout
                 if (gps_read(&gps_data, NULL, 0) != -1) {
-                    GPSData current;
-                    current.fix = (gps_data.fix.mode >= MODE_2D);
-                    if (current.fix) {
-                        current.latitude = gps_data.fix.latitude;
-                        current.longitude = gps_data.fix.longitude;
-                        current.speed = gps_data.fix.speed * 3.6; // m/s in km/h
-                        current.satellites = gps_data.satellites_used;
-                    }
-                    last_data.store(current);
+                    GpsReport report;
+                    report.mode = gps_data.fix.mode;
+                    report.latitude = gps_data.fix.latitude;
+                    report.longitude = gps_data.fix.longitude;
+                    report.speed_ms = gps_data.fix.speed;
+                    report.satellites_used = gps_data.satellites_used;
+                    apply_report(report);
                 }
             }
         }
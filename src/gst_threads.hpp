@@ -0,0 +1,31 @@
+#ifndef GST_THREADS_HPP
+#define GST_THREADS_HPP
+
+#include <gst/gst.h>
+
+#include "thread_registry.hpp"
+
+// Meldet die Streaming-Threads einer Pipeline (Task-Threads der Elemente und den
+// Ringbuffer-Thread des Audio-Sinks) im ThreadRegistry an. GStreamer schickt dafür aus dem
+// neuen Thread selbst eine STREAM_STATUS-Nachricht (ENTER/LEAVE); der Sync-Handler läuft
+// genau in diesem Thread. Alle anderen Nachrichten gehen unverändert an den Bus-Watch.
+// role muss ein String-Literal sein (wird nicht kopiert).
+inline void register_streaming_threads(GstElement *pipeline, const char *role) {
+    if (!pipeline) return;
+    GstBus *bus = gst_element_get_bus(pipeline);
+    gst_bus_set_sync_handler(bus, [](GstBus*, GstMessage *msg, gpointer data) -> GstBusSyncReply {
+        if (GST_MESSAGE_TYPE(msg) != GST_MESSAGE_STREAM_STATUS) return GST_BUS_PASS;
+        GstStreamStatusType type;
+        GstElement *owner = nullptr;
+        gst_message_parse_stream_status(msg, &type, &owner);
+        if (type == GST_STREAM_STATUS_TYPE_ENTER) {
+            ThreadRegistry::instance().register_current("", static_cast<const char*>(data));
+        } else if (type == GST_STREAM_STATUS_TYPE_LEAVE) {
+            ThreadRegistry::instance().unregister_current();
+        }
+        return GST_BUS_PASS;
+    }, const_cast<char*>(role), nullptr);
+    gst_object_unref(bus);
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef INPUT_REPLAY_HPP
+#define INPUT_REPLAY_HPP
+
+#include <glib.h>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "input_trace.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+#include "thread_registry.hpp"
+
+// Empfänger der abgespielten Ereignisse. Drehgeber und GPS laufen wie live im Replay-Thread
+// (dort liefern sonst monitor_encoder bzw. der gpsd-Thread), Bluetooth und Wiedergabe im
+// Main-Thread (dort kommen sonst die D-Bus-Signale bzw. die Bus-/IPC-Meldungen an).
+struct InputSinks {
+    std::function<void(const EncoderEdge&)> encoder;
+    std::function<void(const GpsReport&)> gps;
+    std::function<void(const std::string& path, const BluetoothDeviceDelta& delta, bool removed)> bluetooth;
+    std::function<void(const StreamBusEvent&)> stream;
+    std::function<void()> finished; // Main-Thread, nach dem letzten Ereignis
+};
+
+// Spielt eine Trace-Datei (CAROS_INPUT_REPLAY) mit den aufgezeichneten Abständen ab, um den
+// Faktor speed beschleunigt (0 = ohne Pausen). Die Verspätung jedes Ereignisses gegenüber
+// dem Plan landet in caros_replay_lag_us, damit ein überlasteter Lauf erkennbar ist.
+class InputReplay {
+public:
+    InputReplay(std::vector<InputEvent> trace, double speed) : events(std::move(trace)), speed(speed) {}
+
+    size_t size() const { return events.size(); }
+
+    // Einmalig, nachdem alle Empfänger existieren (Fenster, Manager)
+    void start(InputSinks targets) {
+        sinks = std::move(targets);
+        ThreadRegistry::spawn("caros-replay", "background", [this]() { run(); }).detach();
+    }
+
+private:
+    std::vector<InputEvent> events;
+    double speed;
+    InputSinks sinks;
+
+    struct MainThreadEvent {
+        InputReplay *self;
+        InputEvent event;
+    };
+
+    void run() {
+        static Counter& replayed = MetricsRegistry::instance().counter("caros_replay_events_total", "Abgespielte Eingaben (CAROS_INPUT_REPLAY)");
+        static Histogram& lag = MetricsRegistry::instance().histogram("caros_replay_lag_us", "Verspätung abgespielter Eingaben gegenüber dem Trace (us)");
+        using clock = std::chrono::steady_clock;
+        LOG_INFO("Replay", "Spiele {} Eingaben ab (Geschwindigkeit {})", events.size(), speed);
+
+        auto begin = clock::now();
+        for (auto& e : events) {
+            auto due = begin + std::chrono::microseconds(replay_due_us(e.time_us, speed));
+            std::this_thread::sleep_until(due);
+            lag.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - due).count()));
+            replayed.inc();
+
+            switch (e.source) {
+                case InputSource::Encoder:
+                    if (sinks.encoder) sinks.encoder(e.encoder);
+                    break;
+                case InputSource::Gps:
+                    if (sinks.gps) sinks.gps(e.gps);
+                    break;
+                case InputSource::Bluetooth:
+                case InputSource::Stream:
+                    g_idle_add_full(G_PRIORITY_DEFAULT, +[](gpointer d) -> gboolean {
+                        auto *m = static_cast<MainThreadEvent*>(d);
+                        m->self->dispatch_main(m->event);
+                        delete m;
+                        return G_SOURCE_REMOVE;
+                    }, new MainThreadEvent{this, std::move(e)}, nullptr);
+                    break;
+            }
+        }
+
+        int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - begin).count();
+        LOG_INFO("Replay", "Trace abgespielt in {} ms", ms);
+        // Nach allen Bluetooth-/Wiedergabe-Ereignissen, die noch in der Main-Loop warten
+        g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, +[](gpointer d) -> gboolean {
+            auto *self = static_cast<InputReplay*>(d);
+            if (self->sinks.finished) self->sinks.finished();
+            return G_SOURCE_REMOVE;
+        }, this, nullptr);
+    }
+
+    void dispatch_main(const InputEvent& e) {
+        if (e.source == InputSource::Bluetooth) {
+            if (sinks.bluetooth) sinks.bluetooth(e.bt_path, e.bt, e.bt_removed);
+        } else if (sinks.stream) {
+            sinks.stream(e.stream);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,282 @@
+#include "input_trace.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include "metrics.hpp"
+
+namespace {
+
+constexpr const char *HEADER = "# caros-input-trace 1";
+constexpr int64_t FLUSH_INTERVAL_US = 100000; // Puffer höchstens alle 100 ms auf die Karte schreiben
+
+void append_escaped(std::string& out, const std::string& text) {
+    for (char c : text) {
+        if (c == '\t') out += "\\t";
+        else if (c == '\n') out += "\\n";
+        else if (c == '\\') out += "\\\\";
+        else out += c;
+    }
+}
+
+std::string unescape(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] != '\\' || i + 1 == text.size()) {
+            out += text[i];
+            continue;
+        }
+        char c = text[++i];
+        out += c == 't' ? '\t' : c == 'n' ? '\n' : c;
+    }
+    return out;
+}
+
+void append_number(std::string& out, double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.17g", v); // verlustfrei, damit ein Replay exakt dieselben Werte sieht
+    out += buf;
+}
+
+void append_field(std::string& out, const char *key, const std::string& value) {
+    out += '\t';
+    out += key;
+    out += '=';
+    append_escaped(out, value);
+}
+
+std::vector<std::string> split_tabs(const std::string& line) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true) {
+        size_t tab = line.find('\t', start);
+        fields.push_back(line.substr(start, tab == std::string::npos ? std::string::npos : tab - start));
+        if (tab == std::string::npos) return fields;
+        start = tab + 1;
+    }
+}
+
+bool to_int64(const std::string& s, int64_t& out) {
+    if (s.empty()) return false;
+    char *end = nullptr;
+    errno = 0;
+    long long v = std::strtoll(s.c_str(), &end, 10);
+    if (errno || *end) return false;
+    out = v;
+    return true;
+}
+
+bool to_double(const std::string& s, double& out) {
+    if (s.empty()) return false;
+    char *end = nullptr;
+    out = std::strtod(s.c_str(), &end);
+    return *end == '\0';
+}
+
+} // namespace
+
+std::string format_input_event(const InputEvent& e) {
+    std::string out = std::to_string(e.time_us);
+    switch (e.source) {
+        case InputSource::Encoder:
+            out += "\tenc\t" + std::to_string(e.encoder.line) + "\t" + std::to_string(e.encoder.timestamp_ns) + "\t" +
+                   (e.encoder.b_active ? "1" : "0");
+            break;
+        case InputSource::Gps:
+            out += "\tgps\t" + std::to_string(e.gps.mode) + "\t";
+            append_number(out, e.gps.latitude);
+            out += '\t';
+            append_number(out, e.gps.longitude);
+            out += '\t';
+            append_number(out, e.gps.speed_ms);
+            out += "\t" + std::to_string(e.gps.satellites_used);
+            break;
+        case InputSource::Bluetooth: {
+            out += e.bt_removed ? "\tbt-\t" : "\tbt\t";
+            append_escaped(out, e.bt_path);
+            if (e.bt_removed) break;
+            const BluetoothDeviceDelta& d = e.bt;
+            if (d.address) append_field(out, "addr", *d.address);
+            if (d.name) append_field(out, "name", *d.name);
+            if (d.alias) append_field(out, "alias", *d.alias);
+            if (d.paired) out += *d.paired ? "\tpaired=1" : "\tpaired=0";
+            if (d.connected) out += *d.connected ? "\tconnected=1" : "\tconnected=0";
+            if (d.rssi) out += "\trssi=" + std::to_string(*d.rssi);
+            if (d.rssi_invalidated) out += "\trssi=-";
+            break;
+        }
+        case InputSource::Stream:
+            switch (e.stream.kind) {
+                case StreamBusEvent::Kind::Title:
+                    out += "\ttitle\t";
+                    append_escaped(out, e.stream.text);
+                    break;
+                case StreamBusEvent::Kind::Buffering:
+                    out += "\tbuffer\t" + std::to_string(e.stream.percent) + "\t";
+                    append_number(out, e.stream.kbps);
+                    break;
+                case StreamBusEvent::Kind::Error:
+                    out += "\terror\t";
+                    append_escaped(out, e.stream.text);
+                    break;
+            }
+            break;
+    }
+    return out;
+}
+
+bool parse_input_event(const std::string& line, InputEvent& e) {
+    std::vector<std::string> f = split_tabs(line);
+    e = InputEvent{};
+    if (f.size() < 3 || !to_int64(f[0], e.time_us)) return false;
+    const std::string& kind = f[1];
+    int64_t n = 0;
+
+    if (kind == "enc") {
+        e.source = InputSource::Encoder;
+        int64_t ts = 0;
+        if (f.size() != 5 || !to_int64(f[2], n) || !to_int64(f[3], ts)) return false;
+        e.encoder = {static_cast<unsigned>(n), static_cast<uint64_t>(ts), f[4] == "1"};
+        return true;
+    }
+    if (kind == "gps") {
+        e.source = InputSource::Gps;
+        int64_t sats = 0;
+        if (f.size() != 7 || !to_int64(f[2], n) || !to_double(f[3], e.gps.latitude) ||
+            !to_double(f[4], e.gps.longitude) || !to_double(f[5], e.gps.speed_ms) || !to_int64(f[6], sats)) {
+            return false;
+        }
+        e.gps.mode = static_cast<int>(n);
+        e.gps.satellites_used = static_cast<int>(sats);
+        return true;
+    }
+    if (kind == "bt" || kind == "bt-") {
+        e.source = InputSource::Bluetooth;
+        e.bt_path = unescape(f[2]);
+        e.bt_removed = kind == "bt-";
+        for (size_t i = 3; i < f.size(); i++) {
+            size_t eq = f[i].find('=');
+            if (eq == std::string::npos) return false;
+            std::string key = f[i].substr(0, eq);
+            std::string value = unescape(f[i].substr(eq + 1));
+            if (key == "addr") e.bt.address = value;
+            else if (key == "name") e.bt.name = value;
+            else if (key == "alias") e.bt.alias = value;
+            else if (key == "paired") e.bt.paired = value == "1";
+            else if (key == "connected") e.bt.connected = value == "1";
+            else if (key == "rssi" && value == "-") e.bt.rssi_invalidated = true;
+            else if (key == "rssi" && to_int64(value, n)) e.bt.rssi = static_cast<int16_t>(n);
+            else return false;
+        }
+        return true;
+    }
+
+    e.source = InputSource::Stream;
+    if (kind == "title" || kind == "error") {
+        if (f.size() != 3) return false;
+        e.stream.kind = kind == "title" ? StreamBusEvent::Kind::Title : StreamBusEvent::Kind::Error;
+        e.stream.text = unescape(f[2]);
+        return true;
+    }
+    if (kind == "buffer") {
+        e.stream.kind = StreamBusEvent::Kind::Buffering;
+        if (f.size() != 4 || !to_int64(f[2], n) || !to_double(f[3], e.stream.kbps)) return false;
+        e.stream.percent = static_cast<int>(n);
+        return true;
+    }
+    return false;
+}
+
+bool load_input_trace(const std::string& path, std::vector<InputEvent>& events, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = path + " nicht lesbar";
+        return false;
+    }
+    std::string line;
+    size_t number = 0;
+    InputEvent e;
+    while (std::getline(in, line)) {
+        number++;
+        if (line.empty() || line[0] == '#') continue;
+        if (!parse_input_event(line, e)) {
+            error = path + ":" + std::to_string(number) + ": ungültige Zeile";
+            return false;
+        }
+        events.push_back(std::move(e));
+    }
+    return true;
+}
+
+bool InputRecorder::start(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file) return true;
+    file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+    std::fprintf(file, "%s\n", HEADER);
+    started = std::chrono::steady_clock::now();
+    last_flush_us = 0;
+    recording.store(true, std::memory_order_release);
+    return true;
+}
+
+void InputRecorder::stop() {
+    std::lock_guard<std::mutex> lock(mutex);
+    recording.store(false, std::memory_order_release);
+    if (file) std::fclose(file);
+    file = nullptr;
+}
+
+void InputRecorder::record(InputEvent e) {
+    static Counter& recorded = MetricsRegistry::instance().counter("caros_input_recorded_events_total", "Aufgezeichnete Eingaben (CAROS_INPUT_RECORD)");
+    if (!active()) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file) return;
+    // Zeit unter dem Lock, damit die Datei streng zeitlich sortiert bleibt
+    e.time_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count();
+    line = format_input_event(e);
+    line += '\n';
+    std::fwrite(line.data(), 1, line.size(), file);
+    if (e.time_us - last_flush_us >= FLUSH_INTERVAL_US) {
+        std::fflush(file);
+        last_flush_us = e.time_us;
+    }
+    recorded.inc();
+}
+
+void InputRecorder::record_encoder(const EncoderEdge& edge) {
+    if (!active()) return;
+    InputEvent e;
+    e.source = InputSource::Encoder;
+    e.encoder = edge;
+    record(std::move(e));
+}
+
+void InputRecorder::record_gps(const GpsReport& report) {
+    if (!active()) return;
+    InputEvent e;
+    e.source = InputSource::Gps;
+    e.gps = report;
+    record(std::move(e));
+}
+
+void InputRecorder::record_bluetooth(const std::string& path, const BluetoothDeviceDelta& delta, bool removed) {
+    if (!active()) return;
+    InputEvent e;
+    e.source = InputSource::Bluetooth;
+    e.bt_path = path;
+    e.bt = delta;
+    e.bt_removed = removed;
+    record(std::move(e));
+}
+
+void InputRecorder::record_stream(const StreamBusEvent& event) {
+    if (!active()) return;
+    InputEvent e;
+    e.source = InputSource::Stream;
+    e.stream = event;
+    record(std::move(e));
+}
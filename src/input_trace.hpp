@@ -0,0 +1,101 @@
+#ifndef INPUT_TRACE_HPP
+#define INPUT_TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "bluetooth_device_model.hpp"
+#include "encoder_decoder.hpp"
+#include "gps_fix.hpp"
+
+// Aufnahme und Wiedergabe aller Eingaben von außen: Drehgeber-Flanken, gpsd-Meldungen,
+// BlueZ-Geräteänderungen und die Meldungen der Wiedergabe (GStreamer-Bus bzw. Audio-Daemon).
+// Aufgezeichnet wird dort, wo Live- und abgespielte Eingaben gemeinsam ankommen, damit ein
+// Replay genau dieselben Pfade durchläuft (und selbst wieder aufgezeichnet werden kann).
+//
+// Trace-Datei: Text, eine Zeile pro Ereignis, Felder durch Tabulatoren getrennt:
+//   # caros-input-trace 1
+//   <µs seit Aufnahmebeginn> enc    <GPIO> <Kernel-Zeit ns> <Pin B 0/1>
+//   <µs>                     gps    <Modus> <Breite> <Länge> <m/s> <Satelliten>
+//   <µs>                     bt     <Objektpfad> [addr=.. name=.. alias=.. paired=0/1 connected=0/1 rssi=<dBm>|rssi=-]
+//   <µs>                     bt-    <Objektpfad>
+//   <µs>                     title  <Text>
+//   <µs>                     buffer <Prozent> <kbit/s>
+//   <µs>                     error  <Text>
+// Tabulator, Zeilenumbruch und Backslash in Texten werden als \t, \n und \\ geschrieben.
+
+enum class InputSource : uint8_t { Encoder, Gps, Bluetooth, Stream };
+
+// Meldung der Wiedergabe, wie sie beim RadioManager ankommt (lokal oder vom Daemon)
+struct StreamBusEvent {
+    enum class Kind : uint8_t { Title, Buffering, Error };
+    Kind kind = Kind::Title;
+    int percent = 0;
+    double kbps = -1.0; // Eingangsrate, -1 = unbekannt
+    std::string text;   // Titel bzw. Fehlermeldung
+};
+
+struct InputEvent {
+    int64_t time_us = 0; // seit Beginn der Aufnahme
+    InputSource source = InputSource::Encoder;
+    EncoderEdge encoder{};
+    GpsReport gps;
+    std::string bt_path;
+    BluetoothDeviceDelta bt;
+    bool bt_removed = false; // InterfacesRemoved für Device1
+    StreamBusEvent stream;
+};
+
+std::string format_input_event(const InputEvent& e);
+bool parse_input_event(const std::string& line, InputEvent& e);
+
+// Liest eine komplette Trace-Datei; bei Fehlern steht Zeile und Grund in error
+bool load_input_trace(const std::string& path, std::vector<InputEvent>& events, std::string& error);
+
+// Zeitpunkt (µs nach Replay-Start), zu dem ein Ereignis bei speed-facher Geschwindigkeit fällig
+// ist. speed <= 0: ohne Pausen, so schnell wie möglich.
+inline int64_t replay_due_us(int64_t trace_us, double speed) {
+    return speed > 0 ? static_cast<int64_t>(trace_us / speed) : 0;
+}
+
+// Schreibt Ereignisse aus allen Threads in eine Trace-Datei (CAROS_INPUT_RECORD).
+// Ohne start() kostet record() nur das Lesen eines atomaren Flags.
+class InputRecorder {
+public:
+    static InputRecorder& instance() {
+        // Absichtlich nie freigegeben: Threads dürfen bis zum Prozessende aufzeichnen
+        static InputRecorder *recorder = new InputRecorder();
+        return *recorder;
+    }
+
+    bool start(const std::string& path);
+    void stop();
+
+    bool active() const { return recording.load(std::memory_order_relaxed); }
+
+    // Setzt time_us selbst
+    void record(InputEvent e);
+
+    // Kurzformen für die Quellen
+    void record_encoder(const EncoderEdge& edge);
+    void record_gps(const GpsReport& report);
+    void record_bluetooth(const std::string& path, const BluetoothDeviceDelta& delta, bool removed = false);
+    void record_stream(const StreamBusEvent& event);
+
+private:
+    InputRecorder() = default;
+
+    std::atomic<bool> recording{false};
+    std::mutex mutex;
+    FILE *file = nullptr;
+    std::chrono::steady_clock::time_point started;
+    int64_t last_flush_us = 0;
+    std::string line; // wiederverwendet, unter mutex
+};
+
+#endif
@@ -0,0 +1,411 @@
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <atomic>
+#include <array>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <sys/time.h>
+
+#include "metrics.hpp"
+#include "thread_registry.hpp"
+
+// Asynchrones Logging.
+// Der aufrufende Thread schreibt nur einen Binär-Datensatz fester Größe (Zeit, Aufrufstelle,
+// Argumente) in seinen eigenen lock-freien Ring. Formatieren, Schreiben in die rotierende
+// Log-Datei und das Drosseln gesprächiger Stellen übernimmt ein Hintergrund-Thread.
+//
+//   LOG_INFO("Radio", "Buffering: {}%", percent);
+//
+// Platzhalter ist "{}", erlaubt sind Zahlen, bool und Strings (werden gekürzt übernommen).
+
+enum class LogLevel : uint8_t { Debug, Info, Warn, Error };
+
+// Eine Log-Aufrufstelle, statisch pro Makro-Aufruf angelegt. Ihre Adresse dient als Format-ID.
+struct LogSite {
+    LogLevel level;
+    const char *tag;
+    const char *format;
+
+    // Drosselung, nur vom Formatter-Thread benutzt
+    int64_t window_start_us = 0;
+    uint32_t window_count = 0;
+    uint32_t suppressed = 0;
+};
+
+struct LogRecord {
+    static constexpr size_t PAYLOAD = 108;
+
+    int64_t timestamp_us;   // Unix-Zeit in us
+    LogSite *site;
+    uint8_t used;           // belegte Bytes in payload
+    bool truncated;
+    char payload[PAYLOAD];  // Argumente: Typ-Byte + Wert
+};
+static_assert(sizeof(LogRecord) == 128, "LogRecord soll zwei Cache-Lines belegen");
+
+// Single-Producer/Single-Consumer Ring eines Threads
+struct LogRing {
+    static constexpr size_t CAPACITY = 1024; // Zweierpotenz
+    static constexpr size_t MASK = CAPACITY - 1;
+
+    std::array<LogRecord, CAPACITY> records;
+    alignas(64) std::atomic<size_t> head{0}; // nur der Producer schreibt
+    alignas(64) std::atomic<size_t> tail{0}; // nur der Consumer schreibt
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> closed{false};         // Thread beendet, Ring nach dem Leeren freigeben
+    uint64_t reported_drops = 0;
+};
+
+namespace logdetail {
+
+inline void put(LogRecord& r, char type, const void *data, size_t size) {
+    if (r.used + 1 + size > LogRecord::PAYLOAD) {
+        r.truncated = true;
+        return;
+    }
+    r.payload[r.used++] = type;
+    std::memcpy(r.payload + r.used, data, size);
+    r.used += static_cast<uint8_t>(size);
+}
+
+inline void put_string(LogRecord& r, std::string_view s) {
+    size_t room = LogRecord::PAYLOAD - r.used;
+    if (room < 3) {
+        r.truncated = true;
+        return;
+    }
+    size_t len = std::min(s.size(), std::min(room - 2, size_t(255)));
+    if (len < s.size()) r.truncated = true;
+    r.payload[r.used++] = 's';
+    r.payload[r.used++] = static_cast<char>(len);
+    std::memcpy(r.payload + r.used, s.data(), len);
+    r.used += static_cast<uint8_t>(len);
+}
+
+template<typename T>
+void encode(LogRecord& r, const T& v) {
+    if constexpr (std::is_same_v<T, bool>) {
+        char b = v ? 1 : 0;
+        put(r, 'b', &b, 1);
+    } else if constexpr (std::is_enum_v<T>) {
+        int64_t i = static_cast<int64_t>(v);
+        put(r, 'i', &i, sizeof(i));
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        int64_t i = v;
+        put(r, 'i', &i, sizeof(i));
+    } else if constexpr (std::is_integral_v<T>) {
+        uint64_t u = v;
+        put(r, 'u', &u, sizeof(u));
+    } else if constexpr (std::is_floating_point_v<T>) {
+        double d = v;
+        put(r, 'd', &d, sizeof(d));
+    } else if constexpr (std::is_pointer_v<T>) {
+        put_string(r, v ? std::string_view(v) : std::string_view("(null)"));
+    } else {
+        put_string(r, std::string_view(v));
+    }
+}
+
+} // namespace logdetail
+
+class Logger {
+public:
+    static constexpr uint32_t RATE_LIMIT = 10;         // Zeilen pro Aufrufstelle und Sekunde
+    static constexpr size_t MAX_FILE_BYTES = 1 << 20;  // danach wird rotiert
+    static constexpr int KEEP_FILES = 3;               // caros.log.1 .. caros.log.3
+
+    static Logger& instance() {
+        // Absichtlich nie freigegeben: Threads dürfen bis zum Prozessende loggen
+        static Logger *logger = new Logger();
+        return *logger;
+    }
+
+    static bool enabled(LogLevel level) {
+        return static_cast<uint8_t>(level) >= instance().min_level.load(std::memory_order_relaxed);
+    }
+
+    // Hot-Path: kein Lock, keine Allokation, kein Syscall
+    template<typename... Args>
+    static void write(LogSite& site, const Args&... args) {
+        LogRing& ring = local_ring();
+        size_t h = ring.head.load(std::memory_order_relaxed);
+        if (h - ring.tail.load(std::memory_order_acquire) >= LogRing::CAPACITY) {
+            ring.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        LogRecord& r = ring.records[h & LogRing::MASK];
+        r.timestamp_us = now_us();
+        r.site = &site;
+        r.used = 0;
+        r.truncated = false;
+        (logdetail::encode(r, args), ...);
+        ring.head.store(h + 1, std::memory_order_release);
+    }
+
+    // Startet den Formatter-Thread. Konfiguration über die Umgebung:
+    //   CAROS_LOG_FILE (Default caros.log), CAROS_LOG_LEVEL (debug|info|warn|error),
+    //   CAROS_LOG_ECHO=0 schaltet die zusätzliche Ausgabe auf stderr ab.
+    void start() {
+        if (running.exchange(true)) return;
+
+        const char *path = getenv("CAROS_LOG_FILE");
+        file_path = path ? path : "caros.log";
+        const char *echo_env = getenv("CAROS_LOG_ECHO");
+        echo = !(echo_env && std::strcmp(echo_env, "0") == 0);
+        const char *level = getenv("CAROS_LOG_LEVEL");
+        if (level) {
+            if (std::strcmp(level, "debug") == 0) min_level = 0;
+            else if (std::strcmp(level, "warn") == 0) min_level = 2;
+            else if (std::strcmp(level, "error") == 0) min_level = 3;
+        }
+
+        open_file();
+        ThreadRegistry::spawn("caros-log", "background", [this]() {
+            while (running.load(std::memory_order_relaxed)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                drain();
+            }
+        }).detach();
+    }
+
+    // Zeilen pro Aufrufstelle und Sekunde, 0 = keine Drosselung (Benchmarks)
+    void set_rate_limit(uint32_t lines) { rate_limit.store(lines, std::memory_order_relaxed); }
+
+    // Schreibt alles Ausstehende sofort (z.B. vor dem Beenden)
+    void flush() { drain(); }
+
+private:
+    std::atomic<uint8_t> min_level{static_cast<uint8_t>(LogLevel::Info)};
+    std::atomic<bool> running{false};
+    std::atomic<uint32_t> rate_limit{RATE_LIMIT};
+    bool echo = true;
+
+    std::mutex rings_mutex;
+    std::vector<LogRing*> rings;
+
+    std::mutex drain_mutex;
+    std::vector<LogRecord> batch;
+    std::string line;
+    std::string file_path;
+    FILE *file = nullptr;
+    size_t file_bytes = 0;
+
+    static int64_t now_us() {
+        timeval tv;
+        gettimeofday(&tv, nullptr); // vDSO, kein echter Syscall
+        return tv.tv_sec * 1000000LL + tv.tv_usec;
+    }
+
+    LogRing* register_ring() {
+        LogRing *ring = new LogRing();
+        std::lock_guard<std::mutex> lock(rings_mutex);
+        rings.push_back(ring);
+        return ring;
+    }
+
+    static LogRing& local_ring() {
+        struct Holder {
+            LogRing *ring = Logger::instance().register_ring();
+            ~Holder() { ring->closed.store(true, std::memory_order_release); }
+        };
+        thread_local Holder holder;
+        return *holder.ring;
+    }
+
+    void drain() {
+        std::lock_guard<std::mutex> lock(drain_mutex);
+        static Counter& dropped_metric = MetricsRegistry::instance().counter("caros_log_dropped_total", "Wegen vollem Ring verworfene Log-Meldungen");
+        uint64_t dropped = 0;
+        batch.clear();
+
+        {
+            std::lock_guard<std::mutex> rings_lock(rings_mutex);
+            for (auto it = rings.begin(); it != rings.end();) {
+                LogRing *ring = *it;
+                bool closed = ring->closed.load(std::memory_order_acquire);
+                size_t t = ring->tail.load(std::memory_order_relaxed);
+                size_t h = ring->head.load(std::memory_order_acquire);
+                for (; t != h; t++) batch.push_back(ring->records[t & LogRing::MASK]);
+                ring->tail.store(t, std::memory_order_release);
+
+                uint64_t d = ring->dropped.load(std::memory_order_relaxed);
+                dropped += d - ring->reported_drops;
+                ring->reported_drops = d;
+
+                if (closed) {
+                    delete ring;
+                    it = rings.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        // Über alle Threads hinweg zeitlich geordnet ausgeben
+        std::stable_sort(batch.begin(), batch.end(), [](const LogRecord& a, const LogRecord& b) {
+            return a.timestamp_us < b.timestamp_us;
+        });
+        for (const LogRecord& r : batch) emit(r);
+
+        if (dropped > 0) {
+            dropped_metric.inc(dropped);
+            char text[96];
+            snprintf(text, sizeof(text), "%llu Meldungen verworfen (Ring voll)", (unsigned long long)dropped);
+            emit_line(now_us(), LogLevel::Warn, "Logger", text);
+        }
+        if (file) fflush(file);
+    }
+
+    void emit(const LogRecord& r) {
+        LogSite& site = *r.site;
+
+        // Drosselung: höchstens rate_limit Zeilen pro Stelle und Sekunde
+        uint32_t limit = rate_limit.load(std::memory_order_relaxed);
+        if (r.timestamp_us - site.window_start_us >= 1000000) {
+            if (site.suppressed > 0) {
+                char text[96];
+                snprintf(text, sizeof(text), "%u gleichartige Meldungen unterdrückt", site.suppressed);
+                emit_line(r.timestamp_us, site.level, site.tag, text);
+            }
+            site.window_start_us = r.timestamp_us;
+            site.window_count = 0;
+            site.suppressed = 0;
+        }
+        if (++site.window_count > limit && limit > 0) {
+            site.suppressed++;
+            return;
+        }
+
+        std::string text;
+        format(r, text);
+        emit_line(r.timestamp_us, site.level, site.tag, text.c_str());
+    }
+
+    // Ersetzt die "{}"-Platzhalter der Aufrufstelle durch die gespeicherten Argumente
+    static void format(const LogRecord& r, std::string& out) {
+        size_t pos = 0;
+        char num[32];
+        for (const char *f = r.site->format; *f; f++) {
+            if (f[0] != '{' || f[1] != '}') {
+                out += *f;
+                continue;
+            }
+            f++;
+            if (pos >= r.used) {
+                out += "{}";
+                continue;
+            }
+            char type = r.payload[pos++];
+            switch (type) {
+                case 'i': {
+                    int64_t v;
+                    std::memcpy(&v, r.payload + pos, sizeof(v));
+                    pos += sizeof(v);
+                    snprintf(num, sizeof(num), "%lld", (long long)v);
+                    out += num;
+                    break;
+                }
+                case 'u': {
+                    uint64_t v;
+                    std::memcpy(&v, r.payload + pos, sizeof(v));
+                    pos += sizeof(v);
+                    snprintf(num, sizeof(num), "%llu", (unsigned long long)v);
+                    out += num;
+                    break;
+                }
+                case 'd': {
+                    double v;
+                    std::memcpy(&v, r.payload + pos, sizeof(v));
+                    pos += sizeof(v);
+                    snprintf(num, sizeof(num), "%g", v);
+                    out += num;
+                    break;
+                }
+                case 'b':
+                    out += r.payload[pos++] ? "true" : "false";
+                    break;
+                case 's': {
+                    size_t len = static_cast<uint8_t>(r.payload[pos++]);
+                    out.append(r.payload + pos, len);
+                    pos += len;
+                    break;
+                }
+            }
+        }
+        if (r.truncated) out += " […]";
+    }
+
+    void emit_line(int64_t timestamp_us, LogLevel level, const char *tag, const char *text) {
+        static const char LEVEL_CHAR[] = {'D', 'I', 'W', 'E'};
+        time_t secs = static_cast<time_t>(timestamp_us / 1000000);
+        tm local{};
+        localtime_r(&secs, &local);
+        char when[32];
+        strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &local);
+
+        line.clear();
+        char prefix[64];
+        snprintf(prefix, sizeof(prefix), "%s.%03d %c [", when, static_cast<int>((timestamp_us / 1000) % 1000),
+                 LEVEL_CHAR[static_cast<int>(level)]);
+        line += prefix;
+        line += tag;
+        line += "] ";
+        line += text;
+        line += '\n';
+
+        if (echo) fwrite(line.data(), 1, line.size(), stderr);
+        if (file) {
+            fwrite(line.data(), 1, line.size(), file);
+            file_bytes += line.size();
+            if (file_bytes >= MAX_FILE_BYTES) rotate();
+        }
+    }
+
+    void open_file() {
+        file = fopen(file_path.c_str(), "a");
+        if (!file) {
+            fprintf(stderr, "[Logger] %s kann nicht geöffnet werden, nur stderr.\n", file_path.c_str());
+            return;
+        }
+        fseek(file, 0, SEEK_END);
+        file_bytes = static_cast<size_t>(std::max(0L, ftell(file)));
+    }
+
+    // caros.log -> caros.log.1 -> ... -> caros.log.KEEP_FILES (älteste fällt weg)
+    void rotate() {
+        fclose(file);
+        file = nullptr;
+        for (int i = KEEP_FILES - 1; i >= 1; i--) {
+            std::string from = file_path + "." + std::to_string(i);
+            std::string to = file_path + "." + std::to_string(i + 1);
+            std::rename(from.c_str(), to.c_str());
+        }
+        std::rename(file_path.c_str(), (file_path + ".1").c_str());
+        open_file();
+    }
+};
+
+#define CAROS_LOG(level, tag, fmt, ...) \
+    do { \
+        static LogSite caros_log_site_{level, tag, fmt}; \
+        if (Logger::enabled(level)) Logger::write(caros_log_site_, ##__VA_ARGS__); \
+    } while (0)
+
+#define LOG_DEBUG(tag, fmt, ...) CAROS_LOG(LogLevel::Debug, tag, fmt, ##__VA_ARGS__)
+#define LOG_INFO(tag, fmt, ...) CAROS_LOG(LogLevel::Info, tag, fmt, ##__VA_ARGS__)
+#define LOG_WARN(tag, fmt, ...) CAROS_LOG(LogLevel::Warn, tag, fmt, ##__VA_ARGS__)
+#define LOG_ERROR(tag, fmt, ...) CAROS_LOG(LogLevel::Error, tag, fmt, ##__VA_ARGS__)
+
+#endif
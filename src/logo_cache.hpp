@@ -0,0 +1,76 @@
+#ifndef LOGO_CACHE_HPP
+#define LOGO_CACHE_HPP
+
+#include <gtk/gtk.h>
+#include <string>
+#include <unordered_map>
+
+// Gemeinsamer Cache der Senderlogos.
+// Jede Datei wird nur einmal und direkt in Anzeigegröße dekodiert (ein 512px-Favicon
+// belegt sonst 1 MiB statt 56 KiB). Bei Speicherdruck werden alle Texturen verworfen,
+// die Bilder zeigen dann ein Symbol, bis reload() sie wieder lädt.
+class LogoCache {
+public:
+    static constexpr int LOGO_SIZE = 120;
+
+    // Zeigt das Logo in image an und merkt sich die Verknüpfung bis zur Zerstörung des Widgets
+    void bind(GtkWidget *image, const std::string& path) {
+        if (bound.find(image) == bound.end()) {
+            g_object_weak_ref(G_OBJECT(image), [](gpointer data, GObject *gone) {
+                static_cast<LogoCache*>(data)->bound.erase(reinterpret_cast<GtkWidget*>(gone));
+            }, this);
+        }
+        bound[image] = path;
+        show(image, path);
+    }
+
+    size_t bytes() const { return total_bytes; }
+
+    // Texturen freigeben (Speicherdruck)
+    void drop() {
+        dropped = true;
+        for (const auto& [image, path] : bound) show(image, path);
+        for (auto& [path, entry] : textures) g_object_unref(entry.texture);
+        textures.clear();
+        total_bytes = 0;
+    }
+
+    void reload() {
+        dropped = false;
+        for (const auto& [image, path] : bound) show(image, path);
+    }
+
+private:
+    struct Entry {
+        GdkTexture *texture;
+        size_t bytes;
+    };
+
+    std::unordered_map<std::string, Entry> textures;
+    std::unordered_map<GtkWidget*, std::string> bound;
+    size_t total_bytes = 0;
+    bool dropped = false;
+
+    void show(GtkWidget *image, const std::string& path) {
+        GdkTexture *texture = dropped ? nullptr : get(path);
+        if (texture) gtk_image_set_from_paintable(GTK_IMAGE(image), GDK_PAINTABLE(texture));
+        else gtk_image_set_from_icon_name(GTK_IMAGE(image), "audio-x-generic-symbolic");
+    }
+
+    GdkTexture* get(const std::string& path) {
+        auto it = textures.find(path);
+        if (it != textures.end()) return it->second.texture;
+
+        GdkPixbuf *pixbuf = gdk_pixbuf_new_from_file_at_scale(path.c_str(), LOGO_SIZE, LOGO_SIZE, TRUE, nullptr);
+        if (!pixbuf) return nullptr;
+        Entry entry{gdk_texture_new_for_pixbuf(pixbuf),
+                    static_cast<size_t>(gdk_pixbuf_get_rowstride(pixbuf)) * gdk_pixbuf_get_height(pixbuf)};
+        g_object_unref(pixbuf);
+
+        total_bytes += entry.bytes;
+        textures.emplace(path, entry);
+        return entry.texture;
+    }
+};
+
+#endif
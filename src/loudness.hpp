@@ -0,0 +1,249 @@
+#ifndef LOUDNESS_HPP
+#define LOUDNESS_HPP
+
+#include <atomic>
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Lautheitsmessung nach ITU-R BS.1770 / EBU R128 (integrierte Lautheit, LUFS).
+// Rein C++, läuft im Streaming-Thread. Die gegateten 400-ms-Blöcke landen in einem
+// Histogramm (0,1 LU, pro Bin Anzahl und Energiesumme), so bleibt der Speicher konstant
+// und die integrierte Lautheit kann nach jedem Block in O(Bins) neu berechnet werden.
+class LoudnessMeter {
+public:
+    static constexpr double ABSOLUTE_GATE = -70.0;
+    static constexpr double RELATIVE_GATE = -10.0;
+    static constexpr double HIST_MAX = 5.0;
+    static constexpr double HIST_STEP = 0.1;
+    static constexpr int HIST_BINS = static_cast<int>((HIST_MAX - ABSOLUTE_GATE) / HIST_STEP);
+
+    LoudnessMeter() { configure(44100, 2); }
+
+    void configure(int sample_rate, int channel_count) {
+        rate = sample_rate > 0 ? sample_rate : 44100;
+        stride = std::max(channel_count, 1);
+        channels = std::min(stride, 2);
+        hop_frames = static_cast<size_t>(rate / 10); // 100 ms, ein Block = 4 Hops (75 % Überlappung)
+        design_filters();
+        reset();
+    }
+
+    void reset() {
+        state_s1 = state_s2 = state_o = v4sf{0, 0, 0, 0};
+        hop_energy = v4sf{0, 0, 0, 0};
+        hop_fill = 0;
+        hops_seen = 0;
+        hops.fill(0.0);
+        histogram.fill(0);
+        bin_energy.fill(0.0);
+        gated_blocks = 0;
+        integrated = -HUGE_VAL;
+    }
+
+    // Interleaved float32; bei mehr als zwei Kanälen zählen nur L/R
+    void process(const float *data, size_t frames) {
+        for (size_t n = 0; n < frames; n++) {
+            float l = data[n * stride];
+            float r = channels == 2 ? data[n * stride + 1] : 0.0f;
+            step(l, r);
+            if (++hop_fill == hop_frames) finish_hop();
+        }
+    }
+
+    // Integrierte Lautheit in LUFS (-inf, solange kein Block über dem absoluten Gate liegt)
+    double integrated_lufs() const { return integrated; }
+
+    // Dauer der Blöcke über dem absoluten Gate in Sekunden
+    double gated_seconds() const { return gated_blocks * 0.1; }
+
+private:
+    typedef float v4sf __attribute__((vector_size(16)));
+    typedef int v4si __attribute__((vector_size(16)));
+
+    int rate = 44100;
+    int channels = 2;
+    int stride = 2;
+    size_t hop_frames = 4410;
+
+    // K-Filter: zwei Biquads (Hochton-Shelf + Hochpass) pro Kanal, als Pipeline in einem Vektor:
+    // Lane 0 = L Stufe 1, Lane 1 = L Stufe 2, Lane 2 = R Stufe 1, Lane 3 = R Stufe 2
+    v4sf b0, b1, b2, a1, a2;
+    v4sf state_s1, state_s2, state_o;
+    v4sf hop_energy;
+    size_t hop_fill = 0;
+
+    std::array<double, 4> hops{};   // mittlere Energie der letzten vier 100-ms-Hops
+    uint64_t hops_seen = 0;
+    std::array<uint32_t, HIST_BINS> histogram{};
+    std::array<double, HIST_BINS> bin_energy{};
+    uint64_t gated_blocks = 0;
+    double integrated = -HUGE_VAL;
+
+    // Koeffizienten für beliebige Abtastraten (Herleitung wie in libebur128)
+    void design_filters() {
+        double f0 = 1681.974450955533, gain = 3.999843853973347, q = 0.7071752369554196;
+        double k = std::tan(M_PI * f0 / rate);
+        double vh = std::pow(10.0, gain / 20.0);
+        double vb = std::pow(vh, 0.4996667741545416);
+        double a0 = 1.0 + k / q + k * k;
+        float shelf_b0 = float((vh + vb * k / q + k * k) / a0);
+        float shelf_b1 = float(2.0 * (k * k - vh) / a0);
+        float shelf_b2 = float((vh - vb * k / q + k * k) / a0);
+        float shelf_a1 = float(2.0 * (k * k - 1.0) / a0);
+        float shelf_a2 = float((1.0 - k / q + k * k) / a0);
+
+        f0 = 38.13547087602444;
+        q = 0.5003270373238773;
+        k = std::tan(M_PI * f0 / rate);
+        a0 = 1.0 + k / q + k * k;
+        float hp_a1 = float(2.0 * (k * k - 1.0) / a0);
+        float hp_a2 = float((1.0 - k / q + k * k) / a0);
+
+        b0 = v4sf{shelf_b0, 1.0f, shelf_b0, 1.0f};
+        b1 = v4sf{shelf_b1, -2.0f, shelf_b1, -2.0f};
+        b2 = v4sf{shelf_b2, 1.0f, shelf_b2, 1.0f};
+        a1 = v4sf{shelf_a1, hp_a1, shelf_a1, hp_a1};
+        a2 = v4sf{shelf_a2, hp_a2, shelf_a2, hp_a2};
+    }
+
+    void step(float l, float r) {
+        // [l, o0, r, o2]: Stufe 2 bekommt die Ausgabe von Stufe 1 aus dem vorigen Schritt
+        v4sf x = v4sf{l, r, 0.0f, 0.0f};
+#if defined(__clang__)
+        v4sf in = __builtin_shufflevector(x, state_o, 0, 4, 1, 6);
+#else
+        v4sf in = __builtin_shuffle(x, state_o, v4si{0, 4, 1, 6});
+#endif
+        v4sf y = b0 * in + state_s1;
+        state_s1 = b1 * in - a1 * y + state_s2;
+        state_s2 = b2 * in - a2 * y;
+        state_o = y;
+        hop_energy += y * y;
+    }
+
+    void finish_hop() {
+        // Lanes 1 und 3 = K-gefilterte Kanäle (Kanalgewicht 1 für L/R)
+        double energy = (double(hop_energy[1]) + double(hop_energy[3])) / hop_frames;
+        hop_energy = v4sf{0, 0, 0, 0};
+        hop_fill = 0;
+        hops[hops_seen % 4] = energy;
+        if (++hops_seen < 4) return;
+
+        double block = (hops[0] + hops[1] + hops[2] + hops[3]) / 4.0;
+        double lufs = energy_to_lufs(block);
+        if (lufs < ABSOLUTE_GATE) return;
+
+        int bin = std::min(HIST_BINS - 1, static_cast<int>((lufs - ABSOLUTE_GATE) / HIST_STEP));
+        histogram[bin]++;
+        bin_energy[bin] += block;
+        gated_blocks++;
+        update_integrated();
+    }
+
+    static double energy_to_lufs(double energy) { return -0.691 + 10.0 * std::log10(energy + 1e-20); }
+
+    void update_integrated() {
+        double sum = 0.0;
+        uint64_t count = 0;
+        for (int b = 0; b < HIST_BINS; b++) {
+            if (!histogram[b]) continue;
+            sum += bin_energy[b];
+            count += histogram[b];
+        }
+        double relative = energy_to_lufs(sum / count) + RELATIVE_GATE;
+        // Das Bin mit dem Gate zählt ganz mit: Fehler höchstens ein Bin (0,1 LU) am Gate-Rand
+        int first = std::max(0, static_cast<int>((relative - ABSOLUTE_GATE) / HIST_STEP));
+
+        sum = 0.0;
+        count = 0;
+        for (int b = first; b < HIST_BINS; b++) {
+            if (!histogram[b]) continue;
+            sum += bin_energy[b];
+            count += histogram[b];
+        }
+        integrated = count ? energy_to_lufs(sum / count) : -HUGE_VAL;
+    }
+};
+
+// Lautheitsangleich zwischen Sendern: misst die integrierte Lautheit des Streams und führt
+// eine Verstärkung Richtung TARGET_LUFS nach. Eine bekannte Verstärkung (aus dem Cache)
+// wird beim Senderwechsel sofort gesetzt, Korrekturen danach werden langsam gerampt.
+class LoudnessNormalizer {
+public:
+    static constexpr double TARGET_LUFS = -18.0;
+    static constexpr double MAX_GAIN_DB = 12.0;
+    static constexpr double MIN_MEASURE_S = 3.0; // vorher gilt nur die Cache-Verstärkung
+    static constexpr double SLEW_DB_PER_S = 1.0;
+
+    // Aus dem Streaming-Thread bei Formatänderung
+    void configure(int sample_rate, int channel_count) {
+        rate = sample_rate > 0 ? sample_rate : 44100;
+        channels = std::max(channel_count, 1);
+        meter.configure(rate, channels);
+    }
+
+    // Beliebiger Thread: neuer Sender, optional mit bekannter Verstärkung
+    void start_stream(double cached_gain_db) {
+        pending_gain_db.store(std::clamp(cached_gain_db, -MAX_GAIN_DB, MAX_GAIN_DB), std::memory_order_relaxed);
+        estimate_valid.store(false, std::memory_order_relaxed);
+        restart.store(true, std::memory_order_release);
+    }
+
+    void set_enabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+
+    // Gelernte Verstärkung (threadsicher), nur gültig wenn has_estimate()
+    double learned_gain_db() const { return learned_db.load(std::memory_order_relaxed); }
+    bool has_estimate() const { return estimate_valid.load(std::memory_order_relaxed); }
+    double integrated_lufs() const { return lufs.load(std::memory_order_relaxed); }
+
+    // Streaming-Thread: misst das unbearbeitete Signal und wendet die Verstärkung an
+    void process(float *data, size_t frames) {
+        if (restart.exchange(false, std::memory_order_acquire)) {
+            meter.reset();
+            current_db = target_db = pending_gain_db.load(std::memory_order_relaxed);
+            estimate_valid.store(false, std::memory_order_relaxed);
+        }
+
+        meter.process(data, frames);
+        if (meter.gated_seconds() >= MIN_MEASURE_S) {
+            double measured = meter.integrated_lufs();
+            target_db = std::clamp(TARGET_LUFS - measured, -MAX_GAIN_DB, MAX_GAIN_DB);
+            learned_db.store(target_db, std::memory_order_relaxed);
+            lufs.store(measured, std::memory_order_relaxed);
+            estimate_valid.store(true, std::memory_order_relaxed);
+        }
+        if (!enabled.load(std::memory_order_relaxed)) return;
+
+        // Lineare Rampe in dB über den Buffer, begrenzt auf SLEW_DB_PER_S
+        double max_step = SLEW_DB_PER_S * frames / rate;
+        double end_db = current_db + std::clamp(target_db - current_db, -max_step, max_step);
+        float g0 = db_to_gain(current_db);
+        float g1 = db_to_gain(end_db);
+        float dg = frames ? (g1 - g0) / frames : 0.0f;
+        float g = g0;
+        for (size_t n = 0; n < frames; n++, g += dg) {
+            for (int c = 0; c < channels; c++) data[n * channels + c] *= g;
+        }
+        current_db = end_db;
+    }
+
+private:
+    LoudnessMeter meter;
+    int rate = 44100;
+    int channels = 2;
+    double current_db = 0.0;
+    double target_db = 0.0;
+    std::atomic<bool> restart{false};
+    std::atomic<bool> enabled{true};
+    std::atomic<double> pending_gain_db{0.0};
+    std::atomic<double> learned_db{0.0};
+    std::atomic<double> lufs{-HUGE_VAL};
+    std::atomic<bool> estimate_valid{false};
+
+    static float db_to_gain(double db) { return static_cast<float>(std::pow(10.0, db / 20.0)); }
+};
+
+#endif
@@ -1,12 +1,17 @@
 #include <gtk/gtk.h>
 #include <iostream>
 #include <thread>
+#include <atomic>
+#include <utility>
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include <ctime>
 #include <curl/curl.h>
 #include <algorithm>
+#include <unordered_map>
+#include <set>
+#include <sys/stat.h>
 
 #include "ui_manager.hpp"
 #include "bluetooth_manager.hpp"
@@ -14,26 +19,96 @@
 #include "gpio_handler.hpp"
 #include "virtual_keyboard.hpp"
 #include "gps_handler.hpp"
+#include "station_geo_index.hpp"
+#include "station_search.hpp"
+#include "mainloop_watchdog.hpp"
+#include "metrics.hpp"
+#include "metrics_server.hpp"
+#include "logger.hpp"
+#include "thread_registry.hpp"
+#include "logo_cache.hpp"
+#include "memory_pressure.hpp"
+#include "spectrum_visualizer.hpp"
+#include "media_library.hpp"
+#include "thermal_governor.hpp"
+#include "station_catalog.hpp"
+#include "station_store.hpp"
+#include "input_trace.hpp"
+#include "input_replay.hpp"
+#include "ui_assets.hpp"
 
 // Prototypen
 void refresh_radio_list(GtkWidget *flowbox, RadioManager *radio_mgr);
 void perform_seeding(GtkWidget *flowbox, RadioManager *radio_mgr);
 
-// --- Datenstrukturen ---
-struct RadioStation {
-    std::string name;
-    std::string url;
-    std::string logo_path; // Lokaler Pfad zum Cache
-};
+// Drehgeber an GPIO 17 (A) und 27 (B)
+constexpr int ENCODER_PIN_A = 17;
+constexpr int ENCODER_PIN_B = 27;
 
+// --- Datenstrukturen ---
 struct AppWidgets {
+    int64_t start_us = 0; // Startzeitpunkt (monoton) für Startup-Metriken
     GtkWidget *stack;
     GtkWidget *volume_label;
     RadioManager *radio_mgr;
     GPSManager *gps_mgr;
+    BluetoothManager *bt_mgr = nullptr;
     int current_volume = 50;
     GtkWidget *keyboard_revealer;
     VirtualKeyboard *keyboard;
+    GtkWidget *radio_flowbox;
+    LogoCache *logos;
+};
+
+// Abbau nicht sichtbarer Seiten bei Speicherdruck: die Senderkacheln werden verworfen
+// und beim nächsten Anzeigen der Radio-Seite neu aufgebaut
+struct OffscreenPages {
+    GtkWidget *stack;
+    GtkWidget *radio_flowbox;
+    RadioManager *radio_mgr;
+    bool active = false;       // Speicherdruck-Stufe aktiv
+    bool radio_dropped = false;
+
+    void reap() {
+        if (!active || radio_dropped) return;
+        const char *visible = gtk_stack_get_visible_child_name(GTK_STACK(stack));
+        if (g_strcmp0(visible, "radio") == 0) return;
+        GtkWidget *child;
+        while ((child = gtk_widget_get_first_child(radio_flowbox)) != nullptr) {
+            gtk_flow_box_remove(GTK_FLOW_BOX(radio_flowbox), child);
+        }
+        radio_dropped = true;
+    }
+
+    void on_page_changed() {
+        const char *visible = gtk_stack_get_visible_child_name(GTK_STACK(stack));
+        if (radio_dropped && g_strcmp0(visible, "radio") == 0) {
+            radio_dropped = false;
+            refresh_radio_list(radio_flowbox, radio_mgr);
+        } else {
+            reap();
+        }
+    }
+};
+
+// "Sender in der Nähe": Index über alle Sender mit Koordinaten
+struct NearbyData {
+    GtkWidget *box;
+    RadioManager *radio_mgr;
+    GPSManager *gps_mgr;
+    std::vector<RadioStation> stations;
+    StationGeoIndex index;
+    NearbyStationTracker tracker{index, 3, 150.0};
+};
+
+// Sendersuche: Index über die Namen, Rang der Treffer für Filter/Sortierung der Flowbox
+struct SearchData {
+    GtkWidget *entry;
+    GtkWidget *flowbox;
+    StationSearchIndex index;
+    SearchSession session;
+    std::unordered_map<uint32_t, int> rank;
+    bool active = false;
 };
 
 struct SaveData {
@@ -53,51 +128,6 @@ size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* use
 
 // --- Hilfsfunktionen ---
 
-// Lädt Stationen aus der CSV (Name;URL;LogoPath)
-std::vector<RadioStation> load_stations() {
-    std::vector<RadioStation> list;
-    std::ifstream file("assets/stations.csv");
-    std::string line;
-    if (file.is_open()) {
-        while (std::getline(file, line)) {
-            std::stringstream ss(line);
-            std::string name, url, logo;
-            if (std::getline(ss, name, ';') && 
-                std::getline(ss, url, ';') && 
-                std::getline(ss, logo, ';')) {
-                list.push_back({name, url, logo});
-            }
-        }
-        file.close();
-    }
-    // Fallback falls Datei leer
-    if (list.empty()) {
-        list.push_back({"Rock Antenne", "https://stream.rockantenne.de/rockantenne/stream/mp3", "assets/logos/default.png"});
-    }
-    return list;
-}
-
-void save_station(const std::string& name, const std::string& url, const std::string& logo = "assets/logos/default.png") {
-    std::ofstream file("assets/stations.csv", std::ios::app);
-    if (file.is_open()) { 
-        file << name << ";" << url << ";" << logo << "\n"; 
-        file.close(); 
-    }
-}
-
-void delete_station(const std::string& name_to_delete) {
-    auto stations = load_stations();
-    std::ofstream file("assets/stations.csv", std::ios::trunc);
-    if (file.is_open()) {
-        for (const auto& s : stations) {
-            if (s.name != name_to_delete) {
-                file << s.name << ";" << s.url << ";" << s.logo_path << "\n";
-            }
-        }
-        file.close();
-    }
-}
-
 static gboolean update_clock_label(gpointer user_data) {
     time_t now = time(nullptr);
     struct tm *lt = localtime(&now);
@@ -117,19 +147,88 @@ GtkWidget* create_icon_button(const char* icon_name, const char* label_text) {
     return btn;
 }
 
-GtkWidget* create_nav_button(const char* icon_path) {
+GtkWidget* create_nav_button(const char* icon_name) {
     GtkWidget *btn = gtk_button_new();
-    // Bild aus Datei laden (deine neuen monochromen Icons)
-    GtkWidget *icon = gtk_image_new_from_file(icon_path);
-    
-    // Icon-Größe festlegen (z.B. 32px für eine flache Leiste)
-    gtk_image_set_pixel_size(GTK_IMAGE(icon), 32);
+    // Monochrome Icons aus dem Bundle, 32px für eine flache Leiste
+    GtkWidget *icon = ui_assets::image_new(icon_name, 32);
     
     gtk_button_set_child(GTK_BUTTON(btn), icon);
     gtk_widget_add_css_class(btn, "nav-button");
     return btn;
 }
 
+// --- Sender in der Nähe ---
+
+// Baut den Geo-Index aus der aktuellen Senderliste neu auf
+void rebuild_nearby_index(NearbyData *nd) {
+    nd->stations = load_stations();
+    std::vector<GeoEntry> coords;
+    for (size_t i = 0; i < nd->stations.size(); i++) {
+        if (nd->stations[i].has_geo) {
+            coords.push_back({i, nd->stations[i].lat, nd->stations[i].lon});
+        }
+    }
+    nd->index.build(std::move(coords));
+    nd->tracker.invalidate();
+}
+
+// Klick spielt den Sender; URL und Varianten hängen als Kopie am Button
+static void connect_station_play(GtkWidget *btn, const RadioStation& s, RadioManager *radio_mgr) {
+    g_object_set_data_full(G_OBJECT(btn), "station", new RadioStation(s), [](gpointer p) { delete static_cast<RadioStation*>(p); });
+    g_signal_connect(btn, "clicked", G_CALLBACK(+[](GtkWidget* w, gpointer data) {
+        const RadioStation *station = static_cast<RadioStation*>(g_object_get_data(G_OBJECT(w), "station"));
+        static_cast<RadioManager*>(data)->play_station(station->url, station->variants);
+    }), radio_mgr);
+}
+
+void render_nearby_stations(NearbyData *nd) {
+    GtkWidget *child;
+    while ((child = gtk_widget_get_first_child(nd->box)) != nullptr) {
+        gtk_box_remove(GTK_BOX(nd->box), child);
+    }
+
+    for (const auto& n : nd->tracker.stations()) {
+        const RadioStation& s = nd->stations[n.station_id];
+        char label[256];
+        snprintf(label, sizeof(label), "%s (%.0f km)", s.name.c_str(), n.distance_km);
+
+        GtkWidget *btn = gtk_button_new_with_label(label);
+        gtk_widget_add_css_class(btn, "nearby-station-btn");
+        connect_station_play(btn, s, nd->radio_mgr);
+        gtk_box_append(GTK_BOX(nd->box), btn);
+    }
+    gtk_widget_set_visible(nd->box, !nd->tracker.stations().empty());
+}
+
+// 1Hz: Position abfragen, die Buttons werden nur bei Änderungen neu gebaut
+static gboolean update_nearby_stations(gpointer user_data) {
+    NearbyData *nd = static_cast<NearbyData*>(user_data);
+    GPSData d = nd->gps_mgr->get_latest_data();
+    if (d.fix && nd->index.size() > 0 && nd->tracker.update(d.latitude, d.longitude)) {
+        render_nearby_stations(nd);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+// --- Sendersuche ---
+
+// Wird bei jedem Tastendruck aufgerufen; die Session verfeinert die vorherigen Treffer
+void apply_station_search(SearchData *sd) {
+    std::string query = gtk_editable_get_text(GTK_EDITABLE(sd->entry));
+    sd->rank.clear();
+    auto hits = sd->index.search(query, sd->session, 60);
+    sd->active = !textfold::fold(query).empty();
+    for (size_t i = 0; i < hits.size(); i++) {
+        sd->rank[hits[i].station] = static_cast<int>(i);
+    }
+    gtk_flow_box_invalidate_filter(GTK_FLOW_BOX(sd->flowbox));
+    gtk_flow_box_invalidate_sort(GTK_FLOW_BOX(sd->flowbox));
+}
+
+static int station_index_of(GtkFlowBoxChild *child) {
+    return GPOINTER_TO_INT(g_object_get_data(G_OBJECT(gtk_flow_box_child_get_child(child)), "station_index"));
+}
+
 // --- Hauptfunktionen ---
 
 void refresh_radio_list(GtkWidget *flowbox, RadioManager *radio_mgr) {
@@ -140,14 +239,21 @@ void refresh_radio_list(GtkWidget *flowbox, RadioManager *radio_mgr) {
     }
 
     // 2. Liste neu aufbauen
+    std::vector<std::string> names;
     for (const auto& s : load_stations()) {
+        int station_index = static_cast<int>(names.size());
+        names.push_back(s.name);
         // ORIENTATION_VERTICAL: Packt Logo, Name und Button untereinander
         GtkWidget *item_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
         gtk_widget_add_css_class(item_box, "radio-item-card");
+        g_object_set_data(G_OBJECT(item_box), "station_index", GINT_TO_POINTER(station_index));
         gtk_widget_set_valign(item_box, GTK_ALIGN_START);
 
         // --- Logo (Zentral & Groß) ---
-        GtkWidget *logo_img = gtk_image_new_from_file(s.logo_path.c_str());
+        LogoCache *logos = static_cast<LogoCache*>(g_object_get_data(G_OBJECT(flowbox), "logos"));
+        GtkWidget *logo_img = gtk_image_new();
+        if (logos) logos->bind(logo_img, s.logo_path);
+        else gtk_image_set_from_file(GTK_IMAGE(logo_img), s.logo_path.c_str());
         // Erhöhte Größe für bessere Sichtbarkeit (z.B. 120x120)
         gtk_widget_set_size_request(logo_img, 120, 120);
         gtk_widget_set_halign(logo_img, GTK_ALIGN_CENTER);
@@ -165,10 +271,7 @@ void refresh_radio_list(GtkWidget *flowbox, RadioManager *radio_mgr) {
         gtk_widget_add_css_class(play_btn, "radio-play-btn");
         
         // Signal für Playback (bleibt gleich)
-        g_object_set_data_full(G_OBJECT(play_btn), "station_url", g_strdup(s.url.c_str()), g_free);
-        g_signal_connect(play_btn, "clicked", G_CALLBACK(+[](GtkWidget* w, gpointer data) {
-            static_cast<RadioManager*>(data)->set_source((const char*)g_object_get_data(G_OBJECT(w), "station_url"));
-        }), radio_mgr);
+        connect_station_play(play_btn, s, radio_mgr);
 
         // --- Delete Button ---
         // Wir platzieren ihn dezent am unteren Rand oder als Icon
@@ -180,6 +283,7 @@ void refresh_radio_list(GtkWidget *flowbox, RadioManager *radio_mgr) {
         DelData* dd = new DelData{s.name, flowbox, radio_mgr};
         g_signal_connect(del_btn, "clicked", G_CALLBACK(+[](GtkWidget*, gpointer data) {
             auto* d = static_cast<DelData*>(data);
+            WatchdogSection section("delete_station");
             delete_station(d->name);
             refresh_radio_list(d->fb, d->rm);
             delete d;
@@ -193,6 +297,24 @@ void refresh_radio_list(GtkWidget *flowbox, RadioManager *radio_mgr) {
         // In die Flowbox einfügen
         gtk_flow_box_insert(GTK_FLOW_BOX(flowbox), item_box, -1);
     }
+
+    // Suchindex neu aufbauen und eine laufende Suche auf die neue Liste anwenden
+    SearchData *sd = static_cast<SearchData*>(g_object_get_data(G_OBJECT(flowbox), "search"));
+    if (sd) {
+        sd->index.build(names);
+        apply_station_search(sd);
+    }
+
+    // Vorschläge der Bildschirmtastatur aktualisieren
+    VirtualKeyboard *kb = static_cast<VirtualKeyboard*>(g_object_get_data(G_OBJECT(flowbox), "keyboard"));
+    if (kb) kb->set_completions(names);
+
+    // Geo-Index muss zur neuen Liste passen (station_id = Listenindex)
+    NearbyData *nd = static_cast<NearbyData*>(g_object_get_data(G_OBJECT(flowbox), "nearby"));
+    if (nd) {
+        rebuild_nearby_index(nd);
+        render_nearby_stations(nd);
+    }
 }
 
 bool download_image(const std::string& url, const std::string& destination) {
@@ -207,6 +329,7 @@ bool download_image(const std::string& url, const std::string& destination) {
     curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
     curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L);
     curl_easy_setopt(curl, CURLOPT_USERAGENT, "CarOS-RadioApp/1.0");
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
 
     CURLcode res = curl_easy_perform(curl);
     fclose(fp);
@@ -214,68 +337,222 @@ bool download_image(const std::string& url, const std::string& destination) {
     return (res == CURLE_OK);
 }
 
-void perform_seeding(GtkWidget *flowbox, RadioManager *radio_mgr) {
+static std::string radio_api() {
+    const char* api = g_getenv("CAROS_RADIO_API");
+    return (api && *api) ? api : "https://all.api.radio-browser.info";
+}
+
+static size_t seed_limit() {
+    const char* limit = g_getenv("CAROS_SEED_LIMIT");
+    long n = (limit && *limit) ? std::atol(limit) : 100;
+    return n > 0 ? static_cast<size_t>(n) : 100;
+}
+
+// Such-URL für den Katalog-Abgleich. Land und Anzahl lassen sich über
+// CAROS_SEED_COUNTRY / CAROS_SEED_LIMIT überschreiben (Default: Top 100 Deutschland),
+// der Server über CAROS_RADIO_API (z.B. ein lokaler Mirror).
+std::string seed_api_url() {
+    const char* country = g_getenv("CAROS_SEED_COUNTRY");
+
+    std::string url = radio_api();
+    url += "/json/stations/search?limit=" + std::to_string(seed_limit());
+    url += "&order=clicktrend&reverse=true&hidebroken=true";
+    if (country && *country) {
+        gchar *escaped = g_uri_escape_string(country, nullptr, FALSE);
+        url += std::string("&country=") + escaped;
+        g_free(escaped);
+    } else {
+        url += "&country=Germany&language=german";
+    }
+    return url;
+}
+
+// Ein Katalog-Abgleich: Download, Parsen, Diff und Logos laufen im Worker-Thread,
+// übernommen wird das Ergebnis per g_idle_add im Main-Thread (apply_seeding)
+struct SeedJob {
+    GtkWidget *flowbox;
+    RadioManager *radio_mgr;
+    std::vector<RadioStation> local;    // Stand der Senderliste beim Start (Main-Thread)
+    std::set<std::string> removed;
+    std::string stamp;                  // Änderungsstempel von stations.csv beim Start
+    std::vector<CatalogEntry> remote;
+    bool complete = false;              // Antwort kürzer als das Limit = ganze Liste
+    std::set<std::string> gone;         // per byuuid bestätigt nicht mehr im Katalog
+    CatalogDiff diff;
+    size_t logos = 0;
+    bool ok = false;
+};
+
+// Größe und mtime (ns) der Senderliste; ändert sich, wenn der Nutzer währenddessen speichert/löscht
+static std::string stations_stamp() {
+    struct stat st;
+    if (stat(STATIONS_CSV, &st) != 0) return "";
+    return std::to_string(st.st_size) + ":" + std::to_string(st.st_mtim.tv_sec) + "." + std::to_string(st.st_mtim.tv_nsec);
+}
+
+static bool logo_exists(const std::string& path) {
+    return path == DEFAULT_LOGO || g_file_test(path.c_str(), G_FILE_TEST_EXISTS);
+}
+
+// GET auf die radio-browser-API; leer bei Fehler
+static std::string fetch_json(const std::string& api_url) {
     CURL* curl = curl_easy_init();
-    if (!curl) return;
+    if (!curl) return "";
 
     std::string readBuffer;
-    const char* api_url = "https://all.api.radio-browser.info/json/stations/search?country=Germany&limit=100&language=german&order=clicktrend&reverse=true";
-
-    curl_easy_setopt(curl, CURLOPT_URL, api_url);
+    curl_easy_setopt(curl, CURLOPT_URL, api_url.c_str());
     curl_easy_setopt(curl, CURLOPT_USERAGENT, "CarOS-RadioApp/1.0");
     curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
     curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, ""); 
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
     curl_easy_setopt(curl, CURLOPT_TIMEOUT, 15L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L); // kein SIGALRM aus einem Worker-Thread
 
-    std::cout << "Seeding: Starte API Download..." << std::endl;
     CURLcode res = curl_easy_perform(curl);
-    long response_code;
+    long response_code = 0;
     curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
     curl_easy_cleanup(curl);
+    if (res != CURLE_OK || response_code != 200 || readBuffer.empty()) {
+        LOG_WARN("Seeding", "API nicht erreichbar (curl {}, HTTP {})", static_cast<int>(res), response_code);
+        return "";
+    }
+    return readBuffer;
+}
+
+// Nicht mehr in der Rangliste heißt nicht gelöscht: jeden fehlenden Sender per byuuid
+// nachfragen. Gelöscht ist nur, was der Katalog nicht mehr liefert; bei einem Fehler keiner.
+static std::set<std::string> confirm_gone(const std::vector<std::string>& missing) {
+    constexpr size_t BATCH = 100;
+    std::set<std::string> gone;
+    for (size_t i = 0; i < missing.size(); i += BATCH) {
+        std::vector<std::string> batch(missing.begin() + i, missing.begin() + std::min(missing.size(), i + BATCH));
+        std::string url = radio_api() + "/json/stations/byuuid?uuids=";
+        for (size_t n = 0; n < batch.size(); n++) url += (n ? "," : "") + batch[n];
+        std::string body = fetch_json(url);
+        if (body.empty()) return {};
+        std::set<std::string> found;
+        for (const CatalogEntry& e : CatalogParser::parse(body)) found.insert(e.uuid);
+        for (const auto& uuid : batch) {
+            if (!found.count(uuid)) gone.insert(uuid);
+        }
+    }
+    return gone;
+}
 
-    if (res == CURLE_OK && response_code == 200 && !readBuffer.empty()) {
-        std::ofstream file("assets/stations.csv", std::ios::trunc);
-        system("mkdir -p assets/logos");
-
-        size_t pos = 0;
-        int count = 0;
-        while ((pos = readBuffer.find("\"name\":", pos)) != std::string::npos) {
-            auto extract = [&](const std::string& key, size_t start_from) {
-                size_t k_pos = readBuffer.find("\"" + key + "\":", start_from);
-                if (k_pos == std::string::npos) return std::string("");
-                size_t v_start = readBuffer.find("\"", k_pos + key.length() + 2) + 1;
-                size_t v_end = readBuffer.find("\"", v_start);
-                return readBuffer.substr(v_start, v_end - v_start);
-            };
-
-            std::string name = extract("name", pos);
-            std::string url = extract("url_resolved", pos);
-            std::string logoUrl = extract("favicon", pos);
-
-            if (!name.empty() && !url.empty() && url.find("http") == 0) {
-                size_t s_pos;
-                while((s_pos = name.find(";")) != std::string::npos) name.replace(s_pos, 1, " ");
-                
-                std::string localLogoPath = "assets/logos/default.png";
-                if (!logoUrl.empty() && logoUrl.find("http") == 0) {
-                    std::string safeName = name;
-                    safeName.erase(std::remove_if(safeName.begin(), safeName.end(), [](char c){ return !std::isalnum(c); }), safeName.end());
-                    std::string target = "assets/logos/" + safeName + ".png";
-                    if (download_image(logoUrl, target)) localLogoPath = target;
-                }
-                
-                file << name << ";" << url << ";" << localLogoPath << "\n";
-                count++;
-            }
-            pos = readBuffer.find("}", pos + 1);
-            if (pos == std::string::npos) break;
+// Thermik: Abgleich und Logo-Downloads zurückstellen (set_seeding_deferred aus dem
+// ThermalGovernor-Listener). Ein laufender Abgleich wartet vor dem nächsten Logo.
+static std::atomic<bool> seeding_deferred{false};
+static std::pair<GtkWidget*, RadioManager*> deferred_seeding{nullptr, nullptr}; // angefordert während zurückgestellt
+
+// Worker-Thread: fasst weder Widgets noch die Senderdatei an
+static void fetch_catalog(SeedJob& job) {
+    static Histogram& sync_ms = MetricsRegistry::instance().histogram("caros_catalog_sync_ms", "Dauer eines Katalog-Abgleichs ohne Logos (ms)");
+    LOG_INFO("Seeding", "Starte API Download...");
+    std::string body = fetch_json(seed_api_url());
+    if (body.empty()) return;
+
+    int64_t t0 = g_get_monotonic_time();
+    std::vector<CatalogEntry> entries = CatalogParser::parse(body);
+    job.complete = entries.size() < seed_limit();
+    // Mehrfach gelistete Sender (verschiedene Codecs/Bitraten) werden ein Eintrag mit Varianten
+    job.remote = group_variants(entries);
+    if (job.remote.empty()) {
+        // Leere oder kaputte Antwort darf die Liste nicht leeren
+        LOG_WARN("Seeding", "Antwort enthält keine Sender, Liste bleibt unverändert");
+        return;
+    }
+    job.diff = diff_catalog(job.local, job.remote, job.removed, logo_exists, job.complete);
+    sync_ms.record(static_cast<uint64_t>((g_get_monotonic_time() - t0) / 1000));
+    if (!job.diff.missing.empty()) {
+        job.gone = confirm_gone(job.diff.missing);
+        confirm_deletions(job.diff, job.gone);
+        LOG_INFO("Seeding", "{} Sender nicht in der Rangliste, davon {} im Katalog gelöscht",
+                 job.diff.missing.size() + job.gone.size(), job.gone.size());
+    }
+
+    g_mkdir_with_parents("assets/logos", 0755);
+    for (size_t i : job.diff.fetch_logo) {
+        if (seeding_deferred.load(std::memory_order_relaxed)) {
+            LOG_INFO("Seeding", "Logo-Downloads zurückgestellt (Gerät zu warm)");
+            while (seeding_deferred.load(std::memory_order_relaxed)) g_usleep(G_USEC_PER_SEC);
+        }
+        RadioStation& s = job.diff.stations[i];
+        std::string target = "assets/logos/" + s.uuid + ".png";
+        std::string part = target + ".part";
+        if (download_image(s.logo_url, part) && std::rename(part.c_str(), target.c_str()) == 0) {
+            s.logo_path = target;
+            job.logos++;
+        } else {
+            std::remove(part.c_str());
         }
-        file.close();
-        std::cout << "Seeding abgeschlossen: " << count << " Sender." << std::endl;
-        refresh_radio_list(flowbox, radio_mgr);
     }
+    job.ok = true;
+}
+
+// Main-Thread: Ergebnis übernehmen. Hat der Nutzer die Liste inzwischen geändert, wird der
+// Diff gegen den aktuellen Stand neu gerechnet (die Logos liegen dann schon auf der Platte).
+// Logos entfernter Sender werden erst gelöscht, wenn die neue Liste gespeichert ist.
+static void apply_seeding(SeedJob& job) {
+    WatchdogSection section("apply_seeding");
+    if (!job.ok) return;
+    CatalogDiff& diff = job.diff;
+    if (stations_stamp() != job.stamp) {
+        LOG_INFO("Seeding", "Senderliste während des Abgleichs geändert, Diff wird neu berechnet");
+        diff = diff_catalog(load_stations(), job.remote, load_removed_stations(), logo_exists, job.complete);
+        confirm_deletions(diff, job.gone);
+    }
+
+    LOG_INFO("Seeding", "Abgleich (Katalog-Stand {}): {} neu, {} geändert, {} entfernt, {} übernommen, {} unverändert, {} Logos geladen",
+             diff.newest_change, diff.inserted, diff.updated, diff.deleted, diff.adopted, diff.unchanged, job.logos);
+    if (!diff.changed() && job.logos == 0) return;
+    if (!store_stations(diff.stations)) return;
+    for (const auto& path : diff.stale_logos) std::remove(path.c_str());
+    refresh_radio_list(job.flowbox, job.radio_mgr);
+}
+
+// Gleicht die Senderliste mit radio-browser ab, statt sie neu zu importieren: über
+// stationuuid/changeuuid werden nur neue, geänderte und entfallene Sender übernommen,
+// Logos nur bei Bedarf geladen. Selbst angelegte Sender bleiben unverändert erhalten.
+// Kehrt sofort zurück; Netz und Diff laufen im Hintergrund. Ist der Abgleich zurückgestellt,
+// startet er erst mit set_seeding_deferred(false).
+void perform_seeding(GtkWidget *flowbox, RadioManager *radio_mgr) {
+    static bool running = false; // nur im Main-Thread gelesen und geschrieben
+    if (running) {
+        LOG_INFO("Seeding", "Abgleich läuft bereits");
+        return;
+    }
+    if (seeding_deferred.load(std::memory_order_relaxed)) {
+        LOG_INFO("Seeding", "Abgleich zurückgestellt (Gerät zu warm), startet nach dem Abkühlen");
+        deferred_seeding = {flowbox, radio_mgr};
+        return;
+    }
+    running = true;
+
+    auto *job = new SeedJob{};
+    job->flowbox = flowbox;
+    job->radio_mgr = radio_mgr;
+    job->local = load_stations();
+    job->removed = load_removed_stations();
+    job->stamp = stations_stamp();
+    ThreadRegistry::spawn("caros-seeding", "background", [job]() {
+        fetch_catalog(*job);
+        g_idle_add([](gpointer data) -> gboolean {
+            auto *j = static_cast<SeedJob*>(data);
+            apply_seeding(*j);
+            delete j;
+            running = false;
+            return G_SOURCE_REMOVE;
+        }, job);
+    }).detach();
+}
+
+// Main-Thread (ThermalGovernor-Listener)
+static void set_seeding_deferred(bool deferred) {
+    if (seeding_deferred.exchange(deferred) == deferred || deferred || !deferred_seeding.first) return;
+    auto request = deferred_seeding;
+    deferred_seeding = {nullptr, nullptr};
+    perform_seeding(request.first, request.second);
 }
 
 // --- UI Erstellung ---
@@ -286,8 +563,7 @@ GtkWidget* create_navigation_page(GPSManager *gps_mgr) {
     gtk_widget_add_css_class(nav_box, "navigation-container");
 
     // Icon für Navigation
-    GtkWidget *nav_icon = gtk_image_new_from_file("assets/icons/navigation.png");
-    gtk_image_set_pixel_size(GTK_IMAGE(nav_icon), 80);
+    GtkWidget *nav_icon = ui_assets::image_new("icons/navigation.png", 80);
     gtk_box_append(GTK_BOX(nav_box), nav_icon);
 
     GtkWidget *status_label = gtk_label_new("Warte auf GPS Fix...");
@@ -298,7 +574,7 @@ GtkWidget* create_navigation_page(GPSManager *gps_mgr) {
     gtk_box_append(GTK_BOX(nav_box), detail_label);
 
     // Timer zum UI-Update der GPS-Daten (1Hz)
-    g_timeout_add_seconds(1, [](gpointer data) -> gboolean {
+    NamedSource::timeout_seconds("gps-ui", 1, [](gpointer data) -> gboolean {
         auto* labels = static_cast<GtkWidget**>(data);
         GtkLabel* l_status = GTK_LABEL(labels[0]);
         GtkLabel* l_detail = GTK_LABEL(labels[1]);
@@ -328,6 +604,42 @@ GtkWidget* create_navigation_page(GPSManager *gps_mgr) {
     return nav_box;
 }
 
+// Equalizer: ein vertikaler Regler pro Band, gespeichert beim Schließen des Popovers
+void attach_equalizer_popover(GtkWidget *button, RadioManager *radio_mgr) {
+    GtkWidget *popover = gtk_popover_new();
+    GtkWidget *bands_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
+    gtk_widget_add_css_class(bands_box, "eq-bands");
+
+    for (int b = 0; b < AudioEqualizer::BANDS; b++) {
+        GtkWidget *column = gtk_box_new(GTK_ORIENTATION_VERTICAL, 6);
+        GtkWidget *scale = gtk_scale_new_with_range(GTK_ORIENTATION_VERTICAL, -AudioEqualizer::MAX_GAIN_DB, AudioEqualizer::MAX_GAIN_DB, 1.0);
+        gtk_range_set_inverted(GTK_RANGE(scale), TRUE); // oben = lauter
+        gtk_range_set_value(GTK_RANGE(scale), radio_mgr->eq_gain(b));
+        gtk_scale_add_mark(GTK_SCALE(scale), 0.0, GTK_POS_RIGHT, nullptr);
+        gtk_widget_set_size_request(scale, -1, 220);
+        gtk_widget_add_css_class(scale, "eq-scale");
+        g_object_set_data(G_OBJECT(scale), "band", GINT_TO_POINTER(b));
+        g_signal_connect(scale, "value-changed", G_CALLBACK(+[](GtkRange *r, gpointer data) {
+            int band = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(r), "band"));
+            static_cast<RadioManager*>(data)->set_eq_gain(band, static_cast<float>(gtk_range_get_value(r)));
+        }), radio_mgr);
+
+        float freq = AudioEqualizer::bands()[b].freq;
+        char label[16];
+        if (freq >= 1000.0f) snprintf(label, sizeof(label), "%gk", freq / 1000.0f);
+        else snprintf(label, sizeof(label), "%g", freq);
+
+        gtk_box_append(GTK_BOX(column), scale);
+        gtk_box_append(GTK_BOX(column), gtk_label_new(label));
+        gtk_box_append(GTK_BOX(bands_box), column);
+    }
+
+    gtk_popover_set_child(GTK_POPOVER(popover), bands_box);
+    gtk_widget_set_parent(popover, button);
+    g_signal_connect_swapped(popover, "closed", G_CALLBACK(+[](RadioManager *m) { m->save_eq(); }), radio_mgr);
+    g_signal_connect(button, "clicked", G_CALLBACK(+[](GtkWidget*, gpointer p) { gtk_popover_popup(GTK_POPOVER(p)); }), popover);
+}
+
 GtkWidget* create_radio_page(RadioManager **mgr_out, AppWidgets* widgets) {
     GtkWidget *radio_scroll = gtk_scrolled_window_new();
     gtk_widget_set_vexpand(radio_scroll, TRUE);
@@ -340,6 +652,9 @@ GtkWidget* create_radio_page(RadioManager **mgr_out, AppWidgets* widgets) {
     gtk_widget_add_css_class(meta_label, "radio-metadata");
     *mgr_out = new RadioManager(meta_label);
 
+    // Spektrum der laufenden Wiedergabe, abgegriffen hinter dem EQ (im Daemon oder lokal)
+    SpectrumVisualizer *visualizer = new SpectrumVisualizer((*mgr_out)->spectrum());
+
     GtkWidget *action_row = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 10);
     gtk_widget_set_halign(action_row, GTK_ALIGN_CENTER);
 
@@ -350,8 +665,19 @@ GtkWidget* create_radio_page(RadioManager **mgr_out, AppWidgets* widgets) {
     gtk_widget_add_css_class(seed_btn, "glass-button");
     gtk_widget_add_css_class(seed_btn, "seed-button");
 
+    GtkWidget *eq_btn = gtk_button_new_from_icon_name("emblem-system-symbolic");
+    gtk_widget_add_css_class(eq_btn, "glass-button");
+    attach_equalizer_popover(eq_btn, *mgr_out);
+
+    GtkWidget *search_entry = gtk_search_entry_new();
+    g_object_set(search_entry, "placeholder-text", "Sender suchen...", NULL);
+    gtk_widget_add_css_class(search_entry, "station-search");
+    gtk_widget_set_hexpand(search_entry, TRUE);
+
     gtk_box_append(GTK_BOX(action_row), add_btn);
+    gtk_box_append(GTK_BOX(action_row), search_entry);
     gtk_box_append(GTK_BOX(action_row), seed_btn);
+    gtk_box_append(GTK_BOX(action_row), eq_btn);
 
     GtkWidget *popover = gtk_popover_new();
     GtkWidget *form = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
@@ -362,17 +688,22 @@ GtkWidget* create_radio_page(RadioManager **mgr_out, AppWidgets* widgets) {
     GtkWidget *s_btn = gtk_button_new_with_label("Speichern");
 
     // Helper: Wenn Entry Fokus erhält, Tastatur-Ziel setzen
-    auto connect_kb = [&](GtkWidget* entry) {
+    // (mit "kb_complete" werden Sendernamen als Vorschläge angeboten)
+    auto connect_kb = [&](GtkWidget* entry, bool with_completion) {
+        g_object_set_data(G_OBJECT(entry), "kb_complete", GINT_TO_POINTER(with_completion));
         GtkEventController *c = gtk_event_controller_focus_new();
         g_signal_connect(c, "enter", G_CALLBACK(+[](GtkEventControllerFocus* ctrl, gpointer data){
             AppWidgets* w = static_cast<AppWidgets*>(data);
-            w->keyboard->set_target(GTK_EDITABLE(gtk_event_controller_get_widget(GTK_EVENT_CONTROLLER(ctrl))));
+            GtkWidget *target = gtk_event_controller_get_widget(GTK_EVENT_CONTROLLER(ctrl));
+            w->keyboard->set_target(GTK_EDITABLE(target), GPOINTER_TO_INT(g_object_get_data(G_OBJECT(target), "kb_complete")));
             gtk_revealer_set_reveal_child(GTK_REVEALER(w->keyboard_revealer), TRUE);
         }), widgets);
         gtk_widget_add_controller(entry, c);
     };
-    connect_kb(e_name);
-    connect_kb(e_url);
+    connect_kb(e_name, true);
+    connect_kb(e_url, false);
+
+    connect_kb(search_entry, true);
     
     gtk_box_append(GTK_BOX(form), e_name); gtk_box_append(GTK_BOX(form), e_url); gtk_box_append(GTK_BOX(form), s_btn);
     
@@ -387,9 +718,51 @@ GtkWidget* create_radio_page(RadioManager **mgr_out, AppWidgets* widgets) {
     gtk_flow_box_set_row_spacing(GTK_FLOW_BOX(flowbox), 20);    // Abstand zwischen Zeilen
     gtk_widget_set_valign(flowbox, GTK_ALIGN_START);
 
+    // Sender in der Nähe (nur sichtbar mit GPS-Fix und Sendern mit Koordinaten)
+    GtkWidget *nearby_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 10);
+    gtk_widget_set_halign(nearby_box, GTK_ALIGN_CENTER);
+    gtk_widget_add_css_class(nearby_box, "nearby-stations");
+    gtk_widget_set_visible(nearby_box, FALSE);
+
+    NearbyData *nd = new NearbyData();
+    nd->box = nearby_box;
+    nd->radio_mgr = *mgr_out;
+    nd->gps_mgr = widgets->gps_mgr;
+    g_object_set_data(G_OBJECT(flowbox), "nearby", nd);
+    g_object_set_data(G_OBJECT(flowbox), "keyboard", widgets->keyboard);
+    widgets->logos = new LogoCache();
+    widgets->radio_flowbox = flowbox;
+    g_object_set_data(G_OBJECT(flowbox), "logos", widgets->logos);
+
+    // Suche: Filter blendet Nicht-Treffer aus, Sortierung nach Rang (sonst Listenreihenfolge)
+    SearchData *search = new SearchData();
+    search->entry = search_entry;
+    search->flowbox = flowbox;
+    g_object_set_data(G_OBJECT(flowbox), "search", search);
+    gtk_flow_box_set_filter_func(GTK_FLOW_BOX(flowbox), [](GtkFlowBoxChild *child, gpointer data) -> gboolean {
+        auto* sd = static_cast<SearchData*>(data);
+        return !sd->active || sd->rank.count(station_index_of(child)) > 0;
+    }, search, nullptr);
+    gtk_flow_box_set_sort_func(GTK_FLOW_BOX(flowbox), [](GtkFlowBoxChild *a, GtkFlowBoxChild *b, gpointer data) -> int {
+        auto* sd = static_cast<SearchData*>(data);
+        int ia = station_index_of(a), ib = station_index_of(b);
+        if (sd->active) {
+            auto ra = sd->rank.find(ia), rb = sd->rank.find(ib);
+            int va = ra != sd->rank.end() ? ra->second : G_MAXINT;
+            int vb = rb != sd->rank.end() ? rb->second : G_MAXINT;
+            if (va != vb) return va < vb ? -1 : 1;
+        }
+        return ia - ib;
+    }, search, nullptr);
+    g_signal_connect(search_entry, "changed", G_CALLBACK(+[](GtkEditable*, gpointer data) {
+        apply_station_search(static_cast<SearchData*>(data));
+    }), search);
+    NamedSource::timeout_seconds("nearby-stations", 1, update_nearby_stations, nd);
+
     SaveData *sd = new SaveData{GTK_ENTRY(e_name), GTK_ENTRY(e_url), flowbox, *mgr_out, GTK_POPOVER(popover), widgets};
     g_signal_connect(s_btn, "clicked", G_CALLBACK(+[](GtkWidget*, gpointer data) {
         auto* d = static_cast<SaveData*>(data);
+        WatchdogSection section("save_station");
         save_station(gtk_editable_get_text(GTK_EDITABLE(d->name_entry)), gtk_editable_get_text(GTK_EDITABLE(d->url_entry)));
         refresh_radio_list(d->flowbox, d->radio_mgr);
         gtk_revealer_set_reveal_child(GTK_REVEALER(d->widgets->keyboard_revealer), FALSE);
@@ -402,13 +775,15 @@ GtkWidget* create_radio_page(RadioManager **mgr_out, AppWidgets* widgets) {
     SeedData* sc = new SeedData{flowbox, *mgr_out};
     g_signal_connect(seed_btn, "clicked", G_CALLBACK(+[](GtkWidget*, gpointer data) {
         auto* d = static_cast<SeedData*>(data);
-        perform_seeding(d->fb, d->rm); 
+        perform_seeding(d->fb, d->rm);
     }), sc);
 
     refresh_radio_list(flowbox, *mgr_out);
 
     gtk_box_append(GTK_BOX(radio_box), meta_label);
+    gtk_box_append(GTK_BOX(radio_box), visualizer->get_widget());
     gtk_box_append(GTK_BOX(radio_box), action_row);
+    gtk_box_append(GTK_BOX(radio_box), nearby_box);
     gtk_box_append(GTK_BOX(radio_box), flowbox);
     gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(radio_scroll), radio_box);
     
@@ -416,18 +791,47 @@ GtkWidget* create_radio_page(RadioManager **mgr_out, AppWidgets* widgets) {
 }
 
 // (Bluetooth-Seite bleibt gleich)
-GtkWidget* create_bluetooth_page() {
+GtkWidget* create_bluetooth_page(int64_t start_us, bool live, BluetoothManager **mgr_out) {
     GtkWidget *bt_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 20);
-    GtkWidget *bt_list = gtk_list_box_new();
+    GtkWidget *bt_list = gtk_list_view_new(nullptr, nullptr);
     gtk_widget_add_css_class(bt_list, "bt-list");
-    static BluetoothManager *bt_mgr = new BluetoothManager(GTK_LIST_BOX(bt_list));
+    static BluetoothManager *bt_mgr = new BluetoothManager(GTK_LIST_VIEW(bt_list), start_us, live);
+    *mgr_out = bt_mgr;
+    GtkWidget *bt_scroll = gtk_scrolled_window_new();
+    gtk_widget_set_vexpand(bt_scroll, TRUE);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(bt_scroll), GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(bt_scroll), bt_list);
     GtkWidget *scan_btn = gtk_button_new_with_label("Nach Geräten suchen");
     g_signal_connect(scan_btn, "clicked", G_CALLBACK(+[](GtkButton*, gpointer d) { static_cast<BluetoothManager*>(d)->start_discovery(); }), bt_mgr);
-    gtk_box_append(GTK_BOX(bt_box), bt_list);
+    gtk_box_append(GTK_BOX(bt_box), bt_scroll);
     gtk_box_append(GTK_BOX(bt_box), scan_btn);
     return bt_box;
 }
 
+// Medien: Titel von USB-Datenträgern, lückenlos über das playbin des Radios abgespielt
+GtkWidget* create_media_page(RadioManager *radio_mgr, MediaLibrary **library_out) {
+    GtkWidget *media_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 20);
+    GtkWidget *status_label = gtk_label_new("Kein USB-Datenträger");
+    gtk_widget_add_css_class(status_label, "media-status");
+    GtkWidget *media_list = gtk_list_view_new(nullptr, nullptr);
+    gtk_widget_add_css_class(media_list, "media-list");
+
+    MediaLibrary *library = new MediaLibrary(GTK_LIST_VIEW(media_list), GTK_LABEL(status_label));
+    *library_out = library;
+    library->set_play_callback([radio_mgr](std::vector<std::string> queue) {
+        radio_mgr->play_queue(std::move(queue));
+    });
+    library->start();
+
+    GtkWidget *media_scroll = gtk_scrolled_window_new();
+    gtk_widget_set_vexpand(media_scroll, TRUE);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(media_scroll), GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(media_scroll), media_list);
+    gtk_box_append(GTK_BOX(media_box), status_label);
+    gtk_box_append(GTK_BOX(media_box), media_scroll);
+    return media_box;
+}
+
 // GPIO Callback Wrapper
 void on_encoder_event(bool clockwise, gpointer data) {
     // @TODO: Implement real volume setting
@@ -448,18 +852,67 @@ void on_encoder_event(bool clockwise, gpointer data) {
     }, w);
 }
 
+// CAROS_INPUT_REPLAY: aufgezeichnete Eingaben statt Drehgeber, gpsd, BlueZ und Wiedergabe-Meldungen
+// abspielen (CAROS_REPLAY_SPEED = Faktor, 0 = ohne Pausen). Mit CAROS_REPLAY_METRICS landen
+// die Metriken danach in dieser Datei und die App beendet sich (Benchmarks im CI).
+static InputReplay* load_replay() {
+    const char *path = g_getenv("CAROS_INPUT_REPLAY");
+    if (!path) return nullptr;
+    std::vector<InputEvent> events;
+    std::string error;
+    if (!load_input_trace(path, events, error)) {
+        LOG_ERROR("Replay", "Trace nicht geladen ({}), nutze die echten Eingaben", error);
+        return nullptr;
+    }
+    const char *speed_env = g_getenv("CAROS_REPLAY_SPEED");
+    double speed = speed_env ? g_ascii_strtod(speed_env, nullptr) : 1.0;
+    return new InputReplay(std::move(events), speed);
+}
+
+static void start_replay(InputReplay *replay, AppWidgets *widgets, GtkApplication *app) {
+    InputSinks sinks;
+    sinks.encoder = [widgets, decoder = EncoderDecoder(ENCODER_PIN_A)](const EncoderEdge& edge) mutable {
+        handle_encoder_edge(decoder, edge, on_encoder_event, widgets);
+    };
+    sinks.gps = [widgets](const GpsReport& report) { widgets->gps_mgr->apply_report(report); };
+    sinks.bluetooth = [widgets](const std::string& path, const BluetoothDeviceDelta& delta, bool removed) {
+        widgets->bt_mgr->replay(path, delta, removed);
+    };
+    sinks.stream = [widgets](const StreamBusEvent& e) { widgets->radio_mgr->replay_stream_event(e); };
+    sinks.finished = [app]() {
+        const char *metrics_file = g_getenv("CAROS_REPLAY_METRICS");
+        if (!metrics_file) return;
+        std::ofstream out(metrics_file);
+        out << MetricsRegistry::instance().render_prometheus();
+        LOG_INFO("Replay", "Metriken nach {} geschrieben, beende", metrics_file);
+        g_application_quit(G_APPLICATION(app));
+    };
+    replay->start(std::move(sinks));
+}
+
 static void activate(GtkApplication *app, gpointer) {
     AppWidgets *widgets = new AppWidgets();
+    widgets->start_us = g_get_monotonic_time();
+
+    // Hänger der Main-Loop erkennen (Bericht per SIGUSR1 nach stall_reports.log)
+    MainLoopWatchdog::instance().start(250);
+
+    // Metriken im Prometheus-Format: curl --unix-socket /tmp/caros-metrics.sock http://localhost/metrics
+    const char *metrics_socket = g_getenv("CAROS_METRICS_SOCKET");
+    MetricsServer::serve(metrics_socket ? metrics_socket : "/tmp/caros-metrics.sock");
+
+    // Beim Replay kommen Drehgeber, GPS, Bluetooth und Wiedergabe-Meldungen aus der Trace-Datei
+    InputReplay *replay = load_replay();
 
     widgets->gps_mgr = new GPSManager();
-    widgets->gps_mgr->start();
+    if (!replay) widgets->gps_mgr->start();
     
     GtkWidget *window = gtk_application_window_new(app);
     gtk_window_set_default_size(GTK_WINDOW(window), 1024, 600);
     gtk_window_set_decorated(GTK_WINDOW(window), FALSE);
 
     GtkCssProvider *provider = gtk_css_provider_new();
-    gtk_css_provider_load_from_path(provider, "assets/style.css");
+    ui_assets::load_css(provider, "style.css");
     gtk_style_context_add_provider_for_display(gdk_display_get_default(), GTK_STYLE_PROVIDER(provider), GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
 
     GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
@@ -472,10 +925,17 @@ static void activate(GtkApplication *app, gpointer) {
     gtk_widget_add_css_class(top_clock, "top-clock");
     gtk_widget_set_hexpand(top_clock, TRUE);
     gtk_widget_set_halign(top_clock, GTK_ALIGN_END);
-    g_timeout_add_seconds(1, update_clock_label, top_clock);
+    NamedSource::timeout_seconds("clock", 1, update_clock_label, top_clock);
     GtkWidget *close_btn = gtk_button_new_from_icon_name("window-close-symbolic");
     gtk_widget_add_css_class(close_btn, "top-close-btn");
     g_signal_connect_swapped(close_btn, "clicked", G_CALLBACK(g_application_quit), app);
+    // Frame-Zeiten: Langes Drücken auf die Uhr blendet das Overlay ein/aus
+    FrameTimeMonitor *frame_monitor = new FrameTimeMonitor(window);
+    GtkGesture *clock_press = gtk_gesture_long_press_new();
+    g_signal_connect(clock_press, "pressed", G_CALLBACK(+[](GtkGestureLongPress*, double, double, gpointer data) {
+        static_cast<FrameTimeMonitor*>(data)->toggle_overlay();
+    }), frame_monitor);
+    gtk_widget_add_controller(top_clock, GTK_EVENT_CONTROLLER(clock_press));
     gtk_box_append(GTK_BOX(top_bar), top_clock);
     gtk_box_append(GTK_BOX(top_bar), close_btn);
     gtk_box_append(GTK_BOX(main_box), top_bar);
@@ -503,20 +963,62 @@ static void activate(GtkApplication *app, gpointer) {
     gtk_overlay_set_child(GTK_OVERLAY(overlay), widgets->stack);
     gtk_overlay_add_overlay(GTK_OVERLAY(overlay), widgets->keyboard_revealer);
     gtk_widget_set_valign(widgets->keyboard_revealer, GTK_ALIGN_END); // Unten ausrichten
+    gtk_overlay_add_overlay(GTK_OVERLAY(overlay), frame_monitor->get_overlay_widget());
 
     RadioManager *radio_mgr = nullptr;
     gtk_stack_add_titled(GTK_STACK(widgets->stack), create_radio_page(&radio_mgr, widgets), "radio", "Radio");
     widgets->radio_mgr = radio_mgr; // Manager im Struct speichern für Zugriff via GPIO
-    gtk_stack_add_titled(GTK_STACK(widgets->stack), create_bluetooth_page(), "bt", "Bluetooth");
+    radio_mgr->set_replaying(replay != nullptr);
+    MediaLibrary *media_library = nullptr;
+    gtk_stack_add_titled(GTK_STACK(widgets->stack), create_media_page(radio_mgr, &media_library), "media", "Medien");
+    gtk_stack_add_titled(GTK_STACK(widgets->stack), create_bluetooth_page(widgets->start_us, replay == nullptr, &widgets->bt_mgr), "bt", "Bluetooth");
+
+    // Speicherbudget: bei Druck zuerst Logos, dann Stream-Puffer, dann nicht sichtbare Seiten abwerfen
+    OffscreenPages *pages = new OffscreenPages{widgets->stack, widgets->radio_flowbox, radio_mgr};
+    g_signal_connect_swapped(widgets->stack, "notify::visible-child", G_CALLBACK(+[](OffscreenPages *p) {
+        p->on_page_changed();
+    }), pages);
+    MemoryPressureManager *memory = new MemoryPressureManager();
+    LogoCache *logos = widgets->logos;
+    memory->add_consumer("logos", [logos]() { return logos->bytes(); },
+                         [logos]() { logos->drop(); }, [logos]() { logos->reload(); });
+    memory->add_consumer("stream_buffers", [radio_mgr]() { return radio_mgr->buffer_bytes(); },
+                         [radio_mgr]() { radio_mgr->set_low_memory(true); },
+                         [radio_mgr]() { radio_mgr->set_low_memory(false); });
+    memory->add_consumer("offscreen_pages", nullptr,
+                         [pages]() { pages->active = true; pages->reap(); },
+                         [pages]() { pages->active = false; });
+    memory->start();
+
+    // Thermik: bei Hitze oder zu langsamen Frames flach und ohne Animationen rendern,
+    // den Visualizer bremsen, Datenträger-Scans, Katalog-Abgleich und Logo-Downloads zurückstellen
+    GtkCssProvider *flat_provider = gtk_css_provider_new();
+    ui_assets::load_css(flat_provider, "style-flat.css");
+    ThermalGovernor *thermal = new ThermalGovernor(frame_monitor);
+    thermal->add_listener([flat_provider, radio_mgr, media_library, flat = false](RenderProfile p) mutable {
+        bool want_flat = p != RenderProfile::Full;
+        if (want_flat != flat) {
+            GdkDisplay *display = gdk_display_get_default();
+            if (want_flat) gtk_style_context_add_provider_for_display(display, GTK_STYLE_PROVIDER(flat_provider), GTK_STYLE_PROVIDER_PRIORITY_APPLICATION + 1);
+            else gtk_style_context_remove_provider_for_display(display, GTK_STYLE_PROVIDER(flat_provider));
+            flat = want_flat;
+        }
+        // Gilt für CSS-Transitions genauso wie für Stack- und Revealer-Animationen
+        g_object_set(gtk_settings_get_default(), "gtk-enable-animations", (gboolean)(p == RenderProfile::Full), NULL);
+        radio_mgr->spectrum()->set_rate_hz(p == RenderProfile::Full ? 30 : p == RenderProfile::Reduced ? 15 : 5);
+        media_library->set_deferred(p != RenderProfile::Full);
+        set_seeding_deferred(p != RenderProfile::Full);
+    });
+    thermal->start();
 
     GtkWidget *nav_bar = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
     gtk_widget_add_css_class(nav_bar, "bottom-bar");
 
     const char* icon_paths[] = {
-        "assets/icons/radio.png", 
-        "assets/icons/media.png", 
-        "assets/icons/navigation.png", 
-        "assets/icons/bluetooth.png"
+        "icons/radio.png", 
+        "icons/media.png", 
+        "icons/navigation.png", 
+        "icons/bluetooth.png"
     };
     const char* ids[] = {"radio", "media", "navi", "bt"};
 
@@ -534,15 +1036,45 @@ static void activate(GtkApplication *app, gpointer) {
 
     gtk_box_append(GTK_BOX(main_box), overlay);
     gtk_box_append(GTK_BOX(main_box), nav_bar);
+    // Startup-Metrik: Zeit bis zum ersten gezeichneten Frame
+    g_signal_connect(window, "realize", G_CALLBACK(+[](GtkWidget *w, gpointer data) {
+        g_signal_connect(gtk_widget_get_frame_clock(w), "after-paint", G_CALLBACK(+[](GdkFrameClock *clock, gpointer d) {
+            static Gauge& first_frame = MetricsRegistry::instance().gauge("caros_startup_first_frame_ms", "Zeit vom Start bis zum ersten Frame (ms)");
+            int64_t ms = (g_get_monotonic_time() - static_cast<AppWidgets*>(d)->start_us) / 1000;
+            first_frame.set(static_cast<double>(ms));
+            LOG_INFO("Main", "Erster Frame nach {} ms", ms);
+            g_signal_handlers_disconnect_by_data(clock, d);
+        }), data);
+    }), widgets);
     gtk_window_present(GTK_WINDOW(window));
 
+    if (replay) {
+        start_replay(replay, widgets, app);
+        return;
+    }
+
     // GPIO Thread starten (Pins 17 und 27 als Beispiel für Encoder A/B)
-    std::thread gpio_thread(monitor_encoder, 17, 27, on_encoder_event, widgets);
-    gpio_thread.detach();
+    ThreadRegistry::spawn("caros-encoder", "encoder", [widgets]() {
+        monitor_encoder(ENCODER_PIN_A, ENCODER_PIN_B, on_encoder_event, widgets);
+    }).detach();
 }
 
 int main(int argc, char **argv) {
+    ThreadRegistry::instance().register_current("", "ui"); // Name bleibt der Prozessname
+    Logger::instance().start();
+    curl_global_init(CURL_GLOBAL_DEFAULT); // vor allen Threads, die curl benutzen (Seeding)
+
+    // Alle Eingaben von außen für ein späteres Replay mitschreiben (siehe input_trace.hpp)
+    const char *record_path = g_getenv("CAROS_INPUT_RECORD");
+    if (record_path && !InputRecorder::instance().start(record_path)) {
+        LOG_ERROR("Main", "Aufnahme nach {} nicht möglich", record_path);
+    }
+
     GtkApplication *app = gtk_application_new("com.car.os", G_APPLICATION_DEFAULT_FLAGS);
     g_signal_connect(app, "activate", G_CALLBACK(activate), NULL);
-    return g_application_run(G_APPLICATION(app), argc, argv);
+    int status = g_application_run(G_APPLICATION(app), argc, argv);
+
+    InputRecorder::instance().stop();
+    Logger::instance().flush();
+    return status;
 }
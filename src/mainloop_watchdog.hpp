@@ -0,0 +1,314 @@
+#ifndef MAINLOOP_WATCHDOG_HPP
+#define MAINLOOP_WATCHDOG_HPP
+
+#include <gtk/gtk.h>
+#include <glib-unix.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+#include "named_source.hpp"
+#include "metrics.hpp"
+#include "logger.hpp"
+#include "thread_registry.hpp"
+
+// Ein erkannter Hänger der GTK Main-Loop
+struct StallReport {
+    int64_t started_at;   // Unix-Zeit in Sekunden
+    int64_t duration_ms;
+    char section[48];     // WatchdogSection, sonst der laufende NamedSource-Timer, sonst "unbekannt"
+};
+
+// Überwacht die Default-Main-Loop aus einem eigenen Thread.
+// Ein Heartbeat-Timer im Main-Thread setzt einen Zeitstempel; bleibt er länger als
+// threshold_ms aus, wird ein Hänger samt Verursacher im Ringpuffer festgehalten.
+// Verursacher ist der betretene WatchdogSection-Abschnitt, sonst der gerade laufende
+// NamedSource-Timer. Beides sind Atomics, der Watchdog-Thread fasst den Main-Thread nicht an.
+// SIGUSR1 schreibt den Ringpuffer nach stall_reports.log (Auslesen im Feld).
+class MainLoopWatchdog {
+public:
+    static constexpr size_t RING_SIZE = 64;
+
+    static MainLoopWatchdog& instance() {
+        static MainLoopWatchdog wd;
+        return wd;
+    }
+
+    void start(int threshold_ms = 250, const std::string& dump_path = "stall_reports.log") {
+        if (running) return;
+        threshold_us = threshold_ms * 1000LL;
+        report_path = dump_path;
+        last_beat_us = g_get_monotonic_time();
+        running = true;
+        install_poll_wrapper();
+
+        // Verspätung des Heartbeats gegenüber dem 50-ms-Takt = Latenz der Main-Loop
+        beat_delay = &MetricsRegistry::instance().histogram("caros_mainloop_beat_delay_us", "Verspätung des Main-Loop-Heartbeats (us)");
+        stalls_metric = &MetricsRegistry::instance().counter("caros_mainloop_stalls_total", "Erkannte Hänger der Main-Loop");
+
+        g_timeout_add_full(G_PRIORITY_HIGH, 50, [](gpointer data) -> gboolean {
+            auto *self = static_cast<MainLoopWatchdog*>(data);
+            int64_t now = g_get_monotonic_time();
+            int64_t late = now - self->last_beat_us.load(std::memory_order_relaxed) - 50000;
+            self->beat_delay->record(late > 0 ? static_cast<uint64_t>(late) : 0);
+            self->last_beat_us.store(now, std::memory_order_relaxed);
+            return G_SOURCE_CONTINUE;
+        }, this, nullptr);
+
+        g_unix_signal_add(SIGUSR1, [](gpointer data) -> gboolean {
+            static_cast<MainLoopWatchdog*>(data)->dump();
+            return G_SOURCE_CONTINUE;
+        }, this);
+
+        watcher = ThreadRegistry::spawn("caros-watchdog", "background", [this]() { watch_loop(); });
+        watcher.detach();
+    }
+
+    // Abschnitt, der gerade im Main-Thread läuft (nur statische Strings!), nullptr = keiner
+    static void enter_section(const char *name) { current_section().store(name, std::memory_order_relaxed); }
+    static const char* section() { return current_section().load(std::memory_order_relaxed); }
+
+    size_t stall_count() const { return total_stalls.load(std::memory_order_relaxed); }
+
+    // Schreibt alle Einträge des Ringpuffers (älteste zuerst) in die Log-Datei
+    void dump() {
+        std::lock_guard<std::mutex> lock(ring_mutex);
+        FILE *f = fopen(report_path.c_str(), "w");
+        if (!f) return;
+        size_t n = std::min(ring_count, RING_SIZE);
+        for (size_t i = 0; i < n; i++) {
+            const StallReport& r = ring[(ring_next + RING_SIZE - n + i) % RING_SIZE];
+            time_t t = static_cast<time_t>(r.started_at);
+            char when[32];
+            strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", localtime(&t));
+            fprintf(f, "%s;%lld ms;%s\n", when, (long long)r.duration_ms, r.section);
+        }
+        fclose(f);
+        LOG_INFO("Watchdog", "{} Hänger nach {} geschrieben.", n, report_path);
+    }
+
+private:
+    std::atomic<bool> running{false};
+    std::atomic<int64_t> last_beat_us{0};
+    std::atomic<size_t> total_stalls{0};
+    int64_t threshold_us = 250000;
+    std::string report_path;
+    Histogram *beat_delay = nullptr;
+    Counter *stalls_metric = nullptr;
+    std::thread watcher;
+
+    // Main-Thread wartet in poll(): ein ausbleibender Heartbeat ist dann kein Handler-Hänger
+    static inline std::atomic<bool> polling{false};
+    static inline GPollFunc default_poll = nullptr;
+
+    std::mutex ring_mutex;
+    std::array<StallReport, RING_SIZE> ring{};
+    size_t ring_next = 0;
+    size_t ring_count = 0;
+
+    static std::atomic<const char*>& current_section() {
+        static std::atomic<const char*> name{nullptr};
+        return name;
+    }
+
+    // Poll-Funktion des Default-Kontexts umhüllen, um Leerlauf zu erkennen
+    void install_poll_wrapper() {
+        default_poll = g_main_context_get_poll_func(nullptr);
+        g_main_context_set_poll_func(nullptr, [](GPollFD *fds, guint n, gint timeout) -> gint {
+            polling.store(true, std::memory_order_relaxed);
+            gint r = default_poll(fds, n, timeout);
+            polling.store(false, std::memory_order_relaxed);
+            return r;
+        });
+    }
+
+    // Wer blockiert gerade den Main-Thread? Aufruf aus dem Watchdog-Thread, liest nur Atomics.
+    std::string attribute_stall() {
+        if (const char *name = section()) return name;
+        if (polling.load(std::memory_order_relaxed)) return "poll";
+        if (const char *name = NamedSource::running()) return name;
+        return "unbekannt";
+    }
+
+    void watch_loop() {
+        bool stalled = false;
+        int64_t stall_start_us = 0;
+        std::string stall_section;
+
+        while (running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            int64_t now = g_get_monotonic_time();
+            int64_t beat = last_beat_us.load(std::memory_order_relaxed);
+
+            if (!stalled && now - beat > threshold_us) {
+                stalled = true;
+                stall_start_us = beat;
+                stall_section = attribute_stall();
+                LOG_WARN("Watchdog", "Main-Loop hängt seit {} ms in '{}'", (now - beat) / 1000, stall_section);
+            } else if (stalled && beat > stall_start_us) {
+                // Heartbeat ist wieder da -> Hänger abschließen
+                stalled = false;
+                record(stall_start_us, beat - stall_start_us, stall_section);
+            }
+        }
+    }
+
+    void record(int64_t start_us, int64_t duration_us, const std::string& name) {
+        StallReport r{};
+        r.started_at = (g_get_real_time() - (g_get_monotonic_time() - start_us)) / G_USEC_PER_SEC;
+        r.duration_ms = duration_us / 1000;
+        snprintf(r.section, sizeof(r.section), "%s", name.c_str());
+
+        {
+            std::lock_guard<std::mutex> lock(ring_mutex);
+            ring[ring_next] = r;
+            ring_next = (ring_next + 1) % RING_SIZE;
+            ring_count++;
+        }
+        total_stalls.fetch_add(1, std::memory_order_relaxed);
+        stalls_metric->inc();
+        LOG_WARN("Watchdog", "Hänger beendet: {} ms in '{}'", r.duration_ms, r.section);
+    }
+};
+
+// Markiert einen Abschnitt im Main-Thread für die Hänger-Berichte:
+//   WatchdogSection section("perform_seeding");
+class WatchdogSection {
+public:
+    explicit WatchdogSection(const char *name) : previous(MainLoopWatchdog::section()) {
+        MainLoopWatchdog::enter_section(name);
+    }
+    ~WatchdogSection() { MainLoopWatchdog::enter_section(previous); }
+
+    WatchdogSection(const WatchdogSection&) = delete;
+    WatchdogSection& operator=(const WatchdogSection&) = delete;
+
+private:
+    const char *previous;
+};
+
+// Frame-Zeiten über die GdkFrameClock: Dauer von before-paint bis after-paint
+// als Histogramm, dazu ein einblendbares Overlay mit den aktuellen Werten.
+class FrameTimeMonitor {
+public:
+    // Obergrenzen der Histogramm-Buckets in ms (letzter Bucket = alles darüber)
+    static constexpr std::array<int, 7> BUCKET_MS = {4, 8, 16, 33, 50, 100, 250};
+    static constexpr int64_t SLOW_FRAME_US = 16667;
+
+    explicit FrameTimeMonitor(GtkWidget *window) : window(window) {
+        overlay_label = gtk_label_new("");
+        gtk_widget_add_css_class(overlay_label, "frame-overlay");
+        gtk_widget_set_halign(overlay_label, GTK_ALIGN_START);
+        gtk_widget_set_valign(overlay_label, GTK_ALIGN_START);
+        gtk_widget_set_can_target(overlay_label, FALSE);
+        gtk_widget_set_visible(overlay_label, FALSE);
+
+        // Die Frame-Clock gibt es erst nach dem Realize des Fensters
+        g_signal_connect(window, "realize", G_CALLBACK(+[](GtkWidget *w, gpointer data) {
+            static_cast<FrameTimeMonitor*>(data)->attach(gtk_widget_get_frame_clock(w));
+        }), this);
+        if (gtk_widget_get_realized(window)) attach(gtk_widget_get_frame_clock(window));
+    }
+
+    GtkWidget* get_overlay_widget() { return overlay_label; }
+
+    void toggle_overlay() {
+        bool visible = !gtk_widget_get_visible(overlay_label);
+        gtk_widget_set_visible(overlay_label, visible);
+        if (visible && !refresh_id) {
+            update_overlay();
+            refresh_id = g_timeout_add(500, [](gpointer data) -> gboolean {
+                auto *self = static_cast<FrameTimeMonitor*>(data);
+                if (!gtk_widget_get_visible(self->overlay_label)) {
+                    self->refresh_id = 0;
+                    return G_SOURCE_REMOVE;
+                }
+                self->update_overlay();
+                return G_SOURCE_CONTINUE;
+            }, this);
+        }
+    }
+
+    // Perzentil (0..100) aus dem Histogramm, Ergebnis = Bucket-Obergrenze in ms
+    int percentile_ms(double p) const {
+        uint64_t total = 0;
+        for (auto c : histogram) total += c;
+        if (total == 0) return 0;
+        uint64_t target = static_cast<uint64_t>(total * p / 100.0);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < histogram.size(); i++) {
+            seen += histogram[i];
+            if (seen > target) return i < BUCKET_MS.size() ? BUCKET_MS[i] : BUCKET_MS.back() * 2;
+        }
+        return BUCKET_MS.back() * 2;
+    }
+
+    int64_t max_frame_us() const { return worst_us; }
+    uint64_t frame_count() const { return frames; }
+
+    // Frames seit dem letzten Aufruf und davon die, die das 60-Hz-Budget gesprengt haben
+    struct Window {
+        uint64_t frames;
+        uint64_t slow;
+    };
+
+    Window take_window() {
+        Window w{frames - window_start_frames, slow_frames - window_start_slow};
+        window_start_frames = frames;
+        window_start_slow = slow_frames;
+        return w;
+    }
+
+private:
+    GtkWidget *window;
+    GtkWidget *overlay_label;
+    GdkFrameClock *clock = nullptr;
+    guint refresh_id = 0;
+    int64_t paint_start_us = 0;
+    int64_t worst_us = 0;
+    uint64_t frames = 0;
+    uint64_t slow_frames = 0;
+    uint64_t window_start_frames = 0;
+    uint64_t window_start_slow = 0;
+    std::array<uint64_t, BUCKET_MS.size() + 1> histogram{};
+
+    void attach(GdkFrameClock *c) {
+        if (!c || c == clock) return;
+        clock = c;
+        g_signal_connect(clock, "before-paint", G_CALLBACK(+[](GdkFrameClock*, gpointer data) {
+            static_cast<FrameTimeMonitor*>(data)->paint_start_us = g_get_monotonic_time();
+        }), this);
+        g_signal_connect(clock, "after-paint", G_CALLBACK(+[](GdkFrameClock*, gpointer data) {
+            static_cast<FrameTimeMonitor*>(data)->record_frame();
+        }), this);
+    }
+
+    void record_frame() {
+        if (paint_start_us == 0) return;
+        int64_t us = g_get_monotonic_time() - paint_start_us;
+        paint_start_us = 0;
+
+        size_t bucket = 0;
+        while (bucket < BUCKET_MS.size() && us > BUCKET_MS[bucket] * 1000LL) bucket++;
+        histogram[bucket]++;
+        frames++;
+        if (us > SLOW_FRAME_US) slow_frames++;
+        if (us > worst_us) worst_us = us;
+    }
+
+    void update_overlay() {
+        char text[160];
+        snprintf(text, sizeof(text), "Frames %llu | p50 ≤%d ms | p95 ≤%d ms | max %.1f ms | Hänger %zu",
+                 (unsigned long long)frames, percentile_ms(50), percentile_ms(95),
+                 worst_us / 1000.0, MainLoopWatchdog::instance().stall_count());
+        gtk_label_set_text(GTK_LABEL(overlay_label), text);
+    }
+};
+
+#endif
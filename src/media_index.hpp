@@ -0,0 +1,540 @@
+#ifndef MEDIA_INDEX_HPP
+#define MEDIA_INDEX_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <strings.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "thread_registry.hpp"
+
+// Musikbibliothek auf USB-Datenträgern, ohne GTK: Tag-Leser, persistenter Index und
+// paralleler Verzeichnis-Scanner. Die Anbindung an Mounts, inotify und die Oberfläche
+// liegt in MediaLibrary (media_library.hpp).
+
+// Ein Titel, Pfad relativ zum Mount-Punkt
+struct MediaTrack {
+    std::string path;
+    std::string title;
+    std::string artist;
+    std::string album;
+    int64_t mtime_ns = 0;
+    uint64_t size = 0;
+    uint32_t duration_ms = 0; // 0 = unbekannt
+    // Sortierschlüssel für Interpret und Album (g_utf8_collate_key), wird beim Indexieren im
+    // Scan-Thread gesetzt und nicht gespeichert; siehe MediaLibrary
+    std::string sort_key;
+};
+
+// Liest Titel/Interpret/Album aus den ersten Kilobytes einer Datei:
+// ID3v2 (und ID3v1 am Dateiende) für MP3, Vorbis-Kommentare für FLAC, Ogg Vorbis und Opus.
+// Ohne Tags wird der Dateiname als Titel verwendet.
+class MediaTagReader {
+public:
+    static constexpr size_t HEAD_BYTES = 64 * 1024;
+
+    static bool is_audio(const char *name) {
+        const char *dot = std::strrchr(name, '.');
+        if (!dot) return false;
+        static const char *extensions[] = {".mp3", ".flac", ".ogg", ".oga", ".opus", ".m4a", ".aac", ".wav"};
+        for (const char *ext : extensions) {
+            if (strcasecmp(dot, ext) == 0) return true;
+        }
+        return false;
+    }
+
+    // track.path muss gesetzt sein (für den Fallback-Titel), full_path ist der absolute Pfad
+    static void read(const std::string& full_path, MediaTrack& track) {
+        int fd = open(full_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            std::string head(HEAD_BYTES, '\0');
+            ssize_t n = pread(fd, &head[0], head.size(), 0);
+            head.resize(n > 0 ? static_cast<size_t>(n) : 0);
+
+            if (head.compare(0, 3, "ID3") == 0) parse_id3v2(head, track);
+            else if (head.compare(0, 4, "fLaC") == 0) parse_flac(head, track);
+            else if (head.compare(0, 4, "OggS") == 0) parse_ogg(head, track);
+
+            if (track.title.empty() && track.size > 128) {
+                char tail[128];
+                if (pread(fd, tail, sizeof(tail), static_cast<off_t>(track.size - 128)) == 128) parse_id3v1(tail, track);
+            }
+            close(fd);
+        }
+        if (track.title.empty()) {
+            size_t slash = track.path.rfind('/');
+            track.title = track.path.substr(slash == std::string::npos ? 0 : slash + 1);
+            size_t dot = track.title.rfind('.');
+            if (dot != std::string::npos && dot > 0) track.title.erase(dot);
+        }
+    }
+
+private:
+    static uint32_t be32(const std::string& s, size_t i) {
+        return (uint32_t(uint8_t(s[i])) << 24) | (uint32_t(uint8_t(s[i + 1])) << 16) |
+               (uint32_t(uint8_t(s[i + 2])) << 8) | uint32_t(uint8_t(s[i + 3]));
+    }
+
+    static uint32_t le32(const std::string& s, size_t i) {
+        return uint32_t(uint8_t(s[i])) | (uint32_t(uint8_t(s[i + 1])) << 8) |
+               (uint32_t(uint8_t(s[i + 2])) << 16) | (uint32_t(uint8_t(s[i + 3])) << 24);
+    }
+
+    static uint32_t syncsafe(const std::string& s, size_t i) {
+        return (uint32_t(uint8_t(s[i]) & 0x7f) << 21) | (uint32_t(uint8_t(s[i + 1]) & 0x7f) << 14) |
+               (uint32_t(uint8_t(s[i + 2]) & 0x7f) << 7) | uint32_t(uint8_t(s[i + 3]) & 0x7f);
+    }
+
+    static void append_utf8(std::string& out, uint32_t cp) {
+        if (cp < 0x80) {
+            out += char(cp);
+        } else if (cp < 0x800) {
+            out += char(0xc0 | (cp >> 6));
+            out += char(0x80 | (cp & 0x3f));
+        } else if (cp < 0x10000) {
+            out += char(0xe0 | (cp >> 12));
+            out += char(0x80 | ((cp >> 6) & 0x3f));
+            out += char(0x80 | (cp & 0x3f));
+        } else {
+            out += char(0xf0 | (cp >> 18));
+            out += char(0x80 | ((cp >> 12) & 0x3f));
+            out += char(0x80 | ((cp >> 6) & 0x3f));
+            out += char(0x80 | (cp & 0x3f));
+        }
+    }
+
+    static std::string latin1(const char *p, size_t n) {
+        std::string out;
+        for (size_t i = 0; i < n && p[i]; i++) append_utf8(out, uint8_t(p[i]));
+        while (!out.empty() && out.back() == ' ') out.pop_back();
+        return out;
+    }
+
+    static std::string utf16(const char *p, size_t n, bool big_endian) {
+        std::string out;
+        if (n >= 2 && uint8_t(p[0]) == 0xff && uint8_t(p[1]) == 0xfe) { big_endian = false; p += 2; n -= 2; }
+        else if (n >= 2 && uint8_t(p[0]) == 0xfe && uint8_t(p[1]) == 0xff) { big_endian = true; p += 2; n -= 2; }
+        for (size_t i = 0; i + 1 < n; i += 2) {
+            uint32_t u = big_endian ? (uint8_t(p[i]) << 8) | uint8_t(p[i + 1]) : (uint8_t(p[i + 1]) << 8) | uint8_t(p[i]);
+            if (u == 0) break;
+            if (u >= 0xd800 && u < 0xdc00 && i + 3 < n) {
+                uint32_t lo = big_endian ? (uint8_t(p[i + 2]) << 8) | uint8_t(p[i + 3]) : (uint8_t(p[i + 3]) << 8) | uint8_t(p[i + 2]);
+                u = 0x10000 + ((u - 0xd800) << 10) + (lo - 0xdc00);
+                i += 2;
+            }
+            append_utf8(out, u);
+        }
+        return out;
+    }
+
+    // Textframe: erstes Byte ist die Kodierung (0 Latin-1, 1 UTF-16 mit BOM, 2 UTF-16BE, 3 UTF-8)
+    static std::string id3_text(const char *p, size_t n) {
+        if (n < 2) return "";
+        switch (p[0]) {
+            case 1: return utf16(p + 1, n - 1, false);
+            case 2: return utf16(p + 1, n - 1, true);
+            case 3: return std::string(p + 1, strnlen(p + 1, n - 1));
+            default: return latin1(p + 1, n - 1);
+        }
+    }
+
+    static void parse_id3v2(const std::string& head, MediaTrack& track) {
+        if (head.size() < 10) return;
+        int version = head[3];
+        size_t end = std::min(head.size(), size_t(10) + syncsafe(head, 6));
+        size_t pos = 10;
+        if (uint8_t(head[5]) & 0x40) { // erweiterter Header, Größe steht in den ersten 4 Bytes
+            if (head.size() < 14) return;
+            pos += version == 4 ? syncsafe(head, 10) : be32(head, 10) + 4;
+        }
+
+        while (pos + 10 <= end && head[pos] != '\0') {
+            std::string id = head.substr(pos, 4);
+            size_t size = version == 4 ? syncsafe(head, pos + 4) : be32(head, pos + 4);
+            pos += 10;
+            if (size == 0 || pos + size > end) break;
+            const char *body = head.data() + pos;
+            if (id == "TIT2") track.title = id3_text(body, size);
+            else if (id == "TPE1") track.artist = id3_text(body, size);
+            else if (id == "TALB") track.album = id3_text(body, size);
+            else if (id == "TLEN") track.duration_ms = static_cast<uint32_t>(std::strtoul(id3_text(body, size).c_str(), nullptr, 10));
+            pos += size;
+        }
+    }
+
+    static void parse_id3v1(const char *tail, MediaTrack& track) {
+        if (std::memcmp(tail, "TAG", 3) != 0) return;
+        track.title = latin1(tail + 3, 30);
+        if (track.artist.empty()) track.artist = latin1(tail + 33, 30);
+        if (track.album.empty()) track.album = latin1(tail + 63, 30);
+    }
+
+    // Vorbis-Kommentar: Hersteller, Anzahl, dann "SCHLÜSSEL=Wert", alles Little Endian
+    static void parse_vorbis_comment(const std::string& s, size_t pos, size_t end, MediaTrack& track) {
+        if (pos + 4 > end) return;
+        pos += 4 + le32(s, pos);
+        if (pos + 4 > end) return;
+        uint32_t count = le32(s, pos);
+        pos += 4;
+        for (uint32_t i = 0; i < count && pos + 4 <= end; i++) {
+            uint32_t len = le32(s, pos);
+            pos += 4;
+            if (pos + len > end) break;
+            std::string entry = s.substr(pos, len);
+            pos += len;
+            size_t eq = entry.find('=');
+            if (eq == std::string::npos) continue;
+            std::string key = entry.substr(0, eq);
+            for (char& c : key) c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+            if (key == "TITLE" && track.title.empty()) track.title = entry.substr(eq + 1);
+            else if (key == "ARTIST" && track.artist.empty()) track.artist = entry.substr(eq + 1);
+            else if (key == "ALBUM" && track.album.empty()) track.album = entry.substr(eq + 1);
+        }
+    }
+
+    static void parse_flac(const std::string& head, MediaTrack& track) {
+        size_t pos = 4;
+        while (pos + 4 <= head.size()) {
+            uint8_t type = uint8_t(head[pos]) & 0x7f;
+            bool last = uint8_t(head[pos]) & 0x80;
+            size_t len = (uint8_t(head[pos + 1]) << 16) | (uint8_t(head[pos + 2]) << 8) | uint8_t(head[pos + 3]);
+            pos += 4;
+            if (type == 0 && pos + 18 <= head.size()) {
+                // STREAMINFO: 20 Bit Abtastrate, 36 Bit Gesamtzahl der Samples
+                uint32_t rate = (uint8_t(head[pos + 10]) << 12) | (uint8_t(head[pos + 11]) << 4) | (uint8_t(head[pos + 12]) >> 4);
+                uint64_t samples = (uint64_t(uint8_t(head[pos + 13]) & 0x0f) << 32) | be32(head, pos + 14);
+                if (rate) track.duration_ms = static_cast<uint32_t>(samples * 1000 / rate);
+            } else if (type == 4) {
+                parse_vorbis_comment(head, pos, std::min(head.size(), pos + len), track);
+            }
+            if (last) break;
+            pos += len;
+        }
+    }
+
+    // Ogg: der Kommentar-Header steht praktisch immer in den ersten Seiten
+    static void parse_ogg(const std::string& head, MediaTrack& track) {
+        size_t pos = head.find("\x03vorbis");
+        if (pos != std::string::npos) pos += 7;
+        else if ((pos = head.find("OpusTags")) != std::string::npos) pos += 8;
+        else return;
+        parse_vorbis_comment(head, pos, head.size(), track);
+    }
+};
+
+// Kompakter Index eines Datenträgers, schlüssel ist der relative Pfad. Ein Titel gilt als
+// unverändert, solange mtime und Größe stimmen; dann werden die Tags nicht neu gelesen.
+// Binärformat: "CMI1", Anzahl, dann pro Titel Pfad/Titel/Interpret/Album (Länge + Bytes),
+// mtime, Größe, Dauer.
+//
+// remove() markiert nur (O(1) pro Datei); compact() räumt die markierten Titel in einem
+// Durchgang weg und baut by_path einmal neu auf. all() enthält bis dahin leere Pfade.
+class MediaIndex {
+public:
+    size_t size() const { return tracks.size() - removed; }
+    const std::vector<MediaTrack>& all() const { return tracks; }
+
+    const MediaTrack* find(const std::string& path) const {
+        auto it = by_path.find(path);
+        return it == by_path.end() ? nullptr : &tracks[it->second];
+    }
+
+    void upsert(MediaTrack track) {
+        auto it = by_path.find(track.path);
+        if (it != by_path.end()) {
+            tracks[it->second] = std::move(track);
+            return;
+        }
+        by_path[track.path] = tracks.size();
+        tracks.push_back(std::move(track));
+    }
+
+    // Entfernt eine Datei oder (mit Schrägstrich am Ende) alles unterhalb eines Ordners
+    size_t remove(const std::string& path) {
+        if (path.empty() || path.back() != '/') {
+            auto it = by_path.find(path);
+            if (it == by_path.end()) return 0;
+            drop(it->second);
+            by_path.erase(it);
+            return 1;
+        }
+        size_t count = 0;
+        for (size_t i = 0; i < tracks.size(); i++) {
+            if (tracks[i].path.empty() || tracks[i].path.compare(0, path.size(), path) != 0) continue;
+            by_path.erase(tracks[i].path);
+            drop(i);
+            count++;
+        }
+        return count;
+    }
+
+    // Entfernte Titel endgültig löschen (einmal pro Sammelintervall, nicht pro Ereignis)
+    void compact() {
+        if (removed == 0) return;
+        tracks.erase(std::remove_if(tracks.begin(), tracks.end(), [](const MediaTrack& t) { return t.path.empty(); }),
+                     tracks.end());
+        removed = 0;
+        reindex();
+    }
+
+    void assign(std::vector<MediaTrack> list) {
+        tracks = std::move(list);
+        removed = 0;
+        reindex();
+    }
+
+    bool load(const std::string& file) {
+        std::ifstream in(file, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (data.size() < 8 || data.compare(0, 4, "CMI1") != 0) return false;
+
+        size_t pos = 4;
+        uint32_t count = get<uint32_t>(data, pos);
+        std::vector<MediaTrack> list;
+        list.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            MediaTrack t;
+            if (!get_string(data, pos, t.path) || !get_string(data, pos, t.title) ||
+                !get_string(data, pos, t.artist) || !get_string(data, pos, t.album) ||
+                pos + 20 > data.size()) return false;
+            t.mtime_ns = get<int64_t>(data, pos);
+            t.size = get<uint64_t>(data, pos);
+            t.duration_ms = get<uint32_t>(data, pos);
+            list.push_back(std::move(t));
+        }
+        assign(std::move(list));
+        return true;
+    }
+
+    // Über temporäre Datei + rename, damit ein Abziehen mitten im Schreiben nichts zerstört
+    bool save(const std::string& file) const {
+        std::string data = "CMI1";
+        put<uint32_t>(data, static_cast<uint32_t>(size()));
+        for (const auto& t : tracks) {
+            if (t.path.empty()) continue; // entfernt, compact() steht noch aus
+            put_string(data, t.path);
+            put_string(data, t.title);
+            put_string(data, t.artist);
+            put_string(data, t.album);
+            put<int64_t>(data, t.mtime_ns);
+            put<uint64_t>(data, t.size);
+            put<uint32_t>(data, t.duration_ms);
+        }
+        std::string tmp = file + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            out.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!out) return false;
+        }
+        return std::rename(tmp.c_str(), file.c_str()) == 0;
+    }
+
+private:
+    std::vector<MediaTrack> tracks;
+    std::unordered_map<std::string, size_t> by_path;
+    size_t removed = 0; // Titel mit leerem Pfad in tracks
+
+    void drop(size_t i) {
+        tracks[i] = MediaTrack{};
+        removed++;
+    }
+
+    void reindex() {
+        by_path.clear();
+        by_path.reserve(tracks.size());
+        for (size_t i = 0; i < tracks.size(); i++) by_path[tracks[i].path] = i;
+    }
+
+    template<typename T>
+    static void put(std::string& out, T value) { out.append(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    template<typename T>
+    static T get(const std::string& in, size_t& pos) {
+        T value{};
+        if (pos + sizeof(T) <= in.size()) std::memcpy(&value, in.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    static void put_string(std::string& out, const std::string& s) {
+        put<uint16_t>(out, static_cast<uint16_t>(std::min<size_t>(s.size(), UINT16_MAX)));
+        out.append(s, 0, std::min<size_t>(s.size(), UINT16_MAX));
+    }
+
+    static bool get_string(const std::string& in, size_t& pos, std::string& s) {
+        if (pos + 2 > in.size()) return false;
+        uint16_t len = get<uint16_t>(in, pos);
+        if (pos + len > in.size()) return false;
+        s.assign(in, pos, len);
+        pos += len;
+        return true;
+    }
+};
+
+struct MediaScanStats {
+    size_t directories = 0;
+    size_t files = 0;
+    size_t reused = 0; // aus dem alten Index übernommen (mtime/Größe unverändert)
+    size_t parsed = 0; // Tags neu gelesen
+};
+
+struct MediaScanResult {
+    std::vector<MediaTrack> tracks;
+    std::vector<std::string> directories; // relativ, "" = Wurzel; für inotify-Watches
+    MediaScanStats stats;
+};
+
+// Paralleler Verzeichnis-Scanner: Ordner kommen in eine gemeinsame Warteschlange, jeder
+// Worker liest einen Ordner per openat/fstatat und stellt Unterordner wieder hinten an.
+// Tags werden nur für neue oder geänderte Dateien gelesen.
+class MediaScanner {
+public:
+    // on_directory (aus den Worker-Threads, gleichzeitig) bekommt jeden Ordner, bevor er gelesen
+    // wird: dort angelegte inotify-Watches verpassen keine Änderung während des Scans
+    static MediaScanResult scan(const std::string& root, const MediaIndex& previous,
+                                unsigned threads = 0, const std::string& subdir = "",
+                                std::function<void(const std::string&)> on_directory = nullptr) {
+        if (threads == 0) threads = std::clamp(std::thread::hardware_concurrency(), 2u, 8u);
+        MediaScanner scanner(root, previous);
+        scanner.on_directory = std::move(on_directory);
+        scanner.pending.push_back(subdir);
+
+        std::vector<std::thread> workers;
+        std::vector<MediaScanResult> partial(threads);
+        for (unsigned i = 0; i < threads; i++) {
+            workers.push_back(ThreadRegistry::spawn("caros-scan-" + std::to_string(i), "background",
+                                                    [&scanner, &part = partial[i]]() { scanner.work(part); }));
+        }
+        for (auto& w : workers) w.join();
+
+        MediaScanResult result;
+        for (auto& p : partial) {
+            result.tracks.insert(result.tracks.end(), std::make_move_iterator(p.tracks.begin()), std::make_move_iterator(p.tracks.end()));
+            result.directories.insert(result.directories.end(), p.directories.begin(), p.directories.end());
+            result.stats.directories += p.stats.directories;
+            result.stats.files += p.stats.files;
+            result.stats.reused += p.stats.reused;
+            result.stats.parsed += p.stats.parsed;
+        }
+        return result;
+    }
+
+    // Einzelne Datei (inotify): false, wenn sie nicht (mehr) existiert oder kein Audio ist
+    static bool scan_file(const std::string& root, const std::string& rel, MediaTrack& track) {
+        struct stat st;
+        std::string full = root + "/" + rel;
+        if (!MediaTagReader::is_audio(rel.c_str()) || stat(full.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) return false;
+        track = MediaTrack{};
+        track.path = rel;
+        track.mtime_ns = int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+        track.size = static_cast<uint64_t>(st.st_size);
+        MediaTagReader::read(full, track);
+        return true;
+    }
+
+private:
+    std::string root;
+    const MediaIndex& previous;
+    std::function<void(const std::string&)> on_directory;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::string> pending;
+    unsigned busy = 0;
+
+    MediaScanner(const std::string& root, const MediaIndex& previous) : root(root), previous(previous) {}
+
+    void work(MediaScanResult& out) {
+        std::string dir;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [this]() { return !pending.empty() || busy == 0; });
+                if (pending.empty()) return; // nichts mehr zu tun und niemand erzeugt noch Arbeit
+                dir = std::move(pending.back());
+                pending.pop_back();
+                busy++;
+            }
+
+            std::vector<std::string> subdirs;
+            read_directory(dir, out, subdirs);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (auto& s : subdirs) pending.push_back(std::move(s));
+                busy--;
+            }
+            cv.notify_all();
+        }
+    }
+
+    void read_directory(const std::string& rel, MediaScanResult& out, std::vector<std::string>& subdirs) {
+        std::string full = rel.empty() ? root : root + "/" + rel;
+        int dfd = open(full.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dfd < 0) return;
+        DIR *dir = fdopendir(dfd);
+        if (!dir) {
+            close(dfd);
+            return;
+        }
+        out.stats.directories++;
+        out.directories.push_back(rel);
+        if (on_directory) on_directory(rel);
+
+        while (dirent *e = readdir(dir)) {
+            if (e->d_name[0] == '.') continue; // ".", ".." und versteckte Ordner (.Trash-1000 usw.)
+            std::string child = rel.empty() ? e->d_name : rel + "/" + e->d_name;
+
+            unsigned char type = e->d_type;
+            struct stat st;
+            bool have_stat = false;
+            if (type == DT_UNKNOWN) {
+                if (fstatat(dfd, e->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) continue;
+                have_stat = true;
+                type = S_ISDIR(st.st_mode) ? DT_DIR : S_ISREG(st.st_mode) ? DT_REG : DT_LNK;
+            }
+            if (type == DT_DIR) {
+                subdirs.push_back(std::move(child));
+                continue;
+            }
+            if (type != DT_REG || !MediaTagReader::is_audio(e->d_name)) continue;
+            if (!have_stat && fstatat(dfd, e->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) continue;
+
+            out.stats.files++;
+            int64_t mtime = int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+            uint64_t size = static_cast<uint64_t>(st.st_size);
+            const MediaTrack *known = previous.find(child);
+            if (known && known->mtime_ns == mtime && known->size == size) {
+                out.tracks.push_back(*known);
+                out.stats.reused++;
+                continue;
+            }
+
+            MediaTrack track;
+            track.path = std::move(child);
+            track.mtime_ns = mtime;
+            track.size = size;
+            MediaTagReader::read(full + "/" + e->d_name, track);
+            out.tracks.push_back(std::move(track));
+            out.stats.parsed++;
+        }
+        closedir(dir);
+    }
+};
+
+#endif
@@ -0,0 +1,533 @@
+#ifndef MEDIA_LIBRARY_HPP
+#define MEDIA_LIBRARY_HPP
+
+#include <gtk/gtk.h>
+#include <glib-unix.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#include "media_index.hpp"
+#include "thread_registry.hpp"
+#include "named_source.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+
+// Medienbibliothek: erkennt USB-Datenträger (/proc/self/mounts), scannt sie im Hintergrund
+// gegen den gespeicherten Index, hält sie per inotify aktuell und füllt die Titelliste.
+// Alle Methoden laufen im Main-Thread, Scans in eigenen Threads mit Übergabe per g_idle_add.
+class MediaLibrary {
+public:
+    static constexpr guint REFRESH_DELAY_MS = 500;
+    static constexpr guint QUEUE_MAX = 500; // Titel, die beim Antippen in die Warteschlange kommen
+    static constexpr size_t HELD_MAX = 4096; // zurückgehaltene inotify-Ereignisse während Scans
+    static constexpr uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                           IN_DELETE_SELF | IN_ONLYDIR;
+
+    MediaLibrary(GtkListView *list, GtkLabel *status, std::string index_dir = "assets/media_index")
+        : ui_list(list), status_label(status), index_dir(std::move(index_dir)) {
+        ui_model = gtk_string_list_new(nullptr);
+        setup_view();
+    }
+
+    // Wird mit den absoluten Pfaden ab dem angetippten Titel in Listenreihenfolge aufgerufen
+    void set_play_callback(std::function<void(std::vector<std::string>)> cb) { on_play = std::move(cb); }
+
+    void start() {
+        g_mkdir_with_parents(index_dir.c_str(), 0755);
+
+        inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify_fd >= 0) {
+            g_unix_fd_add(inotify_fd, G_IO_IN, [](gint, GIOCondition, gpointer data) -> gboolean {
+                static_cast<MediaLibrary*>(data)->read_inotify();
+                return G_SOURCE_CONTINUE;
+            }, this);
+        } else {
+            LOG_WARN("Media", "inotify nicht verfügbar: {}", strerror(errno));
+        }
+
+        // Der Kernel meldet Änderungen an der Mount-Tabelle als POLLPRI/POLLERR
+        int mounts_fd = open("/proc/self/mounts", O_RDONLY | O_CLOEXEC);
+        if (mounts_fd >= 0) {
+            g_unix_fd_add(mounts_fd, static_cast<GIOCondition>(G_IO_PRI | G_IO_ERR), [](gint, GIOCondition, gpointer data) -> gboolean {
+                static_cast<MediaLibrary*>(data)->update_volumes();
+                return G_SOURCE_CONTINUE;
+            }, this);
+        }
+        update_volumes();
+    }
+
+    // Hintergrund-Scans zurückstellen (z.B. bei Überhitzung); zurückgestellte Datenträger
+    // werden beim Aufheben voll gescannt, was dank Index nur Neues liest
+    void set_deferred(bool enabled) {
+        if (deferred == enabled) return;
+        deferred = enabled;
+        if (deferred) {
+            update_status();
+            return;
+        }
+        for (auto& v : volumes) {
+            if (!v->scan_deferred) continue;
+            v->scan_deferred = false;
+            start_scan(*v, "", true);
+        }
+        update_status();
+    }
+
+    size_t track_count() const {
+        size_t n = 0;
+        for (const auto& v : volumes) n += v->index.size();
+        return n;
+    }
+
+private:
+    struct Volume {
+        std::string root;
+        std::string index_file;
+        MediaIndex index;
+        std::unordered_map<int, std::string> watches; // wd -> relativer Ordner
+        unsigned generation = 0; // verwirft Ergebnisse von Scans eines inzwischen abgezogenen Datenträgers
+        bool scanning = false;
+        bool scan_deferred = false; // Scan wartet auf set_deferred(false)
+    };
+
+    // Ergebnis eines Hintergrund-Scans für den Main-Thread
+    struct ScanDone {
+        MediaLibrary *self;
+        std::string root;
+        unsigned generation;
+        bool full; // ganzer Datenträger (ersetzt den Index) oder nur ein neuer Ordner (ergänzt)
+        MediaScanResult result;
+        size_t previous_count; // Titel im gespeicherten Index
+        std::vector<std::pair<int, std::string>> watches;
+        double ms;
+    };
+
+    GtkListView *ui_list;
+    GtkLabel *status_label;
+    GtkStringList *ui_model;
+    std::string index_dir;
+    std::function<void(std::vector<std::string>)> on_play;
+    std::vector<std::unique_ptr<Volume>> volumes;
+    unsigned next_generation = 1;
+    int inotify_fd = -1;
+    guint refresh_id = 0;
+    bool deferred = false;
+    std::set<Volume*> dirty; // Index geändert, noch nicht gespeichert
+
+    // Ereignisse aus Ordnern, deren Scan noch läuft (Watch schon angelegt, Ergebnis noch nicht
+    // übernommen); finish_scan spielt sie danach ab
+    struct HeldEvent {
+        int wd;
+        uint32_t mask;
+        std::string name;
+    };
+    std::vector<HeldEvent> held;
+    unsigned scans_running = 0;
+    bool held_overflow = false;
+
+    // --- Datenträger ---
+
+    // Wechseldatenträger unter /media bzw. /run/media, dazu feste Ordner aus CAROS_MEDIA_ROOTS
+    static std::set<std::string> detect_roots() {
+        std::set<std::string> roots;
+        std::ifstream mounts("/proc/self/mounts");
+        std::string line;
+        while (std::getline(mounts, line)) {
+            std::stringstream ss(line);
+            std::string device, mountpoint;
+            ss >> device >> mountpoint;
+            if (mountpoint.rfind("/media/", 0) == 0 || mountpoint.rfind("/run/media/", 0) == 0) {
+                // Leerzeichen stehen oktal kodiert in der Tabelle
+                gchar *decoded = g_strcompress(mountpoint.c_str());
+                roots.insert(decoded);
+                g_free(decoded);
+            }
+        }
+        const char *extra = g_getenv("CAROS_MEDIA_ROOTS");
+        if (extra) {
+            gchar **dirs = g_strsplit(extra, ":", -1);
+            for (gchar **d = dirs; *d; d++) {
+                if (**d && g_file_test(*d, G_FILE_TEST_IS_DIR)) roots.insert(*d);
+            }
+            g_strfreev(dirs);
+        }
+        return roots;
+    }
+
+    void update_volumes() {
+        std::set<std::string> roots = detect_roots();
+
+        for (auto it = volumes.begin(); it != volumes.end();) {
+            if (roots.count((*it)->root)) {
+                roots.erase((*it)->root);
+                ++it;
+                continue;
+            }
+            LOG_INFO("Media", "Datenträger entfernt: {}", (*it)->root);
+            for (const auto& [wd, rel] : (*it)->watches) inotify_rm_watch(inotify_fd, wd);
+            dirty.erase(it->get());
+            it = volumes.erase(it);
+        }
+
+        for (const auto& root : roots) {
+            auto v = std::make_unique<Volume>();
+            v->root = root;
+            // Gleicher Mount-Punkt (Label/UUID des Sticks) -> gleicher Index
+            char name[32];
+            snprintf(name, sizeof(name), "%016llx.idx", static_cast<unsigned long long>(fnv1a(root)));
+            v->index_file = index_dir + "/" + name;
+            LOG_INFO("Media", "Datenträger erkannt: {}", root);
+            start_scan(*v, "", true);
+            volumes.push_back(std::move(v));
+        }
+        schedule_refresh();
+    }
+
+    Volume* find_volume(const std::string& root) {
+        for (auto& v : volumes) if (v->root == root) return v.get();
+        return nullptr;
+    }
+
+    static uint64_t fnv1a(const std::string& s) {
+        uint64_t h = 1469598103934665603ull;
+        for (unsigned char c : s) h = (h ^ c) * 1099511628211ull;
+        return h;
+    }
+
+    // --- Scans ---
+
+    // full: ganzer Datenträger gegen den gespeicherten Index, sonst nur der Ordner subdir
+    void start_scan(Volume& v, const std::string& subdir, bool full) {
+        if (deferred) {
+            // Auch Ordner-Scans werden zum Voll-Scan; bis dahin ignoriert handle_event den Datenträger
+            v.generation = next_generation++;
+            v.scanning = true;
+            v.scan_deferred = true;
+            update_status();
+            return;
+        }
+        if (full) {
+            v.generation = next_generation++;
+            v.scanning = true;
+        }
+        auto *done = new ScanDone{this, v.root, v.generation, full, {}, 0, {}, 0.0};
+        std::string index_file = v.index_file;
+        int fd = inotify_fd;
+        scans_running++;
+        update_status();
+
+        ThreadRegistry::spawn("caros-scan", "background", [done, index_file, subdir, fd]() {
+            auto start = std::chrono::steady_clock::now();
+            MediaIndex previous;
+            if (done->full) previous.load(index_file);
+            done->previous_count = previous.size();
+
+            // Watch vor dem Lesen des Ordners, sonst fehlt, was sich währenddessen ändert
+            std::mutex watches_mutex;
+            auto watch = [done, fd, &watches_mutex](const std::string& rel) {
+                if (fd < 0) return;
+                std::string path = rel.empty() ? done->root : done->root + "/" + rel;
+                int wd = inotify_add_watch(fd, path.c_str(), WATCH_MASK);
+                if (wd < 0) return;
+                std::lock_guard<std::mutex> lock(watches_mutex);
+                done->watches.emplace_back(wd, rel);
+            };
+            done->result = MediaScanner::scan(done->root, previous, 0, subdir, watch);
+            set_sort_keys(done->result.tracks);
+            done->ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            g_idle_add([](gpointer data) -> gboolean {
+                auto *d = static_cast<ScanDone*>(data);
+                d->self->finish_scan(*d);
+                delete d;
+                return G_SOURCE_REMOVE;
+            }, done);
+        }).detach();
+    }
+
+    void finish_scan(ScanDone& done) {
+        static Histogram& scan_ms = MetricsRegistry::instance().histogram("caros_media_scan_ms", "Dauer eines Datenträger-Scans (ms)");
+        scans_running--;
+        Volume *v = find_volume(done.root);
+        if (!v || v->generation != done.generation) { // inzwischen abgezogen oder neu gesteckt
+            release_held(nullptr);
+            return;
+        }
+
+        for (const auto& [wd, rel] : done.watches) v->watches[wd] = rel;
+        const MediaScanStats& st = done.result.stats;
+        if (done.full) {
+            v->index.assign(std::move(done.result.tracks));
+            v->scanning = false;
+            scan_ms.record(static_cast<uint64_t>(done.ms));
+            LOG_INFO("Media", "{}: {} Titel in {} Ordnern, {} aus dem Index, {} neu gelesen, {} ms",
+                     v->root, st.files, st.directories, st.reused, st.parsed, static_cast<int>(done.ms));
+        } else {
+            for (auto& t : done.result.tracks) v->index.upsert(std::move(t));
+        }
+        // Unveränderter Stick: nichts neu gelesen, nichts verschwunden -> Index nicht neu schreiben
+        if (done.full ? st.parsed > 0 || st.reused != done.previous_count : st.files > 0) {
+            dirty.insert(v);
+        }
+        release_held(v);
+        schedule_refresh();
+    }
+
+    // Zurückgehaltene Ereignisse des fertigen Datenträgers abspielen (doppelt ist harmlos:
+    // upsert/remove/Ordner-Scan sind idempotent); ohne laufende Scans verwaiste verwerfen
+    void release_held(Volume *v) {
+        if (v && !v->scanning) {
+            if (held_overflow) {
+                held_overflow = false;
+                LOG_WARN("Media", "Zu viele Änderungen während des Scans, scanne {} neu", v->root);
+                held.clear();
+                start_scan(*v, "", true);
+                return;
+            }
+            std::vector<HeldEvent> replay;
+            for (auto it = held.begin(); it != held.end();) {
+                if (v->watches.count(it->wd)) {
+                    replay.push_back(std::move(*it));
+                    it = held.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            for (const HeldEvent& e : replay) apply_event(*v, e.wd, e.mask, e.name);
+        }
+        if (scans_running == 0) held.clear();
+    }
+
+    // Sortierschlüssel im Scan-Thread: refresh() vergleicht dann nur Bytes statt g_utf8_collate
+    static void set_sort_keys(std::vector<MediaTrack>& tracks) {
+        std::unordered_map<std::string, std::string> cache; // Interpret bzw. Album -> Schlüssel
+        auto key = [&cache](const std::string& text) -> const std::string& {
+            auto it = cache.find(text);
+            if (it != cache.end()) return it->second;
+            gchar *k = g_utf8_collate_key(text.c_str(), -1);
+            it = cache.emplace(text, k).first;
+            g_free(k);
+            return it->second;
+        };
+        for (auto& t : tracks) {
+            // '\0' trennt: kleiner als jedes Byte eines Schlüssels, also erst Interpret, dann Album
+            t.sort_key = key(t.artist);
+            t.sort_key += '\0';
+            t.sort_key += key(t.album);
+        }
+    }
+
+    // --- inotify ---
+
+    void read_inotify() {
+        static Counter& events = MetricsRegistry::instance().counter("caros_media_inotify_events_total", "inotify-Ereignisse der Medienbibliothek");
+        alignas(inotify_event) char buffer[16 * 1024];
+        ssize_t len;
+        while ((len = read(inotify_fd, buffer, sizeof(buffer))) > 0) {
+            for (char *p = buffer; p < buffer + len;) {
+                auto *e = reinterpret_cast<inotify_event*>(p);
+                p += sizeof(inotify_event) + e->len;
+                events.inc();
+                if (e->mask & IN_Q_OVERFLOW) {
+                    LOG_WARN("Media", "inotify-Warteschlange übergelaufen, scanne neu");
+                    for (auto& v : volumes) start_scan(*v, "", true);
+                    return;
+                }
+                handle_event(*e);
+            }
+        }
+    }
+
+    void handle_event(const inotify_event& e) {
+        for (auto& vp : volumes) {
+            Volume& v = *vp;
+            auto w = v.watches.find(e.wd);
+            if (w == v.watches.end()) continue;
+
+            if (e.mask & (IN_IGNORED | IN_DELETE_SELF)) {
+                v.watches.erase(w);
+                return;
+            }
+            if (!e.len || e.name[0] == '.') return;
+            if (v.scanning) {
+                hold(e); // Ergebnis des Voll-Scans ersetzt gleich den Index
+                return;
+            }
+            apply_event(v, e.wd, e.mask, e.name);
+            return;
+        }
+        // Watch aus einem noch laufenden Scan
+        if (scans_running > 0 && e.len && e.name[0] != '.' && !(e.mask & IN_IGNORED)) hold(e);
+    }
+
+    void hold(const inotify_event& e) {
+        if (held.size() >= HELD_MAX) {
+            held_overflow = true;
+            return;
+        }
+        held.push_back({e.wd, e.mask, e.name});
+    }
+
+    void apply_event(Volume& v, int wd, uint32_t mask, const std::string& name) {
+        auto w = v.watches.find(wd);
+        if (w == v.watches.end()) return;
+        std::string rel = w->second.empty() ? name : w->second + "/" + name;
+
+        if (mask & IN_ISDIR) {
+            if (mask & (IN_CREATE | IN_MOVED_TO)) start_scan(v, rel, false);
+            else if ((mask & (IN_DELETE | IN_MOVED_FROM)) && v.index.remove(rel + "/")) dirty.insert(&v);
+        } else if (mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+            std::vector<MediaTrack> track(1);
+            if (MediaScanner::scan_file(v.root, rel, track[0])) {
+                set_sort_keys(track);
+                v.index.upsert(std::move(track[0]));
+                dirty.insert(&v);
+            }
+        } else if (mask & (IN_DELETE | IN_MOVED_FROM)) {
+            if (v.index.remove(rel)) dirty.insert(&v);
+        }
+        schedule_refresh();
+    }
+
+    // --- UI ---
+
+    // Änderungen sammeln: Liste und Index-Dateien höchstens alle REFRESH_DELAY_MS neu schreiben
+    void schedule_refresh() {
+        if (refresh_id) return;
+        refresh_id = NamedSource::timeout("media-refresh", REFRESH_DELAY_MS, [](gpointer data) -> gboolean {
+            auto *self = static_cast<MediaLibrary*>(data);
+            self->refresh_id = 0;
+            self->refresh();
+            return G_SOURCE_REMOVE;
+        }, this);
+    }
+
+    void refresh() {
+        static Gauge& tracks_metric = MetricsRegistry::instance().gauge("caros_media_tracks", "Titel auf allen Datenträgern");
+        for (auto& v : volumes) v->index.compact(); // gesammelte Löschungen, ein Neuaufbau pro Datenträger
+        for (Volume *v : dirty) {
+            if (!v->index.save(v->index_file)) LOG_WARN("Media", "Index {} konnte nicht gespeichert werden", v->index_file);
+        }
+        dirty.clear();
+
+        // Sortiert nach Interpret, Album, Pfad; die Liste enthält nur die absoluten Pfade.
+        // Die Kollationsschlüssel stammen aus dem Scan, hier wird nur noch byteweise verglichen.
+        struct Entry { const MediaTrack *track; const std::string *root; };
+        std::vector<Entry> entries;
+        entries.reserve(track_count());
+        for (const auto& v : volumes) {
+            for (const auto& t : v->index.all()) entries.push_back({&t, &v->root});
+        }
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+            int c = a.track->sort_key.compare(b.track->sort_key);
+            if (c) return c < 0;
+            return a.track->path < b.track->path;
+        });
+
+        std::vector<std::string> paths;
+        paths.reserve(entries.size());
+        for (const auto& e : entries) paths.push_back(*e.root + "/" + e.track->path);
+        std::vector<const char*> items;
+        items.reserve(paths.size() + 1);
+        for (const auto& p : paths) items.push_back(p.c_str());
+        items.push_back(nullptr);
+
+        // Ein einziges items-changed für die ganze Liste
+        gtk_string_list_splice(ui_model, 0, g_list_model_get_n_items(G_LIST_MODEL(ui_model)), items.data());
+        tracks_metric.set(static_cast<double>(entries.size()));
+        update_status();
+    }
+
+    void update_status() {
+        bool scanning = std::any_of(volumes.begin(), volumes.end(), [](const auto& v) { return v->scanning; });
+        char text[96];
+        if (volumes.empty()) snprintf(text, sizeof(text), "Kein USB-Datenträger");
+        else if (scanning && deferred) snprintf(text, sizeof(text), "Suche pausiert (Gerät zu warm)");
+        else if (scanning) snprintf(text, sizeof(text), "Durchsuche Datenträger…");
+        else snprintf(text, sizeof(text), "%zu Titel", track_count());
+        gtk_label_set_text(status_label, text);
+    }
+
+    const MediaTrack* find_track(const char *full_path) {
+        for (const auto& v : volumes) {
+            size_t n = v->root.size();
+            if (std::strncmp(full_path, v->root.c_str(), n) == 0 && full_path[n] == '/') return v->index.find(full_path + n + 1);
+        }
+        return nullptr;
+    }
+
+    void setup_view() {
+        GtkListItemFactory *factory = gtk_signal_list_item_factory_new();
+
+        g_signal_connect(factory, "setup", G_CALLBACK(+[](GtkSignalListItemFactory*, GtkListItem *item, gpointer) {
+            GtkWidget *box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 15);
+            GtkWidget *label_title = gtk_label_new(nullptr);
+            GtkWidget *label_artist = gtk_label_new(nullptr);
+            GtkWidget *label_duration = gtk_label_new(nullptr);
+
+            gtk_widget_set_hexpand(label_title, TRUE);
+            gtk_widget_set_halign(label_title, GTK_ALIGN_START);
+            gtk_label_set_ellipsize(GTK_LABEL(label_title), PANGO_ELLIPSIZE_END);
+            gtk_label_set_ellipsize(GTK_LABEL(label_artist), PANGO_ELLIPSIZE_END);
+            gtk_label_set_max_width_chars(GTK_LABEL(label_artist), 40);
+            gtk_widget_add_css_class(label_artist, "media-dimmed");
+            gtk_widget_add_css_class(label_duration, "media-dimmed");
+
+            gtk_box_append(GTK_BOX(box), label_title);
+            gtk_box_append(GTK_BOX(box), label_artist);
+            gtk_box_append(GTK_BOX(box), label_duration);
+            gtk_list_item_set_child(item, box);
+        }), nullptr);
+
+        g_signal_connect(factory, "bind", G_CALLBACK(+[](GtkSignalListItemFactory*, GtkListItem *item, gpointer data) {
+            MediaLibrary *self = static_cast<MediaLibrary*>(data);
+            const char *path = gtk_string_object_get_string(GTK_STRING_OBJECT(gtk_list_item_get_item(item)));
+            const MediaTrack *t = self->find_track(path);
+            if (!t) return;
+
+            GtkWidget *label_title = gtk_widget_get_first_child(gtk_list_item_get_child(item));
+            GtkWidget *label_artist = gtk_widget_get_next_sibling(label_title);
+            GtkWidget *label_duration = gtk_widget_get_next_sibling(label_artist);
+
+            std::string artist = t->artist;
+            if (!t->album.empty()) artist += (artist.empty() ? "" : " – ") + t->album;
+            char duration[16] = "";
+            if (t->duration_ms) snprintf(duration, sizeof(duration), "%u:%02u", t->duration_ms / 60000, t->duration_ms / 1000 % 60);
+
+            gtk_label_set_text(GTK_LABEL(label_title), t->title.c_str());
+            gtk_label_set_text(GTK_LABEL(label_artist), artist.c_str());
+            gtk_label_set_text(GTK_LABEL(label_duration), duration);
+        }), this);
+
+        GtkNoSelection *selection = gtk_no_selection_new(G_LIST_MODEL(ui_model));
+        gtk_list_view_set_model(ui_list, GTK_SELECTION_MODEL(selection));
+        gtk_list_view_set_factory(ui_list, factory);
+        g_object_unref(selection);
+        g_object_unref(factory);
+
+        gtk_list_view_set_single_click_activate(ui_list, TRUE);
+        g_signal_connect(ui_list, "activate", G_CALLBACK(+[](GtkListView*, guint position, gpointer data) {
+            MediaLibrary *self = static_cast<MediaLibrary*>(data);
+            if (!self->on_play) return;
+            std::vector<std::string> queue;
+            guint n = std::min(g_list_model_get_n_items(G_LIST_MODEL(self->ui_model)), position + QUEUE_MAX);
+            for (guint i = position; i < n; i++) queue.emplace_back(gtk_string_list_get_string(self->ui_model, i));
+            self->on_play(std::move(queue));
+        }), this);
+    }
+};
+
+#endif
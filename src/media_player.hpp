@@ -0,0 +1,240 @@
+#ifndef MEDIA_PLAYER_HPP
+#define MEDIA_PLAYER_HPP
+
+#include <gst/gst.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gst_threads.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+
+// Dekodiert eine lokale Datei vorab in eine begrenzte Warteschlange:
+//   filesrc ! decodebin ! audioconvert ! audioresample ! appsink (max-buffers, sync=false)
+// Ist die Warteschlange voll, blockiert der Decoder (Gegendruck), es liegt also nie mehr als
+// QUEUE_BUFFERS dekodiertes Audio im Speicher. appsink wird nur über Signale/Properties
+// angesprochen, damit keine zusätzliche Abhängigkeit auf gstreamer-app nötig ist.
+class TrackDecoder {
+public:
+    static constexpr int QUEUE_BUFFERS = 32;
+    static constexpr guint64 PULL_TIMEOUT = 200 * GST_MSECOND;
+    static constexpr int MAX_STALL_MS = 5000; // länger hängende USB-Sticks gelten als Fehler
+
+    explicit TrackDecoder(const std::string& path) : path(path) {
+        GError *err = nullptr;
+        pipeline = gst_parse_launch(
+            "filesrc name=src ! decodebin ! audioconvert ! audioresample ! "
+            "appsink name=sink sync=false caps=\"audio/x-raw,format=F32LE,layout=interleaved\"", &err);
+        if (!pipeline) {
+            LOG_ERROR("MediaPlayer", "Decoder-Pipeline fehlgeschlagen: {}", err ? err->message : "?");
+            g_clear_error(&err);
+            return;
+        }
+        GstElement *src = gst_bin_get_by_name(GST_BIN(pipeline), "src");
+        g_object_set(src, "location", path.c_str(), NULL);
+        gst_object_unref(src);
+        register_streaming_threads(pipeline, "decode");
+        sink = gst_bin_get_by_name(GST_BIN(pipeline), "sink");
+        g_object_set(sink, "max-buffers", static_cast<guint>(QUEUE_BUFFERS), NULL);
+        gst_element_set_state(pipeline, GST_STATE_PLAYING);
+    }
+
+    ~TrackDecoder() {
+        if (!pipeline) return;
+        gst_element_set_state(pipeline, GST_STATE_NULL);
+        gst_object_unref(sink);
+        gst_object_unref(pipeline);
+    }
+
+    TrackDecoder(const TrackDecoder&) = delete;
+    TrackDecoder& operator=(const TrackDecoder&) = delete;
+
+    // Nächstes Stück PCM, nullptr bei Dateiende oder Fehler (blockiert höchstens MAX_STALL_MS)
+    GstSample* pull() {
+        if (!pipeline) return nullptr;
+        for (int waited = 0; waited < MAX_STALL_MS; waited += static_cast<int>(PULL_TIMEOUT / GST_MSECOND)) {
+            GstSample *sample = nullptr;
+            g_signal_emit_by_name(sink, "try-pull-sample", PULL_TIMEOUT, &sample);
+            if (sample) return sample;
+
+            gboolean eos = FALSE;
+            g_object_get(sink, "eos", &eos, NULL);
+            if (eos) return nullptr;
+            if (has_error()) return nullptr;
+        }
+        LOG_WARN("MediaPlayer", "{}: keine Daten nach {} ms", path, MAX_STALL_MS);
+        return nullptr;
+    }
+
+    const std::string& file() const { return path; }
+
+    bool caps_sent = false; // nur vom appsrc-Thread benutzt
+
+private:
+    std::string path;
+    GstElement *pipeline = nullptr;
+    GstElement *sink = nullptr;
+
+    bool has_error() {
+        GstBus *bus = gst_element_get_bus(pipeline);
+        GstMessage *msg = gst_bus_pop_filtered(bus, GST_MESSAGE_ERROR);
+        gst_object_unref(bus);
+        if (!msg) return false;
+        GError *err = nullptr;
+        gst_message_parse_error(msg, &err, nullptr);
+        LOG_ERROR("MediaPlayer", "{}: {}", path, err ? err->message : "Dekodierfehler");
+        g_clear_error(&err);
+        gst_message_unref(msg);
+        return true;
+    }
+};
+
+// Lückenlose Wiedergabe lokaler Dateien über das playbin des Radios (gleicher EQ, Limiter,
+// Lautheitsangleich und Visualizer). Jeder Titel ist eine eigene appsrc://-Gruppe im playbin;
+// die PCM-Daten kommen aus einem TrackDecoder, der schon während des Vorgängers läuft.
+// Bei "about-to-finish" wird nur noch die URI gesetzt, playbin schließt die nächste Gruppe
+// ohne Pipeline-Neuaufbau an; die Datei ist dann längst geöffnet und teilweise dekodiert.
+// Fehlt der Decoder noch (Titel kürzer als der Weg über die Main-Loop), wird er im Callback
+// selbst geöffnet: die Warteschlange endet nur, wenn wirklich kein Titel mehr folgt.
+class MediaPlayer {
+public:
+    explicit MediaPlayer(GstElement *playbin) : playbin(playbin) {
+        if (!playbin) return;
+        g_signal_connect(playbin, "about-to-finish", G_CALLBACK(on_about_to_finish), this);
+        g_signal_connect(playbin, "source-setup", G_CALLBACK(on_source_setup), this);
+    }
+
+    // Main-Thread: Warteschlange ab queue[0] abspielen
+    void play(std::vector<std::string> queue) {
+        if (!playbin || queue.empty()) return;
+        gst_element_set_state(playbin, GST_STATE_NULL);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tracks = std::move(queue);
+            position = 0;
+            delete pending;
+            delete ahead;
+            pending = new TrackDecoder(tracks[0]);
+            ahead = tracks.size() > 1 ? new TrackDecoder(tracks[1]) : nullptr;
+            generation++;
+        }
+        active.store(true, std::memory_order_release);
+        LOG_INFO("MediaPlayer", "Spiele {} ({} in der Warteschlange)", tracks[0], tracks.size());
+        g_object_set(playbin, "uri", "appsrc://", NULL);
+        gst_element_set_state(playbin, GST_STATE_PLAYING);
+    }
+
+    // Main-Thread: das Radio übernimmt das playbin
+    void stop() {
+        if (!active.exchange(false)) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        delete pending;
+        delete ahead;
+        pending = ahead = nullptr;
+        tracks.clear();
+        generation++;
+    }
+
+    bool is_active() const { return active.load(std::memory_order_acquire); }
+
+private:
+    GstElement *playbin;
+    std::atomic<bool> active{false};
+    std::mutex mutex;
+    std::vector<std::string> tracks;
+    size_t position = 0;
+    unsigned generation = 0;           // verwirft verspätete Vorbereitungen nach play()/stop()
+    TrackDecoder *pending = nullptr;   // wird beim nächsten source-setup angeschlossen
+    TrackDecoder *ahead = nullptr;     // übernächster Titel, dekodiert schon vor
+
+    struct Prepare {
+        MediaPlayer *self;
+        unsigned generation;
+    };
+
+    // Streaming-Thread des playbin, kurz vor Ende des aktuellen Titels
+    static void on_about_to_finish(GstElement *playbin, gpointer data) {
+        auto *self = static_cast<MediaPlayer*>(data);
+        if (!self->active.load(std::memory_order_acquire)) return;
+        unsigned gen;
+        {
+            std::lock_guard<std::mutex> lock(self->mutex);
+            if (!self->ahead) {
+                if (self->position + 1 >= self->tracks.size()) return; // Warteschlange zu Ende -> EOS
+                // prepare_ahead() kam nicht rechtzeitig (sehr kurzer Titel, Main-Loop belegt):
+                // dann hier im Streaming-Thread öffnen, statt die Warteschlange enden zu lassen
+                static Counter& late = MetricsRegistry::instance().counter("caros_media_prepare_late_total", "Titel, die erst bei about-to-finish geöffnet wurden");
+                late.inc();
+                LOG_WARN("MediaPlayer", "{} war nicht vorbereitet, öffne ihn jetzt", self->tracks[self->position + 1]);
+                self->ahead = new TrackDecoder(self->tracks[self->position + 1]);
+            }
+            self->pending = self->ahead;
+            self->ahead = nullptr;
+            self->position++;
+            gen = self->generation;
+        }
+        g_object_set(playbin, "uri", "appsrc://", NULL);
+
+        // Den Decoder für den Titel danach im Main-Thread starten (nicht im Streaming-Thread)
+        g_idle_add([](gpointer d) -> gboolean {
+            auto *p = static_cast<Prepare*>(d);
+            p->self->prepare_ahead(p->generation);
+            delete p;
+            return G_SOURCE_REMOVE;
+        }, new Prepare{self, gen});
+    }
+
+    void prepare_ahead(unsigned gen) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (gen != generation || ahead || position + 1 >= tracks.size()) return;
+        ahead = new TrackDecoder(tracks[position + 1]);
+    }
+
+    // playbin hat für die neue Gruppe ein appsrc erzeugt: Decoder anschließen.
+    // Der Decoder gehört ab hier dem appsrc und wird mit ihm freigegeben.
+    static void on_source_setup(GstElement*, GstElement *source, gpointer data) {
+        auto *self = static_cast<MediaPlayer*>(data);
+        if (!self->active.load(std::memory_order_acquire)) return;
+        TrackDecoder *decoder;
+        {
+            std::lock_guard<std::mutex> lock(self->mutex);
+            decoder = self->pending;
+            self->pending = nullptr;
+        }
+        if (!decoder) return;
+
+        static Counter& played = MetricsRegistry::instance().counter("caros_media_tracks_played_total", "Gestartete lokale Titel");
+        played.inc();
+        LOG_INFO("MediaPlayer", "Nächster Titel: {}", decoder->file());
+
+        g_object_set(source, "format", GST_FORMAT_TIME, "stream-type", 0 /* GST_APP_STREAM_TYPE_STREAM */, NULL);
+        g_object_set_data_full(G_OBJECT(source), "decoder", decoder, [](gpointer d) { delete static_cast<TrackDecoder*>(d); });
+        g_signal_connect(source, "need-data", G_CALLBACK(on_need_data), decoder);
+    }
+
+    // Streaming-Thread des appsrc: ein Stück PCM aus dem Decoder weiterreichen
+    static void on_need_data(GstElement *source, guint, gpointer data) {
+        static Histogram& wait = MetricsRegistry::instance().histogram("caros_media_pull_us", "Wartezeit auf dekodierte Daten (us)");
+        auto *decoder = static_cast<TrackDecoder*>(data);
+        auto start = std::chrono::steady_clock::now();
+        GstSample *sample = decoder->pull();
+        wait.record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+        GstFlowReturn ret;
+        if (!sample) {
+            g_signal_emit_by_name(source, "end-of-stream", &ret);
+            return;
+        }
+        if (!decoder->caps_sent) {
+            g_object_set(source, "caps", gst_sample_get_caps(sample), NULL);
+            decoder->caps_sent = true;
+        }
+        g_signal_emit_by_name(source, "push-buffer", gst_sample_get_buffer(sample), &ret);
+        gst_sample_unref(sample);
+    }
+};
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef MEMORY_POLICY_HPP
+#define MEMORY_POLICY_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "logger.hpp"
+#include "metrics.hpp"
+
+enum class MemoryPressure { Normal, Moderate, Critical };
+
+// Ein Speicherverbraucher, der bei Druck Speicher abgeben kann
+struct MemoryConsumer {
+    std::string name;
+    std::function<size_t()> bytes;   // aktueller Verbrauch, darf leer sein (unbekannt)
+    std::function<void()> shed;      // Speicher freigeben
+    std::function<void()> restore;   // Normalbetrieb wiederherstellen
+    bool shed_active = false;
+    Gauge *bytes_metric = nullptr;
+};
+
+// Entscheidung des MemoryPressureManager ohne GTK: liest PSI und cgroup und wirft die
+// Verbraucher in der Reihenfolge ihrer Registrierung ab. Moderate -> einer nach dem anderen
+// (mit SHED_COOLDOWN_US dazwischen), Critical -> alle sofort. Nach RESTORE_AFTER_S ohne Druck
+// wird in umgekehrter Reihenfolge wiederhergestellt. Zeiten in µs von außen.
+class MemoryBudget {
+public:
+    static constexpr int64_t SHED_COOLDOWN_US = 5 * 1000000LL;
+    static constexpr int64_t RESTORE_AFTER_S = 30;
+    static constexpr int64_t TRIGGER_HOLD_US = 2 * 1000000LL;
+    static constexpr double SOME_MODERATE = 10.0;   // avg10 in % ("some")
+    static constexpr double FULL_CRITICAL = 5.0;    // avg10 in % ("full")
+    static constexpr double CGROUP_MODERATE = 0.75; // Anteil von memory.max
+    static constexpr double CGROUP_CRITICAL = 0.90;
+
+    // Stufe aus einer Datei im PSI-Format ("some avg10=... " / "full avg10=...")
+    static MemoryPressure read_psi(const std::string& path) {
+        std::ifstream f(path);
+        std::string line;
+        MemoryPressure result = MemoryPressure::Normal;
+        while (std::getline(f, line)) {
+            double avg10 = 0.0;
+            char kind[8] = {0};
+            if (sscanf(line.c_str(), "%7s avg10=%lf", kind, &avg10) != 2) continue;
+            if (strcmp(kind, "full") == 0 && avg10 >= FULL_CRITICAL) result = MemoryPressure::Critical;
+            else if (strcmp(kind, "some") == 0 && avg10 >= SOME_MODERATE) result = std::max(result, MemoryPressure::Moderate);
+        }
+        return result;
+    }
+
+    // Stufe aus memory.current / memory.max unter dir; ratio bleibt ohne Limit ("max") unverändert
+    static MemoryPressure read_cgroup(const std::string& dir, double *ratio) {
+        if (dir.empty()) return MemoryPressure::Normal;
+        std::ifstream max_file(dir + "/memory.max");
+        std::ifstream cur_file(dir + "/memory.current");
+        std::string max_str;
+        double current_bytes = 0;
+        if (!(max_file >> max_str) || !(cur_file >> current_bytes) || max_str == "max") return MemoryPressure::Normal;
+        double limit = std::strtod(max_str.c_str(), nullptr);
+        if (limit <= 0) return MemoryPressure::Normal;
+
+        double r = current_bytes / limit;
+        if (ratio) *ratio = r;
+        if (r >= CGROUP_CRITICAL) return MemoryPressure::Critical;
+        if (r >= CGROUP_MODERATE) return MemoryPressure::Moderate;
+        return MemoryPressure::Normal;
+    }
+
+    // "0::/user.slice/..." aus /proc/self/cgroup (cgroup v2) -> Ordner unter mount
+    static std::string detect_cgroup_dir(const std::string& proc_cgroup = "/proc/self/cgroup",
+                                         const std::string& mount = "/sys/fs/cgroup") {
+        std::ifstream f(proc_cgroup);
+        std::string line;
+        while (std::getline(f, line)) {
+            if (line.rfind("0::", 0) == 0) {
+                std::string dir = mount + line.substr(3);
+                if (access((dir + "/memory.max").c_str(), R_OK) == 0) return dir;
+            }
+        }
+        return "";
+    }
+
+    void add_consumer(MemoryConsumer c) { consumers.push_back(std::move(c)); }
+    const std::vector<MemoryConsumer>& list() const { return consumers; }
+    MemoryPressure level() const { return current; }
+
+    // PSI-Trigger des Kernels: zählt TRIGGER_HOLD_US lang, danach entscheidet avg10
+    void trigger(MemoryPressure level, int64_t now_us) {
+        triggered = std::max(triggered, level);
+        triggered_us = now_us;
+    }
+
+    // Ein Messpunkt; true, wenn sich die Stufe geändert hat
+    bool evaluate(MemoryPressure psi, MemoryPressure cgroup, int64_t now_us) {
+        if (triggered != MemoryPressure::Normal && now_us - triggered_us > TRIGGER_HOLD_US) {
+            triggered = MemoryPressure::Normal;
+        }
+        MemoryPressure level = std::max({psi, cgroup, triggered});
+        bool changed = level != current;
+        current = level;
+
+        if (level == MemoryPressure::Critical) {
+            last_pressure_us = now_us;
+            for (auto& c : consumers) shed(c, now_us);
+        } else if (level == MemoryPressure::Moderate) {
+            last_pressure_us = now_us;
+            if (now_us - last_shed_us >= SHED_COOLDOWN_US) {
+                for (auto& c : consumers) {
+                    if (!c.shed_active) {
+                        shed(c, now_us);
+                        break;
+                    }
+                }
+            }
+        } else if (now_us - last_pressure_us >= RESTORE_AFTER_S * 1000000) {
+            for (auto it = consumers.rbegin(); it != consumers.rend(); ++it) {
+                if (!it->shed_active) continue;
+                it->shed_active = false;
+                LOG_INFO("Memory", "Stelle {} wieder her", it->name);
+                if (it->restore) it->restore();
+            }
+        }
+
+        for (auto& c : consumers) {
+            if (c.bytes_metric) c.bytes_metric->set(static_cast<double>(c.bytes()));
+        }
+        return changed;
+    }
+
+private:
+    std::vector<MemoryConsumer> consumers;
+    MemoryPressure current = MemoryPressure::Normal;
+    MemoryPressure triggered = MemoryPressure::Normal;
+    int64_t triggered_us = 0;
+    int64_t last_shed_us = INT64_MIN / 2;
+    int64_t last_pressure_us = 0;
+
+    void shed(MemoryConsumer& c, int64_t now_us) {
+        if (c.shed_active) return;
+        size_t before = c.bytes ? c.bytes() : 0;
+        c.shed_active = true;
+        last_shed_us = now_us;
+        if (c.shed) c.shed();
+        size_t after = c.bytes ? c.bytes() : 0;
+        LOG_WARN("Memory", "Werfe {} ab ({} KiB frei)", c.name, (before - std::min(before, after)) / 1024);
+    }
+};
+
+#endif
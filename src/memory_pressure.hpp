@@ -0,0 +1,109 @@
+#ifndef MEMORY_PRESSURE_HPP
+#define MEMORY_PRESSURE_HPP
+
+#include <gtk/gtk.h>
+#include <glib-unix.h>
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "named_source.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+#include "memory_policy.hpp"
+
+// Speicherbudget der App.
+// Quellen: PSI (/proc/pressure/memory, Trigger + avg10) und das Limit der eigenen cgroup.
+// Lesen und Abwerfen macht MemoryBudget (memory_policy.hpp), hier nur Trigger und Timer.
+//
+// Zum Testen:
+//   CAROS_PSI_FAKE=<datei>    Datei im PSI-Format ("some avg10=... " / "full avg10=..."), wird gepollt
+//   CAROS_CGROUP_DIR=<ordner> Ordner mit memory.max und memory.current statt der eigenen cgroup
+class MemoryPressureManager {
+public:
+    static constexpr int TICK_MS = 1000;
+
+    void add_consumer(const std::string& name, std::function<size_t()> bytes,
+                      std::function<void()> shed, std::function<void()> restore) {
+        MemoryConsumer c{name, std::move(bytes), std::move(shed), std::move(restore)};
+        if (c.bytes) {
+            c.bytes_metric = &MetricsRegistry::instance().gauge("caros_mem_" + name + "_bytes",
+                                                                "Speicher des Verbrauchers " + name);
+        }
+        budget.add_consumer(std::move(c));
+    }
+
+    void start() {
+        const char *fake = g_getenv("CAROS_PSI_FAKE");
+        psi_path = fake ? fake : "/proc/pressure/memory";
+        if (!fake) {
+            // Trigger: Kernel meldet sich sofort, wenn innerhalb 2 s mehr als 150 ms (some)
+            // bzw. 100 ms (full) auf Speicher gewartet wurde
+            add_trigger("some 150000 2000000", MemoryPressure::Moderate);
+            add_trigger("full 100000 2000000", MemoryPressure::Critical);
+        }
+
+        const char *cg = g_getenv("CAROS_CGROUP_DIR");
+        cgroup_dir = cg ? cg : MemoryBudget::detect_cgroup_dir();
+
+        level_metric = &MetricsRegistry::instance().gauge("caros_mem_pressure_level", "0 = normal, 1 = moderat, 2 = kritisch");
+        cgroup_metric = &MetricsRegistry::instance().gauge("caros_mem_cgroup_usage_ratio", "memory.current / memory.max");
+
+        LOG_INFO("Memory", "PSI-Quelle {}, cgroup {}", psi_path, cgroup_dir.empty() ? "(keine)" : cgroup_dir);
+        NamedSource::timeout("memory-tick", TICK_MS, [](gpointer data) -> gboolean {
+            static_cast<MemoryPressureManager*>(data)->evaluate();
+            return G_SOURCE_CONTINUE;
+        }, this);
+    }
+
+    MemoryPressure level() const { return budget.level(); }
+
+private:
+    struct Trigger {
+        MemoryPressureManager *self;
+        MemoryPressure level;
+    };
+
+    MemoryBudget budget;
+    std::string psi_path;
+    std::string cgroup_dir;
+    Gauge *level_metric = nullptr;
+    Gauge *cgroup_metric = nullptr;
+
+    void add_trigger(const char *spec, MemoryPressure level) {
+        int fd = open(psi_path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) {
+            LOG_WARN("Memory", "{} nicht verfügbar, nur Polling", psi_path);
+            return;
+        }
+        // Der Kernel erwartet den Trigger inklusive abschließender Null
+        if (write(fd, spec, strlen(spec) + 1) < 0) {
+            LOG_WARN("Memory", "PSI-Trigger '{}' abgelehnt: {}", spec, strerror(errno));
+            close(fd);
+            return;
+        }
+        g_unix_fd_add(fd, G_IO_PRI, [](gint, GIOCondition, gpointer data) -> gboolean {
+            auto *t = static_cast<Trigger*>(data);
+            t->self->budget.trigger(t->level, g_get_monotonic_time());
+            t->self->evaluate();
+            return G_SOURCE_CONTINUE;
+        }, new Trigger{this, level});
+    }
+
+    void evaluate() {
+        MemoryPressure before = budget.level();
+        double ratio = 0.0;
+        MemoryPressure cgroup = MemoryBudget::read_cgroup(cgroup_dir, &ratio);
+        if (ratio > 0.0) cgroup_metric->set(ratio);
+        if (budget.evaluate(MemoryBudget::read_psi(psi_path), cgroup, g_get_monotonic_time())) {
+            static const char *NAMES[] = {"normal", "moderat", "kritisch"};
+            MemoryPressure level = budget.level();
+            LOG_WARN("Memory", "Speicherdruck {} -> {}", NAMES[static_cast<int>(before)], NAMES[static_cast<int>(level)]);
+            level_metric->set(static_cast<double>(level));
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <atomic>
+#include <array>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+
+// Metriken für den Feldeinsatz: Counter, Gauges und Histogramme.
+// Das Schreiben ist lock-frei und allokiert nicht (nur relaxed Atomics),
+// angelegt werden die Metriken einmalig, typischerweise über eine lokale static-Referenz:
+//   static Counter& events = MetricsRegistry::instance().counter("caros_x_total", "...");
+
+class Counter {
+public:
+    void inc(uint64_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value{0};
+};
+
+class Gauge {
+public:
+    void set(double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        value.store(bits, std::memory_order_relaxed);
+    }
+
+    double get() const {
+        uint64_t bits = value.load(std::memory_order_relaxed);
+        double v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+
+private:
+    std::atomic<uint64_t> value{0}; // Bitmuster eines double (0 == 0.0)
+};
+
+// Log-lineares Histogramm (HDR-Prinzip): pro Zweierpotenz 16 lineare Unter-Buckets,
+// also höchstens ~6% relativer Fehler über den gesamten Wertebereich von uint64.
+class Histogram {
+public:
+    static constexpr int SUB_BITS = 4;
+    static constexpr int SUB_COUNT = 1 << SUB_BITS;
+    static constexpr int BUCKETS = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+    void record(uint64_t v) {
+        // Kein eigener Zähler für count: der ergibt sich beim Export aus den Buckets
+        buckets[bucket_index(v)].fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(v, std::memory_order_relaxed);
+    }
+
+    static int bucket_index(uint64_t v) {
+        if (v < static_cast<uint64_t>(SUB_COUNT)) return static_cast<int>(v);
+        int msb = 63 - __builtin_clzll(v);
+        int shift = msb - SUB_BITS;
+        int sub = static_cast<int>((v >> shift) & (SUB_COUNT - 1));
+        return (shift + 1) * SUB_COUNT + sub;
+    }
+
+    // Größter Wert, der noch in Bucket i fällt
+    static uint64_t bucket_upper(int i) {
+        if (i < SUB_COUNT) return static_cast<uint64_t>(i);
+        int shift = i / SUB_COUNT - 1;
+        uint64_t sub = static_cast<uint64_t>(i % SUB_COUNT) | SUB_COUNT;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    uint64_t get_count() const {
+        uint64_t total = 0;
+        for (const auto& b : buckets) total += b.load(std::memory_order_relaxed);
+        return total;
+    }
+    uint64_t get_sum() const { return sum.load(std::memory_order_relaxed); }
+    uint64_t bucket(int i) const { return buckets[i].load(std::memory_order_relaxed); }
+
+    // Näherung eines Quantils (0..1) als Bucket-Obergrenze
+    uint64_t quantile(double q) const {
+        uint64_t total = get_count();
+        if (total == 0) return 0;
+        uint64_t target = static_cast<uint64_t>(q * (total - 1));
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += bucket(i);
+            if (seen > target) return bucket_upper(i);
+        }
+        return bucket_upper(BUCKETS - 1);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+    std::atomic<uint64_t> sum{0};
+};
+
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance() {
+        static MetricsRegistry registry;
+        return registry;
+    }
+
+    // Liefert die Metrik mit diesem Namen, legt sie beim ersten Aufruf an.
+    // Die Referenz bleibt für die gesamte Laufzeit gültig.
+    Counter& counter(const std::string& name, const std::string& help) {
+        return get_or_create(name, help, Kind::Counter).counter;
+    }
+
+    Gauge& gauge(const std::string& name, const std::string& help) {
+        return get_or_create(name, help, Kind::Gauge).gauge;
+    }
+
+    Histogram& histogram(const std::string& name, const std::string& help) {
+        return *get_or_create(name, help, Kind::Histogram).histogram;
+    }
+
+    // Prometheus Text-Format (Version 0.0.4)
+    std::string render_prometheus() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string out;
+        char line[256];
+
+        for (const auto& m : metrics) {
+            out += "# HELP " + m.name + " " + m.help + "\n";
+            switch (m.kind) {
+                case Kind::Counter:
+                    out += "# TYPE " + m.name + " counter\n";
+                    snprintf(line, sizeof(line), "%s %llu\n", m.name.c_str(), (unsigned long long)m.counter.get());
+                    out += line;
+                    break;
+                case Kind::Gauge:
+                    out += "# TYPE " + m.name + " gauge\n";
+                    snprintf(line, sizeof(line), "%s %.6g\n", m.name.c_str(), m.gauge.get());
+                    out += line;
+                    break;
+                case Kind::Histogram:
+                    out += "# TYPE " + m.name + " histogram\n";
+                    render_histogram(out, m.name, *m.histogram);
+                    break;
+            }
+        }
+        return out;
+    }
+
+private:
+    enum class Kind { Counter, Gauge, Histogram };
+
+    struct Metric {
+        std::string name;
+        std::string help;
+        Kind kind;
+        Counter counter;
+        Gauge gauge;
+        std::unique_ptr<Histogram> histogram; // nur bei Kind::Histogram (~8 KB Buckets)
+
+        Metric(const std::string& n, const std::string& h, Kind k) : name(n), help(h), kind(k) {
+            if (k == Kind::Histogram) histogram = std::make_unique<Histogram>();
+        }
+    };
+
+    std::mutex mutex;
+    std::deque<Metric> metrics; // deque: Elemente wandern beim Anfügen nicht
+
+    Metric& get_or_create(const std::string& name, const std::string& help, Kind kind) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& m : metrics) {
+            if (m.name == name) return m;
+        }
+        metrics.emplace_back(name, help, kind);
+        return metrics.back();
+    }
+
+    // Kumulative Buckets an jeder zweiten Zweierpotenz bis 2^40, immer dieselben Grenzen,
+    // damit rate()/histogram_quantile() über Scrapes hinweg zusammenpassen
+    static void render_histogram(std::string& out, const std::string& name, const Histogram& h) {
+        char line[256];
+        uint64_t total = h.get_count();
+        uint64_t cumulative = 0;
+        int i = 0;
+        for (int exp = 2; exp <= 40; exp += 2) {
+            uint64_t le = (uint64_t(1) << exp) - 1;
+            while (i < Histogram::BUCKETS && Histogram::bucket_upper(i) <= le) cumulative += h.bucket(i++);
+            snprintf(line, sizeof(line), "%s_bucket{le=\"%llu\"} %llu\n", name.c_str(),
+                     (unsigned long long)le, (unsigned long long)cumulative);
+            out += line;
+        }
+        snprintf(line, sizeof(line), "%s_bucket{le=\"+Inf\"} %llu\n%s_sum %llu\n%s_count %llu\n",
+                 name.c_str(), (unsigned long long)total,
+                 name.c_str(), (unsigned long long)h.get_sum(),
+                 name.c_str(), (unsigned long long)total);
+        out += line;
+    }
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef METRICS_SERVER_HPP
+#define METRICS_SERVER_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "logger.hpp"
+#include "metrics.hpp"
+#include "thread_registry.hpp"
+
+// Stellt die Metriken auf einem Unix-Socket bereit (eigener Thread).
+// Beantwortet sowohl HTTP-GET (curl --unix-socket) als auch eine nackte Verbindung.
+// Eigener Header, weil logger.hpp selbst metrics.hpp einbindet.
+class MetricsServer {
+public:
+    static void serve(const std::string& socket_path, MetricsRegistry& registry = MetricsRegistry::instance()) {
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            LOG_ERROR("Metrics", "socket() fehlgeschlagen: {}", std::strerror(errno));
+            return;
+        }
+
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socket_path.c_str());
+        unlink(socket_path.c_str());
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 4) != 0) {
+            LOG_ERROR("Metrics", "Socket {} konnte nicht geöffnet werden: {}", socket_path, std::strerror(errno));
+            close(fd);
+            return;
+        }
+
+        ThreadRegistry::spawn("caros-metrics", "background", [&registry, fd]() {
+            accept_loop(registry, fd);
+            close(fd);
+        }).detach();
+    }
+
+private:
+    static constexpr int MAX_BACKOFF_MS = 5000;
+
+    static void accept_loop(MetricsRegistry& registry, int fd) {
+        int backoff_ms = 0;
+        while (true) {
+            int client = accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client >= 0) {
+                backoff_ms = 0;
+                handle_client(registry, client);
+                close(client);
+                continue;
+            }
+
+            switch (errno) {
+                case EINTR:
+                case EAGAIN:
+                case ECONNABORTED:
+                case EPROTO:
+                    continue; // vorübergehend bzw. nur diese eine Verbindung betroffen
+                case EMFILE:
+                case ENFILE:
+                case ENOBUFS:
+                case ENOMEM:
+                    // Ressourcen erschöpft: warten statt den Kern im Kreis zu drehen
+                    backoff_ms = backoff_ms ? std::min(backoff_ms * 2, MAX_BACKOFF_MS) : 100;
+                    LOG_ERROR("Metrics", "accept() fehlgeschlagen: {}, neuer Versuch in {} ms", std::strerror(errno), backoff_ms);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(backoff_ms));
+                    continue;
+                default:
+                    LOG_ERROR("Metrics", "accept() fehlgeschlagen: {}, Metrik-Socket wird geschlossen", std::strerror(errno));
+                    return;
+            }
+        }
+    }
+
+    static void handle_client(MetricsRegistry& registry, int client) {
+        // Anfrage lesen, falls vorhanden (kurzes Timeout, nackte Verbindungen senden nichts)
+        timeval tv{0, 200000};
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        char request[512];
+        ssize_t n = recv(client, request, sizeof(request) - 1, 0);
+        bool http = n > 3 && std::strncmp(request, "GET", 3) == 0;
+
+        std::string body = registry.render_prometheus();
+        std::string response;
+        if (http) {
+            response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                       std::to_string(body.size()) + "\r\n\r\n";
+        }
+        response += body;
+
+        size_t sent = 0;
+        while (sent < response.size()) {
+            ssize_t w = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (w <= 0) break;
+            sent += static_cast<size_t>(w);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef NAMED_SOURCE_HPP
+#define NAMED_SOURCE_HPP
+
+#include <glib.h>
+#include <atomic>
+
+// Benannte Timer der Main-Loop. Der Name steht per g_source_set_name in der Quelle (gdb,
+// sysprof) und liegt während des Callbacks in einem Atomic, das der MainLoopWatchdog bei
+// einem Hänger aus seinem Thread liest. Ohne GTK, damit auch der Audio-Daemon es nutzt.
+//
+//   NamedSource::timeout_seconds("clock", 1, update_clock_label, label);
+class NamedSource {
+public:
+    static guint timeout(const char *name, guint interval_ms, GSourceFunc fn, gpointer data,
+                         gint priority = G_PRIORITY_DEFAULT) {
+        guint id = g_timeout_add_full(priority, interval_ms, dispatch, new Call{name, fn, data}, destroy);
+        g_source_set_name_by_id(id, name);
+        return id;
+    }
+
+    static guint timeout_seconds(const char *name, guint interval_s, GSourceFunc fn, gpointer data) {
+        guint id = g_timeout_add_seconds_full(G_PRIORITY_DEFAULT, interval_s, dispatch, new Call{name, fn, data}, destroy);
+        g_source_set_name_by_id(id, name);
+        return id;
+    }
+
+    // Name des gerade laufenden benannten Callbacks (statischer String), nullptr = keiner
+    static const char* running() { return current().load(std::memory_order_relaxed); }
+
+private:
+    struct Call {
+        const char *name;
+        GSourceFunc fn;
+        gpointer data;
+    };
+
+    static std::atomic<const char*>& current() {
+        static std::atomic<const char*> name{nullptr};
+        return name;
+    }
+
+    static gboolean dispatch(gpointer p) {
+        auto *call = static_cast<Call*>(p);
+        const char *previous = current().exchange(call->name, std::memory_order_relaxed);
+        gboolean keep = call->fn(call->data);
+        current().store(previous, std::memory_order_relaxed);
+        return keep;
+    }
+
+    static void destroy(gpointer p) { delete static_cast<Call*>(p); }
+};
+
+#endif
@@ -3,140 +3,457 @@
 
 #include <gst/gst.h>
 #include <gtk/gtk.h>
+#include <glib-unix.h>
 #include <string>
-#include <iostream>
-#include <curl/curl.h>
+#include <vector>
+#include <cstdlib>
+#include <csignal>
+#include <unistd.h>
+
+#include "audio_engine.hpp"
+#include "audio_ipc.hpp"
+#include "spectrum_tap.hpp"
+#include "variant_playback.hpp"
+#include "input_trace.hpp"
+#include "mainloop_watchdog.hpp"
+#include "named_source.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+
+static_assert(SpectrumFrame::BANDS == audio_ipc::LEVEL_BANDS, "Pegel-Bänder von Daemon und Visualizer müssen übereinstimmen");
 
 struct MetadataTask {
     GtkWidget* label;
     char* text;
 };
 
+// Bedienseite der Wiedergabe. Normalerweise läuft das playbin im Audio-Daemon (caros-audiod),
+// angesprochen über gemeinsamen Speicher (audio_ipc.hpp); ein Neustart der Oberfläche
+// unterbricht die Wiedergabe dann nicht. Ist kein Daemon erreichbar oder CAROS_AUDIO_DAEMON=0
+// gesetzt, läuft dieselbe AudioEngine direkt in diesem Prozess. Der Verbindungsaufbau blockiert
+// den Main-Thread nie: ein Daemon, der annimmt, aber den Kanal nicht übergibt, wird beendet
+// und neu gestartet; Befehle bis zur Verbindung werden gesammelt.
+// Sender mit mehreren Qualitäten wechseln die Variante selbst (VariantPlayback), je nach
+// gemessenem Durchsatz und Datensparlimit (CAROS_DATA_SAVER_KBPS).
 class RadioManager {
 public:
-    GstElement *pipeline;
+    static constexpr guint PING_INTERVAL_S = 5;
+    static constexpr guint VARIANT_CHECK_S = 5;
+    static constexpr int MAX_MISSED_PONGS = 3;
+    static constexpr int SPAWN_WAIT_MS = 3000;  // Start inkl. Warten auf die Sperre des Vorgängers
+    static constexpr guint DIAL_RETRY_MS = 20;
+    static constexpr size_t MAX_PENDING = 64;
+
     GtkWidget *title_label;
 
-    RadioManager(GtkWidget *label) : title_label(label) {
+    RadioManager(GtkWidget *label) : title_label(label), remote_spectrum(this) {
         gst_init(NULL, NULL);
-        pipeline = gst_element_factory_make("playbin", "radio-player");
+        const char *saver_env = g_getenv("CAROS_DATA_SAVER_KBPS");
+        if (saver_env) playback.set_cap_kbps(std::atoi(saver_env));
+        playback.load = [this](const std::string& uri, const std::string& station) { load_uri(uri, station); };
+        // Umschalten ohne Anlass von außen (z.B. Sender ohne Titel-Metadaten)
+        NamedSource::timeout_seconds("radio-variant-check", VARIANT_CHECK_S, [](gpointer data) -> gboolean {
+            static_cast<RadioManager*>(data)->playback.poll(false, g_get_monotonic_time());
+            return G_SOURCE_CONTINUE;
+        }, this);
 
-        if (!pipeline) {
-            std::cerr << "[RadioManager] FEHLER: playbin konnte nicht erstellt werden!" << std::endl;
+        const char *socket_env = g_getenv("CAROS_AUDIO_SOCKET");
+        socket_path = socket_env ? socket_env : audio_ipc::default_socket_path();
+
+        const char *daemon_env = g_getenv("CAROS_AUDIO_DAEMON");
+        if (daemon_env && g_strcmp0(daemon_env, "0") == 0) {
+            start_local_engine();
+            return;
         }
+        open_daemon(true);
+    }
+
+    bool is_remote() const { return engine == nullptr; }
 
-        GstBus *bus = gst_element_get_bus(pipeline);
-        gst_bus_add_watch(bus, (GstBusFunc)on_bus_message, this);
-        gst_object_unref(bus);
+    void set_source(const std::string& uri) { play_station(uri, {}); }
+
+    // Sender abspielen; bei mehreren Varianten startet die, die zur Verbindung passt
+    void play_station(const std::string& url, const std::vector<StreamVariant>& variants) {
+        playback.play(url, variants, g_get_monotonic_time());
     }
 
-    std::string resolve_m3u(const std::string& url) {
-        if (url.find(".m3u") == std::string::npos && url.find(".pls") == std::string::npos) {
-            return url; // Keine Playlist, URL direkt zurückgeben
-        }
+    void set_volume(double volume) {
+        // volume sollte zwischen 0.0 und 1.0 (oder bis 10.0 für Boost) liegen
+        if (engine) engine->set_volume(volume);
+        else send(audio_ipc::Command::SetVolume, 0, volume);
+    }
 
-        std::cout << "[RadioManager] Playlist erkannt, extrahiere Stream-URL..." << std::endl;
-        
-        // Einfacher Weg ohne libcurl (via Shell für schnellen Test):
-        // In einer produktiven App solltest du eine HTTP-Library nutzen.
-        std::string cmd = "curl -L -s " + url + " | grep -v '^#' | head -n 1";
-        char buffer[128];
-        std::string result = "";
-        FILE* pipe = popen(cmd.c_str(), "r");
-        if (pipe) {
-            if (fgets(buffer, sizeof(buffer), pipe) != NULL) {
-                result = buffer;
-                result.erase(result.find_last_not_of(" \n\r\t") + 1); // Trim
-            }
-            pclose(pipe);
+    // Speicherdruck: kleinere Stream-Puffer (greift spätestens beim nächsten Senderwechsel)
+    void set_low_memory(bool enabled) {
+        if (engine) engine->set_low_memory(enabled);
+        else send(audio_ipc::Command::SetLowMemory, enabled ? 1 : 0);
+    }
+
+    size_t buffer_bytes() const {
+        if (engine) return engine->buffer_bytes();
+        return endpoint.shared ? endpoint.shared->status.buffer_bytes.load(std::memory_order_relaxed) : 0;
+    }
+
+    // Lokale Titel lückenlos abspielen (ersetzt den laufenden Sender)
+    void play_queue(std::vector<std::string> queue) {
+        if (queue.empty()) return;
+        playback.stop(g_get_monotonic_time());
+        if (engine) {
+            engine->play_queue(std::move(queue));
+            return;
         }
-        
-        if (!result.empty()) {
-            std::cout << "[RadioManager] Echte URL gefunden: " << result << std::endl;
-            return result;
+        send(audio_ipc::Command::QueueClear);
+        for (const auto& path : queue) send(audio_ipc::Command::QueueAdd, 0, 0.0, path);
+        send(audio_ipc::Command::QueuePlay);
+    }
+
+    float eq_gain(int band) const {
+        if (engine) return engine->filter().equalizer().gain(band);
+        if (!endpoint.shared || band < 0 || band >= audio_ipc::EQ_BANDS) return 0.0f;
+        return endpoint.shared->status.eq_gain[band].load(std::memory_order_relaxed);
+    }
+
+    void set_eq_gain(int band, float db) {
+        if (engine) engine->filter().equalizer().set_gain(band, db);
+        else send(audio_ipc::Command::SetEqGain, band, db);
+    }
+
+    void save_eq() {
+        if (engine) engine->filter().save_settings();
+        else send(audio_ipc::Command::SaveEq);
+    }
+
+    // Beim Replay (CAROS_INPUT_REPLAY) zählen nur die abgespielten Meldungen; Titel, Puffer
+    // und Fehler der echten Wiedergabe werden verworfen
+    void set_replaying(bool enabled) { replaying = enabled; }
+
+    // Abgespielte Meldungen der Wiedergabe (input_replay.hpp), wie vom Bus bzw. Daemon
+    void replay_stream_event(const StreamBusEvent& e) {
+        switch (e.kind) {
+            case StreamBusEvent::Kind::Title: on_stream_title(e.text); break;
+            case StreamBusEvent::Kind::Buffering: on_stream_buffering(e.percent, e.kbps); break;
+            case StreamBusEvent::Kind::Error: on_stream_error(e.text); break;
         }
-        return url; 
     }
 
-    void set_volume(double volume) {
-        // volume sollte zwischen 0.0 und 1.0 (oder bis 10.0 für Boost) liegen
-        if (pipeline) {
-            g_object_set(pipeline, "volume", volume, NULL);
+    // Bänder für den Visualizer, egal wo die Wiedergabe läuft
+    SpectrumSource* spectrum() {
+        if (engine) return &engine->spectrum();
+        return &remote_spectrum;
+    }
+
+private:
+    // Pegel aus dem gemeinsamen Speicher; an/aus und Rate gehen als Befehl an den Daemon
+    class RemoteSpectrum : public SpectrumSource {
+    public:
+        explicit RemoteSpectrum(RadioManager *owner) : owner(owner) {}
+
+        void set_active(bool enabled) override {
+            active = enabled;
+            owner->send(audio_ipc::Command::SetSpectrum, enabled ? 1 : 0);
         }
+
+        void set_rate_hz(int hz) override {
+            rate_hz = hz;
+            owner->send(audio_ipc::Command::SetSpectrumRate, hz);
+        }
+
+        bool poll(SpectrumFrame& out) override {
+            if (!owner->endpoint.shared) return false;
+            return audio_ipc::read_levels(owner->endpoint.shared->levels, out.level.data(), last_seq);
+        }
+
+        // Nach einem Neuverbinden den Stand der Oberfläche wiederherstellen
+        void resend() {
+            last_seq = 0;
+            if (rate_hz > 0) owner->send(audio_ipc::Command::SetSpectrumRate, rate_hz);
+            if (active) owner->send(audio_ipc::Command::SetSpectrum, 1);
+        }
+
+    private:
+        RadioManager *owner;
+        bool active = false;
+        int rate_hz = 0;
+        uint32_t last_seq = 0;
+    };
+
+    std::string socket_path;
+    AudioEngine *engine = nullptr;
+    audio_ipc::Endpoint endpoint;
+    RemoteSpectrum remote_spectrum;
+    guint event_watch = 0;
+    guint ping_timer = 0;
+    int missed_pongs = 0;
+    uint32_t session = 0;            // Sitzung der aktuellen Verbindung (audio_ipc::Status)
+    pid_t daemon_pid = 0;            // zuletzt verbundener Daemon
+    bool connecting = false;
+    bool first_connect = true;       // beim Start ohne Daemon übernimmt die lokale Engine
+    bool spawned = false;
+    int64_t spawn_deadline_us = 0;
+    int dial_fd = -1;
+    guint dial_watch = 0;
+    guint dial_timer = 0;
+    std::vector<audio_ipc::Message> pending; // Befehle während des Verbindens
+    std::vector<std::string> local_queue;
+    VariantPlayback playback;
+    bool replaying = false;
+
+    void load_uri(const std::string& uri, const std::string& station) {
+        WatchdogSection section("RadioManager::set_source");
+        if (engine) engine->set_source(uri, station);
+        else send(audio_ipc::Command::PlayUri, 0, 0.0, audio_ipc::play_text(uri, station));
+    }
+
+    // Titel, Puffer und Fehler kommen lokal vom Bus oder per IPC vom Daemon hier an
+    void on_stream_title(const std::string& text) {
+        InputRecorder::instance().record_stream({StreamBusEvent::Kind::Title, 0, -1.0, text});
+        update_ui_label(text);
+        playback.on_title(text, g_get_monotonic_time());
     }
 
-    void set_source(const std::string& uri) {
-        std::string final_uri = resolve_m3u(uri); // URL auflösen
-        std::cout << "[RadioManager] Lade URI: " << final_uri << std::endl;
-        
-        gst_element_set_state(pipeline, GST_STATE_NULL); // Reset auf NULL für sauberen Wechsel
-        g_object_set(pipeline, "uri", final_uri.c_str(), NULL);
-        
-        // Puffer-Einstellungen
-        g_object_set(pipeline, "buffer-duration", 5000 * GST_MSECOND, NULL);
-        g_object_set(pipeline, "buffer-size", 1024 * 1024, NULL); 
+    void on_stream_buffering(int percent, double in_kbps) {
+        InputRecorder::instance().record_stream({StreamBusEvent::Kind::Buffering, percent, in_kbps, ""});
+        playback.on_buffering(percent, in_kbps, g_get_monotonic_time());
+    }
+
+    void on_stream_error(const std::string& text) {
+        InputRecorder::instance().record_stream({StreamBusEvent::Kind::Error, 0, -1.0, text});
+        LOG_WARN("RadioManager", "Wiedergabe meldet: {}", text);
+    }
 
-        GstStateChangeReturn ret = gst_element_set_state(pipeline, GST_STATE_PLAYING);
-        if (ret == GST_STATE_CHANGE_FAILURE) {
-            std::cerr << "[RadioManager] FEHLER: Pipeline konnte nicht in PLAYING-Zustand versetzt werden!" << std::endl;
+    void start_local_engine() {
+        LOG_WARN("RadioManager", "Kein Audio-Daemon, Wiedergabe läuft in der Oberfläche");
+        engine = new AudioEngine();
+        engine->on_title = [this](const std::string& text) { if (!replaying) on_stream_title(text); };
+        engine->on_buffering = [this](int percent, double kbps) { if (!replaying) on_stream_buffering(percent, kbps); };
+        engine->on_error = [this](const std::string& text) { if (!replaying) on_stream_error(text); };
+    }
+
+    // Verbinden ohne zu blockieren: dial, dann fd-Watch auf die Übergabe mit Zeitlimit.
+    // Kein Daemon: einmal starten und alle DIAL_RETRY_MS neu wählen, bis SPAWN_WAIT_MS um sind.
+    void open_daemon(bool spawn) {
+        connecting = true;
+        spawned = !spawn;
+        spawn_deadline_us = g_get_monotonic_time() + SPAWN_WAIT_MS * 1000LL;
+        dial_daemon();
+    }
+
+    void dial_daemon() {
+        int sock = audio_ipc::dial(socket_path);
+        if (sock >= 0) {
+            await_handoff(sock);
+            return;
         }
+        if (errno == EAGAIN) kill_daemon(daemon_pid, "nimmt keine Verbindungen mehr an");
+        retry_dial();
     }
 
-    static gboolean on_bus_message(GstBus *bus, GstMessage *msg, gpointer data) {
-        (void) bus; // ignore the bus paramter
-        RadioManager *self = static_cast<RadioManager*>(data);
+    void await_handoff(int sock) {
+        dial_fd = sock;
+        dial_watch = g_unix_fd_add(sock, static_cast<GIOCondition>(G_IO_IN | G_IO_HUP | G_IO_ERR), [](gint, GIOCondition, gpointer data) -> gboolean {
+            auto *self = static_cast<RadioManager*>(data);
+            self->dial_watch = 0;
+            g_source_remove(self->dial_timer);
+            self->dial_timer = 0;
+            bool ok = audio_ipc::receive(self->dial_fd, self->endpoint);
+            self->close_dial();
+            if (ok) self->on_connected();
+            else self->retry_dial();
+            return G_SOURCE_REMOVE;
+        }, this);
+        dial_timer = NamedSource::timeout("radio-daemon-handoff", audio_ipc::CONNECT_TIMEOUT_MS, [](gpointer data) -> gboolean {
+            auto *self = static_cast<RadioManager*>(data);
+            self->dial_timer = 0;
+            g_source_remove(self->dial_watch);
+            self->dial_watch = 0;
+            self->kill_daemon(audio_ipc::peer_pid(self->dial_fd), "übergibt den Kanal nicht");
+            self->close_dial();
+            self->retry_dial();
+            return G_SOURCE_REMOVE;
+        }, this);
+    }
 
-        switch (GST_MESSAGE_TYPE(msg)) {
-            case GST_MESSAGE_ERROR: {
-                GError *err;
-                gchar *debug_info;
-                gst_message_parse_error(msg, &err, &debug_info);
-                std::cerr << "[RadioManager] GST-FEHLER: " << err->message << std::endl;
-                std::cerr << "[RadioManager] Debug Info: " << (debug_info ? debug_info : "keine") << std::endl;
-                g_clear_error(&err);
-                g_free(debug_info);
-                break;
+    void close_dial() {
+        if (dial_fd >= 0) close(dial_fd);
+        dial_fd = -1;
+    }
+
+    // Nächster Versuch; der erste Fehlschlag startet den Daemon
+    void retry_dial() {
+        if (!spawned) {
+            spawned = true;
+            if (!spawn_daemon()) {
+                give_up();
+                return;
             }
-            case GST_MESSAGE_STATE_CHANGED: {
-                GstState old_state, new_state, pending_state;
-                gst_message_parse_state_changed(msg, &old_state, &new_state, &pending_state);
-                if (GST_MESSAGE_SRC(msg) == GST_OBJECT(self->pipeline)) {
-                    std::cout << "[RadioManager] Status: " << gst_element_state_get_name(old_state) 
-                              << " -> " << gst_element_state_get_name(new_state) << std::endl;
-                }
+            spawn_deadline_us = g_get_monotonic_time() + SPAWN_WAIT_MS * 1000LL;
+        } else if (g_get_monotonic_time() > spawn_deadline_us) {
+            LOG_ERROR("RadioManager", "Audio-Daemon meldet sich nicht auf {}", socket_path);
+            give_up();
+            return;
+        }
+        dial_timer = NamedSource::timeout("radio-daemon-dial", DIAL_RETRY_MS, [](gpointer data) -> gboolean {
+            auto *self = static_cast<RadioManager*>(data);
+            self->dial_timer = 0;
+            self->dial_daemon();
+            return G_SOURCE_REMOVE;
+        }, this);
+    }
+
+    // Hängender Daemon: beenden, damit ein neuer Socket und Sperre übernehmen kann
+    void kill_daemon(pid_t pid, const char *why) {
+        static Counter& kills = MetricsRegistry::instance().counter("caros_audio_daemon_kills_total", "Beendete hängende Audio-Daemons");
+        if (pid <= 0 || pid == getpid()) return;
+        LOG_WARN("RadioManager", "Audio-Daemon (PID {}) {}, wird beendet", pid, why);
+        kill(pid, SIGKILL);
+        kills.inc();
+    }
+
+    // Beim Start übernimmt die lokale Engine samt gesammelter Befehle, später beim nächsten Ping neu
+    void give_up() {
+        connecting = false;
+        if (!first_connect) {
+            pending.clear();
+            return;
+        }
+        first_connect = false;
+        start_local_engine();
+        for (const auto& m : pending) apply_locally(m);
+        pending.clear();
+    }
+
+    void on_connected() {
+        connecting = false;
+        first_connect = false;
+        session = endpoint.shared->status.session.load(std::memory_order_acquire);
+        daemon_pid = endpoint.shared->status.daemon_pid.load(std::memory_order_relaxed);
+        LOG_INFO("RadioManager", "Mit Audio-Daemon verbunden (PID {}, Sitzung {})", daemon_pid, session);
+        missed_pongs = 0;
+        event_watch = g_unix_fd_add(endpoint.event_fd, G_IO_IN, [](gint, GIOCondition, gpointer data) -> gboolean {
+            static_cast<RadioManager*>(data)->drain_events();
+            return G_SOURCE_CONTINUE;
+        }, this);
+        if (!ping_timer) {
+            ping_timer = NamedSource::timeout_seconds("radio-ping", PING_INTERVAL_S, [](gpointer data) -> gboolean {
+                static_cast<RadioManager*>(data)->ping();
+                return G_SOURCE_CONTINUE;
+            }, this);
+        }
+        remote_spectrum.resend();
+        std::vector<audio_ipc::Message> queued = std::move(pending);
+        pending.clear();
+        for (auto& m : queued) {
+            m.session = session;
+            push_command(m);
+        }
+        drain_events(); // Stand seit dem letzten Verbinden (z.B. aktueller Titel)
+    }
+
+    // Befehle, die vor dem Wechsel auf die lokale Engine gesammelt wurden
+    void apply_locally(const audio_ipc::Message& m) {
+        std::string text(m.text, m.text_len);
+        switch (static_cast<audio_ipc::Command>(m.type)) {
+            case audio_ipc::Command::PlayUri: {
+                std::string uri, station;
+                audio_ipc::split_play_text(text, uri, station);
+                engine->set_source(uri, station);
                 break;
             }
-            case GST_MESSAGE_BUFFERING: {
-                gint percent = 0;
-                gst_message_parse_buffering(msg, &percent);
-                std::cout << "[RadioManager] Buffering: " << percent << "%" << std::endl;
-                break;
+            case audio_ipc::Command::SetVolume: engine->set_volume(m.value); break;
+            case audio_ipc::Command::SetLowMemory: engine->set_low_memory(m.arg != 0); break;
+            case audio_ipc::Command::SetEqGain: engine->filter().equalizer().set_gain(m.arg, static_cast<float>(m.value)); break;
+            case audio_ipc::Command::SaveEq: engine->filter().save_settings(); break;
+            case audio_ipc::Command::SetSpectrum: engine->spectrum().set_active(m.arg != 0); break;
+            case audio_ipc::Command::SetSpectrumRate: engine->spectrum().set_rate_hz(m.arg); break;
+            case audio_ipc::Command::QueueClear: local_queue.clear(); break;
+            case audio_ipc::Command::QueueAdd: local_queue.push_back(text); break;
+            case audio_ipc::Command::QueuePlay: engine->play_queue(std::move(local_queue)); local_queue.clear(); break;
+            case audio_ipc::Command::Ping: break;
+        }
+    }
+
+    // Eigene Sitzung: ein Absturz oder Neustart der Oberfläche nimmt den Daemon nicht mit
+    bool spawn_daemon() {
+        const char *argv[] = {"bin/caros-audiod", nullptr};
+        GError *err = nullptr;
+        gboolean ok = g_spawn_async(nullptr, const_cast<gchar**>(argv), nullptr, G_SPAWN_DEFAULT,
+                                    [](gpointer) { setsid(); }, nullptr, nullptr, &err);
+        if (!ok) {
+            LOG_ERROR("RadioManager", "Audio-Daemon konnte nicht gestartet werden: {}", err ? err->message : "?");
+            g_clear_error(&err);
+            return false;
+        }
+        LOG_INFO("RadioManager", "Audio-Daemon gestartet");
+        return true;
+    }
+
+    void send(audio_ipc::Command type, int32_t arg = 0, double value = 0.0, const std::string& text = "") {
+        audio_ipc::Message m = audio_ipc::make_message(static_cast<uint32_t>(type), arg, value, text, session);
+        if (connecting) {
+            if (pending.size() < MAX_PENDING && type != audio_ipc::Command::Ping) pending.push_back(m);
+            return;
+        }
+        if (endpoint.shared) push_command(m);
+    }
+
+    void push_command(const audio_ipc::Message& m) {
+        static Counter& dropped = MetricsRegistry::instance().counter("caros_audio_ipc_commands_dropped_total", "Verworfene Befehle an den Audio-Daemon (Ring voll)");
+        if (!endpoint.shared->commands.push(m)) {
+            dropped.inc();
+            LOG_WARN("RadioManager", "Befehlsring voll, Befehl {} verworfen", m.type);
+            return;
+        }
+        audio_ipc::wake(endpoint.command_fd);
+    }
+
+    void drain_events() {
+        static Histogram& rtt = MetricsRegistry::instance().histogram("caros_audio_ipc_rtt_us", "Umlaufzeit Ping -> Pong zum Audio-Daemon (us)");
+        static Counter& stale = MetricsRegistry::instance().counter("caros_audio_ipc_stale_events_total", "Verworfene Meldungen aus einer früheren Sitzung");
+        audio_ipc::clear_wakeups(endpoint.event_fd);
+        audio_ipc::Message m;
+        while (endpoint.shared && endpoint.shared->events.pop(m)) {
+            if (m.session != session) {
+                stale.inc();
+                continue;
             }
-            case GST_MESSAGE_TAG: {
-                GstTagList *tags = NULL;
-                gst_message_parse_tag(msg, &tags);
-                gchar *title = NULL;
-                gchar *artist = NULL;
-
-                if (gst_tag_list_get_string(tags, GST_TAG_TITLE, &title) ||
-                    gst_tag_list_get_string(tags, GST_TAG_ARTIST, &artist)) {
-                    
-                    std::string display = (artist ? std::string(artist) + " - " : "") + (title ? title : "Stream läuft...");
-                    self->update_ui_label(display);
-                    
-                    g_free(title);
-                    g_free(artist);
-                }
-                if (tags) gst_tag_list_free(tags);
-                break;
+            // Beim Replay kommen Titel, Puffer und Fehler aus der Trace-Datei
+            if (replaying && static_cast<audio_ipc::Event>(m.type) != audio_ipc::Event::Pong) continue;
+            switch (static_cast<audio_ipc::Event>(m.type)) {
+                case audio_ipc::Event::Pong:
+                    missed_pongs = 0;
+                    rtt.record((audio_ipc::now_ns() - static_cast<uint64_t>(m.value)) / 1000);
+                    break;
+                case audio_ipc::Event::Title:
+                    on_stream_title(std::string(m.text, m.text_len));
+                    break;
+                case audio_ipc::Event::Buffering:
+                    LOG_DEBUG("RadioManager", "Buffering: {}%", m.arg);
+                    on_stream_buffering(m.arg, m.value);
+                    break;
+                case audio_ipc::Event::Error:
+                    on_stream_error(std::string(m.text, m.text_len));
+                    break;
             }
-            default:
-                break;
         }
-        return TRUE;
     }
 
-private:
+    // Lebenszeichen + Latenzmessung; bleibt der Daemon stumm, neu verbinden. Hängt er,
+    // läuft die Übergabe ins Zeitlimit und er wird beendet und neu gestartet.
+    void ping() {
+        if (connecting || engine) return;
+        if (missed_pongs >= MAX_MISSED_PONGS || !endpoint.shared) {
+            LOG_WARN("RadioManager", "Audio-Daemon antwortet nicht, verbinde neu");
+            if (event_watch) g_source_remove(event_watch);
+            event_watch = 0;
+            endpoint.close_all();
+            missed_pongs = 0;
+            open_daemon(true);
+            return;
+        }
+        missed_pongs++;
+        send(audio_ipc::Command::Ping, 0, static_cast<double>(audio_ipc::now_ns()));
+    }
+
     void update_ui_label(const std::string& text) {
         MetadataTask *task = new MetadataTask();
         task->label = this->title_label;
@@ -154,4 +471,4 @@ private:
     }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,207 @@
+#ifndef SPECTRUM_HPP
+#define SPECTRUM_HPP
+
+#include <atomic>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Spektrum für den Visualizer: Hann-Fenster, FFT und Zusammenfassung in logarithmische Bänder.
+// Rein C++, läuft im Worker-Thread (siehe SpectrumTap).
+
+// Lock-freier Dreifachpuffer: ein Schreiber, ein Leser, der Leser sieht immer den zuletzt
+// vollständig geschriebenen Stand, ohne dass einer von beiden je wartet.
+template<typename T>
+class TripleBuffer {
+public:
+    T& write_slot() { return slots[back]; }
+
+    // Geschriebenen Slot veröffentlichen
+    void publish() {
+        uint8_t prev = middle.exchange(static_cast<uint8_t>(back | FRESH), std::memory_order_acq_rel);
+        back = prev & INDEX;
+    }
+
+    // true, wenn seit dem letzten Aufruf neue Daten gekommen sind; read_slot() ist dann aktuell
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        uint8_t prev = middle.exchange(front, std::memory_order_acq_rel);
+        front = prev & INDEX;
+        return true;
+    }
+
+    const T& read_slot() const { return slots[front]; }
+
+private:
+    static constexpr uint8_t INDEX = 0x3;
+    static constexpr uint8_t FRESH = 0x4;
+
+    std::array<T, 3> slots{};
+    uint8_t back = 0;                 // nur Schreiber
+    uint8_t front = 1;                // nur Leser
+    std::atomic<uint8_t> middle{2};
+};
+
+// Radix-2-FFT, Real- und Imaginärteil getrennt (SoA), damit die Butterflies ab der
+// dritten Stufe in Vierergruppen laufen. Die GCC-Vektorerweiterung erzeugt daraus
+// SSE auf x86 und NEON auf ARM.
+class Fft {
+public:
+    typedef float v4sf __attribute__((vector_size(16)));
+
+    explicit Fft(size_t n) : size(n), re(n), im(n), bitrev(n) {
+        int bits = 0;
+        while ((size_t(1) << bits) < n) bits++;
+        for (size_t i = 0; i < n; i++) {
+            size_t r = 0;
+            for (int b = 0; b < bits; b++) if (i & (size_t(1) << b)) r |= size_t(1) << (bits - 1 - b);
+            bitrev[i] = static_cast<uint32_t>(r);
+        }
+        // Twiddles pro Stufe hintereinander, damit die innere Schleife linear liest
+        for (size_t half = 1; half < n; half *= 2) {
+            for (size_t j = 0; j < half; j++) {
+                double angle = -M_PI * j / half;
+                tw_re.push_back(static_cast<float>(std::cos(angle)));
+                tw_im.push_back(static_cast<float>(std::sin(angle)));
+            }
+        }
+    }
+
+    // Reelles Eingangssignal (Länge size), Ergebnis in real()/imag()
+    void transform(const float *input) {
+        for (size_t i = 0; i < size; i++) {
+            re[bitrev[i]] = input[i];
+            im[bitrev[i]] = 0.0f;
+        }
+
+        size_t tw = 0;
+        for (size_t half = 1; half < size; tw += half, half *= 2) {
+            size_t len = half * 2;
+            for (size_t k = 0; k < size; k += len) {
+                if (half < 4) {
+                    for (size_t j = 0; j < half; j++) butterfly(k + j, k + j + half, tw_re[tw + j], tw_im[tw + j]);
+                    continue;
+                }
+                for (size_t j = 0; j < half; j += 4) {
+                    v4sf wr = load(&tw_re[tw + j]), wi = load(&tw_im[tw + j]);
+                    v4sf ar = load(&re[k + j]), ai = load(&im[k + j]);
+                    v4sf br = load(&re[k + j + half]), bi = load(&im[k + j + half]);
+                    v4sf tr = br * wr - bi * wi;
+                    v4sf ti = br * wi + bi * wr;
+                    store(&re[k + j], ar + tr);
+                    store(&im[k + j], ai + ti);
+                    store(&re[k + j + half], ar - tr);
+                    store(&im[k + j + half], ai - ti);
+                }
+            }
+        }
+    }
+
+    const float* real() const { return re.data(); }
+    const float* imag() const { return im.data(); }
+
+private:
+    size_t size;
+    std::vector<float> re, im, tw_re, tw_im;
+    std::vector<uint32_t> bitrev;
+
+    static v4sf load(const float *p) {
+        v4sf v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static void store(float *p, v4sf v) { std::memcpy(p, &v, sizeof(v)); }
+
+    void butterfly(size_t a, size_t b, float wr, float wi) {
+        float tr = re[b] * wr - im[b] * wi;
+        float ti = re[b] * wi + im[b] * wr;
+        re[b] = re[a] - tr;
+        im[b] = im[a] - ti;
+        re[a] += tr;
+        im[a] += ti;
+    }
+};
+
+// Bandpegel 0..1 (-60..0 dBFS), fallen langsam ab
+struct SpectrumFrame {
+    static constexpr int BANDS = 32;
+    std::array<float, BANDS> level{};
+};
+
+class SpectrumAnalyzer {
+public:
+    static constexpr size_t FFT_SIZE = 1024;
+    static constexpr float MIN_HZ = 40.0f;
+    static constexpr float MAX_HZ = 16000.0f;
+    static constexpr float FLOOR_DB = -60.0f;
+
+    SpectrumAnalyzer() : fft(FFT_SIZE), history(FFT_SIZE, 0.0f), windowed(FFT_SIZE) {
+        for (size_t i = 0; i < FFT_SIZE; i++) {
+            window[i] = 0.5f - 0.5f * std::cos(2.0f * static_cast<float>(M_PI) * i / (FFT_SIZE - 1));
+        }
+        set_rate(44100);
+    }
+
+    void set_rate(int sample_rate) {
+        if (sample_rate <= 0 || sample_rate == rate) return;
+        rate = sample_rate;
+        // Bandgrenzen logarithmisch zwischen MIN_HZ und MAX_HZ, mindestens ein Bin pro Band
+        float bin_hz = static_cast<float>(rate) / FFT_SIZE;
+        for (int b = 0; b <= SpectrumFrame::BANDS; b++) {
+            float hz = MIN_HZ * std::pow(MAX_HZ / MIN_HZ, static_cast<float>(b) / SpectrumFrame::BANDS);
+            band_edge[b] = std::clamp(static_cast<size_t>(hz / bin_hz), size_t(1), FFT_SIZE / 2);
+        }
+        for (int b = 1; b <= SpectrumFrame::BANDS; b++) {
+            band_edge[b] = std::max(band_edge[b], band_edge[b - 1] + 1);
+        }
+    }
+
+    // Interleaved float32, wird zu Mono gemischt und in den Verlauf geschrieben
+    void push(const float *samples, size_t frames, int channels) {
+        float scale = 1.0f / channels;
+        for (size_t n = 0; n < frames; n++) {
+            float sum = 0.0f;
+            for (int c = 0; c < channels; c++) sum += samples[n * channels + c];
+            history[write_pos] = sum * scale;
+            write_pos = (write_pos + 1) % FFT_SIZE;
+        }
+    }
+
+    // Rechnet die letzten FFT_SIZE Samples in Bandpegel um (mit Abfall gegenüber prev)
+    void compute(SpectrumFrame& out, const SpectrumFrame& prev, float decay) {
+        for (size_t i = 0; i < FFT_SIZE; i++) {
+            windowed[i] = history[(write_pos + i) % FFT_SIZE] * window[i];
+        }
+        fft.transform(windowed.data());
+
+        const float *re = fft.real();
+        const float *im = fft.imag();
+        // Hann-Fenster halbiert die Amplitude, FFT_SIZE/4 normiert einen Vollausschlag-Sinus auf 1
+        const float norm = 4.0f / FFT_SIZE;
+        for (int b = 0; b < SpectrumFrame::BANDS; b++) {
+            float peak = 0.0f;
+            for (size_t k = band_edge[b]; k < band_edge[b + 1] && k < FFT_SIZE / 2; k++) {
+                peak = std::max(peak, re[k] * re[k] + im[k] * im[k]);
+            }
+            float db = 10.0f * std::log10(peak * norm * norm + 1e-12f);
+            float level = std::clamp((db - FLOOR_DB) / -FLOOR_DB, 0.0f, 1.0f);
+            out.level[b] = std::max(level, prev.level[b] - decay);
+        }
+    }
+
+private:
+    Fft fft;
+    int rate = 0;
+    std::vector<float> history;
+    std::vector<float> windowed;
+    std::array<float, FFT_SIZE> window{};
+    std::array<size_t, SpectrumFrame::BANDS + 1> band_edge{};
+    size_t write_pos = 0;
+};
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef SPECTRUM_TAP_HPP
+#define SPECTRUM_TAP_HPP
+
+#include <gst/gst.h>
+#include <atomic>
+#include <array>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#include "spectrum.hpp"
+#include "metrics.hpp"
+#include "thread_registry.hpp"
+
+// Quelle der Bänder für den Visualizer: SpectrumTap im selben Prozess oder der Audio-Daemon
+class SpectrumSource {
+public:
+    virtual ~SpectrumSource() = default;
+    virtual void set_active(bool enabled) = 0;
+    // Analysen pro Sekunde (z.B. vom Thermal-Governor reduziert)
+    virtual void set_rate_hz(int hz) = 0;
+    // true, wenn seit dem letzten Aufruf neue Bänder vorliegen; diese stehen dann in out
+    virtual bool poll(SpectrumFrame& out) = 0;
+};
+
+// Abgriff der dekodierten PCM-Daten für den Visualizer.
+// Der Streaming-Thread legt nur eine zusätzliche Referenz auf den GstBuffer in einen
+// lock-freien Ring (keine Kopie); der Worker liest die Samples direkt aus dem Buffer,
+// rechnet die FFT und veröffentlicht die Bänder über einen Dreifachpuffer.
+// Ist der Visualizer nicht sichtbar, wird gar nichts abgegriffen und der Worker schläft.
+class SpectrumTap : public SpectrumSource {
+public:
+    static constexpr size_t QUEUE = 16; // Zweierpotenz
+    static constexpr float DECAY = 0.04f; // Abfall der Balken pro Analyse
+
+    SpectrumTap() {
+        worker = ThreadRegistry::spawn("caros-spectrum", "spectrum", [this]() { run(); });
+    }
+
+    // Der Worker greift auf this zu: anhalten und abwarten, bevor die Member verschwinden.
+    // Vorher muss der Streaming-Thread fertig sein (Pipeline auf NULL), sonst läuft push() weiter.
+    ~SpectrumTap() override {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    SpectrumTap(const SpectrumTap&) = delete;
+    SpectrumTap& operator=(const SpectrumTap&) = delete;
+
+    // Streaming-Thread
+    void push(GstBuffer *buffer, int channels, int rate) {
+        if (!active.load(std::memory_order_relaxed) || channels < 1) return;
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= QUEUE) return; // Worker hängt hinterher
+        queue[h % QUEUE] = {gst_buffer_ref(buffer), channels, rate};
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    void set_active(bool enabled) override {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            active.store(enabled, std::memory_order_relaxed);
+        }
+        wake.notify_one();
+    }
+
+    void set_rate_hz(int hz) override { rate_hz.store(std::clamp(hz, 1, 60), std::memory_order_relaxed); }
+
+    bool poll(SpectrumFrame& out) override {
+        if (!published.update()) return false;
+        out = published.read_slot();
+        return true;
+    }
+
+private:
+    struct Item {
+        GstBuffer *buffer;
+        int channels;
+        int rate;
+    };
+
+    std::array<Item, QUEUE> queue{};
+    std::atomic<size_t> head{0};
+    std::atomic<size_t> tail{0};
+    std::atomic<bool> active{false};
+    std::atomic<int> rate_hz{30};
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    bool stopping = false; // wake_mutex
+    std::thread worker;
+
+    SpectrumAnalyzer analyzer;
+    SpectrumFrame last;
+    TripleBuffer<SpectrumFrame> published;
+
+    // Worker-Thread
+    void run() {
+        static Histogram& cost = MetricsRegistry::instance().histogram("caros_spectrum_analysis_us", "Rechenzeit einer Spektrum-Analyse (us)");
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        while (!stopping) {
+            if (!active.load(std::memory_order_relaxed)) {
+                lock.unlock();
+                drain(false);
+                lock.lock();
+                wake.wait(lock, [this]() { return active.load(std::memory_order_relaxed) || stopping; });
+                continue;
+            }
+            auto interval = std::chrono::milliseconds(1000 / rate_hz.load(std::memory_order_relaxed));
+            if (wake.wait_for(lock, interval, [this]() { return stopping; })) break;
+            lock.unlock();
+
+            auto start = std::chrono::steady_clock::now();
+            SpectrumFrame& out = published.write_slot();
+            if (drain(true)) {
+                analyzer.compute(out, last, DECAY);
+            } else {
+                // Keine Daten (Pause, Buffering): Balken fallen lassen
+                for (int b = 0; b < SpectrumFrame::BANDS; b++) out.level[b] = std::max(0.0f, last.level[b] - DECAY);
+            }
+            last = out;
+            published.publish();
+            cost.record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+            lock.lock();
+        }
+        lock.unlock();
+        drain(false);
+    }
+
+    // Gibt alle wartenden Buffer frei, mit analyze=true vorher in den Analyzer
+    bool drain(bool analyze) {
+        bool any = false;
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_acquire);
+        for (; t != h; t++) {
+            Item& item = queue[t % QUEUE];
+            GstMapInfo map;
+            if (analyze && gst_buffer_map(item.buffer, &map, GST_MAP_READ)) {
+                analyzer.set_rate(item.rate);
+                analyzer.push(reinterpret_cast<const float*>(map.data), map.size / (sizeof(float) * item.channels), item.channels);
+                gst_buffer_unmap(item.buffer, &map);
+                any = true;
+            }
+            gst_buffer_unref(item.buffer);
+        }
+        tail.store(t, std::memory_order_release);
+        return any;
+    }
+};
+
+#endif
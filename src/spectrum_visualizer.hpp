@@ -0,0 +1,114 @@
+#ifndef SPECTRUM_VISUALIZER_HPP
+#define SPECTRUM_VISUALIZER_HPP
+
+#include <gtk/gtk.h>
+#include <algorithm>
+
+#include "spectrum_tap.hpp"
+
+class SpectrumVisualizer;
+
+// Balken-Widget, gezeichnet per GtkSnapshot
+#define CAR_TYPE_SPECTRUM (car_spectrum_get_type())
+G_DECLARE_FINAL_TYPE(CarSpectrum, car_spectrum, CAR, SPECTRUM, GtkWidget)
+
+struct _CarSpectrum {
+    GtkWidget parent_instance;
+    SpectrumVisualizer *owner;
+};
+
+G_DEFINE_TYPE(CarSpectrum, car_spectrum, GTK_TYPE_WIDGET)
+
+// Zeichnet nur, solange das Widget gemappt ist (sichtbare Seite im Stack),
+// und nur in Frames, in denen der Worker etwas Neues veröffentlicht hat.
+class SpectrumVisualizer {
+public:
+    static constexpr int GAP = 3;
+
+    explicit SpectrumVisualizer(SpectrumSource *source) : source(source) {
+        widget = GTK_WIDGET(g_object_new(CAR_TYPE_SPECTRUM, nullptr));
+        CAR_SPECTRUM(widget)->owner = this;
+        gtk_widget_add_css_class(widget, "spectrum");
+
+        g_signal_connect(widget, "map", G_CALLBACK(+[](GtkWidget*, gpointer d) {
+            static_cast<SpectrumVisualizer*>(d)->set_visible(true);
+        }), this);
+        g_signal_connect(widget, "unmap", G_CALLBACK(+[](GtkWidget*, gpointer d) {
+            static_cast<SpectrumVisualizer*>(d)->set_visible(false);
+        }), this);
+    }
+
+    GtkWidget* get_widget() { return widget; }
+
+    // --- Aufrufe aus dem Widget ---
+
+    void measure(GtkOrientation orientation, int *minimum, int *natural) {
+        if (orientation == GTK_ORIENTATION_HORIZONTAL) {
+            *minimum = SpectrumFrame::BANDS * (2 + GAP);
+            *natural = SpectrumFrame::BANDS * (14 + GAP);
+        } else {
+            *minimum = 60;
+            *natural = 120;
+        }
+    }
+
+    void snapshot(GtkSnapshot *snapshot) {
+        static const GdkRGBA bar = {0.0f, 0.83f, 1.0f, 0.85f};
+        float w = static_cast<float>(gtk_widget_get_width(widget));
+        float h = static_cast<float>(gtk_widget_get_height(widget));
+        float bar_w = (w - (SpectrumFrame::BANDS - 1) * GAP) / SpectrumFrame::BANDS;
+        if (bar_w <= 0) return;
+
+        for (int b = 0; b < SpectrumFrame::BANDS; b++) {
+            float bar_h = std::max(2.0f, levels.level[b] * h);
+            graphene_rect_t rect = GRAPHENE_RECT_INIT(b * (bar_w + GAP), h - bar_h, bar_w, bar_h);
+            gtk_snapshot_append_color(snapshot, &bar, &rect);
+        }
+    }
+
+private:
+    SpectrumSource *source;
+    GtkWidget *widget;
+    SpectrumFrame levels;
+    guint tick_id = 0;
+
+    void set_visible(bool visible) {
+        source->set_active(visible);
+        if (visible && !tick_id) {
+            tick_id = gtk_widget_add_tick_callback(widget, [](GtkWidget *w, GdkFrameClock*, gpointer d) -> gboolean {
+                auto *self = static_cast<SpectrumVisualizer*>(d);
+                if (self->source->poll(self->levels)) gtk_widget_queue_draw(w);
+                return G_SOURCE_CONTINUE;
+            }, this, nullptr);
+        } else if (!visible && tick_id) {
+            gtk_widget_remove_tick_callback(widget, tick_id);
+            tick_id = 0;
+        }
+    }
+};
+
+// --- GObject-Anbindung ---
+
+static void car_spectrum_measure(GtkWidget *widget, GtkOrientation orientation, int,
+                                 int *minimum, int *natural, int *minimum_baseline, int *natural_baseline) {
+    CAR_SPECTRUM(widget)->owner->measure(orientation, minimum, natural);
+    *minimum_baseline = *natural_baseline = -1;
+}
+
+static void car_spectrum_snapshot(GtkWidget *widget, GtkSnapshot *snapshot) {
+    CAR_SPECTRUM(widget)->owner->snapshot(snapshot);
+}
+
+static void car_spectrum_class_init(CarSpectrumClass *klass) {
+    GtkWidgetClass *widget_class = GTK_WIDGET_CLASS(klass);
+    widget_class->measure = car_spectrum_measure;
+    widget_class->snapshot = car_spectrum_snapshot;
+    gtk_widget_class_set_css_name(widget_class, "spectrum");
+}
+
+static void car_spectrum_init(CarSpectrum *self) {
+    self->owner = nullptr;
+    gtk_widget_set_can_target(GTK_WIDGET(self), FALSE);
+}
+
+#endif
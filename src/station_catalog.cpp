@@ -0,0 +1,428 @@
+#include "station_catalog.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cctype>
+
+namespace {
+
+// JSON-Leser für ein Array flacher Objekte; Escapes inkl. \uXXXX (als UTF-8) werden aufgelöst,
+// verschachtelte Werte übersprungen
+class CatalogReader {
+public:
+    static std::vector<CatalogEntry> parse(const std::string& json) {
+        CatalogReader p(json);
+        std::vector<CatalogEntry> out;
+        p.skip_ws();
+        if (!p.eat('[')) return out;
+        p.skip_ws();
+        if (p.eat(']')) return out;
+        do {
+            p.skip_ws();
+            CatalogEntry e;
+            if (!p.parse_object(e)) break;
+            if (!e.uuid.empty() && !e.name.empty() && e.url.rfind("http", 0) == 0) out.push_back(std::move(e));
+            p.skip_ws();
+        } while (p.eat(','));
+        return out;
+    }
+
+private:
+    const std::string& s;
+    size_t i = 0;
+    std::string key, text; // wiederverwendet, spart Allokationen pro Feld
+
+    explicit CatalogReader(const std::string& json) : s(json) {}
+
+    void skip_ws() { while (i < s.size() && (s[i] == ' ' || s[i] == '\n' || s[i] == '\r' || s[i] == '\t')) i++; }
+
+    bool eat(char c) {
+        if (i < s.size() && s[i] == c) {
+            i++;
+            return true;
+        }
+        return false;
+    }
+
+    static void append_utf8(std::string& out, uint32_t cp) {
+        if (cp < 0x80) out += static_cast<char>(cp);
+        else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    uint32_t hex4() {
+        if (i + 4 > s.size()) return 0xFFFD;
+        uint32_t v = static_cast<uint32_t>(std::strtoul(s.substr(i, 4).c_str(), nullptr, 16));
+        i += 4;
+        return v;
+    }
+
+    bool parse_string(std::string& out) {
+        if (!eat('"')) return false;
+        out.clear();
+        while (i < s.size()) {
+            char c = s[i++];
+            if (c == '"') return true;
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (i >= s.size()) return false;
+            char e = s[i++];
+            switch (e) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    uint32_t cp = hex4();
+                    // Surrogatpaar (Emojis in Sendernamen)
+                    if (cp >= 0xD800 && cp < 0xDC00 && i + 1 < s.size() && s[i] == '\\' && s[i + 1] == 'u') {
+                        i += 2;
+                        uint32_t low = hex4();
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    append_utf8(out, cp);
+                    break;
+                }
+                default: out += e; break; // \" \\ \/
+            }
+        }
+        return false;
+    }
+
+    // Zahl, null, true/false oder Verschachteltes überspringen; Zahlen landen in number
+    bool parse_value(std::string& out, double& number, bool& is_number) {
+        is_number = false;
+        skip_ws();
+        if (i >= s.size()) return false;
+        if (s[i] == '"') return parse_string(out);
+        if (s[i] == '{' || s[i] == '[') {
+            int depth = 0;
+            std::string ignored;
+            while (i < s.size()) {
+                if (s[i] == '"') {
+                    if (!parse_string(ignored)) return false;
+                    continue;
+                }
+                if (s[i] == '{' || s[i] == '[') depth++;
+                else if (s[i] == '}' || s[i] == ']') depth--;
+                i++;
+                if (depth == 0) return true;
+            }
+            return false;
+        }
+        const char *start = s.c_str() + i;
+        char *end = nullptr;
+        number = std::strtod(start, &end);
+        if (end != start) {
+            is_number = true;
+            i += end - start;
+            return true;
+        }
+        while (i < s.size() && s[i] != ',' && s[i] != '}' && s[i] != ']') i++; // null/true/false
+        return true;
+    }
+
+    bool parse_object(CatalogEntry& e) {
+        if (!eat('{')) return false;
+        bool has_lat = false, has_lon = false;
+        skip_ws();
+        if (eat('}')) return true;
+        do {
+            skip_ws();
+            double number = 0.0;
+            bool is_number = false;
+            if (!parse_string(key)) return false;
+            skip_ws();
+            if (!eat(':') || !parse_value(text, number, is_number)) return false;
+
+            if (key == "stationuuid") e.uuid = text;
+            else if (key == "changeuuid") e.changeuuid = text;
+            else if (key == "lastchangetime_iso8601") e.lastchangetime = text;
+            else if (key == "name") e.name = text;
+            else if (key == "url_resolved") e.url = text;
+            else if (key == "favicon") e.favicon = text;
+            else if (key == "homepage") e.homepage = text;
+            else if (key == "codec") e.codec = text;
+            else if (key == "bitrate" && is_number) e.bitrate_kbps = static_cast<int>(number);
+            else if (key == "geo_lat" && is_number) { e.lat = number; has_lat = true; }
+            else if (key == "geo_long" && is_number) { e.lon = number; has_lon = true; }
+            skip_ws();
+        } while (eat(','));
+        e.has_geo = has_lat && has_lon;
+        // Das Semikolon trennt die Spalten in stations.csv
+        for (char& c : e.name) if (c == ';' || c == '\n' || c == '\r') c = ' ';
+        for (char& c : e.codec) if (c == ';' || c == '|' || c == '/' || c == '\n' || c == '\r') c = ' ';
+        for (std::string *f : {&e.url, &e.favicon}) {
+            if (f->find_first_of(";\n\r") != std::string::npos) f->clear();
+        }
+        return eat('}');
+    }
+};
+
+} // namespace
+
+std::vector<CatalogEntry> CatalogParser::parse(const std::string& json) {
+    return CatalogReader::parse(json);
+}
+
+std::string encode_variants(const std::vector<StreamVariant>& variants) {
+    std::string out;
+    for (const auto& v : variants) {
+        if (!out.empty()) out += '|';
+        out += v.codec + "/" + std::to_string(v.bitrate_kbps) + "/";
+        for (char c : v.url) {
+            if (c == '|') out += "%7C";
+            else out += c;
+        }
+    }
+    return out;
+}
+
+std::vector<StreamVariant> decode_variants(const std::string& column) {
+    std::vector<StreamVariant> out;
+    std::stringstream ss(column);
+    std::string item;
+    while (std::getline(ss, item, '|')) {
+        size_t a = item.find('/');
+        size_t b = a == std::string::npos ? a : item.find('/', a + 1);
+        if (b == std::string::npos) continue;
+        StreamVariant v;
+        v.codec = item.substr(0, a);
+        v.bitrate_kbps = std::atoi(item.c_str() + a + 1);
+        v.url = item.substr(b + 1);
+        for (size_t p; (p = v.url.find("%7C")) != std::string::npos;) v.url.replace(p, 3, "|");
+        out.push_back(std::move(v));
+    }
+    return out;
+}
+
+void write_station_line(std::ostream& out, const RadioStation& s) {
+    out << s.name << ";" << s.url << ";" << s.logo_path;
+    if (s.has_geo || !s.uuid.empty()) {
+        char buf[64] = ";;";
+        if (s.has_geo) snprintf(buf, sizeof(buf), ";%.6f;%.6f", s.lat, s.lon);
+        out << buf;
+    }
+    if (!s.uuid.empty()) out << ";" << s.uuid << ";" << s.changeuuid << ";" << s.logo_url;
+    if (!s.uuid.empty() && !s.variants.empty()) out << ";" << encode_variants(s.variants);
+    out << "\n";
+}
+
+bool parse_station_line(const std::string& line, RadioStation& s) {
+    std::stringstream ss(line);
+    std::string lat, lon;
+    s = RadioStation{};
+    if (!std::getline(ss, s.name, ';') || !std::getline(ss, s.url, ';') || !std::getline(ss, s.logo_path, ';')) return false;
+    // Koordinaten sind optional (ältere Listen, selbst angelegte Sender)
+    if (std::getline(ss, lat, ';') && std::getline(ss, lon, ';')) {
+        char *end_lat = nullptr, *end_lon = nullptr;
+        s.lat = std::strtod(lat.c_str(), &end_lat);
+        s.lon = std::strtod(lon.c_str(), &end_lon);
+        s.has_geo = end_lat != lat.c_str() && end_lon != lon.c_str();
+    }
+    std::getline(ss, s.uuid, ';');
+    std::getline(ss, s.changeuuid, ';');
+    std::getline(ss, s.logo_url, ';');
+    std::string variants;
+    if (std::getline(ss, variants, ';')) s.variants = decode_variants(variants);
+    return true;
+}
+
+std::string variant_key(const std::string& name, const std::string& homepage) {
+    static const std::set<std::string> quality = {
+        "mp3", "aac", "aac+", "aacp", "heaac", "he", "ogg", "vorbis", "opus", "flac",
+        "hq", "lq", "k", "kbps", "kbit", "kbits",
+        "24", "32", "48", "56", "64", "96", "112", "128", "160", "192", "256", "320"};
+    std::string key, word;
+    auto flush = [&]() {
+        if (word.empty()) return;
+        size_t digits = 0;
+        while (digits < word.size() && std::isdigit(static_cast<unsigned char>(word[digits]))) digits++;
+        std::string unit = word.substr(digits);
+        bool bitrate = digits > 0 && (unit == "k" || unit == "kbps" || unit == "kbit" || unit == "kbits");
+        if (!bitrate && !quality.count(word)) key += (key.empty() ? "" : " ") + word;
+        word.clear();
+    };
+    for (unsigned char c : name) {
+        if (std::isalnum(c) || c >= 0x80 || c == '+') word += static_cast<char>(std::tolower(c));
+        else flush();
+    }
+    flush();
+
+    std::string host = homepage;
+    size_t scheme = host.find("://");
+    if (scheme != std::string::npos) host.erase(0, scheme + 3);
+    host = host.substr(0, host.find('/'));
+    for (char& c : host) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    if (host.rfind("www.", 0) == 0) host.erase(0, 4);
+    return key + "@" + host;
+}
+
+std::vector<CatalogEntry> group_variants(const std::vector<CatalogEntry>& entries) {
+    std::vector<CatalogEntry> out;
+    std::vector<std::vector<const CatalogEntry*>> members;
+    std::unordered_map<std::string, size_t> by_key;
+    for (const CatalogEntry& e : entries) {
+        std::string key = variant_key(e.name, e.homepage);
+        auto it = by_key.find(key);
+        if (it == by_key.end()) {
+            by_key.emplace(key, out.size());
+            out.push_back(e);
+            members.push_back({&e});
+        } else {
+            members[it->second].push_back(&e);
+        }
+    }
+
+    for (size_t g = 0; g < out.size(); g++) {
+        if (members[g].size() < 2) continue;
+        CatalogEntry& head = out[g];
+        std::vector<std::pair<std::string, std::string>> ids;
+        std::set<std::string> urls;
+        for (const CatalogEntry *m : members[g]) {
+            ids.emplace_back(m->uuid, m->changeuuid);
+            if (m->lastchangetime > head.lastchangetime) head.lastchangetime = m->lastchangetime;
+            if (!urls.insert(m->url).second) continue;
+            head.variants.push_back({m->codec, m->bitrate_kbps, m->url});
+        }
+        if (head.variants.size() < 2) head.variants.clear();
+        // FNV-1a über alle uuid/changeuuid-Paare
+        std::sort(ids.begin(), ids.end());
+        uint64_t h = 1469598103934665603ull;
+        for (const auto& [uuid, change] : ids) {
+            for (char c : uuid + "/" + change + ";") h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        char buf[24];
+        snprintf(buf, sizeof(buf), "v%016llx", static_cast<unsigned long long>(h));
+        head.changeuuid = buf;
+    }
+    return out;
+}
+
+CatalogDiff diff_catalog(const std::vector<RadioStation>& local, const std::vector<CatalogEntry>& remote,
+                         const std::set<std::string>& removed, bool (*logo_exists)(const std::string&),
+                         bool complete) {
+    CatalogDiff diff;
+    std::unordered_map<std::string, size_t> by_uuid;
+    std::unordered_map<std::string, size_t> legacy_by_url, legacy_by_name;
+    by_uuid.reserve(local.size());
+    for (size_t n = 0; n < local.size(); n++) {
+        const RadioStation& s = local[n];
+        if (!s.uuid.empty()) by_uuid.emplace(s.uuid, n);
+        // Einträge des früheren Seedings: keine uuid, aber Logo oder Koordinaten aus dem Katalog.
+        // Selbst angelegte Sender haben immer das Default-Logo und keine Koordinaten.
+        else if (s.logo_path != DEFAULT_LOGO || s.has_geo) {
+            legacy_by_url.emplace(s.url, n);
+            legacy_by_name.emplace(s.name, n);
+        }
+    }
+
+    std::vector<bool> kept(local.size(), false);
+    std::unordered_set<std::string> seen;
+    seen.reserve(remote.size());
+    diff.stations.reserve(remote.size() + local.size());
+    for (const CatalogEntry& e : remote) {
+        if (removed.count(e.uuid) || !seen.insert(e.uuid).second) continue;
+        if (e.lastchangetime > diff.newest_change) diff.newest_change = e.lastchangetime;
+
+        const RadioStation *old = nullptr;
+        auto it = by_uuid.find(e.uuid);
+        if (it != by_uuid.end()) old = &local[it->second];
+        else {
+            size_t n = local.size();
+            auto lit = legacy_by_url.find(e.url);
+            if (lit != legacy_by_url.end()) n = lit->second;
+            else if ((lit = legacy_by_name.find(e.name)) != legacy_by_name.end()) n = lit->second;
+            if (n < local.size() && !kept[n]) old = &local[n];
+        }
+        if (old) kept[old - local.data()] = true;
+
+        if (old && old->changeuuid == e.changeuuid && !old->uuid.empty()) {
+            diff.stations.push_back(*old);
+            if (logo_exists && !logo_exists(old->logo_path) && !e.favicon.empty()) diff.fetch_logo.push_back(diff.stations.size() - 1);
+            diff.unchanged++;
+            continue;
+        }
+
+        RadioStation s;
+        s.name = e.name;
+        s.url = e.url;
+        s.has_geo = e.has_geo;
+        s.lat = e.lat;
+        s.lon = e.lon;
+        s.uuid = e.uuid;
+        s.changeuuid = e.changeuuid;
+        s.logo_url = e.favicon;
+        s.variants = e.variants;
+        s.logo_path = old ? old->logo_path : DEFAULT_LOGO;
+        bool logo_changed = !old || (!old->uuid.empty() && old->logo_url != e.favicon) ||
+                            (logo_exists && !logo_exists(s.logo_path));
+        if (e.favicon.rfind("http", 0) == 0 && logo_changed) diff.fetch_logo.push_back(diff.stations.size());
+        if (!old) diff.inserted++;
+        else if (old->uuid.empty()) diff.adopted++;
+        else diff.updated++;
+        diff.stations.push_back(std::move(s));
+    }
+
+    // Nicht gelieferte Katalog-Sender fallen nur bei vollständiger Liste weg; eigene Sender bleiben
+    for (size_t n = 0; n < local.size(); n++) {
+        if (kept[n]) continue;
+        const RadioStation& s = local[n];
+        if (s.uuid.empty() || !complete) {
+            if (!s.uuid.empty()) diff.missing.push_back(s.uuid);
+            diff.stations.push_back(s);
+            continue;
+        }
+        diff.deleted++;
+        if (s.logo_path != DEFAULT_LOGO) diff.stale_logos.push_back(s.logo_path);
+    }
+    return diff;
+}
+
+void confirm_deletions(CatalogDiff& diff, const std::set<std::string>& gone) {
+    std::set<std::string> candidates;
+    for (const std::string& uuid : diff.missing) {
+        if (gone.count(uuid)) candidates.insert(uuid);
+    }
+    if (candidates.empty()) return;
+
+    std::vector<size_t> moved(diff.stations.size());
+    size_t out = 0;
+    for (size_t n = 0; n < diff.stations.size(); n++) {
+        RadioStation& s = diff.stations[n];
+        if (!s.uuid.empty() && candidates.count(s.uuid)) {
+            diff.deleted++;
+            if (s.logo_path != DEFAULT_LOGO) diff.stale_logos.push_back(s.logo_path);
+            moved[n] = static_cast<size_t>(-1);
+            continue;
+        }
+        moved[n] = out;
+        if (out != n) diff.stations[out] = std::move(s);
+        out++;
+    }
+    diff.stations.resize(out);
+    for (size_t& i : diff.fetch_logo) i = moved[i];
+    diff.fetch_logo.erase(std::remove(diff.fetch_logo.begin(), diff.fetch_logo.end(), static_cast<size_t>(-1)), diff.fetch_logo.end());
+    diff.missing.erase(std::remove_if(diff.missing.begin(), diff.missing.end(),
+                                      [&](const std::string& uuid) { return candidates.count(uuid) > 0; }),
+                       diff.missing.end());
+}
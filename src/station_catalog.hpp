@@ -0,0 +1,100 @@
+#ifndef STATION_CATALOG_HPP
+#define STATION_CATALOG_HPP
+
+#include <string>
+#include <vector>
+#include <set>
+#include <ostream>
+
+#include "stream_variants.hpp"
+
+// Ein Sender der lokalen Liste (assets/stations.csv).
+// Sender aus dem radio-browser-Katalog tragen dessen stationuuid/changeuuid, selbst angelegte
+// Sender haben keine uuid und werden vom Abgleich nie angefasst.
+struct RadioStation {
+    std::string name;
+    std::string url;
+    std::string logo_path; // Lokaler Pfad zum Cache
+    bool has_geo = false;  // Koordinaten aus radio-browser (geo_lat/geo_long)
+    double lat = 0.0;
+    double lon = 0.0;
+    std::string uuid;       // stationuuid, leer = selbst angelegt
+    std::string changeuuid; // ändert sich bei jeder Änderung des Eintrags im Katalog
+    std::string logo_url;   // favicon, aus dem logo_path geladen wurde
+    std::vector<StreamVariant> variants; // leer = nur url; sonst alle Qualitäten inkl. url
+};
+
+constexpr const char *DEFAULT_LOGO = "assets/logos/default.png";
+
+// Spalte Varianten: Codec/Bitrate/URL, mehrere durch '|' getrennt ('|' in URLs als %7C)
+std::string encode_variants(const std::vector<StreamVariant>& variants);
+std::vector<StreamVariant> decode_variants(const std::string& column);
+
+// Zeile im CSV-Format: Name;URL;LogoPath[;Lat;Lon[;UUID;ChangeUUID;LogoURL[;Varianten]]]
+void write_station_line(std::ostream& out, const RadioStation& s);
+bool parse_station_line(const std::string& line, RadioStation& s);
+
+// Ein Eintrag aus /json/stations/search
+struct CatalogEntry {
+    std::string uuid;
+    std::string changeuuid;
+    std::string lastchangetime; // ISO 8601, nur für das Log
+    std::string name;
+    std::string url;            // url_resolved
+    std::string favicon;
+    std::string homepage;
+    std::string codec;
+    int bitrate_kbps = 0;
+    bool has_geo = false;
+    double lat = 0.0;
+    double lon = 0.0;
+    std::vector<StreamVariant> variants; // nach group_variants(): alle Qualitäten des Senders
+};
+
+// Minimaler JSON-Leser für die Senderliste von radio-browser: ein Array flacher Objekte.
+// Escapes inkl. \uXXXX (als UTF-8) werden aufgelöst, verschachtelte Werte übersprungen.
+class CatalogParser {
+public:
+    static std::vector<CatalogEntry> parse(const std::string& json);
+};
+
+// Schlüssel, unter dem Varianten desselben Senders zusammenfallen: Wörter des Namens ohne
+// Codec- und Bitraten-Angaben ("Deutschlandfunk | DLF | MP3 128k" -> "deutschlandfunk dlf")
+// plus Host der Homepage, damit gleichnamige Sender verschiedener Betreiber getrennt bleiben.
+std::string variant_key(const std::string& name, const std::string& homepage);
+
+// Fasst mehrfach gelistete Sender zusammen. Der erste Eintrag einer Gruppe (in der Reihenfolge
+// der API, also der beliebteste) gibt uuid, Name, Logo und Standard-URL vor; changeuuid wird
+// aus allen Mitgliedern gebildet, damit neue oder geänderte Varianten als Änderung zählen.
+std::vector<CatalogEntry> group_variants(const std::vector<CatalogEntry>& entries);
+
+// Ergebnis des Abgleichs lokale Liste <-> Katalog
+struct CatalogDiff {
+    std::vector<RadioStation> stations;  // neue Liste: Katalog in dessen Reihenfolge, danach eigene Sender
+    std::vector<size_t> fetch_logo;      // Indizes in stations, deren Logo (neu) geladen werden muss
+    std::vector<std::string> stale_logos;// Logos entfernter Sender, erst nach dem Speichern löschen
+    std::vector<std::string> missing;    // Katalog-Sender, die diese Teilliste nicht enthält (bleiben erhalten)
+    size_t inserted = 0;
+    size_t updated = 0;
+    size_t deleted = 0;
+    size_t unchanged = 0;
+    size_t adopted = 0;                  // alte Seeding-Einträge ohne uuid, die jetzt zugeordnet sind
+    std::string newest_change;           // jüngste lastchangetime im Katalog
+
+    bool changed() const { return inserted || updated || deleted || adopted; }
+};
+
+// Vergleicht über stationuuid/changeuuid. Nur neue und geänderte Einträge werden übernommen,
+// Logos nur bei neuem Sender, geänderter favicon-URL oder fehlender Datei (logo_exists).
+// removed: vom Nutzer gelöschte Katalog-Sender, die nicht wiederkommen sollen.
+// complete: remote ist die vollständige Liste. Eine gekürzte Rangliste (Top-N) ist es nicht;
+// dann gelten fehlende Sender nicht als gelöscht, sondern landen in missing.
+CatalogDiff diff_catalog(const std::vector<RadioStation>& local, const std::vector<CatalogEntry>& remote,
+                         const std::set<std::string>& removed = {},
+                         bool (*logo_exists)(const std::string&) = nullptr,
+                         bool complete = false);
+
+// Entfernt Sender aus missing, die der Katalog bestätigt nicht mehr kennt (byuuid-Abfrage)
+void confirm_deletions(CatalogDiff& diff, const std::set<std::string>& gone);
+
+#endif
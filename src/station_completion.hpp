@@ -0,0 +1,78 @@
+#ifndef STATION_COMPLETION_HPP
+#define STATION_COMPLETION_HPP
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "text_fold.hpp"
+
+// Präfix-Vervollständigung für Sendernamen.
+// Jeder Wortanfang eines Namens ist ein Eintrag ("Deutschlandfunk Kultur" ist also
+// auch über "kultur" zu finden). Einträge liegen sortiert vor, eine Abfrage ist
+// ein lower_bound plus ein kurzer linearer Lauf über den Treffer-Bereich.
+class StationCompletionIndex {
+public:
+    void build(const std::vector<std::string>& station_names) {
+        names = station_names;
+        entries.clear();
+        for (size_t i = 0; i < names.size(); i++) {
+            std::string folded = textfold::fold(names[i]);
+            for (size_t pos = 0; pos < folded.size(); pos++) {
+                if (pos == 0 || folded[pos - 1] == ' ') {
+                    entries.push_back({folded.substr(pos), i, pos == 0});
+                }
+            }
+        }
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+            return a.key != b.key ? a.key < b.key : a.station < b.station;
+        });
+    }
+
+    // Bis zu max_results Sendernamen, deren Name oder ein Wort darin mit prefix beginnt.
+    // Treffer am Namensanfang kommen zuerst.
+    std::vector<std::string> complete(const std::string& prefix, size_t max_results) const {
+        std::vector<std::string> out;
+        std::string key = textfold::fold(prefix);
+        if (key.empty() || max_results == 0) return out;
+
+        auto it = std::lower_bound(entries.begin(), entries.end(), key, [](const Entry& e, const std::string& k) {
+            return e.key < k;
+        });
+
+        // Bei sehr kurzen Präfixen nicht den ganzen Katalog durchlaufen
+        size_t budget = 4096;
+        std::vector<size_t> starts, inner;
+        for (; it != entries.end() && it->key.compare(0, key.size(), key) == 0 && budget > 0; ++it, --budget) {
+            auto& bucket = it->name_start ? starts : inner;
+            if (bucket.size() < max_results &&
+                std::find(bucket.begin(), bucket.end(), it->station) == bucket.end()) {
+                bucket.push_back(it->station);
+            }
+            if (starts.size() >= max_results) break;
+        }
+
+        for (size_t id : starts) {
+            if (out.size() < max_results) out.push_back(names[id]);
+        }
+        for (size_t id : inner) {
+            if (out.size() >= max_results) break;
+            if (std::find(starts.begin(), starts.end(), id) == starts.end()) out.push_back(names[id]);
+        }
+        return out;
+    }
+
+    size_t size() const { return names.size(); }
+
+private:
+    struct Entry {
+        std::string key; // gefalteter Name ab einem Wortanfang
+        size_t station;
+        bool name_start;
+    };
+
+    std::vector<std::string> names;
+    std::vector<Entry> entries;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef STATION_GAIN_STORE_HPP
+#define STATION_GAIN_STORE_HPP
+
+#include <string>
+#include <unordered_map>
+#include <fstream>
+#include <cmath>
+#include <cstdlib>
+
+// Gelernte Lautheitskorrektur pro Sender (CSV: Haupt-URL;Verstärkung in dB, gilt für alle
+// Varianten des Senders), damit beim nächsten Abspielen sofort die richtige Verstärkung gilt
+// und nicht erst neu gemessen werden muss.
+class StationGainStore {
+public:
+    explicit StationGainStore(std::string path = "assets/loudness_gains.csv") : path(std::move(path)) {
+        load();
+    }
+
+    void load() {
+        gains.clear();
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            size_t sep = line.rfind(';');
+            if (sep == std::string::npos || sep == 0) continue;
+            gains[line.substr(0, sep)] = std::strtod(line.c_str() + sep + 1, nullptr);
+        }
+    }
+
+    void save() const {
+        std::ofstream file(path, std::ios::trunc);
+        for (const auto& [url, gain] : gains) file << url << ";" << gain << "\n";
+    }
+
+    bool lookup(const std::string& url, double& gain_db) const {
+        auto it = gains.find(url);
+        if (it == gains.end()) return false;
+        gain_db = it->second;
+        return true;
+    }
+
+    // Speichert nur bei spürbarer Änderung (> 0,1 dB), damit nicht jeder Senderwechsel schreibt
+    void record(const std::string& url, double gain_db) {
+        auto it = gains.find(url);
+        if (it != gains.end() && std::fabs(it->second - gain_db) < 0.1) return;
+        gains[url] = std::round(gain_db * 10.0) / 10.0;
+        save();
+    }
+
+private:
+    std::string path;
+    std::unordered_map<std::string, double> gains;
+};
+
+#endif
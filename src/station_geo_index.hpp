@@ -0,0 +1,217 @@
+#ifndef STATION_GEO_INDEX_HPP
+#define STATION_GEO_INDEX_HPP
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+
+// Ein Sender mit Koordinaten (station_id = Index in der geladenen Senderliste)
+struct GeoEntry {
+    size_t station_id;
+    double lat;
+    double lon;
+};
+
+struct NearbyStation {
+    size_t station_id;
+    double distance_km;
+    double lat;
+    double lon;
+};
+
+inline double geo_distance_km(double lat1, double lon1, double lat2, double lon2) {
+    // Haversine, für "Sender in der Nähe" mehr als genau genug
+    constexpr double deg = M_PI / 180.0;
+    double dlat = (lat2 - lat1) * deg;
+    double dlon = (lon2 - lon1) * deg;
+    double a = std::sin(dlat / 2) * std::sin(dlat / 2) +
+               std::cos(lat1 * deg) * std::cos(lat2 * deg) * std::sin(dlon / 2) * std::sin(dlon / 2);
+    return 2.0 * 6371.0 * std::asin(std::sqrt(std::min(1.0, a)));
+}
+
+// Räumlicher Index als festes Gitter (Zellgröße in Grad).
+// Die Einträge liegen nach Zelle sortiert in einem Vektor, pro Zelle wird nur
+// (Offset, Anzahl) gespeichert -> eine Abfrage liest wenige zusammenhängende Blöcke.
+class StationGeoIndex {
+public:
+    explicit StationGeoIndex(double cell_deg = 0.25)
+        : cell_deg(cell_deg),
+          lat_cells(static_cast<int>(std::ceil(180.0 / cell_deg))),
+          lon_cells(static_cast<int>(std::ceil(360.0 / cell_deg))) {}
+
+    void build(std::vector<GeoEntry> list) {
+        entries = std::move(list);
+        cells.clear();
+        std::sort(entries.begin(), entries.end(), [this](const GeoEntry& a, const GeoEntry& b) {
+            return cell_key(a.lat, a.lon) < cell_key(b.lat, b.lon);
+        });
+
+        for (size_t i = 0; i < entries.size();) {
+            int64_t key = cell_key(entries[i].lat, entries[i].lon);
+            size_t start = i;
+            while (i < entries.size() && cell_key(entries[i].lat, entries[i].lon) == key) i++;
+            cells[key] = {static_cast<uint32_t>(start), static_cast<uint32_t>(i - start)};
+        }
+    }
+
+    size_t size() const { return entries.size(); }
+    double cell_size_deg() const { return cell_deg; }
+
+    int64_t cell_key(double lat, double lon) const {
+        return static_cast<int64_t>(lat_index(lat)) * lon_cells + lon_index(lon);
+    }
+
+    // Liefert die k nächsten Sender (aufsteigend nach Entfernung) innerhalb von max_km.
+    // Gesucht wird ringförmig um die eigene Zelle, bis kein weiterer Ring mehr näher sein kann.
+    std::vector<NearbyStation> query(double lat, double lon, size_t k,
+                                     double max_km = std::numeric_limits<double>::infinity()) const {
+        std::vector<NearbyStation> best;
+        if (k == 0 || entries.empty()) return best;
+        best.reserve(k + 1);
+
+        const int cy = lat_index(lat);
+        const int cx = lon_index(lon);
+        const int max_ring = lat_cells;
+
+        for (int r = 0; r <= max_ring; r++) {
+            // Untergrenze der Entfernung zu allen Zellen ab Ring r
+            double ring_min_km = ring_distance_km(lat, r);
+            if (ring_min_km > max_km) break;
+            if (best.size() == k && ring_min_km > best.back().distance_km) break;
+
+            for (int dy = -r; dy <= r; dy++) {
+                int y = cy + dy;
+                if (y < 0 || y >= lat_cells) continue;
+                // Nur der Rand des Rings, das Innere wurde schon besucht
+                int step = (dy == -r || dy == r) ? 1 : 2 * r;
+                for (int dx = -r; dx <= r; dx += std::max(step, 1)) {
+                    int x = ((cx + dx) % lon_cells + lon_cells) % lon_cells;
+                    scan_cell(static_cast<int64_t>(y) * lon_cells + x, lat, lon, k, max_km, best);
+                }
+            }
+        }
+        return best;
+    }
+
+private:
+    struct CellRange {
+        uint32_t offset;
+        uint32_t count;
+    };
+
+    double cell_deg;
+    int lat_cells;
+    int lon_cells;
+    std::vector<GeoEntry> entries;
+    std::unordered_map<int64_t, CellRange> cells;
+
+    int lat_index(double lat) const {
+        int y = static_cast<int>(std::floor((lat + 90.0) / cell_deg));
+        return std::clamp(y, 0, lat_cells - 1);
+    }
+
+    int lon_index(double lon) const {
+        int x = static_cast<int>(std::floor((lon + 180.0) / cell_deg));
+        return (x % lon_cells + lon_cells) % lon_cells;
+    }
+
+    double ring_distance_km(double lat, int r) const {
+        if (r <= 1) return 0.0;
+        // Ein Längengrad wird zu den Polen hin kürzer -> konservativ mit dem
+        // kleinsten Wert innerhalb des Rings rechnen
+        double edge_lat = std::min(89.9, std::fabs(lat) + r * cell_deg);
+        double km_per_deg = 111.32 * std::cos(edge_lat * M_PI / 180.0);
+        return (r - 1) * cell_deg * km_per_deg;
+    }
+
+    void scan_cell(int64_t key, double lat, double lon, size_t k, double max_km,
+                   std::vector<NearbyStation>& best) const {
+        auto it = cells.find(key);
+        if (it == cells.end()) return;
+
+        const GeoEntry* e = entries.data() + it->second.offset;
+        for (uint32_t i = 0; i < it->second.count; i++) {
+            double d = geo_distance_km(lat, lon, e[i].lat, e[i].lon);
+            if (d > max_km) continue;
+            if (best.size() == k && d >= best.back().distance_km) continue;
+            // Sehr große Ringe können über die Datumsgrenze Zellen doppelt besuchen
+            if (std::any_of(best.begin(), best.end(),
+                    [&](const NearbyStation& n) { return n.station_id == e[i].station_id; })) continue;
+
+            // Sortiert einfügen, k ist klein
+            auto pos = std::upper_bound(best.begin(), best.end(), d,
+                [](double v, const NearbyStation& n) { return v < n.distance_km; });
+            best.insert(pos, {e[i].station_id, d, e[i].lat, e[i].lon});
+            if (best.size() > k) best.pop_back();
+        }
+    }
+};
+
+// Hält die "Sender in der Nähe"-Liste für die aktuelle Position aktuell.
+// Bis requery_km nach der letzten Abfrage und innerhalb derselben Zelle werden nur die
+// Entfernungen der k Treffer nachgeführt. Beim Zellwechsel oder nach requery_km wird der Index
+// neu abgefragt, denn eine Zelle (0,25° ~ 28 km) ist zu groß, um darin neue Nachbarn zu übersehen.
+class NearbyStationTracker {
+public:
+    static constexpr double REQUERY_KM = 2.0;
+
+    NearbyStationTracker(const StationGeoIndex& index, size_t k, double max_km, double requery_km = REQUERY_KM)
+        : index(index), k(k), max_km(max_km), requery_km(requery_km) {}
+
+    // true, wenn sich die Reihenfolge oder Zusammensetzung der Liste geändert hat
+    bool update(double lat, double lon) {
+        int64_t key = index.cell_key(lat, lon);
+        if (!valid || key != current_cell || geo_distance_km(lat, lon, query_lat, query_lon) > requery_km) {
+            valid = true;
+            current_cell = key;
+            query_lat = lat;
+            query_lon = lon;
+            auto fresh = index.query(lat, lon, k, max_km);
+            bool changed = !same_ids(fresh);
+            current = std::move(fresh);
+            return changed;
+        }
+
+        for (auto& n : current) {
+            n.distance_km = geo_distance_km(lat, lon, n.lat, n.lon);
+        }
+        // Fast sortiert -> Insertion Sort ist hier praktisch linear
+        bool changed = false;
+        for (size_t i = 1; i < current.size(); i++) {
+            for (size_t j = i; j > 0 && current[j].distance_km < current[j - 1].distance_km; j--) {
+                std::swap(current[j], current[j - 1]);
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    void invalidate() { valid = false; }
+
+    const std::vector<NearbyStation>& stations() const { return current; }
+
+private:
+    const StationGeoIndex& index;
+    size_t k;
+    double max_km;
+    double requery_km;
+    bool valid = false;
+    int64_t current_cell = 0;
+    double query_lat = 0.0;  // Position der letzten Abfrage
+    double query_lon = 0.0;
+    std::vector<NearbyStation> current;
+
+    bool same_ids(const std::vector<NearbyStation>& other) const {
+        if (other.size() != current.size()) return false;
+        for (size_t i = 0; i < other.size(); i++) {
+            if (other[i].station_id != current[i].station_id) return false;
+        }
+        return true;
+    }
+};
+
+#endif
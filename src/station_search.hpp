@@ -0,0 +1,317 @@
+#ifndef STATION_SEARCH_HPP
+#define STATION_SEARCH_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "text_fold.hpp"
+
+// Ein Treffer der Sendersuche (station = Index in der Liste, die an build() ging)
+struct SearchHit {
+    uint32_t station;
+    int score;
+};
+
+// Zustand zwischen zwei Tastendrücken. Wird die Anfrage nur verlängert,
+// verfeinert die Suche die vorherigen Treffer, statt den Index neu zu durchsuchen.
+struct SearchSession {
+    std::vector<std::string> terms;
+    std::vector<std::vector<uint8_t>> term_dist;     // pro Begriff: Abstand je Token (NO_MATCH = kein Treffer)
+    std::vector<std::vector<uint32_t>> term_tokens;  // pro Begriff: die passenden Tokens
+    std::vector<uint32_t> candidates;                // Sender, die alle Begriffe erfüllen
+    size_t index_generation = 0;
+
+    void reset() {
+        terms.clear();
+        term_dist.clear();
+        term_tokens.clear();
+        candidates.clear();
+    }
+};
+
+// Suchindex über die Sendernamen:
+//  - Tokens (gefaltete Wörter) sortiert für Präfixsuche
+//  - Trigramme je Token für tippfehlertolerante Kandidaten
+//  - Abgleich per Präfix-Editierdistanz (mit Vertauschung benachbarter Zeichen)
+class StationSearchIndex {
+public:
+    static constexpr uint8_t NO_MATCH = 0xFF;
+    static constexpr int MAX_TERM_LEN = 40;
+
+    void build(const std::vector<std::string>& station_names) {
+        names = station_names;
+        tokens.clear();
+        token_stations.clear();
+        station_tokens.assign(names.size(), {});
+        trigrams.clear();
+        generation++;
+
+        std::unordered_map<std::string, uint32_t> token_ids;
+        for (uint32_t s = 0; s < names.size(); s++) {
+            std::string folded = textfold::fold(names[s]);
+            size_t start = 0;
+            while (start < folded.size()) {
+                size_t end = folded.find(' ', start);
+                if (end == std::string::npos) end = folded.size();
+                std::string tok = folded.substr(start, end - start);
+                start = end + 1;
+
+                auto [it, inserted] = token_ids.emplace(tok, static_cast<uint32_t>(tokens.size()));
+                if (inserted) {
+                    tokens.push_back(tok);
+                    token_stations.emplace_back();
+                }
+                auto& postings = token_stations[it->second];
+                if (postings.empty() || postings.back() != s) postings.push_back(s);
+                station_tokens[s].push_back(it->second);
+            }
+        }
+
+        sorted_tokens.resize(tokens.size());
+        for (uint32_t t = 0; t < tokens.size(); t++) {
+            sorted_tokens[t] = t;
+            for_each_trigram(tokens[t], [&](uint32_t tri) {
+                auto& list = trigrams[tri];
+                if (list.empty() || list.back() != t) list.push_back(t);
+            });
+        }
+        std::sort(sorted_tokens.begin(), sorted_tokens.end(), [this](uint32_t a, uint32_t b) {
+            return tokens[a] < tokens[b];
+        });
+    }
+
+    size_t size() const { return names.size(); }
+
+    // Sucht nach query und liefert bis zu max_results Treffer, bestes Ergebnis zuerst.
+    // Die Session merkt sich den Zustand für den nächsten Tastendruck.
+    std::vector<SearchHit> search(const std::string& query, SearchSession& session, size_t max_results) const {
+        std::vector<std::string> terms = split(textfold::fold(query));
+        if (terms.empty()) {
+            session.reset();
+            return {};
+        }
+        if (session.index_generation != generation) {
+            session.reset();
+            session.index_generation = generation;
+        }
+
+        // Nur verlängert? Dann sind die neuen Treffer eine Teilmenge der alten.
+        bool narrowing = !session.terms.empty() && terms.size() >= session.terms.size();
+        std::vector<std::vector<uint8_t>> dist(terms.size());
+        std::vector<std::vector<uint32_t>> matched(terms.size());
+
+        for (size_t i = 0; i < terms.size(); i++) {
+            const std::string& term = terms[i];
+            if (i < session.terms.size() && session.terms[i] == term) {
+                dist[i] = std::move(session.term_dist[i]);
+                matched[i] = std::move(session.term_tokens[i]);
+            } else if (i < session.terms.size() && extends(term, session.terms[i]) &&
+                       allowed_typos(term) == allowed_typos(session.terms[i])) {
+                refine_term(term, session.term_tokens[i], dist[i], matched[i]);
+            } else {
+                match_term(term, dist[i], matched[i]);
+                if (i < session.terms.size()) narrowing = false;
+            }
+        }
+
+        std::vector<uint32_t> candidates;
+        if (narrowing) {
+            for (uint32_t s : session.candidates) {
+                if (matches_all(s, dist)) candidates.push_back(s);
+            }
+        } else {
+            // Mit dem seltensten Begriff beginnen, die übrigen über die Tokens des Senders prüfen
+            size_t rarest = 0;
+            for (size_t i = 1; i < terms.size(); i++) {
+                if (matched[i].size() < matched[rarest].size()) rarest = i;
+            }
+            std::vector<uint8_t> seen(names.size(), 0);
+            for (uint32_t t : matched[rarest]) {
+                for (uint32_t s : token_stations[t]) {
+                    if (seen[s]) continue;
+                    seen[s] = 1;
+                    if (matches_all(s, dist)) candidates.push_back(s);
+                }
+            }
+        }
+
+        std::vector<SearchHit> hits;
+        hits.reserve(candidates.size());
+        for (uint32_t s : candidates) hits.push_back({s, score(s, terms, dist)});
+
+        size_t n = std::min(max_results, hits.size());
+        std::partial_sort(hits.begin(), hits.begin() + n, hits.end(), [this](const SearchHit& a, const SearchHit& b) {
+            if (a.score != b.score) return a.score > b.score;
+            if (names[a.station].size() != names[b.station].size()) return names[a.station].size() < names[b.station].size();
+            return a.station < b.station;
+        });
+        hits.resize(n);
+
+        session.terms = std::move(terms);
+        session.term_dist = std::move(dist);
+        session.term_tokens = std::move(matched);
+        session.candidates = std::move(candidates);
+        return hits;
+    }
+
+    // Präfix-Editierdistanz: kleinster Abstand von term zu einem Präfix von token (max. max_dist)
+    static int prefix_distance(const std::string& term, const std::string& token, int max_dist) {
+        const int n = std::min(static_cast<int>(term.size()), MAX_TERM_LEN);
+        const int m = std::min(static_cast<int>(token.size()), n + max_dist);
+        if (n == 0) return 0;
+
+        // Drei Zeilen für Damerau (Vertauschung benachbarter Zeichen), ohne Heap-Allokation
+        std::array<int, MAX_TERM_LEN + 3> prev2{}, prev{}, cur{};
+        for (int j = 0; j <= m; j++) prev[j] = j;
+
+        for (int i = 1; i <= n; i++) {
+            cur[0] = i;
+            int row_min = cur[0];
+            for (int j = 1; j <= m; j++) {
+                int cost = term[i - 1] == token[j - 1] ? 0 : 1;
+                cur[j] = std::min({prev[j] + 1, cur[j - 1] + 1, prev[j - 1] + cost});
+                if (i > 1 && j > 1 && term[i - 1] == token[j - 2] && term[i - 2] == token[j - 1]) {
+                    cur[j] = std::min(cur[j], prev2[j - 2] + 1);
+                }
+                row_min = std::min(row_min, cur[j]);
+            }
+            if (row_min > max_dist) return max_dist + 1;
+            std::swap(prev2, prev);
+            std::swap(prev, cur);
+        }
+
+        // Beliebiges Präfix des Tokens zählt -> Minimum der letzten Zeile
+        int best = max_dist + 1;
+        for (int j = 0; j <= m; j++) best = std::min(best, prev[j]);
+        return best;
+    }
+
+    // Kurze Begriffe müssen exakt passen, längere dürfen Tippfehler enthalten
+    static int allowed_typos(const std::string& term) {
+        if (term.size() < 4 || static_cast<int>(term.size()) > MAX_TERM_LEN) return 0;
+        if (term.size() < 8) return 1;
+        return 2;
+    }
+
+private:
+    std::vector<std::string> names;
+    std::vector<std::string> tokens;
+    std::vector<uint32_t> sorted_tokens;
+    std::vector<std::vector<uint32_t>> token_stations;
+    std::vector<std::vector<uint32_t>> station_tokens;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams;
+    size_t generation = 0;
+
+    static std::vector<std::string> split(const std::string& folded) {
+        std::vector<std::string> out;
+        size_t start = 0;
+        while (start < folded.size()) {
+            size_t end = folded.find(' ', start);
+            if (end == std::string::npos) end = folded.size();
+            if (end > start) out.push_back(folded.substr(start, end - start));
+            start = end + 1;
+        }
+        return out;
+    }
+
+    static bool extends(const std::string& term, const std::string& previous) {
+        return term.size() > previous.size() && term.compare(0, previous.size(), previous) == 0;
+    }
+
+    // Trigramme mit zwei Füllzeichen am Wortanfang, damit auch kurze Präfixe Kandidaten liefern
+    template <typename F>
+    static void for_each_trigram(const std::string& word, F f) {
+        std::string padded = "\x01\x01" + word;
+        for (size_t i = 0; i + 3 <= padded.size(); i++) {
+            f((uint32_t(uint8_t(padded[i])) << 16) | (uint32_t(uint8_t(padded[i + 1])) << 8) | uint8_t(padded[i + 2]));
+        }
+    }
+
+    void match_term(const std::string& term, std::vector<uint8_t>& dist, std::vector<uint32_t>& matched) const {
+        dist.assign(tokens.size(), NO_MATCH);
+        matched.clear();
+
+        // Exakte Präfixtreffer über die sortierte Tokenliste
+        auto lo = std::lower_bound(sorted_tokens.begin(), sorted_tokens.end(), term, [this](uint32_t t, const std::string& k) {
+            return tokens[t] < k;
+        });
+        for (auto it = lo; it != sorted_tokens.end() && tokens[*it].compare(0, term.size(), term) == 0; ++it) {
+            dist[*it] = 0;
+            matched.push_back(*it);
+        }
+
+        int k = allowed_typos(term);
+        if (k == 0) return;
+
+        // Tippfehler: Kandidaten über gemeinsame Trigramme, dann exakt prüfen.
+        // Ein Fehler zerstört höchstens 3 Trigramme (Vertauschung: 4) -> der Rest muss übrig bleiben.
+        const int needed = std::max(1, static_cast<int>(term.size()) - 4 * k);
+        std::vector<uint8_t> shared(tokens.size(), 0);
+        std::vector<uint32_t> candidates;
+        for_each_trigram(term, [&](uint32_t tri) {
+            auto it = trigrams.find(tri);
+            if (it == trigrams.end()) return;
+            for (uint32_t t : it->second) {
+                if (dist[t] == NO_MATCH && shared[t]++ == 0) candidates.push_back(t);
+            }
+        });
+        for (uint32_t t : candidates) {
+            if (shared[t] < needed) continue;
+            int d = prefix_distance(term, tokens[t], k);
+            if (d <= k) {
+                dist[t] = static_cast<uint8_t>(d);
+                matched.push_back(t);
+            }
+        }
+    }
+
+    // Begriff wurde verlängert: nur die bisherigen Treffer erneut prüfen
+    void refine_term(const std::string& term, const std::vector<uint32_t>& previous,
+                     std::vector<uint8_t>& dist, std::vector<uint32_t>& matched) const {
+        dist.assign(tokens.size(), NO_MATCH);
+        matched.clear();
+        int k = allowed_typos(term);
+        for (uint32_t t : previous) {
+            int d = prefix_distance(term, tokens[t], k);
+            if (d <= k) {
+                dist[t] = static_cast<uint8_t>(d);
+                matched.push_back(t);
+            }
+        }
+    }
+
+    bool matches_all(uint32_t station, const std::vector<std::vector<uint8_t>>& dist) const {
+        for (const auto& term_dist : dist) {
+            bool any = false;
+            for (uint32_t t : station_tokens[station]) {
+                if (term_dist[t] != NO_MATCH) { any = true; break; }
+            }
+            if (!any) return false;
+        }
+        return true;
+    }
+
+    int score(uint32_t station, const std::vector<std::string>& terms, const std::vector<std::vector<uint8_t>>& dist) const {
+        int total = 0;
+        const auto& toks = station_tokens[station];
+        for (size_t i = 0; i < terms.size(); i++) {
+            int best = 0;
+            for (size_t pos = 0; pos < toks.size(); pos++) {
+                uint8_t d = dist[i][toks[pos]];
+                if (d == NO_MATCH) continue;
+                int s = 100 - 30 * d;
+                if (d == 0 && tokens[toks[pos]].size() == terms[i].size()) s += 20; // ganzes Wort
+                if (pos == i) s += 10;                                               // gleiche Wortposition
+                best = std::max(best, s);
+            }
+            total += best;
+        }
+        return total;
+    }
+};
+
+#endif
@@ -0,0 +1,68 @@
+#include "station_store.hpp"
+
+#include <fstream>
+#include <cstdio>
+
+#include "logger.hpp"
+
+std::vector<RadioStation> load_stations(const std::string& path) {
+    std::vector<RadioStation> list;
+    std::ifstream file(path);
+    std::string line;
+    if (file.is_open()) {
+        RadioStation s;
+        while (std::getline(file, line)) {
+            if (parse_station_line(line, s)) list.push_back(s);
+        }
+        file.close();
+    }
+    // Fallback falls Datei leer
+    if (list.empty()) {
+        RadioStation fallback;
+        fallback.name = "Rock Antenne";
+        fallback.url = "https://stream.rockantenne.de/rockantenne/stream/mp3";
+        fallback.logo_path = DEFAULT_LOGO;
+        list.push_back(fallback);
+    }
+    return list;
+}
+
+bool store_stations(const std::vector<RadioStation>& stations, const std::string& path) {
+    std::string tmp = path + ".tmp";
+    std::ofstream file(tmp, std::ios::trunc);
+    if (!file.is_open()) return false;
+    for (const auto& s : stations) write_station_line(file, s);
+    file.close();
+    if (!file || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        LOG_ERROR("Seeding", "{} konnte nicht geschrieben werden", path);
+        return false;
+    }
+    return true;
+}
+
+std::set<std::string> load_removed_stations(const std::string& path) {
+    std::set<std::string> removed;
+    std::ifstream file(path);
+    std::string uuid;
+    while (std::getline(file, uuid)) if (!uuid.empty()) removed.insert(uuid);
+    return removed;
+}
+
+void save_station(const std::string& name, const std::string& url, const std::string& logo, const std::string& path) {
+    std::ofstream file(path, std::ios::app);
+    if (file.is_open()) { 
+        file << name << ";" << url << ";" << logo << "\n"; 
+        file.close(); 
+    }
+}
+
+void delete_station(const std::string& name_to_delete, const std::string& path, const std::string& removed_path) {
+    auto stations = load_stations(path);
+    std::ofstream removed(removed_path, std::ios::app);
+    std::vector<RadioStation> rest;
+    for (auto& s : stations) {
+        if (s.name != name_to_delete) rest.push_back(std::move(s));
+        else if (!s.uuid.empty()) removed << s.uuid << "\n";
+    }
+    store_stations(rest, path);
+}
@@ -0,0 +1,30 @@
+#ifndef STATION_STORE_HPP
+#define STATION_STORE_HPP
+
+#include <string>
+#include <vector>
+#include <set>
+
+#include "station_catalog.hpp"
+
+// Lokale Senderliste auf der SD-Karte (Format siehe write_station_line).
+// Die Pfade sind nur für Tests und Benchmarks überschreibbar.
+constexpr const char *STATIONS_CSV = "assets/stations.csv";
+constexpr const char *REMOVED_STATIONS_CSV = "assets/stations_removed.csv";
+
+// Ohne lesbare Liste gibt es einen Default-Sender, damit die Oberfläche nie leer ist
+std::vector<RadioStation> load_stations(const std::string& path = STATIONS_CSV);
+
+// Schreibt die Liste über eine Temp-Datei, damit ein Abbruch keine halbe stations.csv hinterlässt
+bool store_stations(const std::vector<RadioStation>& stations, const std::string& path = STATIONS_CSV);
+
+// Vom Nutzer gelöschte Katalog-Sender (stationuuid je Zeile); der Abgleich holt sie nicht zurück
+std::set<std::string> load_removed_stations(const std::string& path = REMOVED_STATIONS_CSV);
+
+void save_station(const std::string& name, const std::string& url, const std::string& logo = DEFAULT_LOGO,
+                  const std::string& path = STATIONS_CSV);
+
+void delete_station(const std::string& name_to_delete, const std::string& path = STATIONS_CSV,
+                    const std::string& removed_path = REMOVED_STATIONS_CSV);
+
+#endif
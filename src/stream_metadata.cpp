@@ -0,0 +1,22 @@
+#include "stream_metadata.hpp"
+
+namespace {
+
+std::string trimmed(const char *text) {
+    if (!text) return "";
+    std::string s(text);
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+} // namespace
+
+std::string format_stream_title(const char *artist, const char *title) {
+    std::string a = trimmed(artist);
+    std::string t = trimmed(title);
+    std::string display = a.empty() ? "" : a + " - ";
+    display += t.empty() ? "Stream läuft..." : t;
+    return display;
+}
@@ -0,0 +1,10 @@
+#ifndef STREAM_METADATA_HPP
+#define STREAM_METADATA_HPP
+
+#include <string>
+
+// Anzeigetext aus den Stream-Tags: "Interpret - Titel", ohne Titel ein Platzhalter.
+// nullptr oder leere Tags gelten als nicht gesetzt, Leerraum am Rand wird entfernt.
+std::string format_stream_title(const char *artist, const char *title);
+
+#endif
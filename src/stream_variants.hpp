@@ -0,0 +1,131 @@
+#ifndef STREAM_VARIANTS_HPP
+#define STREAM_VARIANTS_HPP
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+// Ein Stream eines Senders in einer bestimmten Qualität (radio-browser listet viele Sender
+// mehrfach, z.B. "Deutschlandfunk | DLF | MP3 128k" und "... AAC 64k")
+struct StreamVariant {
+    std::string codec;     // wie von radio-browser geliefert, z.B. "MP3", "AAC+"
+    int bitrate_kbps = 0;  // 0 = unbekannt
+    std::string url;
+};
+
+// Wählt die Variante eines Senders nach gemessenem Durchsatz und Datensparlimit.
+// Reine Logik ohne GLib (Zeiten in µs von außen), bedient aus dem RadioManager.
+//
+// Durchsatz: queue2 meldet beim Puffern die Eingangsrate. Solange der Puffer füllt, zeigt sie,
+// was die Verbindung schafft; im laufenden Betrieb liefert der Server nur in Echtzeit, der Wert
+// ist dann nur eine Untergrenze. Ein Aussetzer (Puffer leer nach vollem Puffer) zeigt, dass die
+// aktuelle Bitrate zu hoch ist.
+//
+// Umschalten kostet eine kurze Lücke, deshalb nur an sauberen Stellen: beim Titelwechsel,
+// beim Herunterschalten auch sofort nach einem Aussetzer (die Wiedergabe steht dann ohnehin).
+class VariantSelector {
+public:
+    static constexpr size_t NONE = static_cast<size_t>(-1);
+    static constexpr double HEADROOM = 1.5;            // Verbindung soll das 1,5-fache der Bitrate schaffen
+    static constexpr int DEFAULT_KBPS = 128;           // Startwahl ohne Messung
+    static constexpr int64_t MIN_HOLD_US = 30000000;   // frühestens 30 s nach dem letzten Wechsel
+    static constexpr int64_t STABLE_US = 60000000;     // hochschalten erst nach 60 s ohne Aussetzer
+    static constexpr int64_t FALLBACK_US = 300000000;  // Sender ohne Titel-Metadaten: nach 5 min auch ohne Titelwechsel
+
+    // Datensparmodus: höchstens diese Bitrate (0 = aus)
+    void set_cap_kbps(int kbps) { cap_kbps = kbps; }
+    int cap() const { return cap_kbps; }
+
+    // Neuer Sender: Varianten nach Bitrate sortieren und die Startvariante wählen.
+    // Die Schätzung des Durchsatzes bleibt über Senderwechsel erhalten.
+    size_t start(std::vector<StreamVariant> list, int64_t now_us) {
+        variants = std::move(list);
+        std::stable_sort(variants.begin(), variants.end(), [](const StreamVariant& a, const StreamVariant& b) {
+            return a.bitrate_kbps < b.bitrate_kbps;
+        });
+        current = variants.empty() ? NONE : best_for(capacity_kbps > 0 ? capacity_kbps : DEFAULT_KBPS * HEADROOM);
+        filled = false;
+        last_stall_us = 0;
+        stalls = 0;
+        switched_us = now_us;
+        return current;
+    }
+
+    const std::vector<StreamVariant>& list() const { return variants; }
+    size_t active() const { return current; }
+    double capacity() const { return capacity_kbps; }
+
+    // Puffer-Meldung: Füllstand und gemessene Eingangsrate (kbit/s, <= 0 = unbekannt)
+    void on_buffering(int percent, double in_kbps, int64_t now_us) {
+        if (current == NONE) return;
+        bool stall = filled && percent < 100;
+        if (percent >= 100) filled = true;
+        if (in_kbps > 0) {
+            // Beim Füllen ist die Rate aussagekräftig, sonst nur als Untergrenze
+            if (!filled || stall) capacity_kbps = capacity_kbps > 0 ? 0.7 * capacity_kbps + 0.3 * in_kbps : in_kbps;
+            else capacity_kbps = std::max(capacity_kbps, in_kbps);
+        }
+        if (stall) {
+            filled = false;
+            stalls++;
+            last_stall_us = now_us;
+            // Die aktuelle Bitrate war zu viel für die Verbindung
+            int kbps = variants[current].bitrate_kbps;
+            if (kbps > 0) capacity_kbps = std::min(capacity_kbps > 0 ? capacity_kbps : kbps * HEADROOM, kbps * 1.0);
+        }
+    }
+
+    // Variante, auf die jetzt umgeschaltet werden soll, sonst NONE.
+    // at_boundary: gerade hat ein neuer Titel begonnen
+    size_t poll(bool at_boundary, int64_t now_us) {
+        if (current == NONE || variants.size() < 2 || capacity_kbps <= 0) return NONE;
+        size_t target = best_for(capacity_kbps);
+        if (target == current) return NONE;
+
+        bool stalled_now = stalls > 0 && now_us - last_stall_us < MIN_HOLD_US;
+        bool held = now_us - switched_us >= MIN_HOLD_US;
+        if (target < current) {
+            // Nach einem Aussetzer sofort, sonst am nächsten Titelwechsel
+            if (!stalled_now && !(held && at_boundary) && !over_cap()) return NONE;
+        } else {
+            bool stable = last_stall_us == 0 || now_us - last_stall_us >= STABLE_US;
+            if (!held || !stable) return NONE;
+            if (!at_boundary && now_us - switched_us < FALLBACK_US) return NONE;
+        }
+        current = target;
+        switched_us = now_us;
+        filled = false;
+        stalls = 0;
+        return current;
+    }
+
+private:
+    std::vector<StreamVariant> variants;
+    size_t current = NONE;
+    double capacity_kbps = 0.0;
+    int cap_kbps = 0;
+    bool filled = false;
+    int stalls = 0;
+    int64_t last_stall_us = 0;
+    int64_t switched_us = 0;
+
+    bool over_cap() const {
+        return cap_kbps > 0 && variants[current].bitrate_kbps > cap_kbps;
+    }
+
+    // Höchste Variante, die Verbindung und Datensparlimit erlauben; sonst die kleinste.
+    // Unbekannte Bitraten (0) gelten als klein.
+    size_t best_for(double capacity) const {
+        size_t best = 0;
+        for (size_t i = 0; i < variants.size(); i++) {
+            int kbps = variants[i].bitrate_kbps;
+            if (cap_kbps > 0 && kbps > cap_kbps) break;
+            if (kbps * HEADROOM <= capacity) best = i;
+        }
+        return best;
+    }
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef TEXT_FOLD_HPP
+#define TEXT_FOLD_HPP
+
+#include <string>
+#include <cstdint>
+
+// Normalisiert Text für Suche und Vervollständigung:
+// Kleinbuchstaben, Umlaute/Akzente auf den Grundbuchstaben (ä -> a, ß -> ss),
+// alles außer Buchstaben und Ziffern wird zu einem einzelnen Leerzeichen.
+// "Bayern 3", "BAYERN-3" und "bayern  3" ergeben damit alle "bayern 3".
+
+namespace textfold {
+
+// Grundbuchstaben für U+00C0 .. U+017F (Latin-1 Supplement und Latin Extended-A).
+// 0 = kein Buchstabe (wird zum Trenner), '2' = Sonderfall mit zwei Zeichen
+inline const char* latin_table() {
+    static const char table[] =
+        // U+00C0 .. U+00FF
+        "aaaaaaaceeeeiiii" "dnooooo\0ouuuuyts"
+        "aaaaaaaceeeeiiii" "dnooooo\0ouuuuyty"
+        // U+0100 .. U+017F
+        "aaaaaaccccccccdd" "ddeeeeeeeeeegggg"
+        "gggghhhhiiiiiiii" "iijjjjkkklllllll"
+        "lllnnnnnnnnnoooo" "oooorrrrrrssssss"
+        "ssttttttuuuuuuuu" "uuuuwwyyyzzzzzzs";
+    return table;
+}
+
+inline void append_folded(std::string& out, char c, bool& pending_space) {
+    if (pending_space && !out.empty()) out += ' ';
+    pending_space = false;
+    out += c;
+}
+
+inline std::string fold(const std::string& in) {
+    std::string out;
+    out.reserve(in.size());
+    bool pending_space = false;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(in.data());
+    const unsigned char* end = p + in.size();
+
+    while (p < end) {
+        unsigned char c = *p;
+        if (c < 0x80) {
+            if (c >= 'A' && c <= 'Z') append_folded(out, static_cast<char>(c + 32), pending_space);
+            else if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) append_folded(out, static_cast<char>(c), pending_space);
+            else pending_space = true;
+            p++;
+            continue;
+        }
+
+        // Zwei-Byte-Sequenz im Bereich U+0080 .. U+07FF
+        if ((c & 0xE0) == 0xC0 && p + 1 < end) {
+            uint32_t cp = ((c & 0x1F) << 6) | (p[1] & 0x3F);
+            p += 2;
+            if (cp == 0xDF) { // ß
+                append_folded(out, 's', pending_space);
+                out += 's';
+            } else if (cp >= 0xC0 && cp <= 0x17F && latin_table()[cp - 0xC0] != '\0') {
+                append_folded(out, latin_table()[cp - 0xC0], pending_space);
+            } else {
+                pending_space = true;
+            }
+            continue;
+        }
+
+        // Alles andere (längere Sequenzen, kaputtes UTF-8) trennt Wörter
+        p++;
+        while (p < end && (*p & 0xC0) == 0x80) p++;
+        pending_space = true;
+    }
+    return out;
+}
+
+} // namespace textfold
+
+#endif
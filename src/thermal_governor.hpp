@@ -0,0 +1,77 @@
+#ifndef THERMAL_GOVERNOR_HPP
+#define THERMAL_GOVERNOR_HPP
+
+#include <gtk/gtk.h>
+#include <functional>
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include "mainloop_watchdog.hpp"
+#include "named_source.hpp"
+#include "thermal_policy.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+
+// Thermischer Governor: wertet alle TICK_MS die SoC-Temperatur (/sys/class/thermal) und die
+// Frame-Zeiten aus und schaltet das Render-Profil; die Regeln stehen in ThermalPolicy.
+// Die Umsetzung (CSS, Animationen, Visualizer, Scans, Abgleich) hängt als Listener in main.cpp.
+//
+// Zum Testen:
+//   CAROS_SYSFS_ROOT=<ordner> statt /sys, darin class/thermal/thermal_zone*/temp (Milligrad)
+class ThermalGovernor {
+public:
+    static constexpr guint TICK_MS = 2000;
+    static constexpr uint64_t MIN_FRAMES = 20;    // kleinere Fenster sagen nichts über die Last
+
+    explicit ThermalGovernor(FrameTimeMonitor *frames) : frames(frames) {}
+
+    void add_listener(std::function<void(RenderProfile)> cb) { listeners.push_back(std::move(cb)); }
+
+    void start() {
+        const char *root = g_getenv("CAROS_SYSFS_ROOT");
+        sysfs_root = root ? root : "/sys";
+        temp_metric = &MetricsRegistry::instance().gauge("caros_thermal_temp_celsius", "Höchste Temperatur aller Thermal-Zonen");
+        profile_metric = &MetricsRegistry::instance().gauge("caros_render_profile", "0 = voll, 1 = reduziert, 2 = minimal");
+        if (std::isnan(ThermalPolicy::read_temperature(sysfs_root))) {
+            LOG_WARN("Thermal", "Keine Thermal-Zonen unter {}, nur Frame-Zeiten", sysfs_root);
+        }
+        NamedSource::timeout("thermal-tick", TICK_MS, [](gpointer data) -> gboolean {
+            static_cast<ThermalGovernor*>(data)->evaluate();
+            return G_SOURCE_CONTINUE;
+        }, this);
+    }
+
+    RenderProfile profile() const { return policy.profile(); }
+
+private:
+    FrameTimeMonitor *frames;
+    std::vector<std::function<void(RenderProfile)>> listeners;
+    std::string sysfs_root;
+    ThermalPolicy policy;
+    Gauge *temp_metric = nullptr;
+    Gauge *profile_metric = nullptr;
+
+    void evaluate() {
+        double temp = ThermalPolicy::read_temperature(sysfs_root);
+        if (!std::isnan(temp)) temp_metric->set(temp);
+
+        FrameTimeMonitor::Window w = frames ? frames->take_window() : FrameTimeMonitor::Window{0, 0};
+        double slow_ratio = w.frames >= MIN_FRAMES ? static_cast<double>(w.slow) / w.frames : 0.0;
+
+        RenderProfile before = policy.profile();
+        if (policy.evaluate(temp, slow_ratio, g_get_monotonic_time())) switch_to(before, temp, slow_ratio);
+    }
+
+    void switch_to(RenderProfile before, double temp, double slow_ratio) {
+        static Counter& changes = MetricsRegistry::instance().counter("caros_render_profile_changes_total", "Wechsel des Render-Profils");
+        RenderProfile p = policy.profile();
+        LOG_INFO("Thermal", "Profil {} -> {} ({} °C, {}% langsame Frames)",
+                 render_profile_name(before), render_profile_name(p), temp, static_cast<int>(slow_ratio * 100.0));
+        changes.inc();
+        profile_metric->set(static_cast<int>(p));
+        for (auto& cb : listeners) cb(p);
+    }
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef THERMAL_POLICY_HPP
+#define THERMAL_POLICY_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <dirent.h>
+
+// Stufen, in denen die Oberfläche rendert und rechnet
+enum class RenderProfile {
+    Full,     // Glas-Optik, Animationen, Visualizer mit voller Rate
+    Reduced,  // flaches CSS, keine Animationen, Visualizer langsamer, Hintergrundjobs pausiert
+    Minimal,  // wie Reduced, Visualizer nur noch wenige Male pro Sekunde
+};
+
+inline const char* render_profile_name(RenderProfile p) {
+    switch (p) {
+        case RenderProfile::Full: return "voll";
+        case RenderProfile::Reduced: return "reduziert";
+        case RenderProfile::Minimal: return "minimal";
+    }
+    return "?";
+}
+
+// Entscheidung des ThermalGovernor ohne GTK: aus Temperatur und Anteil langsamer Frames die
+// Stufe. Hochschalten sofort, Zurückschalten erst nach RELAX_AFTER_S ohne Anlass und jeweils
+// nur eine Stufe, damit es nicht hin- und herpendelt. Zeiten in µs von außen.
+class ThermalPolicy {
+public:
+    static constexpr double REDUCED_C = 70.0;
+    static constexpr double MINIMAL_C = 78.0;     // der Pi 3B drosselt ab 80 °C
+    static constexpr double HYSTERESIS_C = 5.0;
+    static constexpr double SLOW_REDUCED = 0.10;  // Anteil zu langsamer Frames
+    static constexpr double SLOW_MINIMAL = 0.25;
+    static constexpr int64_t RELAX_AFTER_S = 30;
+
+    // Höchste Temperatur in °C über alle Zonen unter root (/sys oder CAROS_SYSFS_ROOT),
+    // NAN ohne lesbare Zone
+    static double read_temperature(const std::string& root) {
+        std::string dir = root + "/class/thermal";
+        DIR *d = opendir(dir.c_str());
+        if (!d) return NAN;
+        double hottest = NAN;
+        while (dirent *e = readdir(d)) {
+            if (std::strncmp(e->d_name, "thermal_zone", 12) != 0) continue;
+            std::ifstream f(dir + "/" + e->d_name + "/temp");
+            long millis;
+            if (f >> millis) hottest = std::isnan(hottest) ? millis / 1000.0 : std::max(hottest, millis / 1000.0);
+        }
+        closedir(d);
+        return hottest;
+    }
+
+    // Stufe, die Temperatur und Frame-Zeiten verlangen. holding: Schwellen zum Halten einer
+    // Stufe (Hysterese), u.a. weil die Frames im reduzierten Profil ja schneller werden
+    static int wanted_level(double temp, double slow_ratio, bool holding) {
+        double margin = holding ? HYSTERESIS_C : 0.0;
+        double scale = holding ? 0.5 : 1.0;
+        int level = 0;
+        if (!std::isnan(temp)) {
+            if (temp >= MINIMAL_C - margin) level = 2;
+            else if (temp >= REDUCED_C - margin) level = 1;
+        }
+        if (slow_ratio >= SLOW_MINIMAL * scale) level = std::max(level, 2);
+        else if (slow_ratio >= SLOW_REDUCED * scale) level = std::max(level, 1);
+        return level;
+    }
+
+    RenderProfile profile() const { return current; }
+
+    // Ein Messpunkt; true, wenn sich das Profil geändert hat
+    bool evaluate(double temp, double slow_ratio, int64_t now_us) {
+        int level = static_cast<int>(current);
+        int up = wanted_level(temp, slow_ratio, false);
+        if (up > level) {
+            current = static_cast<RenderProfile>(up);
+            last_pressure_us = now_us;
+            return true;
+        }
+        // Solange die Werte innerhalb der Hysterese bleiben, gilt die Stufe als noch nötig
+        if (wanted_level(temp, slow_ratio, true) >= level) {
+            last_pressure_us = now_us;
+            return false;
+        }
+        if (level > 0 && now_us - last_pressure_us > RELAX_AFTER_S * 1000000) {
+            current = static_cast<RenderProfile>(level - 1);
+            last_pressure_us = now_us;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    RenderProfile current = RenderProfile::Full;
+    int64_t last_pressure_us = 0;
+};
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef THREAD_REGISTRY_HPP
+#define THREAD_REGISTRY_HPP
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Scheduling-Vorgaben für eine Thread-Rolle (eine Zeile in assets/thread_policy.csv)
+struct ThreadPolicy {
+    cpu_set_t cpus;
+    bool pin = false;       // false: alle CPUs
+    int scheduler = SCHED_OTHER;
+    int priority = 0;       // SCHED_FIFO: 1..99, SCHED_OTHER: nice-Wert
+};
+
+struct ThreadInfo {
+    pid_t tid;
+    std::string name;
+    std::string role;
+    bool applied;           // Vorgaben der Rolle vollständig übernommen
+};
+
+// Alle Threads der App melden sich hier mit Namen und Rolle an; die Rolle bestimmt
+// CPU-Kerne, Scheduler und Priorität. Vorgaben kommen aus CAROS_THREAD_POLICY
+// (Default assets/thread_policy.csv), CAROS_THREAD_POLICY=0 benennt nur.
+// Liegt unter Logger und Metriken, meldet Probleme deshalb direkt auf stderr.
+class ThreadRegistry {
+public:
+    static ThreadRegistry& instance() {
+        static ThreadRegistry registry;
+        return registry;
+    }
+
+    static pid_t current_tid() { return static_cast<pid_t>(syscall(SYS_gettid)); }
+
+    // Startet einen Thread, der sich vor f() selbst anmeldet und danach wieder abmeldet
+    template<typename F>
+    static std::thread spawn(std::string name, std::string role, F&& f) {
+        return std::thread([name = std::move(name), role = std::move(role), f = std::forward<F>(f)]() mutable {
+            instance().register_current(name, role);
+            f();
+            instance().unregister_current();
+        });
+    }
+
+    // Aus dem Thread selbst. Leerer Name behält den bisherigen (z.B. Prozessname oder
+    // der Name, den GStreamer seinen Task-Threads gibt).
+    void register_current(const std::string& name, const std::string& role) {
+        if (!name.empty()) pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+        char actual[16] = {};
+        pthread_getname_np(pthread_self(), actual, sizeof(actual));
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ThreadInfo info{current_tid(), actual, role, true};
+        auto it = policies.find(role);
+        if (it != policies.end()) info.applied = apply(info, it->second);
+        threads_by_tid[info.tid] = info;
+    }
+
+    void unregister_current() {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads_by_tid.erase(current_tid());
+    }
+
+    // Neue Vorgaben laden und auf alle angemeldeten Threads anwenden; leerer Pfad = keine Vorgaben
+    bool load_policy(const std::string& path) {
+        std::unordered_map<std::string, ThreadPolicy> loaded;
+        bool ok = path.empty() || parse(path, loaded);
+        if (!ok) return false;
+
+        // Rollen, die ihre Vorgaben verloren haben, zurück auf die Standardwerte
+        static const ThreadPolicy defaults{};
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& entry : threads_by_tid) {
+            ThreadInfo& info = entry.second;
+            auto now = loaded.find(info.role);
+            if (now != loaded.end()) info.applied = apply(info, now->second);
+            else if (policies.count(info.role)) info.applied = apply(info, defaults);
+        }
+        policies = std::move(loaded);
+        return true;
+    }
+
+    std::vector<ThreadInfo> threads() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<ThreadInfo> out;
+        for (const auto& entry : threads_by_tid) out.push_back(entry.second);
+        return out;
+    }
+
+    // Zeile im Format der Policy-Datei, z.B. "2-3" für cpus
+    static bool parse_cpus(const std::string& text, cpu_set_t& set) {
+        CPU_ZERO(&set);
+        std::stringstream ss(text);
+        std::string part;
+        bool any = false;
+        while (std::getline(ss, part, ',')) {
+            char *end = nullptr;
+            long first = std::strtol(part.c_str(), &end, 10);
+            long last = first;
+            if (end == part.c_str()) return false;
+            if (*end == '-') last = std::strtol(end + 1, &end, 10);
+            if (*end != '\0' || first < 0 || last < first || last >= CPU_SETSIZE) return false;
+            for (long c = first; c <= last; c++) CPU_SET(c, &set);
+            any = true;
+        }
+        return any;
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<pid_t, ThreadInfo> threads_by_tid;
+    std::unordered_map<std::string, ThreadPolicy> policies;
+    bool warned_permissions = false;
+
+    ThreadRegistry() {
+        const char *env = getenv("CAROS_THREAD_POLICY");
+        std::string path = env ? env : "assets/thread_policy.csv";
+        if (path == "0") return;
+        parse(path, policies);
+    }
+
+    // Format: Rolle;CPUs;Scheduler;Priorität   (# = Kommentar, CPUs "-" = alle)
+    static bool parse(const std::string& path, std::unordered_map<std::string, ThreadPolicy>& out) {
+        std::ifstream file(path);
+        if (!file) return false;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::stringstream ss(line);
+            std::string role, cpus, scheduler, priority;
+            if (!std::getline(ss, role, ';') || !std::getline(ss, cpus, ';') ||
+                !std::getline(ss, scheduler, ';') || !std::getline(ss, priority)) {
+                fprintf(stderr, "[Threads] Ungültige Zeile in %s: %s\n", path.c_str(), line.c_str());
+                continue;
+            }
+            ThreadPolicy p;
+            p.pin = cpus != "-" && parse_cpus(cpus, p.cpus);
+            p.scheduler = scheduler == "fifo" ? SCHED_FIFO : SCHED_OTHER;
+            p.priority = std::atoi(priority.c_str());
+            out[role] = p;
+        }
+        return true;
+    }
+
+    // Mutex gehalten; false, wenn etwas (meist mangels Rechten) nicht übernommen wurde
+    bool apply(const ThreadInfo& info, const ThreadPolicy& p) {
+        bool ok = true;
+        int error = 0;
+
+        // Nur Kerne, die es auf diesem Gerät gibt (die Policy ist für den Pi 3B geschrieben)
+        cpu_set_t wanted;
+        CPU_ZERO(&wanted);
+        for (long c = 0, n = sysconf(_SC_NPROCESSORS_ONLN); c < n && c < CPU_SETSIZE; c++) {
+            if (!p.pin || CPU_ISSET(c, &p.cpus)) CPU_SET(c, &wanted);
+        }
+        if (CPU_COUNT(&wanted) > 0 && sched_setaffinity(info.tid, sizeof(wanted), &wanted) != 0) {
+            ok = false;
+            error = errno;
+        }
+
+        sched_param param{};
+        if (p.scheduler == SCHED_FIFO) {
+            param.sched_priority = p.priority;
+            if (sched_setscheduler(info.tid, SCHED_FIFO, &param) != 0) {
+                ok = false;
+                error = errno;
+            }
+        } else {
+            sched_setscheduler(info.tid, SCHED_OTHER, &param);
+            if (setpriority(PRIO_PROCESS, static_cast<id_t>(info.tid), p.priority) != 0) {
+                ok = false;
+                error = errno;
+            }
+        }
+
+        if (!ok && !warned_permissions) {
+            warned_permissions = true;
+            fprintf(stderr, "[Threads] Vorgaben für %s (%s) nicht vollständig übernommen: %s "
+                            "(SCHED_FIFO braucht CAP_SYS_NICE oder LimitRTPRIO)\n",
+                    info.name.c_str(), info.role.c_str(), strerror(error));
+        }
+        return ok;
+    }
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef UI_ASSETS_HPP
+#define UI_ASSETS_HPP
+
+#include <gtk/gtk.h>
+#include <string>
+#include <unordered_map>
+
+#include "logger.hpp"
+
+// Statische UI-Dateien (CSS, Nav-Icons, Hintergrund) kommen aus dem einkompilierten
+// GResource-Bundle (assets/caros.gresource.xml), unabhängig vom Arbeitsverzeichnis und ohne
+// Zugriffe auf die SD-Karte beim Start. Das CSS löst url('background.png') relativ zu sich
+// selbst auf, also ebenfalls im Bundle.
+//
+// Zum Entwickeln: CAROS_ASSETS_DIR=assets lädt alles stattdessen von der Platte,
+// Änderungen am CSS brauchen dann keinen Rebuild.
+namespace ui_assets {
+
+constexpr const char *RESOURCE_PREFIX = "/com/car/os/";
+
+inline const char* disk_dir() {
+    const char *dir = g_getenv("CAROS_ASSETS_DIR");
+    return (dir && *dir) ? dir : nullptr;
+}
+
+inline void load_css(GtkCssProvider *provider, const char *name) {
+    if (const char *dir = disk_dir()) {
+        std::string path = std::string(dir) + "/" + name;
+        gtk_css_provider_load_from_path(provider, path.c_str());
+    } else {
+        gtk_css_provider_load_from_resource(provider, (std::string(RESOURCE_PREFIX) + name).c_str());
+    }
+}
+
+// Icon als Textur in Anzeigegröße (die PNGs haben 320px, angezeigt werden 32/80px).
+// Jede Kombination aus Datei und Größe wird nur einmal dekodiert und von allen Widgets geteilt.
+inline GdkTexture* texture(const char *name, int size) {
+    static std::unordered_map<std::string, GdkTexture*> cache;
+    std::string key = std::string(name) + "@" + std::to_string(size);
+    auto it = cache.find(key);
+    if (it != cache.end()) return it->second;
+
+    GError *error = nullptr;
+    GdkPixbuf *pixbuf = nullptr;
+    if (const char *dir = disk_dir()) {
+        std::string path = std::string(dir) + "/" + name;
+        pixbuf = gdk_pixbuf_new_from_file_at_scale(path.c_str(), size, size, TRUE, &error);
+    } else {
+        std::string path = std::string(RESOURCE_PREFIX) + name;
+        pixbuf = gdk_pixbuf_new_from_resource_at_scale(path.c_str(), size, size, TRUE, &error);
+    }
+    GdkTexture *texture = nullptr;
+    if (pixbuf) {
+        texture = gdk_texture_new_for_pixbuf(pixbuf);
+        g_object_unref(pixbuf);
+    } else {
+        LOG_WARN("Assets", "{} nicht ladbar: {}", name, error ? error->message : "?");
+        g_clear_error(&error);
+    }
+    cache.emplace(key, texture);
+    return texture;
+}
+
+inline GtkWidget* image_new(const char *name, int size) {
+    GdkTexture *t = texture(name, size);
+    GtkWidget *image = t ? gtk_image_new_from_paintable(GDK_PAINTABLE(t)) : gtk_image_new_from_icon_name("image-missing");
+    gtk_image_set_pixel_size(GTK_IMAGE(image), size);
+    return image;
+}
+
+} // namespace ui_assets
+
+#endif
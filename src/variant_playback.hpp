@@ -0,0 +1,88 @@
+#ifndef VARIANT_PLAYBACK_HPP
+#define VARIANT_PLAYBACK_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "stream_variants.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+
+// Umschaltpfad zwischen den Varianten eines Senders: nimmt die Meldungen der Wiedergabe
+// (Titel, Puffer mit queue2-Eingangsrate) entgegen, fragt den VariantSelector und lädt die
+// gewählte Variante über load. Ohne GTK, damit der RadioManager ihn bedient und test/gst ihn
+// direkt an eine AudioEngine hängen kann. Zeiten in µs von außen (g_get_monotonic_time).
+class VariantPlayback {
+public:
+    // Stream-URL der Variante, Haupt-URL des Senders (Schlüssel der Lautheit)
+    std::function<void(const std::string&, const std::string&)> load;
+
+    void set_cap_kbps(int kbps) { selector.set_cap_kbps(kbps); }
+    const VariantSelector& variants() const { return selector; }
+    const std::string& station() const { return station_url; }
+
+    // Sender abspielen; bei mehreren Varianten startet die, die zur Verbindung passt
+    void play(const std::string& url, const std::vector<StreamVariant>& list, int64_t now_us) {
+        last_title.clear();
+        station_url = url;
+        size_t i = selector.start(list.size() > 1 ? list : std::vector<StreamVariant>{}, now_us);
+        if (i == VariantSelector::NONE) {
+            kbps_metric().set(0);
+            if (load) load(url, station_url);
+            return;
+        }
+        const StreamVariant& v = selector.list()[i];
+        LOG_INFO("VariantPlayback", "Variante {} {} kbit/s von {} (Durchsatz {} kbit/s, Limit {})",
+                 v.codec, v.bitrate_kbps, selector.list().size(), static_cast<int>(selector.capacity()), selector.cap());
+        kbps_metric().set(v.bitrate_kbps);
+        if (load) load(v.url, station_url);
+    }
+
+    // Anderes als ein Sender läuft (lokale Warteschlange): keine Umschaltung
+    void stop(int64_t now_us) {
+        selector.start({}, now_us);
+        station_url.clear();
+        last_title.clear();
+    }
+
+    // Neuer Titel = saubere Stelle für einen Wechsel der Variante
+    void on_title(const std::string& text, int64_t now_us) {
+        bool boundary = !last_title.empty() && text != last_title;
+        last_title = text;
+        poll(boundary, now_us);
+    }
+
+    void on_buffering(int percent, double in_kbps, int64_t now_us) {
+        static Gauge& throughput = MetricsRegistry::instance().gauge("caros_radio_throughput_kbps", "Geschätzter Durchsatz der Stream-Verbindung (kbit/s)");
+        selector.on_buffering(percent, in_kbps, now_us);
+        if (selector.capacity() > 0) throughput.set(selector.capacity());
+        poll(false, now_us);
+    }
+
+    // Auch ohne Anlass regelmäßig aufrufen (Sender ohne Titel-Metadaten)
+    void poll(bool at_boundary, int64_t now_us) {
+        static Counter& switches = MetricsRegistry::instance().counter("caros_radio_variant_switches_total", "Automatische Wechsel der Sender-Variante");
+        size_t i = selector.poll(at_boundary, now_us);
+        if (i == VariantSelector::NONE) return;
+        const StreamVariant& v = selector.list()[i];
+        LOG_INFO("VariantPlayback", "Wechsel auf {} {} kbit/s (Durchsatz {} kbit/s, {})", v.codec, v.bitrate_kbps,
+                 static_cast<int>(selector.capacity()), at_boundary ? "Titelwechsel" : "sofort");
+        switches.inc();
+        kbps_metric().set(v.bitrate_kbps);
+        if (load) load(v.url, station_url);
+    }
+
+private:
+    VariantSelector selector;
+    std::string station_url;
+    std::string last_title;
+
+    static Gauge& kbps_metric() {
+        static Gauge& kbps = MetricsRegistry::instance().gauge("caros_radio_variant_kbps", "Bitrate der laufenden Sender-Variante (0 = unbekannt/keine Auswahl)");
+        return kbps;
+    }
+};
+
+#endif
@@ -5,114 +5,430 @@
 #include <vector>
 #include <string>
 #include <functional>
+#include <algorithm>
+
+#include "station_completion.hpp"
+
+class VirtualKeyboard;
+
+// Eigenes Widget für die Tastatur: alle Tasten werden per GtkSnapshot gezeichnet
+// und selbst getroffen, statt 44 einzelne GtkButtons mit CSS und Layout zu pflegen.
+#define CAR_TYPE_KEYBOARD (car_keyboard_get_type())
+G_DECLARE_FINAL_TYPE(CarKeyboard, car_keyboard, CAR, KEYBOARD, GtkWidget)
+
+struct _CarKeyboard {
+    GtkWidget parent_instance;
+    VirtualKeyboard *owner;
+};
+
+G_DEFINE_TYPE(CarKeyboard, car_keyboard, GTK_TYPE_WIDGET)
 
 class VirtualKeyboard {
 private:
+    enum class KeyKind { Char, Space, Backspace, Hide, Suggestion };
+
+    struct Key {
+        std::string label;
+        KeyKind kind;
+        graphene_rect_t rect;
+    };
+
+    static constexpr int KEY_H = 48;
+    static constexpr int SUGGESTION_H = 40;
+    static constexpr int GAP = 4;
+    static constexpr int MAX_KEYS_PER_ROW = 11;
+    static constexpr size_t MAX_SUGGESTIONS = 3;
+
     GtkWidget *container;
     GtkEditable *target_entry;
+    bool target_completion = false;
     std::function<void()> hide_callback;
 
+    // rows[0] = Vorschlagsleiste, danach die Tastenreihen
+    std::vector<std::vector<Key>> rows;
+    int layout_width = 0;
+    int pressed_row = -1;
+    int pressed_col = -1;
+
+    // Gerenderte Tasten werden gecacht und nur bei Größen- bzw. Vorschlagsänderung neu erzeugt
+    GskRenderNode *keys_node = nullptr;
+    GskRenderNode *suggestion_node = nullptr;
+
+    // Eingaben eines Frames werden gesammelt und mit einem einzigen Editable-Aufruf übernommen
+    std::string pending_text;
+    int pending_backspace = 0;
+    guint flush_tick = 0;
+
+    // Latenz vom Tastendruck bis zum gezeichneten Frame mit dem neuen Zeichen
+    int64_t press_time_us = 0;
+    int64_t last_latency_us = -1;
+    gulong after_paint_handler = 0;
+
+    StationCompletionIndex completion;
+    std::vector<std::string> suggestions;
+
 public:
     VirtualKeyboard() {
-        container = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+        container = GTK_WIDGET(g_object_new(CAR_TYPE_KEYBOARD, nullptr));
+        CAR_KEYBOARD(container)->owner = this;
         gtk_widget_add_css_class(container, "virtual-keyboard");
         target_entry = nullptr;
         build_layout();
+
+        GtkGesture *click = gtk_gesture_click_new();
+        g_signal_connect(click, "pressed", G_CALLBACK(+[](GtkGestureClick*, int, double x, double y, gpointer d) {
+            static_cast<VirtualKeyboard*>(d)->on_press(x, y);
+        }), this);
+        g_signal_connect(click, "released", G_CALLBACK(+[](GtkGestureClick*, int, double, double, gpointer d) {
+            static_cast<VirtualKeyboard*>(d)->on_release();
+        }), this);
+        g_signal_connect(click, "stopped", G_CALLBACK(+[](GtkGestureClick*, gpointer d) {
+            static_cast<VirtualKeyboard*>(d)->on_release();
+        }), this);
+        gtk_widget_add_controller(container, GTK_EVENT_CONTROLLER(click));
     }
 
     GtkWidget* get_widget() { return container; }
 
-    void set_target(GtkEditable *entry) {
+    // with_completion: Sendernamen als Vorschläge anbieten (z.B. für Namens- und Suchfelder)
+    void set_target(GtkEditable *entry, bool with_completion = false) {
+        flush_pending();
         target_entry = entry;
+        target_completion = with_completion;
+        update_suggestions();
     }
 
     void set_hide_callback(std::function<void()> cb) {
         hide_callback = cb;
     }
 
+    void set_completions(const std::vector<std::string>& station_names) {
+        completion.build(station_names);
+        update_suggestions();
+    }
+
+    // Letzte gemessene Latenz Tastendruck -> Frame in µs (-1 = noch keine Messung)
+    int64_t get_last_latency_us() const { return last_latency_us; }
+
+    // --- Aufrufe aus dem Widget ---
+
+    void measure(GtkOrientation orientation, int *minimum, int *natural) {
+        if (orientation == GTK_ORIENTATION_HORIZONTAL) {
+            *minimum = MAX_KEYS_PER_ROW * 32 + (MAX_KEYS_PER_ROW - 1) * GAP;
+            *natural = MAX_KEYS_PER_ROW * 64 + (MAX_KEYS_PER_ROW - 1) * GAP;
+        } else {
+            int n_rows = static_cast<int>(rows.size()) - 1;
+            *minimum = *natural = SUGGESTION_H + GAP + n_rows * KEY_H + (n_rows - 1) * GAP;
+        }
+    }
+
+    void allocate(int width, int) {
+        if (width == layout_width) return;
+        layout_width = width;
+        layout_keys();
+        layout_suggestions();
+        invalidate(true);
+    }
+
+    void snapshot(GtkSnapshot *snapshot) {
+        if (!keys_node) keys_node = render_rows(1, rows.size());
+        if (!suggestion_node && !rows[0].empty()) suggestion_node = render_rows(0, 1);
+
+        if (suggestion_node) gtk_snapshot_append_node(snapshot, suggestion_node);
+        if (keys_node) gtk_snapshot_append_node(snapshot, keys_node);
+
+        // Nur die gedrückte Taste wird live gezeichnet
+        if (pressed_row >= 0) {
+            static const GdkRGBA pressed_bg = {0.0f, 0.83f, 1.0f, 1.0f};
+            static const GdkRGBA pressed_fg = {0.0f, 0.0f, 0.0f, 1.0f};
+            draw_key(snapshot, rows[pressed_row][pressed_col], pressed_bg, pressed_fg);
+        }
+    }
+
 private:
     void build_layout() {
         // Layout: QWERTZ (vereinfacht)
-        const std::vector<std::vector<std::string>> rows = {
+        const std::vector<std::vector<std::string>> char_rows = {
             {"1", "2", "3", "4", "5", "6", "7", "8", "9", "0", "ß"},
             {"Q", "W", "E", "R", "T", "Z", "U", "I", "O", "P", "Ü"},
             {"A", "S", "D", "F", "G", "H", "J", "K", "L", "Ö", "Ä"},
             {"Y", "X", "C", "V", "B", "N", "M", ".", "-", "_"}
         };
 
-        for (const auto& row_keys : rows) {
-            GtkWidget *row_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 4);
-            gtk_widget_set_halign(row_box, GTK_ALIGN_CENTER);
-            
-            for (const auto& key : row_keys) {
-                create_key(key, row_box);
+        rows.clear();
+        rows.emplace_back(); // Vorschläge
+        for (const auto& row_keys : char_rows) {
+            std::vector<Key> row;
+            for (const auto& key : row_keys) row.push_back({key, KeyKind::Char, {}});
+            rows.push_back(row);
+        }
+
+        // Sonderzeile: Space, Backspace & Verstecken
+        rows.push_back({
+            {"SPACE", KeyKind::Space, {}},
+            {"⌫", KeyKind::Backspace, {}},
+            {"Verstecken", KeyKind::Hide, {}}
+        });
+    }
+
+    // Breite einer Sondertaste in Tastenbreiten
+    static int key_units(KeyKind kind) {
+        switch (kind) {
+            case KeyKind::Space: return 5;
+            case KeyKind::Backspace: return 2;
+            case KeyKind::Hide: return 3;
+            default: return 1;
+        }
+    }
+
+    void layout_keys() {
+        float key_w = std::min(64.0f, (layout_width - (MAX_KEYS_PER_ROW - 1) * GAP) / float(MAX_KEYS_PER_ROW));
+        float y = SUGGESTION_H + GAP;
+
+        for (size_t r = 1; r < rows.size(); r++) {
+            float row_w = -GAP;
+            for (const auto& k : rows[r]) row_w += key_units(k.kind) * (key_w + GAP);
+
+            float x = (layout_width - row_w) / 2.0f;
+            for (auto& k : rows[r]) {
+                float w = key_units(k.kind) * (key_w + GAP) - GAP;
+                graphene_rect_init(&k.rect, x, y, w, KEY_H);
+                x += w + GAP;
             }
-            gtk_box_append(GTK_BOX(container), row_box);
+            y += KEY_H + GAP;
+        }
+    }
+
+    void layout_suggestions() {
+        rows[0].clear();
+        if (suggestions.empty()) return;
+
+        float w = (layout_width - (MAX_SUGGESTIONS - 1) * GAP) / float(MAX_SUGGESTIONS);
+        for (size_t i = 0; i < suggestions.size(); i++) {
+            Key k{suggestions[i], KeyKind::Suggestion, {}};
+            graphene_rect_init(&k.rect, i * (w + GAP), 0, w, SUGGESTION_H);
+            rows[0].push_back(k);
         }
+    }
+
+    void invalidate(bool keys) {
+        if (keys) g_clear_pointer(&keys_node, gsk_render_node_unref);
+        g_clear_pointer(&suggestion_node, gsk_render_node_unref);
+        gtk_widget_queue_draw(container);
+    }
+
+    GskRenderNode* render_rows(size_t first, size_t last) {
+        static const GdkRGBA key_bg = {1.0f, 1.0f, 1.0f, 0.1f};
+        static const GdkRGBA suggestion_bg = {0.0f, 0.83f, 1.0f, 0.15f};
+        static const GdkRGBA key_fg = {1.0f, 1.0f, 1.0f, 1.0f};
 
-        // Sonderzeile: Space & Backspace
-        GtkWidget *bottom_row = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 10);
-        gtk_widget_set_halign(bottom_row, GTK_ALIGN_CENTER);
-
-        GtkWidget *space = gtk_button_new_with_label("SPACE");
-        gtk_widget_set_size_request(space, 200, -1);
-        gtk_widget_set_focusable(space, FALSE);
-        g_signal_connect(space, "clicked", G_CALLBACK(+[](GtkWidget*, gpointer d) {
-            VirtualKeyboard* self = (VirtualKeyboard*)d;
-            if (self->target_entry) {
-                int pos = gtk_editable_get_position(self->target_entry);
-                gtk_editable_insert_text(self->target_entry, " ", 1, &pos);
-                gtk_editable_set_position(self->target_entry, pos);
+        GtkSnapshot *s = gtk_snapshot_new();
+        for (size_t r = first; r < last && r < rows.size(); r++) {
+            for (const auto& k : rows[r]) {
+                draw_key(s, k, k.kind == KeyKind::Suggestion ? suggestion_bg : key_bg, key_fg);
             }
-        }), this);
-        gtk_box_append(GTK_BOX(bottom_row), space);
-
-        GtkWidget *backspace = gtk_button_new_from_icon_name("edit-clear-symbolic");
-        gtk_widget_set_focusable(backspace, FALSE);
-        gtk_widget_add_css_class(backspace, "key-backspace");
-        g_signal_connect(backspace, "clicked", G_CALLBACK(+[](GtkWidget*, gpointer d) {
-            VirtualKeyboard* self = (VirtualKeyboard*)d;
-            if (self->target_entry) {
-                int pos = gtk_editable_get_position(self->target_entry);
-                if (pos > 0) {
-                    gtk_editable_delete_text(self->target_entry, pos - 1, pos);
+        }
+        return gtk_snapshot_free_to_node(s);
+    }
+
+    void draw_key(GtkSnapshot *s, const Key& k, const GdkRGBA& bg, const GdkRGBA& fg) {
+        GskRoundedRect outline;
+        gsk_rounded_rect_init_from_rect(&outline, &k.rect, 8.0f);
+        gtk_snapshot_push_rounded_clip(s, &outline);
+        gtk_snapshot_append_color(s, &bg, &k.rect);
+        gtk_snapshot_pop(s);
+
+        PangoLayout *layout = gtk_widget_create_pango_layout(container, k.label.c_str());
+        pango_layout_set_width(layout, static_cast<int>((k.rect.size.width - 8) * PANGO_SCALE));
+        pango_layout_set_ellipsize(layout, PANGO_ELLIPSIZE_END);
+        pango_layout_set_alignment(layout, PANGO_ALIGN_CENTER);
+
+        int text_w, text_h;
+        pango_layout_get_pixel_size(layout, &text_w, &text_h);
+        (void) text_w;
+
+        gtk_snapshot_save(s);
+        graphene_point_t origin = GRAPHENE_POINT_INIT(k.rect.origin.x + 4,
+                                                      k.rect.origin.y + (k.rect.size.height - text_h) / 2.0f);
+        gtk_snapshot_translate(s, &origin);
+        gtk_snapshot_append_layout(s, layout, &fg);
+        gtk_snapshot_restore(s);
+        g_object_unref(layout);
+    }
+
+    // --- Eingabe ---
+
+    bool hit_test(double x, double y, int *row, int *col) const {
+        graphene_point_t p = GRAPHENE_POINT_INIT(static_cast<float>(x), static_cast<float>(y));
+        for (size_t r = 0; r < rows.size(); r++) {
+            if (rows[r].empty()) continue;
+            const graphene_rect_t& first = rows[r][0].rect;
+            // Zeilen liegen übereinander -> erst die Zeile, dann die Taste suchen
+            if (y < first.origin.y || y > first.origin.y + first.size.height) continue;
+            for (size_t c = 0; c < rows[r].size(); c++) {
+                if (graphene_rect_contains_point(&rows[r][c].rect, &p)) {
+                    *row = static_cast<int>(r);
+                    *col = static_cast<int>(c);
+                    return true;
                 }
             }
+            return false;
+        }
+        return false;
+    }
+
+    void on_press(double x, double y) {
+        int row, col;
+        if (!hit_test(x, y, &row, &col)) return;
+
+        pressed_row = row;
+        pressed_col = col;
+        gtk_widget_queue_draw(container);
+
+        const Key& k = rows[row][col];
+        switch (k.kind) {
+            case KeyKind::Char:
+                queue_input(k.label);
+                break;
+            case KeyKind::Space:
+                queue_input(" ");
+                break;
+            case KeyKind::Backspace:
+                if (!pending_text.empty()) {
+                    // Letztes (UTF-8) Zeichen der noch nicht übernommenen Eingabe entfernen
+                    const char *end = pending_text.c_str() + pending_text.size();
+                    pending_text.resize(g_utf8_find_prev_char(pending_text.c_str(), end) - pending_text.c_str());
+                } else {
+                    pending_backspace++;
+                }
+                queue_input("");
+                break;
+            case KeyKind::Hide:
+                pressed_row = -1;
+                if (hide_callback) hide_callback();
+                break;
+            case KeyKind::Suggestion:
+                apply_suggestion(k.label);
+                break;
+        }
+    }
+
+    void on_release() {
+        if (pressed_row < 0) return;
+        pressed_row = -1;
+        pressed_col = -1;
+        gtk_widget_queue_draw(container);
+    }
+
+    void queue_input(const std::string& text) {
+        pending_text += text;
+        if (press_time_us == 0) press_time_us = g_get_monotonic_time();
+        if (flush_tick) return;
+
+        flush_tick = gtk_widget_add_tick_callback(container, [](GtkWidget*, GdkFrameClock*, gpointer d) -> gboolean {
+            VirtualKeyboard *self = static_cast<VirtualKeyboard*>(d);
+            self->flush_tick = 0;
+            self->flush_pending();
+            return G_SOURCE_REMOVE;
+        }, this, nullptr);
+    }
+
+    void flush_pending() {
+        if (flush_tick) {
+            gtk_widget_remove_tick_callback(container, flush_tick);
+            flush_tick = 0;
+        }
+        if (!target_entry || (pending_text.empty() && pending_backspace == 0)) {
+            pending_text.clear();
+            pending_backspace = 0;
+            return;
+        }
+
+        int pos = gtk_editable_get_position(target_entry);
+        if (pending_backspace > 0 && pos > 0) {
+            int from = std::max(0, pos - pending_backspace);
+            gtk_editable_delete_text(target_entry, from, pos);
+            pos = from;
+        }
+        if (!pending_text.empty()) {
+            gtk_editable_insert_text(target_entry, pending_text.c_str(), -1, &pos);
+            gtk_editable_set_position(target_entry, pos);
+        }
+        pending_text.clear();
+        pending_backspace = 0;
+
+        update_suggestions();
+        track_latency();
+    }
+
+    // Misst bis zum Ende des Frames, in dem die neue Eingabe gezeichnet wird
+    void track_latency() {
+        GdkFrameClock *clock = gtk_widget_get_frame_clock(container);
+        if (!clock || after_paint_handler) return;
+
+        after_paint_handler = g_signal_connect(clock, "after-paint", G_CALLBACK(+[](GdkFrameClock *c, gpointer d) {
+            VirtualKeyboard *self = static_cast<VirtualKeyboard*>(d);
+            self->last_latency_us = g_get_monotonic_time() - self->press_time_us;
+            self->press_time_us = 0;
+            g_signal_handler_disconnect(c, self->after_paint_handler);
+            self->after_paint_handler = 0;
+            g_debug("Tastatur: Eingabe-Latenz %lld µs", (long long)self->last_latency_us);
         }), this);
-        gtk_box_append(GTK_BOX(bottom_row), backspace);
-
-        // "Verstecken" Button
-        GtkWidget *hide_btn = gtk_button_new_with_label("Verstecken");
-        gtk_widget_set_focusable(hide_btn, FALSE);
-        g_signal_connect(hide_btn, "clicked", G_CALLBACK(+[](GtkWidget*, gpointer d) {
-            VirtualKeyboard* self = (VirtualKeyboard*)d;
-            if (self->hide_callback) {
-                self->hide_callback();
-            }
-        }), this);
-        gtk_box_append(GTK_BOX(bottom_row), hide_btn);
-
-        gtk_box_append(GTK_BOX(container), bottom_row);
-    }
-
-    void create_key(const std::string& label, GtkWidget* parent) {
-        GtkWidget *btn = gtk_button_new_with_label(label.c_str());
-        gtk_widget_set_focusable(btn, FALSE); // WICHTIG: Fokus bleibt im Entry
-        gtk_widget_add_css_class(btn, "keyboard-key");
-        
-        // Label kopieren für Callback
-        g_object_set_data_full(G_OBJECT(btn), "key_val", g_strdup(label.c_str()), g_free);
-        g_signal_connect(btn, "clicked", G_CALLBACK(+[](GtkWidget* w, gpointer d) {
-            VirtualKeyboard* self = (VirtualKeyboard*)d;
-            const char* val = (const char*)g_object_get_data(G_OBJECT(w), "key_val");
-            if (self->target_entry && val) {
-                int pos = gtk_editable_get_position(self->target_entry);
-                gtk_editable_insert_text(self->target_entry, val, -1, &pos);
-                gtk_editable_set_position(self->target_entry, pos);
-            }
-        }), this);
-        gtk_box_append(GTK_BOX(parent), btn);
+    }
+
+    void apply_suggestion(const std::string& name) {
+        pending_text.clear();
+        pending_backspace = 0;
+        if (target_entry) {
+            gtk_editable_set_text(target_entry, name.c_str());
+            gtk_editable_set_position(target_entry, -1);
+        }
+        suggestions.clear();
+        layout_suggestions();
+        pressed_row = -1;
+        invalidate(false);
+    }
+
+    void update_suggestions() {
+        std::vector<std::string> fresh;
+        if (target_entry && target_completion && completion.size() > 0) {
+            fresh = completion.complete(gtk_editable_get_text(target_entry), MAX_SUGGESTIONS);
+        }
+        if (fresh == suggestions) return;
+
+        suggestions = std::move(fresh);
+        layout_suggestions();
+        invalidate(false);
     }
 };
 
-#endif
\ No newline at end of file
+// --- GObject-Anbindung ---
+
+static void car_keyboard_measure(GtkWidget *widget, GtkOrientation orientation, int,
+                                 int *minimum, int *natural, int *minimum_baseline, int *natural_baseline) {
+    CAR_KEYBOARD(widget)->owner->measure(orientation, minimum, natural);
+    *minimum_baseline = *natural_baseline = -1;
+}
+
+static void car_keyboard_size_allocate(GtkWidget *widget, int width, int height, int) {
+    CAR_KEYBOARD(widget)->owner->allocate(width, height);
+}
+
+static void car_keyboard_snapshot(GtkWidget *widget, GtkSnapshot *snapshot) {
+    CAR_KEYBOARD(widget)->owner->snapshot(snapshot);
+}
+
+static void car_keyboard_class_init(CarKeyboardClass *klass) {
+    GtkWidgetClass *widget_class = GTK_WIDGET_CLASS(klass);
+    widget_class->measure = car_keyboard_measure;
+    widget_class->size_allocate = car_keyboard_size_allocate;
+    widget_class->snapshot = car_keyboard_snapshot;
+    gtk_widget_class_set_css_name(widget_class, "keyboard");
+}
+
+static void car_keyboard_init(CarKeyboard *self) {
+    self->owner = nullptr;
+    gtk_widget_set_focusable(GTK_WIDGET(self), FALSE); // WICHTIG: Fokus bleibt im Entry
+}
+
+#endif
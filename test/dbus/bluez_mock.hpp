@@ -0,0 +1,178 @@
+#ifndef CAROS_TEST_BLUEZ_MOCK_HPP
+#define CAROS_TEST_BLUEZ_MOCK_HPP
+
+#include <gio/gio.h>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <sys/wait.h>
+
+#include "test.hpp"
+
+// BlueZ-Attrappe für bin/caros-dbus-tests: python-dbusmock mit dem bluez5-Template auf einem
+// privaten Session-Bus (GTestDBus). Der Code unter Test nimmt über CAROS_BT_BUS=session diesen
+// Bus statt des System-Busses. Ohne python-dbusmock wird der Test übersprungen.
+//
+//   BluezMock bluez;                       // startet dbusmock, wartet auf org.bluez
+//   bluez.add_adapter("hci0");
+//   std::string path = bluez.add_device("hci0", "00:11:22:33:44:55", "Telefon");
+//   bluez.update(path, "RSSI", g_variant_new_int16(-60));   // PropertiesChanged
+namespace bluez_mock {
+
+// Ein privater Bus für den ganzen Testlauf; die Session-Verbindung von GIO ist ein Singleton
+inline void ensure_bus() {
+    static GTestDBus *bus = [] {
+        GTestDBus *b = g_test_dbus_new(G_TEST_DBUS_NONE);
+        g_test_dbus_up(b); // setzt DBUS_SESSION_BUS_ADDRESS für uns und dbusmock
+        g_setenv("CAROS_BT_BUS", "session", TRUE);
+        return b;
+    }();
+    (void) bus;
+}
+
+// Dreht die Main-Loop, bis done() gilt; false nach timeout_ms
+inline bool run_until(const std::function<bool()>& done, int timeout_ms = 5000) {
+    gint64 end = g_get_monotonic_time() + static_cast<gint64>(timeout_ms) * 1000;
+    while (!done()) {
+        if (g_get_monotonic_time() > end) return false;
+        if (!g_main_context_iteration(nullptr, FALSE)) g_usleep(1000);
+    }
+    return true;
+}
+
+// Lässt bereits eingetroffene Signale noch abarbeiten
+inline void drain(int ms = 100) {
+    gint64 end = g_get_monotonic_time() + static_cast<gint64>(ms) * 1000;
+    while (g_get_monotonic_time() < end) {
+        if (!g_main_context_iteration(nullptr, FALSE)) g_usleep(1000);
+    }
+}
+
+class BluezMock {
+public:
+    BluezMock() {
+        if (std::system("python3 -c 'import dbusmock' >/dev/null 2>&1") != 0) {
+            SKIP("python-dbusmock nicht installiert");
+        }
+        ensure_bus();
+
+        GError *err = nullptr;
+        connection = g_bus_get_sync(G_BUS_TYPE_SESSION, nullptr, &err);
+        if (!connection) fail_with("Session-Bus", err);
+
+        const gchar *argv[] = {"python3", "-m", "dbusmock", "--template", "bluez5", nullptr};
+        if (!g_spawn_async(nullptr, const_cast<gchar**>(argv), nullptr, G_SPAWN_SEARCH_PATH, nullptr, nullptr, &pid, &err)) {
+            fail_with("dbusmock starten", err);
+        }
+        if (!run_until([this] { return has_owner(); }, 10000)) {
+            kill(pid, SIGTERM);
+            waitpid(pid, nullptr, 0);
+            test::fail(__FILE__, __LINE__, "org.bluez erscheint nicht auf dem Bus");
+        }
+    }
+
+    ~BluezMock() {
+        if (pid > 0) {
+            kill(pid, SIGTERM);
+            waitpid(pid, nullptr, 0);
+            g_spawn_close_pid(pid);
+        }
+        // Name-Owner-Wechsel und ausstehende Antworten abarbeiten, bevor der nächste Test startet
+        run_until([this] { return !has_owner(); }, 2000);
+        drain(50);
+        if (connection) g_object_unref(connection);
+    }
+
+    BluezMock(const BluezMock&) = delete;
+    BluezMock& operator=(const BluezMock&) = delete;
+
+    std::string add_adapter(const std::string& name) {
+        return call_string("/org/bluez", "org.bluez.Mock", "AddAdapter",
+                           g_variant_new("(ss)", name.c_str(), "caros-test"));
+    }
+
+    std::string add_device(const std::string& adapter, const std::string& address, const std::string& alias) {
+        return call_string("/org/bluez", "org.bluez.Mock", "AddDevice",
+                           g_variant_new("(sss)", adapter.c_str(), address.c_str(), alias.c_str()));
+    }
+
+    void remove_device(const std::string& adapter, const std::string& address) {
+        call("/org/bluez", "org.bluez.Mock", "RemoveDevice", g_variant_new("(ss)", adapter.c_str(), address.c_str()));
+    }
+
+    // Setzt eine Device1-Eigenschaft und sendet PropertiesChanged (value wird übernommen)
+    void update(const std::string& device_path, const char *property, GVariant *value) {
+        GVariantBuilder props;
+        g_variant_builder_init(&props, G_VARIANT_TYPE("a{sv}"));
+        g_variant_builder_add(&props, "{sv}", property, value);
+        call(device_path, "org.freedesktop.DBus.Mock", "UpdateProperties",
+             g_variant_new("(sa{sv})", "org.bluez.Device1", &props));
+    }
+
+    // Ersetzt eine Methode eines Objekts durch Python-Code (self = Mock-Objekt, dbus importiert)
+    void set_method(const std::string& path, const char *iface, const char *method, const char *in_sig,
+                    const std::string& code) {
+        call(path, "org.freedesktop.DBus.Mock", "AddMethod",
+             g_variant_new("(sssss)", iface, method, in_sig, "", code.c_str()));
+    }
+
+    // Wie oft method auf dem Objekt aufgerufen wurde (seit dem Start von dbusmock)
+    size_t method_calls(const std::string& path, const char *method) {
+        GVariant *r = call_reply(path, "org.freedesktop.DBus.Mock", "GetMethodCalls", g_variant_new("(s)", method));
+        GVariant *calls = g_variant_get_child_value(r, 0);
+        size_t n = g_variant_n_children(calls);
+        g_variant_unref(calls);
+        g_variant_unref(r);
+        return n;
+    }
+
+private:
+    GDBusConnection *connection = nullptr;
+    GPid pid = 0;
+
+    [[noreturn]] void fail_with(const char *what, GError *err) {
+        std::string msg = std::string(what) + ": " + (err ? err->message : "?");
+        g_clear_error(&err);
+        test::fail(__FILE__, __LINE__, msg);
+        throw test::Failure{}; // nicht erreicht, test::fail wirft bereits
+    }
+
+    bool has_owner() {
+        GVariant *r = g_dbus_connection_call_sync(
+            connection, "org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus",
+            "NameHasOwner", g_variant_new("(s)", "org.bluez"), G_VARIANT_TYPE("(b)"),
+            G_DBUS_CALL_FLAGS_NONE, -1, nullptr, nullptr);
+        if (!r) return false;
+        gboolean owned = FALSE;
+        g_variant_get(r, "(b)", &owned);
+        g_variant_unref(r);
+        return owned;
+    }
+
+    GVariant* call_reply(const std::string& path, const char *iface, const char *method, GVariant *params) {
+        GError *err = nullptr;
+        GVariant *r = g_dbus_connection_call_sync(connection, "org.bluez", path.c_str(), iface, method, params,
+                                                  nullptr, G_DBUS_CALL_FLAGS_NONE, -1, nullptr, &err);
+        if (!r) fail_with(method, err);
+        return r;
+    }
+
+    void call(const std::string& path, const char *iface, const char *method, GVariant *params) {
+        g_variant_unref(call_reply(path, iface, method, params));
+    }
+
+    std::string call_string(const std::string& path, const char *iface, const char *method, GVariant *params) {
+        GVariant *r = call_reply(path, iface, method, params);
+        const gchar *value = nullptr;
+        g_variant_get(r, "(&s)", &value);
+        std::string out = value ? value : "";
+        g_variant_unref(r);
+        return out;
+    }
+};
+
+} // namespace bluez_mock
+
+#endif
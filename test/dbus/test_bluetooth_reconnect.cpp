@@ -0,0 +1,129 @@
+#include <fstream>
+
+#include "bench_data.hpp"
+#include "bluetooth_tracker.hpp"
+#include "bluez_mock.hpp"
+#include "test.hpp"
+
+using bluez_mock::BluezMock;
+using bluez_mock::run_until;
+
+namespace {
+
+constexpr const char *PHONE = "00:11:22:33:44:01";  // zuletzt verbunden, aber nicht in Reichweite
+constexpr const char *TABLET = "00:11:22:33:44:02"; // antwortet auf Connect
+constexpr const char *OLD = "00:11:22:33:44:03";    // älter, BlueZ kennt es nicht mehr
+
+const char *CONNECT_OK =
+    "self.UpdateProperties('org.bluez.Device1', {'Connected': dbus.Boolean(True, variant_level=1)})";
+const char *CONNECT_FAIL =
+    "raise dbus.exceptions.DBusException('Page Timeout', name='org.bluez.Error.Failed')";
+const char *CONNECT_ALREADY =
+    "raise dbus.exceptions.DBusException('Already Connected', name='org.bluez.Error.AlreadyConnected')";
+
+std::string write_known(const bench_data::TempDir& dir) {
+    std::string path = dir.path + "/known.csv";
+    std::ofstream(path) << PHONE << ";Telefon;12;1760000300\n"
+                        << TABLET << ";Tablet;3;1760000200\n"
+                        << OLD << ";Alt;40;1760000100\n";
+    return path;
+}
+
+} // namespace
+
+// Parallele Connect-Versuche an die bekannten Geräte, ohne Suche; das erste, das sich
+// verbindet, beendet den Reconnect. Die Startzeit liegt 2 s zurück (wie nach dem Hochfahren).
+CAROS_TEST("bluez/reconnect_parallel_connect") {
+    BluezMock bluez;
+    bluez.add_adapter("hci0");
+    std::string phone = bluez.add_device("hci0", PHONE, "Telefon");
+    std::string tablet = bluez.add_device("hci0", TABLET, "Tablet");
+    bluez.set_method(phone, "org.bluez.Device1", "Connect", "", CONNECT_FAIL);
+    bluez.set_method(tablet, "org.bluez.Device1", "Connect", "", CONNECT_OK);
+
+    bench_data::TempDir dir;
+    std::string known = write_known(dir);
+    BluetoothTracker tracker(g_get_monotonic_time() - 2 * G_USEC_PER_SEC, nullptr, known);
+    CHECK(run_until([&] { return tracker.reconnect_ms() >= 0; }));
+
+    CHECK(tracker.reconnect_ms() >= 2000);
+    CHECK(run_until([&] {
+        const BluetoothDevice *d = tracker.devices().find(TABLET);
+        return d && d->connected;
+    }));
+    CHECK_EQ(bluez.method_calls(phone, "Connect"), 1u);
+    CHECK_EQ(bluez.method_calls(tablet, "Connect"), 1u);
+    CHECK_EQ(bluez.method_calls("/org/bluez/hci0", "StartDiscovery"), 0u);
+
+    // Der Erfolg landet in der Liste der bekannten Geräte (Anzahl +1, jetzt an erster Stelle)
+    KnownDeviceStore store(known);
+    auto ranked = store.ranked(3);
+    CHECK_EQ(ranked[0].address, std::string(TABLET));
+    CHECK_EQ(ranked[0].connect_count, 4);
+}
+
+// Alle Versuche scheitern: kurze, auf Audio-Geräte gefilterte Suche. Sobald ein bekanntes
+// Gerät dabei mit RSSI auftaucht, wird es verbunden und die Suche beendet.
+CAROS_TEST("bluez/reconnect_filtered_search") {
+    BluezMock bluez;
+    std::string adapter = bluez.add_adapter("hci0");
+    std::string phone = bluez.add_device("hci0", PHONE, "Telefon");
+    std::string tablet = bluez.add_device("hci0", TABLET, "Tablet");
+    bluez.set_method(phone, "org.bluez.Device1", "Connect", "", CONNECT_FAIL);
+    bluez.set_method(tablet, "org.bluez.Device1", "Connect", "", CONNECT_FAIL);
+    bluez.set_method(adapter, "org.bluez.Adapter1", "SetDiscoveryFilter", "a{sv}", "pass");
+    bluez.set_method(adapter, "org.bluez.Adapter1", "StartDiscovery", "", "pass");
+    bluez.set_method(adapter, "org.bluez.Adapter1", "StopDiscovery", "", "pass");
+
+    bench_data::TempDir dir;
+    BluetoothTracker tracker(g_get_monotonic_time(), nullptr, write_known(dir));
+    CHECK(run_until([&] { return bluez.method_calls(adapter, "StartDiscovery") == 1; }));
+    CHECK(bluez.method_calls(adapter, "SetDiscoveryFilter") >= 1);
+    CHECK(tracker.reconnect_ms() < 0);
+
+    // Das Telefon kommt in Reichweite und nimmt die Verbindung jetzt an
+    bluez.set_method(phone, "org.bluez.Device1", "Connect", "", CONNECT_OK);
+    bluez.update(phone, "RSSI", g_variant_new_int16(-58));
+    CHECK(run_until([&] { return tracker.reconnect_ms() >= 0; }));
+    CHECK_EQ(bluez.method_calls(phone, "Connect"), 2u);
+    CHECK(run_until([&] { return bluez.method_calls(adapter, "StopDiscovery") == 1; }));
+    // Filter wieder leer, damit die manuelle Suche alles findet
+    CHECK(run_until([&] { return bluez.method_calls(adapter, "SetDiscoveryFilter") == 2; }));
+}
+
+// Das Telefon hat sich vor dem Start selbst verbunden: kein Connect, Reconnect gilt als erledigt
+CAROS_TEST("bluez/reconnect_skips_connected") {
+    BluezMock bluez;
+    bluez.add_adapter("hci0");
+    std::string phone = bluez.add_device("hci0", PHONE, "Telefon");
+    std::string tablet = bluez.add_device("hci0", TABLET, "Tablet");
+    bluez.set_method(phone, "org.bluez.Device1", "Connect", "", CONNECT_OK);
+    bluez.set_method(tablet, "org.bluez.Device1", "Connect", "", CONNECT_OK);
+    bluez.update(phone, "Connected", g_variant_new_boolean(TRUE));
+
+    bench_data::TempDir dir;
+    BluetoothTracker tracker(g_get_monotonic_time(), nullptr, write_known(dir));
+    CHECK(run_until([&] { return tracker.reconnect_ms() >= 0; }));
+    bluez_mock::drain();
+    CHECK_EQ(bluez.method_calls(phone, "Connect"), 0u);
+    CHECK_EQ(bluez.method_calls(tablet, "Connect"), 0u);
+}
+
+// Zwischen Modellstand und Connect hat sich das Telefon selbst verbunden: AlreadyConnected
+// ist ein Erfolg, keine Suche
+CAROS_TEST("bluez/reconnect_already_connected_is_success") {
+    BluezMock bluez;
+    std::string adapter = bluez.add_adapter("hci0");
+    std::string phone = bluez.add_device("hci0", PHONE, "Telefon");
+    std::string tablet = bluez.add_device("hci0", TABLET, "Tablet");
+    bluez.set_method(phone, "org.bluez.Device1", "Connect", "", CONNECT_ALREADY);
+    bluez.set_method(tablet, "org.bluez.Device1", "Connect", "", CONNECT_FAIL);
+    bluez.set_method(adapter, "org.bluez.Adapter1", "StartDiscovery", "", "pass");
+
+    bench_data::TempDir dir;
+    BluetoothTracker tracker(g_get_monotonic_time(), nullptr, write_known(dir));
+    CHECK(run_until([&] { return tracker.reconnect_ms() >= 0; }));
+    bluez_mock::drain();
+    CHECK_EQ(bluez.method_calls(phone, "Connect"), 1u);
+    CHECK_EQ(bluez.method_calls(adapter, "StartDiscovery"), 0u);
+}
@@ -0,0 +1,232 @@
+#include <gst/gst.h>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "bench_data.hpp"
+#include "media_player.hpp"
+#include "test.hpp"
+
+namespace {
+
+constexpr int RATE = 44100;
+// Titelgrenzen mitten in einem Puffer, nicht auf einer Zweierpotenz
+constexpr size_t TRACK_FRAMES[] = {RATE + 123, RATE - 457, RATE + 1001};
+constexpr size_t TRACKS = sizeof(TRACK_FRAMES) / sizeof(TRACK_FRAMES[0]);
+// Höchstens 1,5 ms Stille bzw. fehlende Frames pro Übergang, darunter nicht hörbar
+constexpr size_t MAX_GAP_FRAMES = 64;
+constexpr float SILENCE = 1e-3f;
+
+// Durchgehender Sinus mit Gleichanteil über alle Titel: nie still, Lücken fallen sofort auf
+float signal_at(size_t n) {
+    return static_cast<float>(0.25 + 0.2 * std::sin(2 * M_PI * 441.0 * n / RATE));
+}
+
+void write_u32(std::ofstream& out, uint32_t v) { out.write(reinterpret_cast<const char*>(&v), 4); }
+void write_u16(std::ofstream& out, uint16_t v) { out.write(reinterpret_cast<const char*>(&v), 2); }
+
+// PCM S16LE stereo, first = Index des ersten Frames im durchgehenden Signal
+void write_wav(const std::string& path, size_t first, size_t frames) {
+    std::ofstream out(path, std::ios::binary);
+    uint32_t data_bytes = static_cast<uint32_t>(frames * 4);
+    out.write("RIFF", 4);
+    write_u32(out, 36 + data_bytes);
+    out.write("WAVEfmt ", 8);
+    write_u32(out, 16);
+    write_u16(out, 1);            // PCM
+    write_u16(out, 2);            // Kanäle
+    write_u32(out, RATE);
+    write_u32(out, RATE * 4);     // Bytes pro Sekunde
+    write_u16(out, 4);            // Bytes pro Frame
+    write_u16(out, 16);
+    out.write("data", 4);
+    write_u32(out, data_bytes);
+    for (size_t n = 0; n < frames; n++) {
+        int16_t v = static_cast<int16_t>(std::lround(signal_at(first + n) * 32767.0f));
+        write_u16(out, static_cast<uint16_t>(v));
+        write_u16(out, static_cast<uint16_t>(v));
+    }
+}
+
+bool has_element(const char *name) {
+    GstElementFactory *f = gst_element_factory_find(name);
+    if (!f) return false;
+    gst_object_unref(f);
+    return true;
+}
+
+// Lässt eine Pipeline bis EOS laufen, false bei Fehler
+bool run_to_eos(const std::string& description) {
+    GError *err = nullptr;
+    GstElement *pipeline = gst_parse_launch(description.c_str(), &err);
+    if (!pipeline) {
+        g_clear_error(&err);
+        return false;
+    }
+    gst_element_set_state(pipeline, GST_STATE_PLAYING);
+    GstBus *bus = gst_element_get_bus(pipeline);
+    GstMessage *msg = gst_bus_timed_pop_filtered(bus, 10 * GST_SECOND,
+                                                 static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+    bool ok = msg && GST_MESSAGE_TYPE(msg) == GST_MESSAGE_EOS;
+    if (msg) gst_message_unref(msg);
+    gst_object_unref(bus);
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_object_unref(pipeline);
+    return ok;
+}
+
+// Fixtures: WAV, der mittlere Titel als FLAC, wenn flacenc/flacdec vorhanden sind
+std::vector<std::string> make_fixtures(const bench_data::TempDir& dir) {
+    std::vector<std::string> files;
+    size_t first = 0;
+    bool flac = has_element("flacenc") && has_element("flacdec");
+    for (size_t i = 0; i < TRACKS; i++) {
+        std::string wav = dir.path + "/track" + std::to_string(i) + ".wav";
+        write_wav(wav, first, TRACK_FRAMES[i]);
+        first += TRACK_FRAMES[i];
+        if (i == 1 && flac) {
+            std::string out = dir.path + "/track1.flac";
+            if (!run_to_eos("filesrc location=\"" + wav + "\" ! wavparse ! audioconvert ! flacenc ! filesink location=\"" + out + "\"")) {
+                test::fail(__FILE__, __LINE__, "FLAC-Fixture konnte nicht erzeugt werden");
+            }
+            wav = out;
+        }
+        files.push_back(wav);
+    }
+    if (!flac) std::printf("        flacenc/flacdec fehlen, nur WAV\n");
+    return files;
+}
+
+// Spielt die Warteschlange über ein playbin mit MediaPlayer ab (Takt wie im Auto, sync=true)
+// und sammelt den Ausgang als F32 stereo. main_loop=false: die Main-Loop läuft während der
+// Wiedergabe nicht (belegter Main-Thread), prepare_ahead() kommt also nie dran.
+std::vector<float> play_and_capture(const std::vector<std::string>& files, bool main_loop = true) {
+    GstElement *playbin = gst_element_factory_make("playbin", nullptr);
+    GError *err = nullptr;
+    GstElement *sink_bin = gst_parse_bin_from_description(
+        "audioconvert ! audio/x-raw,format=F32LE,channels=2,rate=44100 ! appsink name=out sync=true", TRUE, &err);
+    if (!sink_bin) {
+        std::string msg = err ? err->message : "?";
+        g_clear_error(&err);
+        test::fail(__FILE__, __LINE__, "Sink: " + msg);
+    }
+    GstElement *appsink = gst_bin_get_by_name(GST_BIN(sink_bin), "out");
+    g_object_set(playbin, "audio-sink", sink_bin, "flags", 0x2 /* GST_PLAY_FLAG_AUDIO */, NULL);
+
+    MediaPlayer player(playbin);
+    player.play(files);
+
+    std::vector<float> pcm;
+    std::string error;
+    GstBus *bus = gst_element_get_bus(playbin);
+    gint64 deadline = g_get_monotonic_time() + 20 * G_USEC_PER_SEC;
+    while (g_get_monotonic_time() < deadline) {
+        while (main_loop && g_main_context_iteration(nullptr, FALSE)) {} // prepare_ahead() läuft per g_idle_add
+
+        GstSample *sample = nullptr;
+        g_signal_emit_by_name(appsink, "try-pull-sample", 20 * GST_MSECOND, &sample);
+        if (sample) {
+            GstMapInfo map;
+            GstBuffer *buffer = gst_sample_get_buffer(sample);
+            if (gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+                const float *f = reinterpret_cast<const float*>(map.data);
+                pcm.insert(pcm.end(), f, f + map.size / sizeof(float));
+                gst_buffer_unmap(buffer, &map);
+            }
+            gst_sample_unref(sample);
+            continue;
+        }
+
+        gboolean eos = FALSE;
+        g_object_get(appsink, "eos", &eos, NULL);
+        if (eos) break;
+        if (GstMessage *msg = gst_bus_pop_filtered(bus, GST_MESSAGE_ERROR)) {
+            GError *e = nullptr;
+            gst_message_parse_error(msg, &e, nullptr);
+            error = e ? e->message : "Fehler";
+            g_clear_error(&e);
+            gst_message_unref(msg);
+            break;
+        }
+    }
+
+    player.stop();
+    gst_element_set_state(playbin, GST_STATE_NULL);
+    while (g_main_context_iteration(nullptr, FALSE)) {} // liegengebliebene prepare_ahead(), solange player lebt
+    gst_object_unref(bus);
+    gst_object_unref(appsink);
+    gst_object_unref(playbin);
+    if (!error.empty()) test::fail(__FILE__, __LINE__, "Wiedergabe: " + error);
+    return pcm;
+}
+
+bool silent(const std::vector<float>& pcm, size_t frame) {
+    return std::fabs(pcm[frame * 2]) < SILENCE && std::fabs(pcm[frame * 2 + 1]) < SILENCE;
+}
+
+size_t audible_frames(const std::vector<float>& pcm) {
+    size_t frames = pcm.size() / 2;
+    size_t first = 0;
+    while (first < frames && silent(pcm, first)) first++;
+    size_t last = frames;
+    while (last > first && silent(pcm, last - 1)) last--;
+    return last - first;
+}
+
+} // namespace
+
+// Misst die Lücke zwischen Titelende und Beginn des nächsten Titels in Samples:
+// längste Stille innerhalb des hörbaren Bereichs und fehlende/überzählige Frames insgesamt
+CAROS_TEST("media/gapless_transition") {
+    gst_init(nullptr, nullptr);
+    for (const char *name : {"playbin", "appsrc", "appsink", "wavparse", "decodebin", "audioconvert", "audioresample"}) {
+        if (!has_element(name)) SKIP(std::string("GStreamer-Element ") + name + " fehlt");
+    }
+
+    bench_data::TempDir dir;
+    std::vector<float> pcm = play_and_capture(make_fixtures(dir));
+    size_t frames = pcm.size() / 2;
+    CHECK(frames > 0);
+    if (frames == 0) return;
+
+    size_t first = 0;
+    while (first < frames && silent(pcm, first)) first++;
+    size_t last = frames;
+    while (last > first && silent(pcm, last - 1)) last--;
+
+    size_t longest_gap = 0;
+    for (size_t n = first, run = 0; n < last; n++) {
+        run = silent(pcm, n) ? run + 1 : 0;
+        longest_gap = std::max(longest_gap, run);
+    }
+
+    size_t expected = 0;
+    for (size_t f : TRACK_FRAMES) expected += f;
+    size_t audible = last - first;
+    long missing = static_cast<long>(expected) - static_cast<long>(audible);
+    std::printf("        %zu Frames erwartet, %zu hörbar (Differenz %ld), längste Stille %zu Frames\n",
+                expected, audible, missing, longest_gap);
+
+    CHECK(longest_gap <= MAX_GAP_FRAMES);
+    CHECK(static_cast<size_t>(std::labs(missing)) <= MAX_GAP_FRAMES * (TRACKS - 1));
+}
+
+// Die Main-Loop hängt während der ganzen Wiedergabe: der dritte Titel wird nie vorab geöffnet
+// und muss trotzdem im about-to-finish des zweiten anschließen
+CAROS_TEST("media/queue_continues_without_main_loop") {
+    gst_init(nullptr, nullptr);
+    for (const char *name : {"playbin", "appsrc", "appsink", "wavparse", "decodebin", "audioconvert", "audioresample"}) {
+        if (!has_element(name)) SKIP(std::string("GStreamer-Element ") + name + " fehlt");
+    }
+
+    bench_data::TempDir dir;
+    std::vector<float> pcm = play_and_capture(make_fixtures(dir), false);
+    size_t expected = 0;
+    for (size_t f : TRACK_FRAMES) expected += f;
+    size_t audible = audible_frames(pcm);
+    std::printf("        %zu Frames erwartet, %zu hörbar\n", expected, audible);
+    CHECK(audible + MAX_GAP_FRAMES * TRACKS >= expected);
+}
@@ -0,0 +1,115 @@
+#include <gst/gst.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <string>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+#include "spectrum_tap.hpp"
+#include "test.hpp"
+#include "thread_registry.hpp"
+
+namespace {
+
+constexpr int RATE = 48000;
+constexpr int CHANNELS = 2;
+constexpr size_t FRAMES = 1024; // ein Puffer aus dem Filter, ~21 ms
+// Anteil eines Kerns für Tap und Worker bei sichtbarem Visualizer (Budget für den Pi 3B)
+constexpr double BUDGET_PERCENT = 5.0;
+
+int audio_seconds() {
+    const char *env = getenv("CAROS_BENCH_SPECTRUM_S");
+    return env ? std::max(1, std::atoi(env)) : 10;
+}
+
+// Verbrauchte CPU-Zeit eines Threads aus /proc (utime + stime)
+double thread_cpu_s(pid_t tid) {
+    std::ifstream in("/proc/self/task/" + std::to_string(tid) + "/stat");
+    std::string stat((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    size_t p = stat.rfind(')');
+    if (p == std::string::npos) return 0;
+    unsigned long utime = 0, stime = 0;
+    // nach dem Namen: Zustand (Feld 3) ... utime (14), stime (15)
+    std::sscanf(stat.c_str() + p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime);
+    return static_cast<double>(utime + stime) / sysconf(_SC_CLK_TCK);
+}
+
+double own_cpu_s() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+} // namespace
+
+// Kosten von SpectrumTap samt Worker für N Sekunden Audio in Echtzeit (CAROS_BENCH_SPECTRUM_S):
+// push() im Streaming-Thread plus FFT im Worker bei 30 Analysen/s, als Anteil eines Kerns
+CAROS_TEST("spectrum/tap_cpu_budget") {
+    gst_init(nullptr, nullptr);
+    std::set<pid_t> before;
+    for (const ThreadInfo& t : ThreadRegistry::instance().threads()) before.insert(t.tid);
+
+    SpectrumTap tap;
+    pid_t worker = 0;
+    for (int i = 0; i < 100 && worker == 0; i++) {
+        for (const ThreadInfo& t : ThreadRegistry::instance().threads()) {
+            if (t.role == "spectrum" && !before.count(t.tid)) worker = t.tid;
+        }
+        if (worker == 0) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(worker != 0);
+
+    tap.set_rate_hz(30);
+    tap.set_active(true);
+    double worker_start = thread_cpu_s(worker);
+
+    // Puffer im Voraus, damit das Erzeugen nicht mitzählt; der Tap hält nur Referenzen
+    std::vector<GstBuffer*> buffers;
+    for (int b = 0; b < 8; b++) {
+        GstBuffer *buffer = gst_buffer_new_allocate(nullptr, FRAMES * CHANNELS * sizeof(float), nullptr);
+        GstMapInfo map;
+        gst_buffer_map(buffer, &map, GST_MAP_WRITE);
+        float *samples = reinterpret_cast<float*>(map.data);
+        for (size_t n = 0; n < FRAMES; n++) {
+            float v = static_cast<float>(0.3 * std::sin(2 * M_PI * 440.0 * (b * FRAMES + n) / RATE) +
+                                         0.1 * std::sin(2 * M_PI * 5000.0 * (b * FRAMES + n) / RATE));
+            for (int c = 0; c < CHANNELS; c++) samples[n * CHANNELS + c] = v;
+        }
+        gst_buffer_unmap(buffer, &map);
+        buffers.push_back(buffer);
+    }
+
+    // Takt wie die Soundkarte; nebenbei holt der "UI-Thread" die Bänder ab
+    int seconds = audio_seconds();
+    size_t count = static_cast<size_t>(seconds) * RATE / FRAMES;
+    auto period = std::chrono::microseconds(FRAMES * 1000000 / RATE);
+    auto next = std::chrono::steady_clock::now();
+    double push_s = 0;
+    int frames_seen = 0;
+    SpectrumFrame frame;
+    for (size_t i = 0; i < count; i++) {
+        double t0 = own_cpu_s();
+        tap.push(buffers[i % buffers.size()], CHANNELS, RATE);
+        push_s += own_cpu_s() - t0;
+        if (tap.poll(frame)) frames_seen++;
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+    double worker_s = thread_cpu_s(worker) - worker_start;
+    tap.set_active(false);
+    for (GstBuffer *buffer : buffers) gst_buffer_unref(buffer);
+
+    double audio_s = static_cast<double>(count * FRAMES) / RATE;
+    double percent = 100.0 * (worker_s + push_s) / audio_s;
+    std::printf("        %.1f s Audio: Worker %.0f ms, push %.1f ms, %.2f %% eines Kerns (Budget %.0f %%), %d Bilder\n",
+                audio_s, worker_s * 1000, push_s * 1000, percent, BUDGET_PERCENT, frames_seen);
+    CHECK(frames_seen > seconds * 10);
+    CHECK(percent <= BUDGET_PERCENT);
+}
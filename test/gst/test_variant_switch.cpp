@@ -0,0 +1,273 @@
+#include <gst/gst.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "audio_engine.hpp"
+#include "bench_data.hpp"
+#include "test.hpp"
+#include "variant_playback.hpp"
+
+namespace {
+
+// Zwei Varianten desselben Senders als endlose WAV-Streams (PCM S16LE mono): die Bitrate
+// ist exakt die angegebene, damit der VariantSelector mit echten Zahlen arbeitet
+constexpr int LO_RATE = 8000;   // 128 kbit/s
+constexpr int HI_RATE = 48000;  // 768 kbit/s
+constexpr int LO_KBPS = LO_RATE * 16 / 1000;
+constexpr int HI_KBPS = HI_RATE * 16 / 1000;
+
+using Clock = std::chrono::steady_clock;
+
+bool has_element(const char *name) {
+    GstElementFactory *f = gst_element_factory_find(name);
+    if (!f) return false;
+    gst_object_unref(f);
+    return true;
+}
+
+bool send_all(int fd, const char *data, size_t size) {
+    while (size > 0) {
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+int listen_loopback(uint16_t& port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 8) != 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        test::fail(__FILE__, __LINE__, "Loopback-Socket nicht verfügbar");
+    }
+    port = ntohs(addr.sin_port);
+    return fd;
+}
+
+std::string read_request_path(int fd) {
+    std::string request;
+    char buf[1024];
+    ssize_t n;
+    while (request.find("\r\n\r\n") == std::string::npos && (n = read(fd, buf, sizeof(buf))) > 0) {
+        request.append(buf, static_cast<size_t>(n));
+    }
+    size_t start = request.find(' ');
+    if (start == std::string::npos) return "";
+    size_t end = request.find(' ', start + 1);
+    return request.substr(start + 1, end - start - 1);
+}
+
+// Sender: liefert so schnell, wie der Socket annimmt (/lo.wav, /hi.wav)
+class Origin {
+public:
+    Origin() {
+        fd = listen_loopback(port);
+        thread = std::thread([this] { serve(); });
+    }
+    ~Origin() {
+        stopping = true;
+        shutdown(fd, SHUT_RDWR);
+        thread.join();
+        for (auto& t : clients) t.join();
+        close(fd);
+    }
+    uint16_t port = 0;
+
+private:
+    int fd = -1;
+    std::atomic<bool> stopping{false};
+    std::thread thread;
+    std::vector<std::thread> clients;
+
+    void serve() {
+        while (!stopping) {
+            int c = accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (c < 0) continue;
+            clients.emplace_back([this, c] { stream(c); });
+        }
+    }
+
+    void stream(int c) {
+        std::string path = read_request_path(c);
+        int rate = path == "/hi.wav" ? HI_RATE : path == "/lo.wav" ? LO_RATE : 0;
+        if (rate == 0) {
+            send_all(c, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n", 63);
+            close(c);
+            return;
+        }
+        std::string head = "HTTP/1.1 200 OK\r\nContent-Type: audio/x-wav\r\nConnection: close\r\n\r\n";
+        head += wav_header(rate);
+        bool ok = send_all(c, head.data(), head.size());
+        std::vector<int16_t> block(rate / 10);
+        for (size_t n = 0; ok && !stopping; n += block.size()) {
+            for (size_t i = 0; i < block.size(); i++) block[i] = static_cast<int16_t>(((n + i) % 64) * 256 - 8192);
+            ok = send_all(c, reinterpret_cast<const char*>(block.data()), block.size() * sizeof(int16_t));
+        }
+        close(c);
+    }
+
+    static std::string wav_header(int rate) {
+        auto u32 = [](uint32_t v) { return std::string(reinterpret_cast<const char*>(&v), 4); };
+        auto u16 = [](uint16_t v) { return std::string(reinterpret_cast<const char*>(&v), 2); };
+        return "RIFF" + u32(0xFFFFFFFFu) + "WAVEfmt " + u32(16) + u16(1) + u16(1) + u32(rate) + u32(rate * 2) +
+               u16(2) + u16(16) + "data" + u32(0xFFFFFFF0u);
+    }
+};
+
+// Gedrosselte Verbindung zwischen Wiedergabe und Sender (Token-Bucket, Rate änderbar)
+class ShapingProxy {
+public:
+    explicit ShapingProxy(uint16_t upstream) : upstream(upstream) {
+        fd = listen_loopback(port);
+        thread = std::thread([this] { serve(); });
+    }
+    ~ShapingProxy() {
+        stopping = true;
+        shutdown(fd, SHUT_RDWR);
+        thread.join();
+        for (auto& t : clients) t.join();
+        close(fd);
+    }
+    void set_kbps(int kbps) { rate_kbps = kbps; }
+    uint16_t port = 0;
+
+private:
+    uint16_t upstream;
+    int fd = -1;
+    std::atomic<int> rate_kbps{100000};
+    std::atomic<bool> stopping{false};
+    std::thread thread;
+    std::vector<std::thread> clients;
+
+    void serve() {
+        while (!stopping) {
+            int c = accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (c < 0) continue;
+            clients.emplace_back([this, c] { relay(c); });
+        }
+    }
+
+    void relay(int c) {
+        int up = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(upstream);
+        timeval tv{0, 200000};
+        setsockopt(up, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        if (connect(up, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            char request[2048];
+            ssize_t n = read(c, request, sizeof(request)); // GET passt in ein Segment
+            bool ok = n > 0 && send_all(up, request, static_cast<size_t>(n));
+            char chunk[1024];
+            auto next = Clock::now();
+            while (ok && !stopping) {
+                n = read(up, chunk, sizeof(chunk));
+                if (n < 0 && errno == EAGAIN) continue;
+                if (n <= 0) break;
+                // Kein Nachholen nach Pausen: eine gesenkte Rate wirkt sofort
+                auto now = Clock::now();
+                if (next < now - std::chrono::milliseconds(20)) next = now;
+                std::this_thread::sleep_until(next);
+                ok = send_all(c, chunk, static_cast<size_t>(n));
+                next += std::chrono::microseconds(static_cast<int64_t>(n * 8 * 1000.0 / rate_kbps.load()));
+            }
+        }
+        close(up);
+        close(c);
+    }
+};
+
+bool run_until(const std::function<bool()>& done, int timeout_s) {
+    gint64 end = g_get_monotonic_time() + timeout_s * G_USEC_PER_SEC;
+    while (!done()) {
+        if (g_get_monotonic_time() > end) return false;
+        if (!g_main_context_iteration(nullptr, FALSE)) g_usleep(2000);
+    }
+    return true;
+}
+
+} // namespace
+
+// Ende zu Ende: AudioEngine spielt über einen gedrosselten Proxy, die queue2-Eingangsrate
+// (avg_in aus den BUFFERING-Meldungen) speist VariantPlayback, der Umschaltpfad lädt die
+// Variante neu. Nur die Haltezeiten des Selectors laufen auf einer vorgestellten Uhr.
+CAROS_TEST("stream_variants/switch_over_shaped_http") {
+    gst_init(nullptr, nullptr);
+    for (const char *name : {"playbin", "souphttpsrc", "queue2", "wavparse", "audioconvert", "audioresample", "fakesink"}) {
+        if (!has_element(name)) SKIP(std::string("GStreamer-Element ") + name + " fehlt");
+    }
+
+    // Die Engine liest und schreibt Einstellungen relativ zum Arbeitsverzeichnis
+    bench_data::TempDir dir;
+    char cwd[4096];
+    CHECK(getcwd(cwd, sizeof(cwd)) != nullptr);
+    CHECK_EQ(chdir(dir.path.c_str()), 0);
+
+    Origin origin;
+    ShapingProxy proxy(origin.port);
+    std::string base = "http://127.0.0.1:" + std::to_string(proxy.port);
+    std::vector<StreamVariant> variants = {{"WAV", HI_KBPS, base + "/hi.wav"}, {"WAV", LO_KBPS, base + "/lo.wav"}};
+
+    auto *engine = new AudioEngine(); // lebt wie im Daemon bis zum Prozessende (Timer hält this)
+    engine->set_audio_sink(gst_element_factory_make("fakesink", nullptr)); // sync=true: Takt wie im Auto
+    engine->set_low_memory(true);
+
+    int64_t skew = 0;
+    auto now = [&skew] { return g_get_monotonic_time() + skew; };
+    VariantPlayback playback;
+    std::vector<std::string> loads;
+    playback.load = [&](const std::string& uri, const std::string& station) {
+        loads.push_back(uri);
+        engine->set_source(uri, station);
+    };
+    engine->on_buffering = [&](int percent, double kbps) { playback.on_buffering(percent, kbps, now()); };
+
+    // Ohne Messung startet die kleine Variante; die Verbindung schafft viel mehr
+    playback.play(base + "/hi.wav", variants, now());
+    CHECK_EQ(loads.back(), base + "/lo.wav");
+    CHECK(run_until([&] { return playback.variants().capacity() >= HI_KBPS * VariantSelector::HEADROOM; }, 20));
+    skew += VariantSelector::FALLBACK_US; // Haltezeit und Rückfall ohne Titel vorbei
+    playback.poll(false, now());
+    CHECK_EQ(loads.back(), base + "/hi.wav");
+    size_t up = loads.size();
+
+    // Verbindung bricht unter die Bitrate ein: Aussetzer, sofort zurück auf die kleine Variante
+    proxy.set_kbps(HI_KBPS / 2);
+    CHECK(run_until([&] { return loads.size() > up; }, 30));
+    CHECK_EQ(loads.back(), base + "/lo.wav");
+    size_t down = loads.size();
+
+    // Erholung: nach STABLE_US ohne Aussetzer wieder hoch
+    proxy.set_kbps(100000);
+    CHECK(run_until([&] { return playback.variants().capacity() >= HI_KBPS * VariantSelector::HEADROOM; }, 20));
+    skew += VariantSelector::STABLE_US + VariantSelector::FALLBACK_US;
+    playback.poll(false, now());
+    CHECK_EQ(loads.size(), down + 1);
+    CHECK_EQ(loads.back(), base + "/hi.wav");
+    std::printf("        %zu Ladevorgänge, Durchsatz zuletzt %.0f kbit/s\n", loads.size(), playback.variants().capacity());
+
+    engine->on_buffering = nullptr;
+    engine->stop();
+    CHECK_EQ(chdir(cwd), 0);
+}
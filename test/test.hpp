@@ -0,0 +1,77 @@
+#ifndef CAROS_TEST_HPP
+#define CAROS_TEST_HPP
+
+#include <cstdio>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Minimales Test-Gerüst für bin/caros-tests (ohne externe Abhängigkeiten).
+//
+//   CAROS_TEST("station_catalog/csv_round_trip") {
+//       CHECK(parse_station_line(line, s));
+//       CHECK_EQ(s.name, "Bayern 3");
+//   }
+//
+// Ein fehlgeschlagenes CHECK meldet Datei und Zeile und bricht nur den aktuellen Test ab.
+// SKIP("Grund") beendet einen Test, dessen Voraussetzung fehlt (z.B. python-dbusmock).
+namespace test {
+
+struct Failure {};
+
+struct Skipped {
+    std::string reason;
+};
+
+struct Entry {
+    std::string name;
+    std::function<void()> body;
+};
+
+inline std::vector<Entry>& registry() {
+    static std::vector<Entry> entries;
+    return entries;
+}
+
+struct Registrar {
+    Registrar(const char *name, std::function<void()> body) { registry().push_back({name, std::move(body)}); }
+};
+
+inline void fail(const char *file, int line, const std::string& what) {
+    std::fprintf(stderr, "  %s:%d: %s\n", file, line, what.c_str());
+    throw Failure{};
+}
+
+template<typename T>
+std::string show(const T& v) {
+    std::ostringstream out;
+    out << v;
+    return out.str();
+}
+
+} // namespace test
+
+#define CAROS_TEST_CAT2(a, b) a##b
+#define CAROS_TEST_CAT(a, b) CAROS_TEST_CAT2(a, b)
+#define CAROS_TEST(name)                                                                         \
+    static void CAROS_TEST_CAT(caros_test_, __LINE__)();                                         \
+    static test::Registrar CAROS_TEST_CAT(caros_test_reg_, __LINE__)(name, &CAROS_TEST_CAT(caros_test_, __LINE__)); \
+    static void CAROS_TEST_CAT(caros_test_, __LINE__)()
+
+#define SKIP(reason) throw test::Skipped{reason}
+
+#define CHECK(cond)                                                                              \
+    do {                                                                                         \
+        if (!(cond)) test::fail(__FILE__, __LINE__, "CHECK(" #cond ")");                          \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                                           \
+    do {                                                                                         \
+        auto&& caros_a = (a);                                                                    \
+        auto&& caros_b = (b);                                                                    \
+        if (!(caros_a == caros_b))                                                               \
+            test::fail(__FILE__, __LINE__, "CHECK_EQ(" #a ", " #b "): " + test::show(caros_a) + " != " + test::show(caros_b)); \
+    } while (0)
+
+#endif
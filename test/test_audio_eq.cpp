@@ -0,0 +1,142 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "audio_eq.hpp"
+#include "bench_data.hpp"
+#include "test.hpp"
+
+namespace {
+
+using Kernel = AudioEqualizer::Kernel;
+
+// Abweichung SIMD gegen skalar: nur die Reihenfolge der float-Operationen unterscheidet sich
+constexpr float EPSILON = 1e-4f;
+// Kein Vielfaches der Vektorbreite (4 bzw. 8) und nicht von RAMP_FRAMES
+constexpr size_t BLOCK = 37;
+constexpr size_t FRAMES = 48000 / 2;
+
+std::vector<Kernel> simd_kernels() {
+    std::vector<Kernel> kernels;
+#if CAROS_EQ_X86
+    kernels.push_back(Kernel::Sse);
+    if (__builtin_cpu_supports("avx")) kernels.push_back(Kernel::Avx);
+#elif CAROS_EQ_NEON
+    kernels.push_back(Kernel::Neon);
+#endif
+    return kernels;
+}
+
+// Sinus-Gemisch über alle Bänder plus Rauschen, Kanäle verschieden
+std::vector<float> make_signal(int channels) {
+    bench_data::Rng rng(11);
+    std::vector<float> data(FRAMES * channels);
+    for (size_t n = 0; n < FRAMES; n++) {
+        for (int c = 0; c < channels; c++) {
+            double t = static_cast<double>(n) / 48000.0;
+            double v = 0.15 * std::sin(2 * M_PI * (55.0 + 40.0 * c) * t) + 0.1 * std::sin(2 * M_PI * 1000.0 * t) +
+                       0.05 * std::sin(2 * M_PI * 9000.0 * t) + rng.uniform(-0.05, 0.05);
+            data[n * channels + c] = static_cast<float>(v);
+        }
+    }
+    return data;
+}
+
+std::vector<float> run(Kernel kernel, int channels, std::vector<float> data) {
+    AudioEqualizer eq;
+    for (int b = 0; b < AudioEqualizer::BANDS; b++) eq.set_gain(b, b % 2 ? 9.0f : -6.0f);
+    eq.set_limiter_enabled(false); // Limiter getrennt vom Filterpfad, hier nur die Kernel
+    eq.configure(48000, channels); // übernimmt die Verstärkungen ohne Rampe
+    eq.set_kernel(kernel);
+    for (size_t done = 0; done < FRAMES; done += BLOCK) {
+        eq.process(data.data() + done * channels, std::min(BLOCK, FRAMES - done));
+    }
+    return data;
+}
+
+// Größte Abweichung zwischen Referenz und um latency Frames verzögertem Kernel-Ausgang
+float max_difference(const std::vector<float>& reference, const std::vector<float>& out, int channels, int latency) {
+    float worst = 0.0f;
+    for (size_t n = 0; n + latency < FRAMES; n++) {
+        for (int c = 0; c < channels; c++) {
+            worst = std::max(worst, std::fabs(reference[n * channels + c] - out[(n + latency) * channels + c]));
+        }
+    }
+    return worst;
+}
+
+void check_kernels(int channels) {
+    std::vector<float> input = make_signal(channels);
+    std::vector<float> reference = run(Kernel::Scalar, channels, input);
+    CHECK(max_difference(input, reference, channels, 0) > 0.05f); // der EQ greift tatsächlich
+    for (Kernel kernel : simd_kernels()) {
+        AudioEqualizer probe;
+        probe.set_kernel(kernel);
+        float diff = max_difference(reference, run(kernel, channels, input), channels, probe.latency_frames());
+        std::printf("        %s %s: max. Abweichung %.2e\n", AudioEqualizer::kernel_name(kernel), channels == 1 ? "mono" : "stereo", diff);
+        CHECK(diff <= EPSILON);
+    }
+}
+
+} // namespace
+
+CAROS_TEST("audio_eq/simd_matches_scalar_mono") {
+    check_kernels(1);
+}
+
+CAROS_TEST("audio_eq/simd_matches_scalar_stereo") {
+    check_kernels(2);
+}
+
+// Rampe: pro RAMP_FRAMES höchstens RAMP_DB, Koeffizienten nur während der Rampe neu berechnet
+CAROS_TEST("audio_eq/ramp_bounded_per_block") {
+    AudioEqualizer eq;
+    eq.configure(44100, 2);
+    std::vector<float> block(AudioEqualizer::RAMP_FRAMES * 2, 0.1f);
+    uint64_t before = eq.coefficient_updates();
+
+    eq.set_gain(3, 12.0f);
+    eq.set_gain(0, -6.0f);
+    const int steps = static_cast<int>(std::ceil(12.0f / AudioEqualizer::RAMP_DB));
+    for (int i = 0; i < steps; i++) {
+        float mid = eq.ramped_gain(3), low = eq.ramped_gain(0);
+        eq.process(block.data(), AudioEqualizer::RAMP_FRAMES);
+        CHECK(std::fabs(eq.ramped_gain(3) - mid) <= AudioEqualizer::RAMP_DB + 1e-6f);
+        CHECK(std::fabs(eq.ramped_gain(0) - low) <= AudioEqualizer::RAMP_DB + 1e-6f);
+        CHECK(eq.ramped_gain(3) > mid); // kommt auch voran
+    }
+    CHECK_EQ(eq.ramped_gain(3), 12.0f);
+    CHECK_EQ(eq.ramped_gain(0), -6.0f);
+    // 48 Schritte für Band 3, 24 für Band 0
+    uint64_t ramp_updates = eq.coefficient_updates() - before;
+    CHECK_EQ(ramp_updates, static_cast<uint64_t>(steps + 6.0f / AudioEqualizer::RAMP_DB));
+
+    // Am Ziel keine weiteren Berechnungen
+    for (int i = 0; i < 100; i++) eq.process(block.data(), AudioEqualizer::RAMP_FRAMES);
+    CHECK_EQ(eq.coefficient_updates() - before, ramp_updates);
+}
+
+// Limiter: auch bei +12 dB auf ein Signal bei 0 dBFS kein Sample über LIMIT
+CAROS_TEST("audio_eq/limiter_ceiling") {
+    for (int channels = 1; channels <= 2; channels++) {
+        AudioEqualizer eq;
+        for (int b = 0; b < AudioEqualizer::BANDS; b++) eq.set_gain(b, AudioEqualizer::MAX_GAIN_DB);
+        eq.configure(48000, channels);
+        std::vector<float> data(FRAMES * channels);
+        for (size_t n = 0; n < FRAMES; n++) {
+            for (int c = 0; c < channels; c++) {
+                data[n * channels + c] = static_cast<float>(std::sin(2 * M_PI * (100.0 + 900.0 * c) * n / 48000.0));
+            }
+        }
+        float peak = 0.0f;
+        for (size_t done = 0; done < FRAMES; done += BLOCK) {
+            size_t n = std::min(BLOCK, FRAMES - done);
+            float *p = data.data() + done * channels;
+            eq.process(p, n);
+            for (size_t i = 0; i < n * channels; i++) peak = std::max(peak, std::fabs(p[i]));
+        }
+        std::printf("        %s: Spitze %.4f (Grenze %.3f)\n", channels == 1 ? "mono" : "stereo", peak, AudioEqualizer::LIMIT);
+        CHECK(peak <= AudioEqualizer::LIMIT * (1.0f + 1e-6f));
+        CHECK(peak > AudioEqualizer::LIMIT * 0.95f); // der Limiter greift, statt das Signal zu verlieren
+    }
+}
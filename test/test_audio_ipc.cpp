@@ -0,0 +1,103 @@
+#include <chrono>
+#include <string>
+#include <sys/stat.h>
+
+#include "audio_ipc.hpp"
+#include "bench_data.hpp"
+#include "test.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+} // namespace
+
+// Ein hängender Daemon nimmt über den Backlog an, schickt aber nie die Deskriptoren:
+// connect muss nach dem Zeitlimit aufgeben statt ewig in recvmsg zu warten
+CAROS_TEST("audio_ipc/connect_times_out_on_silent_daemon") {
+    bench_data::TempDir dir;
+    std::string path = dir.path + "/audio.sock";
+    int listener = audio_ipc::listen_socket(path);
+    CHECK(listener >= 0);
+
+    audio_ipc::Endpoint ep;
+    auto start = Clock::now();
+    CHECK(!audio_ipc::connect(path, ep, 100));
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    CHECK(ms >= 90 && ms < 1000);
+    CHECK(ep.shared == nullptr);
+
+    // Die Oberfläche erfährt die PID, um den Daemon zu beenden
+    int sock = audio_ipc::dial(path);
+    CHECK(sock >= 0);
+    CHECK_EQ(audio_ipc::peer_pid(sock), getpid());
+    close(sock);
+    close(listener);
+}
+
+CAROS_TEST("audio_ipc/socket_private_and_single_daemon") {
+    bench_data::TempDir dir;
+    std::string path = dir.path + "/audio.sock";
+    int lock = audio_ipc::lock_socket(path, 0);
+    CHECK(lock >= 0);
+    CHECK_EQ(audio_ipc::lock_socket(path, 100), -1); // zweiter Daemon gibt auf
+    int listener = audio_ipc::listen_socket(path);
+    struct stat st{};
+    CHECK_EQ(stat(path.c_str(), &st), 0);
+    CHECK_EQ(st.st_mode & 077, 0u); // nur der Benutzer
+    close(listener);
+
+    close(lock);
+    int next = audio_ipc::lock_socket(path, 0); // Vorgänger beendet: Sperre frei
+    CHECK(next >= 0);
+    close(next);
+}
+
+// Übergabe wie beim Verbinden; Meldungen tragen die Sitzung, Reste der vorigen erkennt man daran
+CAROS_TEST("audio_ipc/handoff_and_session") {
+    bench_data::TempDir dir;
+    std::string path = dir.path + "/audio.sock";
+    audio_ipc::Endpoint daemon;
+    CHECK(daemon.create());
+    int listener = audio_ipc::listen_socket(path);
+    CHECK(listener >= 0);
+
+    daemon.shared->events.push(audio_ipc::make_message(1, 0, 0.0, "alt", 0));
+    int client = audio_ipc::dial(path);
+    CHECK(client >= 0);
+    int accepted = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+    daemon.shared->status.session.fetch_add(1);
+    CHECK(audio_ipc::send_fds(accepted, daemon));
+    close(accepted);
+
+    audio_ipc::Endpoint ui;
+    CHECK(audio_ipc::receive(client, ui));
+    close(client);
+    uint32_t session = ui.shared->status.session.load();
+    CHECK_EQ(session, 1u);
+    daemon.shared->events.push(audio_ipc::make_message(1, 0, 0.0, "neu", session));
+
+    audio_ipc::Message m;
+    CHECK(ui.shared->events.pop(m));
+    CHECK(m.session != session);
+    CHECK(ui.shared->events.pop(m));
+    CHECK_EQ(m.session, session);
+    CHECK_EQ(std::string(m.text, m.text_len), std::string("neu"));
+
+    ui.close_all();
+    daemon.close_all();
+    close(listener);
+}
+
+// Varianten-Wechsel: die Lautheit hängt am Sender, nicht an der URL der Variante
+CAROS_TEST("audio_ipc/play_text_carries_station") {
+    std::string uri, station;
+    audio_ipc::split_play_text(audio_ipc::play_text("http://x/64", "http://x/128"), uri, station);
+    CHECK_EQ(uri, std::string("http://x/64"));
+    CHECK_EQ(station, std::string("http://x/128"));
+
+    audio_ipc::split_play_text(audio_ipc::play_text("http://x/64", ""), uri, station);
+    CHECK_EQ(station, std::string("http://x/64"));
+    std::string long_url(audio_ipc::TEXT_SIZE - 10, 'u');
+    CHECK_EQ(audio_ipc::play_text(long_url, "http://x/128"), long_url); // passt nicht: URL = Sender
+}
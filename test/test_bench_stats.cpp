@@ -0,0 +1,36 @@
+#include <cmath>
+
+#include "bench.hpp"
+#include "test.hpp"
+
+CAROS_TEST("bench/percentile_interpolates") {
+    std::vector<double> v = {1, 2, 3, 4, 5};
+    CHECK_EQ(bench::percentile(v, 0), 1.0);
+    CHECK_EQ(bench::percentile(v, 50), 3.0);
+    CHECK(std::abs(bench::percentile(v, 90) - 4.6) < 1e-9);
+    CHECK_EQ(bench::percentile(v, 100), 5.0);
+    CHECK_EQ(bench::percentile({}, 50), 0.0);
+}
+
+CAROS_TEST("bench/summarize") {
+    bench::Stats s = bench::summarize({4, 2, 8, 6}, 16);
+    CHECK_EQ(s.samples, 4u);
+    CHECK_EQ(s.batch, 16u);
+    CHECK_EQ(s.min_ns, 2.0);
+    CHECK_EQ(s.max_ns, 8.0);
+    CHECK_EQ(s.mean_ns, 5.0);
+    CHECK_EQ(s.p50_ns, 5.0);
+    CHECK(std::abs(s.stddev_ns - std::sqrt(20.0 / 3.0)) < 1e-9);
+}
+
+CAROS_TEST("bench/measure_runs_op") {
+    bench::Options opt;
+    opt.warmup_ms = 1;
+    opt.min_sample_us = 10;
+    opt.samples = 5;
+    opt.max_time_ms = 50;
+    uint64_t calls = 0;
+    bench::Stats s = bench::measure([&calls] { calls++; }, opt);
+    CHECK_EQ(s.samples, 5u);
+    CHECK(calls >= 5u * s.batch);
+}
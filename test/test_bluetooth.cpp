@@ -0,0 +1,49 @@
+#include <fstream>
+
+#include "bench_data.hpp"
+#include "bluetooth_known_devices.hpp"
+#include "test.hpp"
+
+// Zeitpunkte kommen vom Aufrufer (Unix-Sekunden), hier eine feste Uhr statt der Systemzeit
+CAROS_TEST("bluetooth/known_devices_ranking") {
+    bench_data::TempDir dir;
+    std::string path = dir.path + "/known.csv";
+    {
+        KnownDeviceStore store(path);
+        store.record_connected("AA:00:00:00:00:01", "Telefon", 1000);
+        store.record_connected("AA:00:00:00:00:02", "Tablet", 3000);
+        store.record_connected("AA:00:00:00:00:03", "Auto;Kit", 2000);
+        store.record_connected("AA:00:00:00:00:03", "", 2000); // gleiche Zeit, jetzt häufiger
+        store.record_connected("AA:00:00:00:00:04", "Uhr", 2000);
+    }
+
+    // Neu geladen: zuletzt verbunden zuerst, bei gleicher Zeit das häufiger verbundene
+    KnownDeviceStore store(path);
+    auto ranked = store.ranked(10);
+    CHECK_EQ(ranked.size(), 4u);
+    CHECK_EQ(ranked[0].address, std::string("AA:00:00:00:00:02"));
+    CHECK_EQ(ranked[1].address, std::string("AA:00:00:00:00:03"));
+    CHECK_EQ(ranked[1].connect_count, 2);
+    CHECK_EQ(ranked[1].name, std::string("Auto Kit")); // ';' würde die CSV zerlegen
+    CHECK_EQ(ranked[2].address, std::string("AA:00:00:00:00:04"));
+    CHECK_EQ(ranked[3].address, std::string("AA:00:00:00:00:01"));
+
+    // Der Reconnect fragt höchstens MAX_PARALLEL Geräte gleichzeitig an
+    CHECK_EQ(store.ranked(3).size(), 3u);
+    CHECK(store.contains("AA:00:00:00:00:01"));
+    CHECK(!store.contains("AA:00:00:00:00:05"));
+
+    store.record_connected("AA:00:00:00:00:01", "Telefon", 4000);
+    ranked = store.ranked(1);
+    CHECK_EQ(ranked[0].address, std::string("AA:00:00:00:00:01"));
+}
+
+CAROS_TEST("bluetooth/known_devices_ignores_broken_lines") {
+    bench_data::TempDir dir;
+    std::string path = dir.path + "/known.csv";
+    std::ofstream(path) << "AA:00:00:00:00:01;Telefon;3;100\nkaputt\n;;\nAA:00:00:00:00:02;Tablet;1;200\n";
+    KnownDeviceStore store(path);
+    auto ranked = store.ranked(10);
+    CHECK_EQ(ranked.size(), 2u);
+    CHECK_EQ(ranked[0].address, std::string("AA:00:00:00:00:02"));
+}
@@ -0,0 +1,134 @@
+#include <fstream>
+
+#include "bench_data.hpp"
+#include "input_trace.hpp"
+#include "test.hpp"
+
+namespace {
+
+InputEvent round_trip(const InputEvent& e) {
+    InputEvent back;
+    CHECK(parse_input_event(format_input_event(e), back));
+    CHECK_EQ(back.time_us, e.time_us);
+    CHECK(back.source == e.source);
+    return back;
+}
+
+} // namespace
+
+CAROS_TEST("input_trace/encoder_and_gps") {
+    InputEvent e;
+    e.time_us = 1234567;
+    e.encoder = {27, 987654321012ull, true};
+    InputEvent back = round_trip(e);
+    CHECK_EQ(back.encoder.line, 27u);
+    CHECK_EQ(back.encoder.timestamp_ns, 987654321012ull);
+    CHECK(back.encoder.b_active);
+
+    InputEvent g;
+    g.source = InputSource::Gps;
+    g.gps.mode = 3;
+    g.gps.latitude = 48.137154123456789;
+    g.gps.longitude = -11.575382;
+    g.gps.speed_ms = 0.1;
+    g.gps.satellites_used = 11;
+    back = round_trip(g);
+    CHECK_EQ(back.gps.latitude, g.gps.latitude); // bitgenau
+    CHECK_EQ(back.gps.longitude, g.gps.longitude);
+    CHECK_EQ(back.gps.speed_ms, g.gps.speed_ms);
+    CHECK_EQ(back.gps.satellites_used, 11);
+}
+
+CAROS_TEST("input_trace/bluetooth") {
+    InputEvent e;
+    e.source = InputSource::Bluetooth;
+    e.bt_path = "/org/bluez/hci0/dev_00_11_22_33_44_55";
+    e.bt.address = std::string("00:11:22:33:44:55");
+    e.bt.name = std::string("Auto\tTelefon\\2");
+    e.bt.paired = false;
+    e.bt.rssi = static_cast<int16_t>(-67);
+    InputEvent back = round_trip(e);
+    CHECK_EQ(back.bt_path, e.bt_path);
+    CHECK(back.bt.address && *back.bt.address == "00:11:22:33:44:55");
+    CHECK(back.bt.name && *back.bt.name == "Auto\tTelefon\\2");
+    CHECK(!back.bt.alias);
+    CHECK(back.bt.paired && !*back.bt.paired);
+    CHECK(!back.bt.connected);
+    CHECK(back.bt.rssi && *back.bt.rssi == -67);
+    CHECK(!back.bt_removed);
+
+    InputEvent gone;
+    gone.source = InputSource::Bluetooth;
+    gone.bt_path = e.bt_path;
+    gone.bt_removed = true;
+    CHECK(round_trip(gone).bt_removed);
+
+    InputEvent lost;
+    lost.source = InputSource::Bluetooth;
+    lost.bt_path = e.bt_path;
+    lost.bt.rssi_invalidated = true;
+    CHECK(round_trip(lost).bt.rssi_invalidated);
+}
+
+CAROS_TEST("input_trace/stream") {
+    InputEvent e;
+    e.source = InputSource::Stream;
+    e.stream.kind = StreamBusEvent::Kind::Title;
+    e.stream.text = "Interpret - Titel\nmit Umbruch";
+    CHECK_EQ(round_trip(e).stream.text, e.stream.text);
+
+    e.stream.kind = StreamBusEvent::Kind::Buffering;
+    e.stream.percent = 42;
+    e.stream.kbps = 131.5;
+    InputEvent back = round_trip(e);
+    CHECK(back.stream.kind == StreamBusEvent::Kind::Buffering);
+    CHECK_EQ(back.stream.percent, 42);
+    CHECK_EQ(back.stream.kbps, 131.5);
+
+    e.stream.kind = StreamBusEvent::Kind::Error;
+    e.stream.text = "Could not resolve host";
+    CHECK(round_trip(e).stream.kind == StreamBusEvent::Kind::Error);
+}
+
+CAROS_TEST("input_trace/rejects_garbage") {
+    InputEvent e;
+    CHECK(!parse_input_event("", e));
+    CHECK(!parse_input_event("12\tenc\t27", e));
+    CHECK(!parse_input_event("x\ttitle\ta", e));
+    CHECK(!parse_input_event("12\tgps\t3\tnord\t1\t0\t4", e));
+    CHECK(!parse_input_event("12\tbt\t/p\tcolor=blau", e));
+    CHECK(!parse_input_event("12\tmidi\t1", e));
+}
+
+CAROS_TEST("input_trace/record_and_load") {
+    bench_data::TempDir dir;
+    std::string path = dir.path + "/input.trace";
+    InputRecorder& rec = InputRecorder::instance();
+    CHECK(rec.start(path));
+    rec.record_encoder({27, 1000, false});
+    rec.record_gps(GpsReport{3, 48.1, 11.5, 2.0, 8});
+    rec.record_bluetooth("/org/bluez/hci0/dev_1", {}, true);
+    rec.record_stream({StreamBusEvent::Kind::Buffering, 100, 256.0, ""});
+    rec.stop();
+    CHECK(!rec.active());
+    rec.record_encoder({27, 2000, false}); // nach stop() ignoriert
+
+    std::vector<InputEvent> events;
+    std::string error;
+    CHECK(load_input_trace(path, events, error));
+    CHECK_EQ(events.size(), 4u);
+    CHECK(events[0].source == InputSource::Encoder);
+    CHECK(events[3].source == InputSource::Stream);
+    for (size_t i = 1; i < events.size(); i++) CHECK(events[i].time_us >= events[i - 1].time_us);
+
+    std::ofstream(path, std::ios::app) << "kaputt\n";
+    events.clear();
+    CHECK(!load_input_trace(path, events, error));
+    CHECK(error.find(":6:") != std::string::npos);
+}
+
+CAROS_TEST("input_trace/replay_schedule") {
+    CHECK_EQ(replay_due_us(1000000, 1.0), 1000000);
+    CHECK_EQ(replay_due_us(1000000, 10.0), 100000);
+    CHECK_EQ(replay_due_us(1000000, 0.0), 0);
+}
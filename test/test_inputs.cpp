@@ -0,0 +1,56 @@
+#include <cmath>
+
+#include "encoder_decoder.hpp"
+#include "gps_fix.hpp"
+#include "stream_metadata.hpp"
+#include "test.hpp"
+
+CAROS_TEST("inputs/encoder_direction_and_pin_filter") {
+    EncoderDecoder decoder(27);
+    bool clockwise = false;
+    CHECK(decoder.feed({27, 1000, true}, clockwise));
+    CHECK(clockwise);
+    CHECK(decoder.feed({27, 2000, false}, clockwise));
+    CHECK(!clockwise);
+    CHECK(!decoder.feed({17, 3000, true}, clockwise)); // Pin B allein ist kein Schritt
+    CHECK_EQ(decoder.steps(), 2u);
+}
+
+CAROS_TEST("inputs/encoder_debounce") {
+    EncoderDecoder decoder(27, 5000000);
+    bool clockwise = false;
+    CHECK(decoder.feed({27, 10000000, true}, clockwise));
+    CHECK(!decoder.feed({27, 11000000, true}, clockwise));
+    CHECK(decoder.feed({27, 16000000, true}, clockwise));
+    CHECK_EQ(decoder.steps(), 2u);
+    CHECK_EQ(decoder.bounces(), 1u);
+}
+
+CAROS_TEST("inputs/gps_report") {
+    GpsReport r;
+    r.mode = 3;
+    r.latitude = 48.1;
+    r.longitude = 11.5;
+    r.speed_ms = 10.0;
+    r.satellites_used = 7;
+    GPSData d = gps_data_from_report(r);
+    CHECK(d.fix);
+    CHECK(std::abs(d.speed - 36.0) < 1e-9);
+    CHECK_EQ(d.satellites, 7);
+
+    r.mode = 1;
+    CHECK(!gps_data_from_report(r).fix);
+    r.mode = 2;
+    r.latitude = NAN;
+    CHECK(!gps_data_from_report(r).fix);
+    r.latitude = 48.1;
+    r.speed_ms = NAN;
+    CHECK_EQ(gps_data_from_report(r).speed, 0.0);
+}
+
+CAROS_TEST("inputs/stream_title") {
+    CHECK_EQ(format_stream_title(" Die Ärzte ", "Westerland\n"), "Die Ärzte - Westerland");
+    CHECK_EQ(format_stream_title(nullptr, "Nachrichten"), "Nachrichten");
+    CHECK_EQ(format_stream_title("  ", nullptr), "Stream läuft...");
+    CHECK_EQ(format_stream_title("Interpret", ""), "Interpret - Stream läuft...");
+}
@@ -0,0 +1,188 @@
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "bench_data.hpp"
+#include "loudness.hpp"
+#include "station_gain_store.hpp"
+#include "test.hpp"
+
+namespace {
+
+// Mono-Sinus, amplitude_dbfs bezogen auf den Spitzenwert
+std::vector<float> sine(int rate, double freq, double amplitude_dbfs, double seconds, double phase = 0.0) {
+    double a = std::pow(10.0, amplitude_dbfs / 20.0);
+    std::vector<float> out(static_cast<size_t>(rate * seconds));
+    for (size_t n = 0; n < out.size(); n++) out[n] = static_cast<float>(a * std::sin(2 * M_PI * freq * n / rate + phase));
+    return out;
+}
+
+// In 100-ms-Puffern wie aus der Pipeline
+double measure(int rate, const std::vector<float>& signal) {
+    LoudnessMeter meter;
+    meter.configure(rate, 1);
+    size_t block = static_cast<size_t>(rate / 10);
+    for (size_t done = 0; done < signal.size(); done += block) {
+        meter.process(signal.data() + done, std::min(block, signal.size() - done));
+    }
+    return meter.integrated_lufs();
+}
+
+// Kanäle interleaved zusammenlegen (gleich lang)
+std::vector<float> interleave(const std::vector<std::vector<float>>& channels) {
+    std::vector<float> out(channels[0].size() * channels.size());
+    for (size_t n = 0; n < channels[0].size(); n++) {
+        for (size_t c = 0; c < channels.size(); c++) out[n * channels.size() + c] = channels[c][n];
+    }
+    return out;
+}
+
+double measure_interleaved(int rate, int channel_count, const std::vector<float>& signal) {
+    LoudnessMeter meter;
+    meter.configure(rate, channel_count);
+    size_t block = static_cast<size_t>(rate / 10);
+    size_t frames = signal.size() / channel_count;
+    for (size_t done = 0; done < frames; done += block) {
+        meter.process(signal.data() + done * channel_count, std::min(block, frames - done));
+    }
+    return meter.integrated_lufs();
+}
+
+} // namespace
+
+// EBU Tech 3341: 1 kHz bei -20 dBFS (ein Kanal) ergibt -23,0 LUFS
+CAROS_TEST("loudness/sine_1k_48k") {
+    double lufs = measure(48000, sine(48000, 1000.0, -20.0, 20.0));
+    CHECK(std::fabs(lufs - (-23.0)) <= 0.1);
+}
+
+CAROS_TEST("loudness/sine_1k_44k1") {
+    double lufs = measure(44100, sine(44100, 1000.0, -20.0, 20.0));
+    CHECK(std::fabs(lufs - (-23.0)) <= 0.1);
+}
+
+CAROS_TEST("loudness/below_absolute_gate") {
+    LoudnessMeter meter;
+    meter.configure(48000, 1);
+    std::vector<float> quiet = sine(48000, 1000.0, -80.0, 10.0);
+    meter.process(quiet.data(), quiet.size());
+    CHECK(std::isinf(meter.integrated_lufs()) && meter.integrated_lufs() < 0);
+    CHECK_EQ(meter.gated_seconds(), 0.0);
+}
+
+// Leises Intro bei -53 LUFS: über dem absoluten Gate, aber mehr als 10 LU unter dem Rest.
+// Ungegatet läge das Mittel bei etwa -26 LUFS.
+CAROS_TEST("loudness/relative_gate_excludes_quiet_blocks") {
+    std::vector<float> signal = sine(48000, 1000.0, -50.0, 20.0);
+    std::vector<float> loud = sine(48000, 1000.0, -20.0, 20.0);
+    signal.insert(signal.end(), loud.begin(), loud.end());
+
+    LoudnessMeter meter;
+    meter.configure(48000, 1);
+    meter.process(signal.data(), signal.size());
+    CHECK(meter.gated_seconds() > 39.0); // die leisen Blöcke liegen über dem absoluten Gate
+    CHECK(std::fabs(meter.integrated_lufs() - (-23.0)) <= 0.1);
+}
+
+// Sehr leiser Sender (~-63 LUFS): +45 dB wären nötig, angewendet werden höchstens MAX_GAIN_DB
+CAROS_TEST("loudness/normalizer_clamps_gain") {
+    LoudnessNormalizer norm;
+    norm.configure(48000, 1);
+    norm.start_stream(0.0);
+    std::vector<float> in = sine(48000, 1000.0, -60.0, 30.0);
+    std::vector<float> out = in;
+    for (size_t done = 0; done < out.size(); done += 4800) norm.process(out.data() + done, 4800);
+
+    CHECK(norm.has_estimate());
+    CHECK_EQ(norm.learned_gain_db(), LoudnessNormalizer::MAX_GAIN_DB);
+    size_t last = out.size() - 12; // ein Sample nahe dem Spitzenwert
+    while (std::fabs(in[last]) < 1e-4f) last--;
+    double applied_db = 20.0 * std::log10(out[last] / in[last]);
+    CHECK(std::fabs(applied_db - LoudnessNormalizer::MAX_GAIN_DB) < 0.01);
+}
+
+// Korrekturen nach dem Messen laufen mit höchstens SLEW_DB_PER_S
+CAROS_TEST("loudness/normalizer_slew_rate") {
+    constexpr int RATE = 48000;
+    constexpr size_t BLOCK = RATE / 10;
+    LoudnessNormalizer norm;
+    norm.configure(RATE, 1);
+    norm.start_stream(0.0);
+    // -6 dBFS ergibt ~-9 LUFS, Ziel also ~-9 dB; Phase so, dass jeder Block mit einem Spitzenwert endet
+    std::vector<float> in = sine(RATE, 1000.0, -6.0, 10.0, M_PI / 2 + 2 * M_PI * 1000.0 / RATE);
+    std::vector<float> out = in;
+
+    double previous_db = 0.0;
+    double steepest = 0.0;
+    for (size_t done = 0; done < out.size(); done += BLOCK) {
+        norm.process(out.data() + done, BLOCK);
+        size_t last = done + BLOCK - 1;
+        double db = 20.0 * std::log10(out[last] / in[last]);
+        steepest = std::max(steepest, std::fabs(db - previous_db));
+        previous_db = db;
+    }
+    double per_block = LoudnessNormalizer::SLEW_DB_PER_S * BLOCK / RATE;
+    CHECK(steepest <= per_block + 5e-3); // Rest: float-Auflösung der Verstärkung im Sample
+    CHECK(steepest > per_block * 0.9); // die Rampe läuft tatsächlich am Limit
+    // 3 s Messen, danach höchstens 7 s Rampe: noch nicht am Ziel, aber auf dem Weg
+    CHECK(norm.learned_gain_db() < -8.0);
+    CHECK(previous_db < -6.0 && previous_db > norm.learned_gain_db());
+}
+
+// EBU Tech 3341 Fall 1: 1 kHz bei -23 dBFS auf beiden Kanälen ergibt -23,0 LUFS, die Leistungen
+// der Kanäle addieren sich (G = 1 für L und R). Ein Kanal allein liegt 3 dB darunter.
+CAROS_TEST("loudness/stereo_channel_sum") {
+    std::vector<float> tone = sine(48000, 1000.0, -23.0, 20.0);
+    std::vector<float> silence(tone.size(), 0.0f);
+    double both = measure_interleaved(48000, 2, interleave({tone, tone}));
+    double left = measure_interleaved(48000, 2, interleave({tone, silence}));
+    double right = measure_interleaved(48000, 2, interleave({silence, tone}));
+    CHECK(std::fabs(both - (-23.0)) <= 0.1);
+    CHECK(std::fabs(left - (-26.0)) <= 0.1);
+    CHECK(std::fabs(right - left) <= 0.01);
+
+    // Die Phasenlage zwischen den Kanälen zählt nicht: summiert wird die Leistung, nicht das Signal
+    std::vector<float> other = sine(48000, 1000.0, -23.0, 20.0, M_PI / 3);
+    CHECK(std::fabs(measure_interleaved(48000, 2, interleave({tone, other})) - (-23.0)) <= 0.1);
+
+    // Mehr als zwei Kanäle: gemessen werden nur L und R, der Rest wird übersprungen
+    std::vector<float> loud = sine(48000, 1000.0, -3.0, 20.0);
+    double surround = measure_interleaved(48000, 4, interleave({tone, tone, loud, loud}));
+    CHECK(std::fabs(surround - (-23.0)) <= 0.1);
+}
+
+CAROS_TEST("loudness/gain_store_round_trip") {
+    bench_data::TempDir dir;
+    std::string path = dir.path + "/loudness_gains.csv";
+    {
+        StationGainStore store(path);
+        double gain = 0.0;
+        CHECK(!store.lookup("http://a.example/live", gain));
+        store.record("http://a.example/live", -4.26);
+        store.record("http://b.example/stream;type=mp3", 7.5); // ';' in der URL, getrennt wird am letzten
+        store.record("http://c.example/", 12.0);
+    }
+
+    StationGainStore reloaded(path);
+    double gain = 0.0;
+    CHECK(reloaded.lookup("http://a.example/live", gain));
+    CHECK_EQ(gain, -4.3); // auf 0,1 dB gerundet
+    CHECK(reloaded.lookup("http://b.example/stream;type=mp3", gain));
+    CHECK_EQ(gain, 7.5);
+    CHECK(reloaded.lookup("http://c.example/", gain));
+    CHECK_EQ(gain, 12.0);
+    CHECK(!reloaded.lookup("http://b.example/stream", gain));
+
+    // Unter 0,1 dB Änderung wird nicht geschrieben
+    reloaded.record("http://c.example/", 12.04);
+    std::ofstream(path, std::ios::app) << "http://d.example/;1.5\n"; // nur in der Datei
+    reloaded.load();
+    CHECK(reloaded.lookup("http://d.example/", gain));
+    CHECK_EQ(gain, 1.5);
+    reloaded.record("http://c.example/", 11.0);
+    StationGainStore again(path);
+    CHECK(again.lookup("http://c.example/", gain));
+    CHECK_EQ(gain, 11.0);
+    CHECK(again.lookup("http://d.example/", gain)); // beim Speichern mitgeschrieben
+}
@@ -0,0 +1,31 @@
+// Runner für bin/caros-tests: führt alle Tests aus (oder die, deren Name das Argument enthält)
+
+#include <cstdio>
+#include <exception>
+
+#include "test.hpp"
+
+int main(int argc, char **argv) {
+    const char *filter = argc > 1 ? argv[1] : nullptr;
+    int run = 0, failed = 0, skipped = 0;
+    for (const auto& t : test::registry()) {
+        if (filter && t.name.find(filter) == std::string::npos) continue;
+        run++;
+        try {
+            t.body();
+            std::printf("ok      %s\n", t.name.c_str());
+        } catch (const test::Skipped& s) {
+            skipped++;
+            std::printf("skip    %s (%s)\n", t.name.c_str(), s.reason.c_str());
+        } catch (const test::Failure&) {
+            failed++;
+            std::printf("FEHLER  %s\n", t.name.c_str());
+        } catch (const std::exception& e) {
+            failed++;
+            std::printf("FEHLER  %s (Ausnahme: %s)\n", t.name.c_str(), e.what());
+        }
+    }
+    if (skipped) std::printf("\n%d Tests, %d fehlgeschlagen, %d übersprungen\n", run, failed, skipped);
+    else std::printf("\n%d Tests, %d fehlgeschlagen\n", run, failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <sys/stat.h>
+
+#include "bench_data.hpp"
+#include "media_index.hpp"
+#include "test.hpp"
+
+namespace {
+
+MediaTrack track(const std::string& path) {
+    MediaTrack t;
+    t.path = path;
+    t.title = path;
+    return t;
+}
+
+void write_file(const std::string& path, const std::string& data) {
+    std::ofstream out(path, std::ios::binary);
+    out << data;
+}
+
+} // namespace
+
+CAROS_TEST("media_index/remove_batches_until_compact") {
+    MediaIndex index;
+    index.assign({track("a/1.mp3"), track("a/2.mp3"), track("b/1.mp3"), track("b/2.mp3"), track("c.mp3")});
+
+    CHECK_EQ(index.remove("a/1.mp3"), 1u);
+    CHECK_EQ(index.remove("a/1.mp3"), 0u);
+    CHECK_EQ(index.remove("b/"), 2u);
+    CHECK_EQ(index.size(), 2u);
+    CHECK(index.find("a/1.mp3") == nullptr);
+    CHECK(index.find("b/2.mp3") == nullptr);
+    CHECK(index.find("c.mp3") != nullptr);
+    CHECK_EQ(index.find("c.mp3")->title, "c.mp3");
+
+    // Wieder angelegt, bevor aufgeräumt wurde
+    index.upsert(track("b/1.mp3"));
+    CHECK_EQ(index.size(), 3u);
+
+    index.compact();
+    CHECK_EQ(index.all().size(), 3u);
+    std::set<std::string> paths;
+    for (const auto& t : index.all()) paths.insert(t.path);
+    CHECK(paths == std::set<std::string>({"a/2.mp3", "b/1.mp3", "c.mp3"}));
+    CHECK_EQ(index.find("c.mp3")->path, "c.mp3");
+}
+
+CAROS_TEST("media_index/save_skips_removed") {
+    bench_data::TempDir dir;
+    MediaIndex index;
+    index.assign({track("1.mp3"), track("2.mp3")});
+    index.remove("1.mp3");
+    CHECK(index.save(dir.path + "/index.idx"));
+
+    MediaIndex loaded;
+    CHECK(loaded.load(dir.path + "/index.idx"));
+    CHECK_EQ(loaded.size(), 1u);
+    CHECK(loaded.find("2.mp3") != nullptr);
+}
+
+// Erweiterter ID3v2-Header gesetzt, aber die Datei endet direkt nach dem Kopf
+CAROS_TEST("media_index/id3_extended_header_truncated") {
+    bench_data::TempDir dir;
+    std::string path = dir.path + "/kurz.mp3";
+    write_file(path, std::string("ID3\x03\x00\x40\x00\x00\x00\x7f\x00\x00", 12));
+    MediaTrack t;
+    t.path = "kurz.mp3";
+    MediaTagReader::read(path, t);
+    CHECK_EQ(t.title, "kurz");
+}
+
+CAROS_TEST("media_index/scan_reports_each_directory") {
+    bench_data::TempDir dir;
+    mkdir((dir.path + "/Album").c_str(), 0755);
+    write_file(dir.path + "/Album/1.mp3", "x");
+    write_file(dir.path + "/0.mp3", "x");
+
+    std::mutex mutex; // zwei Worker rufen gleichzeitig auf
+    std::set<std::string> seen;
+    MediaScanResult result = MediaScanner::scan(dir.path, MediaIndex(), 2, "", [&](const std::string& rel) {
+        std::lock_guard<std::mutex> lock(mutex);
+        seen.insert(rel);
+    });
+    CHECK_EQ(result.stats.files, 2u);
+    CHECK(seen.count(""));
+    CHECK(seen.count("Album"));
+}
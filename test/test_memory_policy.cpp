@@ -0,0 +1,159 @@
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "bench_data.hpp"
+#include "memory_policy.hpp"
+#include "test.hpp"
+
+namespace {
+
+constexpr int64_t S = 1000000;
+
+// Nachgebaute Quellen wie unter CAROS_PSI_FAKE und CAROS_CGROUP_DIR
+struct FakeSources {
+    bench_data::TempDir dir;
+
+    std::string psi() const { return dir.path + "/memory"; }
+    std::string cgroup() const { return dir.path + "/cgroup/app.slice"; }
+
+    void set_psi(double some_avg10, double full_avg10) {
+        std::ofstream(psi()) << "some avg10=" << some_avg10 << " avg60=0.00 avg300=0.00 total=1234\n"
+                             << "full avg10=" << full_avg10 << " avg60=0.00 avg300=0.00 total=567\n";
+    }
+
+    void set_cgroup(const std::string& max, long current) {
+        std::system(("mkdir -p '" + cgroup() + "'").c_str());
+        std::ofstream(cgroup() + "/memory.max") << max << "\n";
+        std::ofstream(cgroup() + "/memory.current") << current << "\n";
+    }
+};
+
+// Verbraucher, die ihre Aufrufe in ein gemeinsames Protokoll schreiben
+struct Consumers {
+    std::vector<std::string> calls;
+
+    void add(MemoryBudget& budget, const std::string& name) {
+        budget.add_consumer(MemoryConsumer{name, nullptr,
+                                           [this, name]() { calls.push_back("shed " + name); },
+                                           [this, name]() { calls.push_back("restore " + name); }});
+    }
+};
+
+} // namespace
+
+CAROS_TEST("memory/read_psi") {
+    FakeSources src;
+    CHECK(MemoryBudget::read_psi(src.psi()) == MemoryPressure::Normal); // Datei fehlt
+    src.set_psi(3.5, 0.0);
+    CHECK(MemoryBudget::read_psi(src.psi()) == MemoryPressure::Normal);
+    src.set_psi(12.0, 1.0);
+    CHECK(MemoryBudget::read_psi(src.psi()) == MemoryPressure::Moderate);
+    src.set_psi(12.0, 6.0);
+    CHECK(MemoryBudget::read_psi(src.psi()) == MemoryPressure::Critical);
+    // "full" allein reicht für kritisch
+    src.set_psi(0.0, 5.0);
+    CHECK(MemoryBudget::read_psi(src.psi()) == MemoryPressure::Critical);
+}
+
+CAROS_TEST("memory/read_cgroup") {
+    FakeSources src;
+    double ratio = -1.0;
+    CHECK(MemoryBudget::read_cgroup("", &ratio) == MemoryPressure::Normal);
+    CHECK(MemoryBudget::read_cgroup(src.cgroup(), &ratio) == MemoryPressure::Normal);
+    CHECK_EQ(ratio, -1.0);
+
+    src.set_cgroup("max", 900);
+    CHECK(MemoryBudget::read_cgroup(src.cgroup(), &ratio) == MemoryPressure::Normal);
+    CHECK_EQ(ratio, -1.0);
+
+    src.set_cgroup("1000", 500);
+    CHECK(MemoryBudget::read_cgroup(src.cgroup(), &ratio) == MemoryPressure::Normal);
+    CHECK_EQ(ratio, 0.5);
+    src.set_cgroup("1000", 800);
+    CHECK(MemoryBudget::read_cgroup(src.cgroup(), &ratio) == MemoryPressure::Moderate);
+    src.set_cgroup("1000", 950);
+    CHECK(MemoryBudget::read_cgroup(src.cgroup(), &ratio) == MemoryPressure::Critical);
+    CHECK_EQ(ratio, 0.95);
+}
+
+CAROS_TEST("memory/detect_cgroup_dir") {
+    FakeSources src;
+    std::string proc = src.dir.path + "/proc_cgroup";
+    std::string mount = src.dir.path + "/cgroup";
+    std::ofstream(proc) << "0::/app.slice\n";
+    CHECK_EQ(MemoryBudget::detect_cgroup_dir(proc, mount), std::string()); // noch kein memory.max
+    src.set_cgroup("1000", 1);
+    CHECK_EQ(MemoryBudget::detect_cgroup_dir(proc, mount), src.cgroup());
+    // cgroup v1 ohne "0::"-Zeile
+    std::ofstream(proc) << "4:memory:/app.slice\n";
+    CHECK_EQ(MemoryBudget::detect_cgroup_dir(proc, mount), std::string());
+}
+
+// Moderat: einer nach dem anderen mit SHED_COOLDOWN_US Abstand; kritisch: alle sofort;
+// zurück erst nach RESTORE_AFTER_S ohne Druck, in umgekehrter Reihenfolge
+CAROS_TEST("memory/shed_and_restore_order") {
+    FakeSources src;
+    MemoryBudget budget;
+    Consumers log;
+    log.add(budget, "logos");
+    log.add(budget, "stream_buffers");
+    log.add(budget, "offscreen_pages");
+    int64_t now = 100 * S;
+    auto tick = [&]() {
+        return budget.evaluate(MemoryBudget::read_psi(src.psi()),
+                               MemoryBudget::read_cgroup(src.cgroup(), nullptr), now);
+    };
+
+    src.set_psi(12.0, 0.0);
+    CHECK(tick());
+    CHECK(budget.level() == MemoryPressure::Moderate);
+    CHECK(log.calls == std::vector<std::string>{"shed logos"});
+    now += 1 * S;
+    CHECK(!tick());
+    CHECK_EQ(log.calls.size(), size_t{1});
+    now += MemoryBudget::SHED_COOLDOWN_US;
+    tick();
+    CHECK_EQ(log.calls.back(), std::string("shed stream_buffers"));
+
+    // cgroup am Limit -> kritisch, der Rest sofort
+    src.set_cgroup("1000", 990);
+    now += 1 * S;
+    CHECK(tick());
+    CHECK(budget.level() == MemoryPressure::Critical);
+    CHECK_EQ(log.calls.back(), std::string("shed offscreen_pages"));
+    CHECK_EQ(log.calls.size(), size_t{3});
+
+    src.set_psi(0.0, 0.0);
+    src.set_cgroup("1000", 100);
+    now += 1 * S;
+    CHECK(tick());
+    CHECK(budget.level() == MemoryPressure::Normal);
+    now += (MemoryBudget::RESTORE_AFTER_S - 2) * S;
+    tick();
+    CHECK_EQ(log.calls.size(), size_t{3});
+    now += 2 * S;
+    tick();
+    CHECK((log.calls == std::vector<std::string>{"shed logos", "shed stream_buffers", "shed offscreen_pages",
+                                                 "restore offscreen_pages", "restore stream_buffers", "restore logos"}));
+}
+
+// Ein Kernel-Trigger hebt die Stufe TRIGGER_HOLD_US lang an, auch wenn avg10 noch nichts zeigt
+CAROS_TEST("memory/trigger_holds_two_seconds") {
+    FakeSources src;
+    src.set_psi(0.0, 0.0);
+    MemoryBudget budget;
+    Consumers log;
+    log.add(budget, "logos");
+    int64_t now = 100 * S;
+
+    budget.trigger(MemoryPressure::Critical, now);
+    CHECK(budget.evaluate(MemoryBudget::read_psi(src.psi()), MemoryPressure::Normal, now));
+    CHECK(budget.level() == MemoryPressure::Critical);
+    CHECK(log.calls == std::vector<std::string>{"shed logos"});
+    budget.evaluate(MemoryBudget::read_psi(src.psi()), MemoryPressure::Normal, now + MemoryBudget::TRIGGER_HOLD_US);
+    CHECK(budget.level() == MemoryPressure::Critical);
+    budget.evaluate(MemoryBudget::read_psi(src.psi()), MemoryPressure::Normal, now + MemoryBudget::TRIGGER_HOLD_US + 1);
+    CHECK(budget.level() == MemoryPressure::Normal);
+}
@@ -0,0 +1,32 @@
+#include <string>
+
+#include "metrics.hpp"
+#include "test.hpp"
+
+namespace {
+
+size_t count_lines(const std::string& text, const std::string& needle) {
+    size_t n = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) n++;
+    return n;
+}
+
+} // namespace
+
+// Prometheus verlangt über alle Scrapes dieselben le-Grenzen, egal welche Werte schon kamen
+CAROS_TEST("metrics/histogram_fixed_buckets") {
+    MetricsRegistry registry;
+    Histogram& h = registry.histogram("caros_test_latency_us", "Test");
+    std::string empty = registry.render_prometheus();
+    h.record(3);
+    h.record(70000);
+    std::string filled = registry.render_prometheus();
+
+    CHECK_EQ(count_lines(empty, "_bucket{"), count_lines(filled, "_bucket{"));
+    CHECK_EQ(count_lines(filled, "_bucket{"), 21u);
+    CHECK(filled.find("caros_test_latency_us_bucket{le=\"3\"} 1\n") != std::string::npos);
+    CHECK(filled.find("caros_test_latency_us_bucket{le=\"65535\"} 1\n") != std::string::npos);
+    CHECK(filled.find("caros_test_latency_us_bucket{le=\"262143\"} 2\n") != std::string::npos);
+    CHECK(filled.find("caros_test_latency_us_bucket{le=\"+Inf\"} 2\n") != std::string::npos);
+    CHECK(filled.find("caros_test_latency_us_count 2\n") != std::string::npos);
+}
@@ -0,0 +1,188 @@
+#include <cmath>
+#include <sstream>
+
+#include "bench_data.hpp"
+#include "station_catalog.hpp"
+#include "station_store.hpp"
+#include "test.hpp"
+
+namespace {
+
+CatalogEntry entry(const std::string& uuid, const std::string& change, const std::string& name) {
+    CatalogEntry e;
+    e.uuid = uuid;
+    e.changeuuid = change;
+    e.name = name;
+    e.url = "https://" + uuid + ".example/live";
+    e.favicon = "https://" + uuid + ".example/logo.png";
+    return e;
+}
+
+bool always(const std::string&) { return true; }
+
+} // namespace
+
+CAROS_TEST("station_catalog/csv_round_trip") {
+    RadioStation s;
+    s.name = "Bayern 3";
+    s.url = "https://br.example/b3.mp3";
+    s.logo_path = "assets/logos/b3.png";
+    s.has_geo = true;
+    s.lat = 48.1371;
+    s.lon = 11.5754;
+    s.uuid = "u1";
+    s.changeuuid = "c1";
+    s.logo_url = "https://br.example/b3.png";
+    s.variants = {{"AAC", 64, "https://br.example/b3.aac?a|b"}, {"MP3", 128, s.url}};
+
+    std::ostringstream out;
+    write_station_line(out, s);
+    std::string line = out.str();
+    line.pop_back(); // Zeilenende
+
+    RadioStation back;
+    CHECK(parse_station_line(line, back));
+    CHECK_EQ(back.name, s.name);
+    CHECK_EQ(back.url, s.url);
+    CHECK_EQ(back.logo_path, s.logo_path);
+    CHECK(back.has_geo);
+    CHECK(std::abs(back.lat - s.lat) < 1e-6);
+    CHECK_EQ(back.uuid, "u1");
+    CHECK_EQ(back.changeuuid, "c1");
+    CHECK_EQ(back.logo_url, s.logo_url);
+    CHECK_EQ(back.variants.size(), 2u);
+    CHECK_EQ(back.variants[0].url, "https://br.example/b3.aac?a|b");
+    CHECK_EQ(back.variants[1].bitrate_kbps, 128);
+}
+
+CAROS_TEST("station_catalog/csv_legacy_line") {
+    RadioStation s;
+    CHECK(parse_station_line("Mein Sender;http://x.example/;assets/logos/default.png", s));
+    CHECK_EQ(s.name, "Mein Sender");
+    CHECK(!s.has_geo);
+    CHECK(s.uuid.empty());
+    CHECK(!parse_station_line("nur ein Feld", s));
+}
+
+CAROS_TEST("station_catalog/parse_json") {
+    std::string json = R"([{"stationuuid":"a","changeuuid":"1","name":"Köln \"Eins\"","url_resolved":"https://a/",
+        "tags":["x",{"y":1}],"bitrate":128,"codec":"MP3","geo_lat":50.9,"geo_long":6.9,"favicon":null},
+        {"stationuuid":"b","name":"ohne URL","url_resolved":""}])";
+    std::vector<CatalogEntry> list = CatalogParser::parse(json);
+    CHECK_EQ(list.size(), 1u);
+    CHECK_EQ(list[0].name, "Köln \"Eins\"");
+    CHECK_EQ(list[0].bitrate_kbps, 128);
+    CHECK(list[0].has_geo);
+    CHECK(CatalogParser::parse("kaputt").empty());
+}
+
+CAROS_TEST("station_catalog/diff_insert_noop_update") {
+    std::vector<CatalogEntry> remote = {entry("a", "1", "Eins"), entry("b", "1", "Zwei")};
+    CatalogDiff first = diff_catalog({}, remote);
+    CHECK_EQ(first.inserted, 2u);
+    CHECK_EQ(first.fetch_logo.size(), 2u);
+
+    CatalogDiff again = diff_catalog(first.stations, remote, {}, &always);
+    CHECK(!again.changed());
+    CHECK_EQ(again.unchanged, 2u);
+    CHECK(again.fetch_logo.empty());
+
+    remote[1].changeuuid = "2";
+    remote[1].name = "Zwei Neu";
+    CatalogDiff update = diff_catalog(first.stations, remote, {}, &always);
+    CHECK_EQ(update.updated, 1u);
+    CHECK_EQ(update.unchanged, 1u);
+    CHECK_EQ(update.stations[1].name, "Zwei Neu");
+    CHECK(update.fetch_logo.empty()); // favicon unverändert
+}
+
+CAROS_TEST("station_catalog/diff_delete_keeps_own_stations") {
+    std::vector<CatalogEntry> remote = {entry("a", "1", "Eins"), entry("b", "1", "Zwei")};
+    std::vector<RadioStation> local = diff_catalog({}, remote).stations;
+    local[1].logo_path = "assets/logos/b.png";
+    RadioStation own;
+    own.name = "Eigener";
+    own.url = "http://own/";
+    own.logo_path = DEFAULT_LOGO;
+    local.push_back(own);
+
+    CatalogDiff diff = diff_catalog(local, {remote[0]}, {}, &always, true);
+    CHECK_EQ(diff.deleted, 1u);
+    CHECK_EQ(diff.stale_logos.size(), 1u);
+    CHECK_EQ(diff.stations.size(), 2u);
+    CHECK_EQ(diff.stations[1].name, "Eigener");
+
+    CatalogDiff removed = diff_catalog({}, remote, {"b"});
+    CHECK_EQ(removed.stations.size(), 1u);
+}
+
+// Eine Top-N-Rangliste ist keine vollständige Liste: wer herausfällt, bleibt, bis der Katalog
+// (byuuid) bestätigt, dass es ihn nicht mehr gibt
+CAROS_TEST("station_catalog/partial_listing_keeps_missing") {
+    std::vector<CatalogEntry> remote = {entry("a", "1", "Eins"), entry("b", "1", "Zwei"), entry("c", "1", "Drei")};
+    std::vector<RadioStation> local = diff_catalog({}, remote).stations;
+    local[1].logo_path = "assets/logos/b.png";
+    local[2].logo_path = "assets/logos/c.png";
+
+    CatalogEntry fresh = entry("d", "1", "Vier");
+    fresh.favicon = "http://logo/d.png";
+    CatalogDiff diff = diff_catalog(local, {fresh, remote[0]}, {}, &always);
+    CHECK_EQ(diff.deleted, 0u);
+    CHECK(diff.stale_logos.empty());
+    CHECK_EQ(diff.stations.size(), 4u);
+    CHECK_EQ(diff.missing.size(), 2u);
+
+    confirm_deletions(diff, {"c", "x"});
+    CHECK_EQ(diff.deleted, 1u);
+    CHECK_EQ(diff.stations.size(), 3u);
+    CHECK_EQ(diff.stations[2].name, "Zwei");
+    CHECK_EQ(diff.stale_logos.size(), 1u);
+    CHECK_EQ(diff.stale_logos[0], "assets/logos/c.png");
+    CHECK_EQ(diff.missing.size(), 1u);
+    CHECK_EQ(diff.fetch_logo.size(), 1u);
+    CHECK_EQ(diff.stations[diff.fetch_logo[0]].name, "Vier");
+}
+
+CAROS_TEST("station_catalog/group_variants") {
+    CatalogEntry hi = entry("a", "1", "Deutschlandfunk | DLF | MP3 128k");
+    CatalogEntry lo = entry("b", "1", "Deutschlandfunk | DLF | AAC 64k");
+    CatalogEntry other = entry("c", "1", "Deutschlandfunk");
+    hi.homepage = lo.homepage = "https://www.dlf.example/";
+    other.homepage = "https://andere.example/";
+    hi.bitrate_kbps = 128;
+    lo.bitrate_kbps = 64;
+    CHECK_EQ(variant_key(hi.name, hi.homepage), variant_key(lo.name, lo.homepage));
+
+    std::vector<CatalogEntry> grouped = group_variants({hi, lo, other});
+    CHECK_EQ(grouped.size(), 2u);
+    CHECK_EQ(grouped[0].uuid, "a");
+    CHECK_EQ(grouped[0].variants.size(), 2u);
+    CHECK(grouped[1].variants.empty());
+
+    // Neue changeuuid einer Variante ändert die Gruppe
+    std::string before = grouped[0].changeuuid;
+    lo.changeuuid = "2";
+    CHECK(group_variants({hi, lo, other})[0].changeuuid != before);
+}
+
+CAROS_TEST("station_catalog/sync_is_idempotent") {
+    std::vector<CatalogEntry> remote = group_variants(CatalogParser::parse(bench_data::catalog_json(2000)));
+    CHECK(remote.size() > 1000u);
+    std::vector<RadioStation> local = diff_catalog({}, remote).stations;
+
+    bench_data::TempDir dir;
+    std::string path = dir.path + "/stations.csv";
+    CHECK(store_stations(local, path));
+    std::vector<RadioStation> loaded = load_stations(path);
+    CHECK_EQ(loaded.size(), local.size());
+
+    CatalogDiff again = diff_catalog(loaded, remote, {}, &always);
+    CHECK(!again.changed());
+    CHECK_EQ(again.unchanged, remote.size());
+
+    std::vector<CatalogEntry> changed = group_variants(CatalogParser::parse(bench_data::catalog_json(2000, 1, 100)));
+    CatalogDiff one_pct = diff_catalog(loaded, changed, {}, &always);
+    CHECK(one_pct.updated > 0u);
+    CHECK(one_pct.updated <= 40u);
+    CHECK_EQ(one_pct.inserted + one_pct.deleted, 0u);
+}
@@ -0,0 +1,47 @@
+#include <cmath>
+#include <vector>
+
+#include "station_geo_index.hpp"
+#include "test.hpp"
+
+namespace {
+
+// Zwei Sender in derselben 0,25°-Zelle, rund 25 km auseinander
+StationGeoIndex two_stations_one_cell() {
+    StationGeoIndex index;
+    index.build({{0, 48.01, 11.01}, {1, 48.20, 11.20}});
+    return index;
+}
+
+} // namespace
+
+// Innerhalb der Zelle fragt der Tracker nach REQUERY_KM neu ab, sonst bliebe der erste
+// Treffer stehen, obwohl inzwischen ein anderer Sender näher ist
+CAROS_TEST("geo/tracker_requery_within_cell") {
+    StationGeoIndex index = two_stations_one_cell();
+    CHECK_EQ(index.cell_key(48.01, 11.01), index.cell_key(48.19, 11.19));
+    NearbyStationTracker tracker(index, 1, 150.0);
+
+    CHECK(tracker.update(48.01, 11.01));
+    CHECK_EQ(tracker.stations().size(), size_t{1});
+    CHECK_EQ(tracker.stations()[0].station_id, size_t{0});
+
+    // Unter REQUERY_KM: nur die Entfernung wird nachgeführt
+    CHECK(!tracker.update(48.015, 11.015));
+    CHECK(std::fabs(tracker.stations()[0].distance_km - geo_distance_km(48.015, 11.015, 48.01, 11.01)) < 1e-9);
+
+    // Schrittweise Richtung Sender 1, immer in derselben Zelle
+    NearbyStationTracker cell_only(index, 1, 150.0, INFINITY); // fragt nur beim Zellwechsel neu ab
+    cell_only.update(48.015, 11.015);
+    bool switched = false;
+    for (int step = 1; step <= 20; step++) {
+        double t = step / 20.0;
+        double lat = 48.015 + t * (48.19 - 48.015), lon = 11.015 + t * (11.19 - 11.015);
+        if (tracker.update(lat, lon)) switched = true;
+        cell_only.update(lat, lon);
+    }
+    CHECK(switched);
+    CHECK_EQ(tracker.stations()[0].station_id, size_t{1});
+    CHECK(tracker.stations()[0].distance_km < 2.0);
+    CHECK_EQ(cell_only.stations()[0].station_id, size_t{0});
+}
@@ -0,0 +1,90 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "stream_variants.hpp"
+#include "variant_playback.hpp"
+#include "test.hpp"
+
+namespace {
+
+constexpr int64_t S = 1000000;
+
+std::vector<StreamVariant> three() {
+    return {{"AAC", 256, "http://x/256"}, {"MP3", 64, "http://x/64"}, {"MP3", 128, "http://x/128"}};
+}
+
+} // namespace
+
+CAROS_TEST("stream_variants/start_without_measurement") {
+    VariantSelector v;
+    CHECK_EQ(v.start(three(), 0), 1u); // sortiert: 64, 128, 256 -> Default 128
+    CHECK_EQ(v.list()[v.active()].bitrate_kbps, 128);
+    CHECK_EQ(v.poll(true, 100 * S), VariantSelector::NONE); // ohne Messung kein Wechsel
+}
+
+CAROS_TEST("stream_variants/stall_switches_down_immediately") {
+    VariantSelector v;
+    v.start(three(), 0);
+    v.on_buffering(100, 300, 1 * S);
+    v.on_buffering(10, -1, 2 * S);
+    CHECK_EQ(v.poll(false, 2 * S), 0u);
+    CHECK_EQ(v.list()[v.active()].bitrate_kbps, 64);
+}
+
+CAROS_TEST("stream_variants/switch_up_only_at_boundary_after_hold") {
+    VariantSelector v;
+    v.start(three(), 0);
+    v.on_buffering(50, 500, 1 * S);
+    CHECK_EQ(v.poll(true, 10 * S), VariantSelector::NONE);  // MIN_HOLD noch nicht vorbei
+    CHECK_EQ(v.poll(false, 40 * S), VariantSelector::NONE); // kein Titelwechsel
+    CHECK_EQ(v.poll(true, 40 * S), 2u);
+}
+
+CAROS_TEST("stream_variants/fallback_without_titles") {
+    VariantSelector v;
+    v.start(three(), 0);
+    v.on_buffering(50, 500, 1 * S);
+    CHECK_EQ(v.poll(false, VariantSelector::FALLBACK_US), 2u);
+}
+
+CAROS_TEST("stream_variants/data_saver_cap") {
+    VariantSelector v;
+    v.set_cap_kbps(96);
+    CHECK_EQ(v.start(three(), 0), 0u);
+    v.on_buffering(50, 1000, 1 * S);
+    CHECK_EQ(v.poll(true, 100 * S), VariantSelector::NONE);
+}
+
+// Umschaltpfad wie im RadioManager, mit eingespeisten queue2-Raten: Einbruch von 250 auf
+// 80 kbit/s (Aussetzer, sofort runter auf 64k), Erholung auf 700 kbit/s (nach Haltezeit und
+// STABLE_US am Titelwechsel hoch auf 256k). Der Sender bleibt Schlüssel jeder Ladung.
+CAROS_TEST("stream_variants/playback_steps_down_and_up") {
+    VariantPlayback playback;
+    std::vector<std::pair<std::string, std::string>> loads;
+    playback.load = [&loads](const std::string& uri, const std::string& station) { loads.emplace_back(uri, station); };
+    int64_t t = 0;
+    playback.play("http://x/128", three(), t);
+    CHECK_EQ(loads.size(), 1u);
+    CHECK_EQ(loads.back().first, std::string("http://x/128"));
+
+    playback.on_buffering(50, 250, t += S);
+    playback.on_buffering(100, 245, t += S);
+    playback.on_title("A", t += S);
+    playback.on_title("B", t += VariantSelector::MIN_HOLD_US);
+    CHECK_EQ(loads.size(), 1u); // 250 kbit/s reichen nicht für 256k
+
+    playback.on_buffering(20, 80, t += S);
+    CHECK_EQ(loads.size(), 2u);
+    CHECK_EQ(loads.back().first, std::string("http://x/64"));
+
+    for (int i = 0; i < 4; i++) playback.on_buffering(25 * i, 700, t += S);
+    playback.on_buffering(100, 690, t += S);
+    CHECK(playback.variants().capacity() >= 384);
+    playback.on_title("C", t += S);
+    CHECK_EQ(loads.size(), 2u); // MIN_HOLD/STABLE noch nicht vorbei
+    playback.on_title("D", t += VariantSelector::STABLE_US);
+    CHECK_EQ(loads.size(), 3u);
+    CHECK_EQ(loads.back().first, std::string("http://x/256"));
+    for (const auto& [uri, station] : loads) CHECK_EQ(station, std::string("http://x/128"));
+}
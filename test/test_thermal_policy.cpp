@@ -0,0 +1,112 @@
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include "bench_data.hpp"
+#include "test.hpp"
+#include "thermal_policy.hpp"
+
+namespace {
+
+constexpr int64_t S = 1000000;
+
+// Nachgebautes sysfs wie unter CAROS_SYSFS_ROOT: class/thermal/thermal_zone<n>/temp in Milligrad
+struct ThermalTree {
+    bench_data::TempDir dir;
+
+    void set(int zone, long millis) {
+        std::string path = dir.path + "/class/thermal/thermal_zone" + std::to_string(zone);
+        std::system(("mkdir -p '" + path + "'").c_str());
+        std::ofstream(path + "/temp") << millis << "\n";
+    }
+
+    double read() const { return ThermalPolicy::read_temperature(dir.path); }
+};
+
+} // namespace
+
+CAROS_TEST("thermal/read_hottest_zone") {
+    ThermalTree tree;
+    CHECK(std::isnan(tree.read()));
+    tree.set(0, 51234);
+    tree.set(1, 68000);
+    CHECK_EQ(tree.read(), 68.0);
+    // Andere Einträge unter class/thermal (cooling_device*) zählen nicht
+    std::system(("mkdir -p '" + tree.dir.path + "/class/thermal/cooling_device0'").c_str());
+    std::ofstream(tree.dir.path + "/class/thermal/cooling_device0/temp") << "99000\n";
+    CHECK_EQ(tree.read(), 68.0);
+}
+
+// Hoch sofort; innerhalb der Hysterese (5 °C unter der Schwelle) bleibt die Stufe beliebig
+// lange, darunter erst nach RELAX_AFTER_S zurück
+CAROS_TEST("thermal/hysteresis_and_hold") {
+    ThermalTree tree;
+    ThermalPolicy policy;
+    int64_t now = 100 * S;
+
+    tree.set(0, 69000);
+    CHECK(!policy.evaluate(tree.read(), 0.0, now));
+    CHECK(policy.profile() == RenderProfile::Full);
+
+    tree.set(0, 71000);
+    CHECK(policy.evaluate(tree.read(), 0.0, now));
+    CHECK(policy.profile() == RenderProfile::Reduced);
+
+    // 66 °C liegt in der Hysterese: hält auch nach mehreren Minuten
+    tree.set(0, 66000);
+    for (int i = 0; i < 100; i++) {
+        now += 2 * S;
+        CHECK(!policy.evaluate(tree.read(), 0.0, now));
+    }
+    CHECK(policy.profile() == RenderProfile::Reduced);
+
+    // Unter 65 °C: erst nach RELAX_AFTER_S ohne Anlass zurück
+    tree.set(0, 60000);
+    int64_t cool_since = now;
+    while (!policy.evaluate(tree.read(), 0.0, now += 2 * S)) {
+        CHECK(now - cool_since <= (ThermalPolicy::RELAX_AFTER_S + 2) * S);
+    }
+    CHECK(now - cool_since > ThermalPolicy::RELAX_AFTER_S * S);
+    CHECK(policy.profile() == RenderProfile::Full);
+
+    // Ein kurzer Ausreißer über die Haltegrenze setzt die Wartezeit zurück
+    tree.set(0, 71000);
+    policy.evaluate(tree.read(), 0.0, now += 2 * S);
+    tree.set(0, 60000);
+    now += (ThermalPolicy::RELAX_AFTER_S - 10) * S;
+    CHECK(!policy.evaluate(tree.read(), 0.0, now));
+    tree.set(0, 67000);
+    CHECK(!policy.evaluate(tree.read(), 0.0, now += 2 * S));
+    tree.set(0, 60000);
+    CHECK(!policy.evaluate(tree.read(), 0.0, now += 20 * S));
+    CHECK(policy.profile() == RenderProfile::Reduced);
+}
+
+// Von minimal zurück nur stufenweise, jede Stufe mit eigener Wartezeit
+CAROS_TEST("thermal/step_down_one_level") {
+    ThermalTree tree;
+    ThermalPolicy policy;
+    int64_t now = 100 * S;
+
+    tree.set(0, 81000);
+    CHECK(policy.evaluate(tree.read(), 0.0, now));
+    CHECK(policy.profile() == RenderProfile::Minimal);
+
+    tree.set(0, 45000);
+    CHECK(policy.evaluate(tree.read(), 0.0, now += (ThermalPolicy::RELAX_AFTER_S + 1) * S));
+    CHECK(policy.profile() == RenderProfile::Reduced);
+    CHECK(!policy.evaluate(tree.read(), 0.0, now += 2 * S));
+    CHECK(policy.evaluate(tree.read(), 0.0, now += ThermalPolicy::RELAX_AFTER_S * S));
+    CHECK(policy.profile() == RenderProfile::Full);
+}
+
+// Langsame Frames schalten auch ohne Temperatur (keine Thermal-Zone lesbar)
+CAROS_TEST("thermal/slow_frames_without_sensor") {
+    ThermalPolicy policy;
+    CHECK(policy.evaluate(NAN, 0.30, 10 * S));
+    CHECK(policy.profile() == RenderProfile::Minimal);
+    // 15 % langsam hält minimal (halbe Schwelle beim Halten)
+    CHECK(!policy.evaluate(NAN, 0.15, 50 * S));
+    CHECK(policy.profile() == RenderProfile::Minimal);
+}